@@ -28,6 +28,7 @@ extern double fgIsFinite(double x);
 
 #include "AIAircraft.hxx"
 #include "AIFlightPlan.hxx"
+#include "AIKinematics.hxx"
 #include "AIManager.hxx"
 #include "performancedata.hxx"
 #include "performancedb.hxx"
@@ -148,6 +149,11 @@ void FGAIAircraft::update(double dt)
     FGAIBase::update(dt);
     Run(dt);
     Transform();
+    updateTracking();
+}
+
+void FGAIAircraft::updateTracking()
+{
     if (tracked && !csvFile->is_open()) {
         char fname[160];
         time_t t = time(0); // get time now
@@ -161,6 +167,75 @@ void FGAIAircraft::update(double dt)
     }
 }
 
+bool FGAIAircraft::beginUpdate(double dt)
+{
+    FGAIBase::update(dt);
+    if (updateTargets(dt)) {
+        return true;
+    }
+
+    Transform();
+    updateTracking();
+    return false;
+}
+
+void FGAIAircraft::addKinematics(FGAIKinematics& batch) const
+{
+    const size_t i = batch.add();
+    batch.latDeg[i] = pos.getLatitudeDeg();
+    batch.lonDeg[i] = pos.getLongitudeDeg();
+    batch.altitudeFt[i] = altitude_ft;
+    batch.hdg[i] = hdg;
+    batch.speed[i] = speed;
+    batch.roll[i] = roll;
+    batch.vsFps[i] = vs_fps;
+    batch.pitch[i] = pitch;
+    batch.turnRadiusFt[i] = turn_radius_ft;
+    batch.spinCounter[i] = spinCounter;
+
+    batch.tgtSpeed[i] = onGround() ? groundTargetSpeed : (tgt_speed * speedFraction);
+    batch.tgtRoll[i] = tgt_roll;
+    batch.tgtVs[i] = tgt_vs;
+    batch.tgtPitch[i] = tgt_pitch;
+
+    batch.acceleration[i] = _performance->acceleration();
+    batch.deceleration[i] = _performance->deceleration();
+    batch.brakeDeceleration[i] = _performance->brakeDeceleration();
+    batch.maxBank[i] = _performance->maximumBankAngle();
+    batch.rollRate[i] = _performance->rollRate();
+    batch.climbRate[i] = _performance->climbRate();
+    batch.descentRate[i] = _performance->descentRate();
+    batch.onGround[i] = onGround();
+    batch.maxBrakes[i] = onGround() && holdPos;
+}
+
+void FGAIAircraft::endUpdate(double dt, const FGAIKinematics& batch, size_t i)
+{
+    if (!batch.valid[i]) {
+        throw sg_exception("_geo_direct_wgs_84 failed");
+    }
+
+    pos = SGGeod::fromDegFt(batch.lonDeg[i], batch.latDeg[i], batch.altitudeFt[i]);
+    altitude_ft = batch.altitudeFt[i];
+    hdg = batch.hdg[i];
+    speed = batch.speed[i];
+    roll = batch.roll[i];
+    vs_fps = batch.vsFps[i];
+    pitch = batch.pitch[i];
+    turn_radius_ft = batch.turnRadiusFt[i];
+    spinCounter = batch.spinCounter[i];
+
+    if (onGround()) {
+        // not integrated in the batch, see FGAIKinematics::integrate()
+        updateGroundHeading(dt);
+        FGAIKinematics::normalizeHeading(hdg, spinCounter);
+    }
+
+    finishRun(dt);
+    Transform();
+    updateTracking();
+}
+
 void FGAIAircraft::unbind()
 {
     FGAIBase::unbind();
@@ -181,6 +256,16 @@ void FGAIAircraft::setPerformance(const std::string& acType, const std::string&
 }
 
 void FGAIAircraft::Run(double dt)
+{
+    if (!updateTargets(dt)) {
+        return;
+    }
+
+    updateActualState(dt);
+    finishRun(dt);
+}
+
+bool FGAIAircraft::updateTargets(double dt)
 {
     // We currently have one situation in which an AIAircraft object is used that is not attached to the
     // AI manager. In this particular case, the AIAircraft is used to shadow the user's aircraft's behavior in the AI world.
@@ -196,7 +281,7 @@ void FGAIAircraft::Run(double dt)
         bool outOfSight = false;
         updatePrimaryTargetValues(dt, flightplanActive, outOfSight); // target hdg, alt, speed
         if (outOfSight) {
-            return;
+            return false;
         }
     } else {
         updateUserFlightPlan(dt);
@@ -208,12 +293,14 @@ void FGAIAircraft::Run(double dt)
 
     handleATCRequests(dt);           // ATC also has a word to say
     updateSecondaryTargetValues(dt); // target roll, vertical speed, pitch
-    updateActualState(dt);
+    return true;
+}
 
+void FGAIAircraft::finishRun(double dt)
+{
     updateModelProperties(dt);
 
-
-    if (!isUserAircraft) {
+    if (manager) {
         UpdateRadar(manager);
         invisible = !manager->isVisible(pos);
     }
@@ -1232,98 +1319,84 @@ void FGAIAircraft::updateHeading(double dt)
     if (roll == 0.0)
         roll = 0.01;
 
-    if (roll != 0.0) {
+    if (onGround()) {
         // If on ground, calculate heading change directly
-        if (onGround()) {
-            const double headingDiff = SGMiscd::normalizePeriodic(-180, 180, hdg - tgt_heading);
-
-            // When pushback behind us we still want to move but ...
-            groundTargetSpeed = tgt_speed * cos(headingDiff * SG_DEGREES_TO_RADIANS);
-
-            if (sign(groundTargetSpeed) != sign(tgt_speed) && fabs(tgt_speed) > 0) {
-                if (fabs(speed) < 2 && fp->isActive(globals->get_time_params()->get_cur_time())) {
-                    // This seems to happen in case there is a change from forward to pushback.
-                    // which should never happen.
-                    SG_LOG(SG_AI, SG_BULK, "Oh dear " << _callsign << " might get stuck aka next point is behind us. Speed is " << speed);
-                    stuckCounter++;
-                    if (stuckCounter > AI_STUCK_LIMIT) {
-                        SG_LOG(SG_AI, SG_WARN, "Stuck flight " << _callsign << " killed on leg " << fp->getLeg() << " because point behind");
-                        setDie(true);
-                    }
-                }
-                // Negative Cosinus means angle > 90°
-                groundTargetSpeed = 0.21 * sign(tgt_speed); // to prevent speed getting stuck in 'negative' mode
-            }
+        updateGroundHeading(dt);
+    } else {
+        hdg = FGAIKinematics::airTurnStep(hdg, speed, roll, dt, turn_radius_ft);
+    }
+    FGAIKinematics::normalizeHeading(hdg, spinCounter);
+}
 
-            // Only update the target values when we're not moving because otherwise we might introduce an enormous target change rate while waiting a the gate, or holding.
-            if (speed != 0) {
-                if (fabs(headingDiff) > 30.0) {
-                    // invert if pushed backward
-                    if (sign(headingChangeRate) == sign(headingDiff)) {
-                        // left/right change
-                        headingChangeRate = 10.0 * dt * sign(headingDiff) * -1;
-                    } else {
-                        headingChangeRate -= 10.0 * dt * sign(headingDiff);
-                    }
-
-                    // Clamp the maximum steering rate to 30 degrees per second,
-                    // But only do this when the heading error is decreasing.
-                    // FIXME
-                    if ((headingDiff < headingError)) {
-                        if (headingChangeRate > 30)
-                            headingChangeRate = 30;
-                        else if (headingChangeRate < -30)
-                            headingChangeRate = -30;
-                    }
-                } else {
-                    if (sign(headingChangeRate) == sign(headingDiff)) {
-                        // left/right change
-                        headingChangeRate = 3 * dt * sign(headingDiff) * -1;
-                    } else {
-                        headingChangeRate -= 3 * dt * sign(headingDiff);
-                    }
-                    /*
-                    if (headingChangeRate > headingDiff ||
-                        headingChangeRate < headingDiff) {
-                        headingChangeRate = headingDiff*sign(roll);
-                    }
-                    else {
-                        headingChangeRate += dt * sign(roll);
-                    }
-                    */
-                }
+void FGAIAircraft::updateGroundHeading(double dt)
+{
+    const double headingDiff = SGMiscd::normalizePeriodic(-180, 180, hdg - tgt_heading);
+
+    // When pushback behind us we still want to move but ...
+    groundTargetSpeed = tgt_speed * cos(headingDiff * SG_DEGREES_TO_RADIANS);
+
+    if (sign(groundTargetSpeed) != sign(tgt_speed) && fabs(tgt_speed) > 0) {
+        if (fabs(speed) < 2 && fp->isActive(globals->get_time_params()->get_cur_time())) {
+            // This seems to happen in case there is a change from forward to pushback.
+            // which should never happen.
+            SG_LOG(SG_AI, SG_BULK, "Oh dear " << _callsign << " might get stuck aka next point is behind us. Speed is " << speed);
+            stuckCounter++;
+            if (stuckCounter > AI_STUCK_LIMIT) {
+                SG_LOG(SG_AI, SG_WARN, "Stuck flight " << _callsign << " killed on leg " << fp->getLeg() << " because point behind");
+                setDie(true);
             }
+        }
+        // Negative Cosinus means angle > 90°
+        groundTargetSpeed = 0.21 * sign(tgt_speed); // to prevent speed getting stuck in 'negative' mode
+    }
 
-            hdg += headingChangeRate * dt * sqrt(fabs(speed) / 15);
+    // Only update the target values when we're not moving because otherwise we might introduce an enormous target change rate while waiting a the gate, or holding.
+    if (speed != 0) {
+        if (fabs(headingDiff) > 30.0) {
+            // invert if pushed backward
+            if (sign(headingChangeRate) == sign(headingDiff)) {
+                // left/right change
+                headingChangeRate = 10.0 * dt * sign(headingDiff) * -1;
+            } else {
+                headingChangeRate -= 10.0 * dt * sign(headingDiff);
+            }
 
-            headingError = headingDiff;
-            // SG_LOG(SG_AI, SG_BULK, "Headingerror " << headingError );
-            if (fabs(headingError) < 1.0) {
-                hdg = tgt_heading;
+            // Clamp the maximum steering rate to 30 degrees per second,
+            // But only do this when the heading error is decreasing.
+            // FIXME
+            if ((headingDiff < headingError)) {
+                if (headingChangeRate > 30)
+                    headingChangeRate = 30;
+                else if (headingChangeRate < -30)
+                    headingChangeRate = -30;
             }
         } else {
-            if (fabs(speed) > 1.0) {
-                turn_radius_ft = 0.088362 * speed * speed / tan(fabs(roll) / SG_RADIANS_TO_DEGREES);
+            if (sign(headingChangeRate) == sign(headingDiff)) {
+                // left/right change
+                headingChangeRate = 3 * dt * sign(headingDiff) * -1;
             } else {
-                // Check if turn_radius_ft == 0; this might lead to a division by 0.
-                turn_radius_ft = 1.0;
+                headingChangeRate -= 3 * dt * sign(headingDiff);
             }
-            double turn_circum_ft = SGD_2PI * turn_radius_ft;
-            double dist_covered_ft = speed * 1.686 * dt;
-            double alpha = dist_covered_ft / turn_circum_ft * 360.0;
-            hdg += alpha * sign(roll);
-        }
-        while (hdg > 360.0) {
-            hdg -= 360.0;
-            spinCounter++;
-        }
-        while (hdg < 0.0) {
-            hdg += 360.0;
-            spinCounter--;
+            /*
+            if (headingChangeRate > headingDiff ||
+                headingChangeRate < headingDiff) {
+                headingChangeRate = headingDiff*sign(roll);
+            }
+            else {
+                headingChangeRate += dt * sign(roll);
+            }
+            */
         }
     }
-}
 
+    hdg += headingChangeRate * dt * sqrt(fabs(speed) / 15);
+
+    headingError = headingDiff;
+    // SG_LOG(SG_AI, SG_BULK, "Headingerror " << headingError );
+    if (fabs(headingError) < 1.0) {
+        hdg = tgt_heading;
+    }
+}
 
 void FGAIAircraft::updateBankAngleTarget()
 {
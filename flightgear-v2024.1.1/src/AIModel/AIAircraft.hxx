@@ -19,6 +19,7 @@ class FGAISchedule;
 class FGAIFlightPlan;
 class FGATCController;
 class FGATCInstruction;
+class FGAIKinematics;
 class FGAIWaypoint;
 class sg_ofstream;
 
@@ -59,6 +60,23 @@ public:
     void update(double dt) override;
     void unbind() override;
 
+    /**
+     * FGAIManager updates AI aircraft in three steps instead of calling
+     * update(), so that the motion of all of them is integrated in one
+     * pass over an FGAIKinematics batch: beginUpdate() runs the flight
+     * plan, ATC and the target computations, addKinematics() copies the
+     * state into the batch and endUpdate() takes the integrated state back
+     * and does the rest of update().
+     *
+     * Subclasses which extend update() must return false here.
+     */
+    virtual bool isBatchable() const { return manager != nullptr; }
+
+    /// returns false if nothing is left to integrate this frame
+    bool beginUpdate(double dt);
+    void addKinematics(FGAIKinematics& batch) const;
+    void endUpdate(double dt, const FGAIKinematics& batch, size_t index);
+
     void setPerformance(const std::string& acType, const std::string& perfString);
 
     void setFlightPlan(const std::string& fp, bool repat = false);
@@ -140,6 +158,9 @@ public:
 
 protected:
     void Run(double dt);
+    bool updateTargets(double dt);
+    void finishRun(double dt);
+    void updateTracking();
 
 private:
     FGAISchedule* trafficRef;
@@ -181,6 +202,7 @@ private:
     void updatePrimaryTargetValues(double dt, bool& flightplanActive, bool& aiOutOfSight);
     void updateSecondaryTargetValues(double dt);
     void updateHeading(double dt);
+    void updateGroundHeading(double dt);
     void updateBankAngleTarget();
     void updateVerticalSpeedTarget(double dt);
     void updatePitchAngleTarget();
@@ -329,10 +329,13 @@ void FGAIBase::update(double dt) {
                 name << _refID;
                 _fx = new FGFX(name.str(), props);
                 _fx->init();
+                _fx->setUpdateInterval(_updateInterval);
             }
         }
     }
 
+    updateThrottle();
+
     if ( _fx )
     {
         // update model's audio sample values
@@ -374,6 +377,42 @@ void FGAIBase::updateInterior()
     }
 }
 
+/** reduce the animation and sound update rate of distant models */
+void FGAIBase::updateThrottle()
+{
+    unsigned interval = 1;
+    if (manager && _model.valid() && !invisible) {
+        double radius = _model->getRadius();
+        if (radius <= 0) {
+            radius = getDefaultModelRadius();
+        }
+        interval = manager->updateIntervalFor(pos, radius);
+    }
+
+    if (interval == _updateInterval) {
+        return;
+    }
+
+    _updateInterval = interval;
+    aip.setUpdateInterval(interval);
+    if (_fx) {
+        _fx->setUpdateInterval(interval);
+    }
+
+    // published for model Nasal code, which can stretch its own timers
+    props->setIntValue("update-interval", interval);
+}
+
+unsigned FGAIBase::getSkippedAnimationUpdates() const
+{
+    return aip.getSkippedUpdates();
+}
+
+unsigned FGAIBase::getSkippedSoundUpdates() const
+{
+    return _fx ? _fx->getSkippedUpdates() : 0;
+}
+
 /** update LOD properties of the model */
 void FGAIBase::updateLOD()
 {
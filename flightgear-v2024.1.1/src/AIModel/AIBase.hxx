@@ -84,6 +84,10 @@ public:
 
     void updateLOD();
     void updateInterior();
+    void updateThrottle();
+
+    unsigned getSkippedAnimationUpdates() const;
+    unsigned getSkippedSoundUpdates() const;
 
     void setManager(FGAIManager* mgr, SGPropertyNode* p);
 
@@ -304,6 +308,7 @@ private:
     osg::ref_ptr<FGAIModelData> _modeldata;
 
     SGSharedPtr<FGFX> _fx;
+    unsigned _updateInterval = 1;
 
     std::vector<std::string> resolveModelPath(ModelSearchOrder searchOrder);
 
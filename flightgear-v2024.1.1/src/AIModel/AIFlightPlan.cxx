@@ -143,6 +143,28 @@ FGAIFlightPlan::FGAIFlightPlan(FGAIAircraft* ac,
                                double speed,
                                const string& fltType,
                                const string& acType,
+                               const string& airline) : FGAIFlightPlan(ac, loadFiledPlan(p).get(), course, start,
+                                                                       remainingTime, dep, arr, firstLeg,
+                                                                       radius, alt, lat, lon, speed,
+                                                                       fltType, acType, airline)
+{
+}
+
+FGAIFlightPlan::FGAIFlightPlan(FGAIAircraft* ac,
+                               const SGPropertyNode* filedPlan,
+                               double course,
+                               time_t start,
+                               time_t remainingTime,
+                               FGAirport* dep,
+                               FGAirport* arr,
+                               bool firstLeg,
+                               double radius,
+                               double alt,
+                               double lat,
+                               double lon,
+                               double speed,
+                               const string& fltType,
+                               const string& acType,
                                const string& airline) : sid(NULL),
                                                         repeat(false),
                                                         distance_to_go(0),
@@ -156,7 +178,7 @@ FGAIFlightPlan::FGAIFlightPlan(FGAIAircraft* ac,
                                                         departure(dep),
                                                         arrival(arr)
 {
-    if (parseProperties(p)) {
+    if (filedPlan && readFlightplan(filedPlan, sg_location(filedPlan))) {
         isValid = true;
     } else {
         createWaypoints(ac, course, start, remainingTime, dep, arr, firstLeg, radius,
@@ -227,6 +249,24 @@ bool FGAIFlightPlan::readFlightplan(const SGPath& file)
     return readFlightplan(f, file);
 }
 
+SGPropertyNode_ptr FGAIFlightPlan::loadFiledPlan(const std::string& filename)
+{
+    SGPath fp = globals->findDataPath("AI/FlightPlans/" + filename);
+    if (!fp.exists()) {
+        return {};
+    }
+
+    SGPropertyNode_ptr root(new SGPropertyNode);
+    sg_ifstream f(fp);
+    try {
+        readProperties(f, root);
+    } catch (const sg_exception& e) {
+        SG_LOG(SG_AI, SG_ALERT, "Error reading AI flight plan: " << fp << " message:" << e.getFormattedMessage());
+        return {};
+    }
+    return root;
+}
+
 bool FGAIFlightPlan::readFlightplan(std::istream& stream, const sg_location& loc)
 {
     SGPropertyNode root;
@@ -237,7 +277,12 @@ bool FGAIFlightPlan::readFlightplan(std::istream& stream, const sg_location& loc
         return false;
     }
 
-    SGPropertyNode* node = root.getNode("flightplan");
+    return readFlightplan(&root, loc);
+}
+
+bool FGAIFlightPlan::readFlightplan(const SGPropertyNode* root, const sg_location& loc)
+{
+    const SGPropertyNode* node = root->getNode("flightplan");
     if (!node) {
         SG_LOG(SG_AI, SG_ALERT, "Error reading AI flight plan: " << loc.asString() << ": no <flightplan> root element");
         return false;
@@ -245,7 +290,7 @@ bool FGAIFlightPlan::readFlightplan(std::istream& stream, const sg_location& loc
 
     for (int i = 0; i < node->nChildren(); i++) {
         FGAIWaypoint* wpt = new FGAIWaypoint;
-        SGPropertyNode* wpt_node = node->getChild(i);
+        const SGPropertyNode* wpt_node = node->getChild(i);
 
         bool gear, flaps;
 
@@ -14,6 +14,7 @@
 #include <Navaids/positioned.hxx>
 #include <simgear/compiler.h>
 #include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
 #include <simgear/structure/SGSharedPtr.hxx>
 #include <simgear/structure/exception.hxx>
 
@@ -140,8 +141,36 @@ public:
                    const std::string& fltType,
                    const std::string& acType,
                    const std::string& airline);
+    /**
+     * As above, but with a filed flight plan already read by
+     * loadFiledPlan(), or nullptr to generate the waypoints.
+     */
+    FGAIFlightPlan(FGAIAircraft*,
+                   const SGPropertyNode* filedPlan,
+                   double course,
+                   time_t start,
+                   time_t remainingTime,
+                   FGAirport* dep,
+                   FGAirport* arr,
+                   bool firstLeg,
+                   double radius,
+                   double alt,
+                   double lat,
+                   double lon,
+                   double speed,
+                   const std::string& fltType,
+                   const std::string& acType,
+                   const std::string& airline);
     virtual ~FGAIFlightPlan();
 
+    /**
+     * Look for a filed flight plan (AI/FlightPlans/<filename>) and read it
+     * into a new property tree. Returns nullptr if there is none or it
+     * could not be read. Only touches the data paths and the file, so it
+     * is safe to call from a worker thread.
+     */
+    static SGPropertyNode_ptr loadFiledPlan(const std::string& filename);
+
     /**
         @brief create a nearly empty FlightPlan for the user aircraft, based
      on the current position and route-manager data.
@@ -156,6 +185,9 @@ public:
 
     bool readFlightplan(std::istream& stream, const sg_location& loc = sg_location{});
 
+    /// read the waypoints from a property tree with a <flightplan> root element
+    bool readFlightplan(const SGPropertyNode* root, const sg_location& loc);
+
     FGAIWaypoint* getPreviousWaypoint(void) const;
     FGAIWaypoint* getCurrentWaypoint(void) const;
     FGAIWaypoint* getNextWaypoint(void) const;
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileName: AIFlightPlanBuilder.cxx
+ * SPDX-FileComment: asynchronous preparation of AI flight plans
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "AIFlightPlanBuilder.hxx"
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/threads/SGThread.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include <Airports/airport.hxx>
+#include <Airports/groundnetwork.hxx>
+#include <Airports/xmlloader.hxx>
+
+#include "AIFlightPlan.hxx"
+
+class FGAIFlightPlanBuilder::WorkerThread : public SGThread
+{
+public:
+    explicit WorkerThread(FGAIFlightPlanBuilder* builder) : _builder(builder) {}
+
+    void run() override
+    {
+        for (;;) {
+            JobRef job = _builder->_pending.pop();
+            if (!job) {
+                return; // shutting down
+            }
+
+            if (!job->cancelled) {
+                job->filedPlan = FGAIFlightPlan::loadFiledPlan(job->planName);
+            }
+
+            for (auto& load : job->groundnets) {
+                if (job->cancelled) {
+                    break;
+                }
+
+                // the same as FGAirport::groundNetwork(), but not shared yet
+                load.net.reset(new FGGroundNetwork(load.airport));
+                load.hasErrors = !XMLLoader::parseGroundnet(load.net.get(), load.path);
+                load.net->init();
+            }
+            _builder->_finished.push(job);
+        }
+    }
+
+private:
+    FGAIFlightPlanBuilder* _builder;
+};
+
+FGAIFlightPlanBuilder::Job::~Job()
+{
+}
+
+FGAIFlightPlanBuilder::FGAIFlightPlanBuilder(unsigned maxJobs) : _maxJobs(maxJobs),
+                                                                 _worker(new WorkerThread(this))
+{
+    _worker->start();
+}
+
+FGAIFlightPlanBuilder::~FGAIFlightPlanBuilder()
+{
+    cancelAll();
+    _pending.push(JobRef());
+    _worker->join();
+}
+
+FGAIFlightPlanBuilder::Ticket FGAIFlightPlanBuilder::request(const std::string& planName, ReadyCallback onReady)
+{
+    return request(planName, {}, std::move(onReady));
+}
+
+FGAIFlightPlanBuilder::Ticket FGAIFlightPlanBuilder::request(const std::string& planName,
+                                                             const std::vector<FGAirport*>& airports,
+                                                             ReadyCallback onReady)
+{
+    if (_jobs.size() >= _maxJobs) {
+        return 0;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->ticket = _nextTicket++;
+    if (_nextTicket == 0) {
+        _nextTicket = 1; // 0 means no ticket
+    }
+    job->planName = planName;
+    job->onReady = std::move(onReady);
+
+    for (FGAirport* apt : airports) {
+        if (!apt || apt->hasGroundNetwork() || (_loadingGroundnets.count(apt) != 0)) {
+            continue;
+        }
+
+        // finding the file uses the navigation data, which the worker must not
+        SGPath path;
+        if (!XMLLoader::findAirportData(apt->ident(), "groundnet", path)) {
+            continue; // groundNetwork() creates an empty one quickly
+        }
+
+        GroundnetLoad load;
+        load.airport = apt;
+        load.path = path;
+        job->groundnets.push_back(std::move(load));
+        _loadingGroundnets.insert(apt);
+    }
+
+    _jobs[job->ticket] = job;
+    _pending.push(job);
+    return job->ticket;
+}
+
+void FGAIFlightPlanBuilder::cancel(Ticket ticket)
+{
+    auto it = _jobs.find(ticket);
+    if (it == _jobs.end()) {
+        return;
+    }
+
+    // the worker or the ready list may still hold the job, it is skipped there
+    it->second->cancelled = true;
+    _jobs.erase(it);
+}
+
+void FGAIFlightPlanBuilder::cancelAll()
+{
+    for (auto& it : _jobs) {
+        it.second->cancelled = true;
+    }
+    _jobs.clear();
+    _ready.clear();
+}
+
+void FGAIFlightPlanBuilder::update(double budgetMs)
+{
+    for (JobRef job = _finished.pop(); job; job = _finished.pop()) {
+        // the networks of cancelled jobs are still good
+        installGroundnets(*job);
+        if (!job->cancelled) {
+            _ready.push_back(job);
+        }
+    }
+
+    SGTimeStamp start;
+    start.stamp();
+    unsigned delivered = 0;
+    while (!_ready.empty()) {
+        if ((delivered > 0) && (start.elapsedUSec() >= budgetMs * 1000.0)) {
+            break;
+        }
+
+        JobRef job = _ready.front();
+        _ready.pop_front();
+        if (job->cancelled) {
+            continue;
+        }
+
+        // remove the job first, so the callback may request a new one
+        _jobs.erase(job->ticket);
+        ++delivered;
+        job->onReady(job->filedPlan.get());
+    }
+
+    if (!_ready.empty()) {
+        SG_LOG(SG_AI, SG_BULK, "AI flight plan builder: " << _ready.size() << " plans deferred to the next frame");
+    }
+}
+
+void FGAIFlightPlanBuilder::installGroundnets(Job& job)
+{
+    for (auto& load : job.groundnets) {
+        _loadingGroundnets.erase(load.airport.get());
+        if (!load.net || load.airport->hasGroundNetwork()) {
+            continue; // not loaded, or the main thread needed it first
+        }
+
+        if (load.hasErrors) {
+            XMLLoader::reportGroundnetErrors(load.net.get(), load.path);
+        }
+        load.airport->setGroundNetwork(std::move(load.net));
+    }
+    job.groundnets.clear();
+}
@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileName: AIFlightPlanBuilder.hxx
+ * SPDX-FileComment: asynchronous preparation of AI flight plans
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/threads/SGQueue.hxx>
+
+#include <Airports/airports_fwd.hxx>
+
+/**
+ * Prepares the flight plans of traffic manager aircraft which are about
+ * to become active, so that doing so does not stall the frame.
+ *
+ * Looking up and parsing a filed flight plan (AI/FlightPlans/DEP-ARR.xml)
+ * only depends on the data paths and the file itself and is done on a
+ * worker thread. So is loading the ground networks of the airports
+ * involved, when they have none yet: parsing the groundnet XML and
+ * pairing its segments is most of the cost of the first taxi route at an
+ * airport. The networks are complete, unshared objects until update()
+ * hands them to their airport.
+ *
+ * Generating the waypoints, the taxi route search included, must stay on
+ * the main thread: it allocates gates, picks the runway in use and talks
+ * to the ATC controllers, none of which is thread-safe. The generation is
+ * run from update() when the worker is done with a job, within a time
+ * budget per frame, so a burst of aircraft entering the area is spread
+ * over several frames instead of being built all at once.
+ *
+ * The number of jobs in flight is bounded, request() fails when the
+ * builder is busy and the caller should try again later.
+ */
+class FGAIFlightPlanBuilder
+{
+public:
+    using Ticket = unsigned;
+
+    /**
+     * Called on the main thread when the plan can be built, with the
+     * filed flight plan, or nullptr if there is none.
+     */
+    using ReadyCallback = std::function<void(const SGPropertyNode* filedPlan)>;
+
+    explicit FGAIFlightPlanBuilder(unsigned maxJobs = 16);
+    ~FGAIFlightPlanBuilder();
+
+    /**
+     * Queue a plan, planName is the file name of a possible filed flight
+     * plan. Returns 0 if too many jobs are in flight already.
+     */
+    Ticket request(const std::string& planName, ReadyCallback onReady);
+
+    /**
+     * As above, also loading the ground networks of those airports which
+     * have none loaded yet, or being loaded by another job.
+     */
+    Ticket request(const std::string& planName, const std::vector<FGAirport*>& airports,
+                   ReadyCallback onReady);
+
+    /// drop a job, its callback will not be run
+    void cancel(Ticket ticket);
+
+    /// drop all jobs
+    void cancelAll();
+
+    /**
+     * Run the callbacks of finished jobs, at least one, then as many as
+     * fit into budgetMs.
+     */
+    void update(double budgetMs);
+
+    size_t numJobs() const { return _jobs.size(); }
+    unsigned getMaxJobs() const { return _maxJobs; }
+
+private:
+    struct GroundnetLoad {
+        FGAirportRef airport;
+        SGPath path;
+        std::unique_ptr<FGGroundNetwork> net; ///< set by the worker
+        bool hasErrors = false;
+    };
+
+    struct Job {
+        Ticket ticket = 0;
+        std::string planName;
+        ReadyCallback onReady;
+        SGPropertyNode_ptr filedPlan;
+        std::vector<GroundnetLoad> groundnets;
+        std::atomic<bool> cancelled{false};
+
+        ~Job();
+    };
+    using JobRef = std::shared_ptr<Job>;
+
+    class WorkerThread;
+
+    void installGroundnets(Job& job);
+
+    const unsigned _maxJobs;
+    Ticket _nextTicket = 1;
+    std::map<Ticket, JobRef> _jobs;      ///< requested and not delivered
+    std::deque<JobRef> _ready;           ///< waiting for update()
+    std::set<FGAirport*> _loadingGroundnets;
+
+    SGBlockingQueue<JobRef> _pending;    ///< to the worker, nullptr stops it
+    SGLockedQueue<JobRef> _finished;     ///< back from the worker
+    std::unique_ptr<WorkerThread> _worker;
+};
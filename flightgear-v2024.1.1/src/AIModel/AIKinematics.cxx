@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileName: AIKinematics.cxx
+ * SPDX-FileComment: batched integration of the motion of AI aircraft
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "AIKinematics.hxx"
+
+#include <cmath>
+
+#include <simgear/constants.h>
+#include <simgear/math/SGMath.hxx>
+#include <simgear/math/sg_geodesy.hxx>
+
+double FGAIKinematics::speedStep(double speed, double tgtSpeed, double dt,
+                                 double acceleration, double deceleration,
+                                 double brakeDeceleration, bool onGround, bool maxBrakes)
+{
+    if (tgtSpeed > speed) {
+        speed += acceleration * dt;
+        if (speed > tgtSpeed) {
+            speed = tgtSpeed;
+        }
+    } else if (tgtSpeed < speed) {
+        if (onGround) {
+            // deceleration performance is better due to wheel brakes.
+            speed -= (maxBrakes ? 2.0 : 1.0) * brakeDeceleration * dt;
+        } else {
+            speed -= deceleration * dt;
+        }
+
+        if (speed < tgtSpeed) {
+            speed = tgtSpeed;
+        }
+    }
+
+    return speed;
+}
+
+double FGAIKinematics::bankStep(double roll, double tgtRoll, double dt, double maxBank, double rollRate)
+{
+    // check maximum bank angle
+    if (fabs(tgtRoll) > maxBank) {
+        tgtRoll = maxBank * tgtRoll / fabs(tgtRoll);
+    }
+
+    const double bankDiff = tgtRoll - roll;
+    if (fabs(bankDiff) > 0.2) {
+        if (bankDiff > 0.0) {
+            roll += rollRate * dt;
+            if (roll > tgtRoll) {
+                roll = tgtRoll;
+            }
+        } else {
+            roll -= rollRate * dt;
+            if (roll < tgtRoll) {
+                roll = tgtRoll;
+            }
+        }
+    }
+
+    return roll;
+}
+
+double FGAIKinematics::pitchStep(double pitch, double tgtPitch, double dt, double climbRate, double descentRate)
+{
+    if (tgtPitch > pitch) {                       // nose up
+        pitch += 0.005 * climbRate * dt / 3.0;    // TODO: avoid hardcoded 3 secs
+        if (pitch > tgtPitch) {
+            pitch = tgtPitch;
+        }
+    } else if (tgtPitch < pitch) {                // nose down
+        pitch -= 0.002 * descentRate * dt / 3.0;
+        if (pitch < tgtPitch) {
+            pitch = tgtPitch;
+        }
+    }
+
+    return pitch;
+}
+
+double FGAIKinematics::verticalSpeedStep(double vsFpm, double tgtVs, double dt, double climbRate, double descentRate)
+{
+    const double vsDiff = tgtVs - vsFpm;
+    if (fabs(vsDiff) > .001) {
+        if (vsDiff > 0.0) {
+            vsFpm += climbRate * dt / 3.0; // TODO: avoid hardcoded 3 secs to attain climb rate from level flight
+            if (vsFpm > tgtVs) {
+                vsFpm = tgtVs;
+            }
+        } else {
+            vsFpm -= descentRate * dt / 3.0;
+            if (vsFpm < tgtVs) {
+                vsFpm = tgtVs;
+            }
+        }
+    }
+
+    return vsFpm;
+}
+
+double FGAIKinematics::airTurnStep(double hdg, double speed, double roll, double dt, double& turnRadiusFt)
+{
+    if (fabs(speed) > 1.0) {
+        turnRadiusFt = 0.088362 * speed * speed / tan(fabs(roll) / SG_RADIANS_TO_DEGREES);
+    } else {
+        // Check if turn_radius_ft == 0; this might lead to a division by 0.
+        turnRadiusFt = 1.0;
+    }
+
+    const double turnCircumFt = SGD_2PI * turnRadiusFt;
+    const double distCoveredFt = speed * 1.686 * dt;
+    const double alpha = distCoveredFt / turnCircumFt * 360.0;
+    const double sense = (roll > 0.0) ? 1.0 : ((roll < 0.0) ? -1.0 : 0.0);
+    return hdg + alpha * sense;
+}
+
+void FGAIKinematics::normalizeHeading(double& hdg, int& spinCounter)
+{
+    while (hdg > 360.0) {
+        hdg -= 360.0;
+        spinCounter++;
+    }
+    while (hdg < 0.0) {
+        hdg += 360.0;
+        spinCounter--;
+    }
+}
+
+void FGAIKinematics::clear()
+{
+    for (auto column : {&latDeg, &lonDeg, &altitudeFt, &hdg, &speed, &roll, &vsFps, &pitch,
+                        &turnRadiusFt, &tgtSpeed, &tgtRoll, &tgtVs, &tgtPitch,
+                        &acceleration, &deceleration, &brakeDeceleration,
+                        &maxBank, &rollRate, &climbRate, &descentRate}) {
+        column->clear();
+    }
+    spinCounter.clear();
+    onGround.clear();
+    maxBrakes.clear();
+    valid.clear();
+}
+
+size_t FGAIKinematics::add()
+{
+    const size_t index = size();
+    const size_t n = index + 1;
+    for (auto column : {&latDeg, &lonDeg, &altitudeFt, &hdg, &speed, &roll, &vsFps, &pitch,
+                        &turnRadiusFt, &tgtSpeed, &tgtRoll, &tgtVs, &tgtPitch,
+                        &acceleration, &deceleration, &brakeDeceleration,
+                        &maxBank, &rollRate, &climbRate, &descentRate}) {
+        column->resize(n, 0.0);
+    }
+    spinCounter.resize(n, 0);
+    onGround.resize(n, 0);
+    maxBrakes.resize(n, 0);
+    valid.resize(n, 1);
+    return index;
+}
+
+void FGAIKinematics::integrate(double dt)
+{
+    const size_t n = size();
+
+    // The quantities are advanced one after the other, in the order in
+    // which FGAIAircraft::updateActualState() does it: each loop only
+    // sees the results of the loops before it.
+
+    // move along the current heading with the current speed
+    for (size_t i = 0; i < n; ++i) {
+        const SGGeod start = SGGeod::fromDeg(lonDeg[i], latDeg[i]);
+        SGGeod end;
+        double course2;
+        if (!SGGeodesy::direct(start, hdg[i], speed[i] * SG_KT_TO_MPS * dt, end, course2)) {
+            valid[i] = 0;
+            continue;
+        }
+        latDeg[i] = end.getLatitudeDeg();
+        lonDeg[i] = end.getLongitudeDeg();
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        speed[i] = speedStep(speed[i], tgtSpeed[i], dt, acceleration[i], deceleration[i],
+                             brakeDeceleration[i], onGround[i], maxBrakes[i]);
+    }
+
+    // turning on the ground is left to the aircraft, it steers towards
+    // its target heading and might decide it is stuck
+    for (size_t i = 0; i < n; ++i) {
+        if (roll[i] == 0.0) {
+            roll[i] = 0.01;
+        }
+        if (!onGround[i]) {
+            hdg[i] = airTurnStep(hdg[i], speed[i], roll[i], dt, turnRadiusFt[i]);
+            normalizeHeading(hdg[i], spinCounter[i]);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        roll[i] = bankStep(roll[i], tgtRoll[i], dt, maxBank[i], rollRate[i]);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        altitudeFt[i] += vsFps[i] * dt;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        vsFps[i] = verticalSpeedStep(vsFps[i] * 60, tgtVs[i], dt, climbRate[i], descentRate[i]) / 60;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        pitch[i] = pitchStep(pitch[i], tgtPitch[i], dt, climbRate[i], descentRate[i]);
+    }
+}
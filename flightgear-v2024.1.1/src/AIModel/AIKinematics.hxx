@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileName: AIKinematics.hxx
+ * SPDX-FileComment: batched integration of the motion of AI aircraft
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The state of all AI aircraft integrated in one frame, stored as one
+ * array per quantity.
+ *
+ * FGAIManager fills the batch after every aircraft has run its flight
+ * plan, ATC and target computations (FGAIAircraft::beginUpdate()), then
+ * integrate() advances position, speed, heading, bank, altitude, vertical
+ * speed and pitch of all of them in a few tight loops and the aircraft
+ * take their new state back (FGAIAircraft::endUpdate()).
+ *
+ * The step functions are the only implementation of the AI flight model,
+ * PerformanceData and the unbatched FGAIAircraft::update() use them too.
+ */
+class FGAIKinematics
+{
+public:
+    /// speed in kts after accelerating towards tgtSpeed for dt
+    static double speedStep(double speed, double tgtSpeed, double dt,
+                            double acceleration, double deceleration,
+                            double brakeDeceleration, bool onGround, bool maxBrakes);
+
+    /// bank angle after rolling towards tgtRoll for dt
+    static double bankStep(double roll, double tgtRoll, double dt, double maxBank, double rollRate);
+
+    /// pitch after rotating towards tgtPitch for dt
+    static double pitchStep(double pitch, double tgtPitch, double dt, double climbRate, double descentRate);
+
+    /// vertical speed in fpm after changing towards tgtVs for dt
+    static double verticalSpeedStep(double vsFpm, double tgtVs, double dt, double climbRate, double descentRate);
+
+    /**
+     * Heading after a coordinated turn with the bank angle roll for dt,
+     * not normalized. Also returns the turn radius.
+     */
+    static double airTurnStep(double hdg, double speed, double roll, double dt, double& turnRadiusFt);
+
+    /// bring hdg into [0, 360], counting the full turns in spinCounter
+    static void normalizeHeading(double& hdg, int& spinCounter);
+
+    void clear();
+    size_t size() const { return latDeg.size(); }
+
+    /// append an aircraft, all columns must then be set at the returned index
+    size_t add();
+
+    /// advance all aircraft by dt
+    void integrate(double dt);
+
+    // integrated state
+    std::vector<double> latDeg, lonDeg, altitudeFt;
+    std::vector<double> hdg, speed, roll, vsFps, pitch;
+    std::vector<double> turnRadiusFt;
+    std::vector<int> spinCounter;
+
+    // targets, computed by the aircraft before integrating
+    std::vector<double> tgtSpeed, tgtRoll, tgtVs, tgtPitch;
+
+    // performance limits and flags
+    std::vector<double> acceleration, deceleration, brakeDeceleration;
+    std::vector<double> maxBank, rollRate, climbRate, descentRate;
+    std::vector<uint8_t> onGround, maxBrakes;
+
+    /// cleared if the position could not be advanced
+    std::vector<uint8_t> valid;
+};
@@ -156,6 +156,29 @@ void FGAIManager::init()
     _radarRangeNode = fgGetNode("/instrumentation/radar/range", true);
     _radarDebugNode = fgGetNode("/instrumentation/radar/debug-mode", true);
 
+    // update throttling of the animations and sounds of distant models
+    SGPropertyNode* throttle = fgGetNode("/sim/ai/update-throttle", true);
+    _throttleEnabledNode = throttle->getNode("enabled", true);
+    if (!_throttleEnabledNode->hasValue()) {
+        _throttleEnabledNode->setBoolValue(true);
+    }
+    // distance, in model radii, up to which models are updated every frame
+    _throttleFullRateRadiiNode = throttle->getNode("full-rate-radii", true);
+    if (!_throttleFullRateRadiiNode->hasValue()) {
+        _throttleFullRateRadiiNode->setDoubleValue(200.0);
+    }
+    _throttleMaxIntervalNode = throttle->getNode("max-interval", true);
+    if (!_throttleMaxIntervalNode->hasValue()) {
+        _throttleMaxIntervalNode->setIntValue(8);
+    }
+    _skippedAnimationUpdatesNode = throttle->getNode("skipped-animation-updates", true);
+    _skippedSoundUpdatesNode = throttle->getNode("skipped-sound-updates", true);
+
+    _batchKinematicsNode = fgGetNode("/sim/ai/batch-kinematics", true);
+    if (!_batchKinematicsNode->hasValue()) {
+        _batchKinematicsNode->setBoolValue(true);
+    }
+
     // register scenarios if we didn't do it already
     registerScenarios();
 }
@@ -365,6 +388,8 @@ void FGAIManager::update(double dt)
     _radarDebugMode = _radarDebugNode->getBoolValue();
     _radarRangeM = _radarRangeNode->getDoubleValue() * SG_NM_TO_METER;
 
+    fetchUpdateThrottleState();
+
     // partition the list into dead followed by alive
     auto firstAlive =
         std::stable_partition(ai_list.begin(), ai_list.end(), std::mem_fn(&FGAIBase::getDie));
@@ -379,10 +404,22 @@ void FGAIManager::update(double dt)
     // every remaining item is alive. update them in turn, but guard for
     // exceptions, so a single misbehaving AI object doesn't bring down the
     // entire subsystem.
+    // AI aircraft only compute their targets here, their motion is
+    // integrated for all of them at once below.
+    const bool batchKinematics = _batchKinematicsNode->getBoolValue();
+    _kinematics.clear();
+    _batchedAircraft.clear();
     for (FGAIBase* base : ai_list) {
         try {
             if (base->isa(FGAIBase::object_type::otThermal)) {
                 processThermal(dt, static_cast<FGAIThermal*>(base));
+            } else if (batchKinematics && base->isa(FGAIBase::object_type::otAircraft) &&
+                       static_cast<FGAIAircraft*>(base)->isBatchable()) {
+                auto aircraft = static_cast<FGAIAircraft*>(base);
+                if (aircraft->beginUpdate(dt)) {
+                    aircraft->addKinematics(_kinematics);
+                    _batchedAircraft.push_back(aircraft);
+                }
             } else {
                 base->update(dt);
             }
@@ -394,7 +431,28 @@ void FGAIManager::update(double dt)
         }
     }                                            // of live AI objects iteration
 
+    _kinematics.integrate(dt);
+    for (size_t i = 0; i < _batchedAircraft.size(); ++i) {
+        FGAIAircraft* aircraft = _batchedAircraft[i];
+        try {
+            aircraft->endUpdate(dt, _kinematics, i);
+        } catch (sg_exception& e) {
+            SG_LOG(SG_AI, SG_WARN, "caught exception updating AI model:" << aircraft->_getName() << ", which will be killed."
+                                                                                                    "\n\tError:"
+                                                                             << e.getFormattedMessage());
+            aircraft->setDie(true);
+        }
+    }
+
     thermal_lift_node->setDoubleValue(strength); // for thermals
+
+    long skippedAnimations = 0, skippedSounds = 0;
+    for (FGAIBase* base : ai_list) {
+        skippedAnimations += base->getSkippedAnimationUpdates();
+        skippedSounds += base->getSkippedSoundUpdates();
+    }
+    _skippedAnimationUpdatesNode->setLongValue(skippedAnimations);
+    _skippedSoundUpdatesNode->setLongValue(skippedSounds);
 }
 
 /** update LOD settings of all AI/MP models */
@@ -439,6 +497,25 @@ bool FGAIManager::isVisible(const SGGeod& pos) const
     return (dist(globals->get_view_position_cart(), SGVec3d::fromGeod(pos))) <= visibility_meters;
 }
 
+unsigned FGAIManager::updateIntervalFor(const SGGeod& pos, double radiusM) const
+{
+    if (!_throttleEnabled || (radiusM <= 0.0) || (_throttleFullRateRadii <= 0.0)) {
+        return 1;
+    }
+
+    if (_environmentVisiblity && !isVisible(pos)) {
+        return _throttleMaxInterval;
+    }
+
+    const double distanceM = dist(globals->get_view_position_cart(), SGVec3d::fromGeod(pos));
+    const double interval = distanceM / (radiusM * _throttleFullRateRadii);
+    if (interval >= _throttleMaxInterval) {
+        return _throttleMaxInterval;
+    }
+
+    return std::max(1u, static_cast<unsigned>(interval));
+}
+
 int FGAIManager::getNumAiObjects() const
 {
     return static_cast<int>(ai_list.size());
@@ -458,6 +535,13 @@ void FGAIManager::fetchUserState(double dt)
     _userAircraft->update(dt);
 }
 
+void FGAIManager::fetchUpdateThrottleState()
+{
+    _throttleEnabled = _throttleEnabledNode->getBoolValue();
+    _throttleFullRateRadii = _throttleFullRateRadiiNode->getDoubleValue();
+    _throttleMaxInterval = static_cast<unsigned>(std::max(1, _throttleMaxIntervalNode->getIntValue()));
+}
+
 // only keep the results from the nearest thermal
 void FGAIManager::processThermal(double dt, FGAIThermal* thermal)
 {
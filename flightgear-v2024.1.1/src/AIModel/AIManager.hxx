@@ -16,6 +16,8 @@
 #include <simgear/structure/SGSharedPtr.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 
+#include "AIKinematics.hxx"
+
 class FGAIBase;
 class FGAIThermal;
 class FGAIAircraft;
@@ -67,6 +69,14 @@ public:
     FGAIBasePtr addObject(const SGPropertyNode* definition);
     bool isVisible(const SGGeod& pos) const;
 
+    /**
+     * @brief number of frames between two updates of the animations and
+     * sounds of a model at the given position. Grows with the distance
+     * from the viewer relative to the model radius (i.e. as the model gets
+     * smaller on screen), 1 if update throttling is disabled.
+     */
+    unsigned updateIntervalFor(const SGGeod& pos, double radiusM) const;
+
     /**
      * @brief given a reference to an /ai/models/<foo>[n] node, return the
      * corresponding AIObject implementation, or NULL.
@@ -148,6 +158,7 @@ private:
     double wind_from_north = 0.0;
 
     void fetchUserState(double dt);
+    void fetchUpdateThrottleState();
 
     // used by thermals
     double range_nearest = 0.0;
@@ -169,4 +180,16 @@ private:
     bool _radarEnabled = true,
          _radarDebugMode = false;
     double _radarRangeM = 0.0;
+
+    SGPropertyNode_ptr _throttleEnabledNode,
+        _throttleFullRateRadiiNode, _throttleMaxIntervalNode,
+        _skippedAnimationUpdatesNode, _skippedSoundUpdatesNode;
+    bool _throttleEnabled = false;
+    double _throttleFullRateRadii = 0.0;
+    unsigned _throttleMaxInterval = 1;
+
+    // motion of the AI aircraft, integrated for all of them at once
+    SGPropertyNode_ptr _batchKinematicsNode;
+    FGAIKinematics _kinematics;
+    std::vector<FGAIAircraft*> _batchedAircraft;
 };
@@ -33,6 +33,9 @@ public:
     void readFromScenario(SGPropertyNode* scFileNode) override;
     void bind() override;
 
+    // update() adds the radar contact check
+    bool isBatchable() const override { return false; }
+
     void setTACANChannelID(const std::string& id);
 
 private:
@@ -6,6 +6,7 @@
 #include <simgear/props/props.hxx>
 
 #include "AIAircraft.hxx"
+#include "AIKinematics.hxx"
 
 #include "performancedata.hxx"
 
@@ -108,34 +109,8 @@ double PerformanceData::actualSpeed(const FGAIAircraft* ac, double tgt_speed, do
     //    tgt_speed = _vTaxi;
     // bad idea for a take off roll :-)
 
-    double speed = ac->getSpeed();
-    double speed_diff = tgt_speed - speed;
-
-    if (speed_diff > 0.0) // need to accelerate
-    {
-        speed += _acceleration * dt;
-        if (speed > tgt_speed)
-            speed = tgt_speed;
-
-    } else if (speed_diff < 0.0) { // decelerate
-        if (ac->onGround()) {
-            // deceleration performance is better due to wheel brakes.
-            double brakePower = 0;
-            if (maxBrakes) {
-                brakePower = 2;
-            } else {
-                brakePower = 1;
-            }
-            speed -= brakePower * _brakeDeceleration * dt;
-        } else {
-            speed -= _deceleration * dt;
-        }
-
-        if (speed < tgt_speed)
-            speed = tgt_speed;
-    }
-
-    return speed;
+    return FGAIKinematics::speedStep(ac->getSpeed(), tgt_speed, dt, _acceleration, _deceleration,
+                                     _brakeDeceleration, ac->onGround(), maxBrakes);
 }
 
 double PerformanceData::decelerationOnGround() const
@@ -145,49 +120,12 @@ double PerformanceData::decelerationOnGround() const
 
 double PerformanceData::actualBankAngle(const FGAIAircraft* ac, double tgt_roll, double dt)
 {
-    // check maximum bank angle
-    if (fabs(tgt_roll) > _maxbank)
-        tgt_roll = _maxbank * tgt_roll / fabs(tgt_roll);
-
-    double roll = ac->getRoll();
-    double bank_diff = tgt_roll - roll;
-
-    if (fabs(bank_diff) > 0.2) {
-        if (bank_diff > 0.0) {
-            roll += _rollrate * dt;
-            if (roll > tgt_roll)
-                roll = tgt_roll;
-        } else if (bank_diff < 0.0) {
-            roll -= _rollrate * dt;
-
-            if (roll < tgt_roll)
-                roll = tgt_roll;
-        }
-        //while (roll > 180) roll -= 360;
-        //while (roll < 180) roll += 360;
-    }
-
-    return roll;
+    return FGAIKinematics::bankStep(ac->getRoll(), tgt_roll, dt, _maxbank, _rollrate);
 }
 
 double PerformanceData::actualPitch(const FGAIAircraft* ac, double tgt_pitch, double dt)
 {
-    double pitch = ac->getPitch();
-    double pdiff = tgt_pitch - pitch;
-
-    if (pdiff > 0.0) {                          // nose up
-        pitch += 0.005 * _climbRate * dt / 3.0; // TODO: avoid hardcoded 3 secs
-
-        if (pitch > tgt_pitch)
-            pitch = tgt_pitch;
-    } else if (pdiff < 0.0) { // nose down
-        pitch -= 0.002 * _descentRate * dt / 3.0;
-
-        if (pitch < tgt_pitch)
-            pitch = tgt_pitch;
-    }
-
-    return pitch;
+    return FGAIKinematics::pitchStep(ac->getPitch(), tgt_pitch, dt, _climbRate, _descentRate);
 }
 
 double PerformanceData::actualAltitude(const FGAIAircraft* ac, double tgt_altitude, double dt)
@@ -201,24 +139,7 @@ double PerformanceData::actualAltitude(const FGAIAircraft* ac, double tgt_altitu
 
 double PerformanceData::actualVerticalSpeed(const FGAIAircraft* ac, double tgt_vs, double dt)
 {
-    double vs = ac->getVerticalSpeedFPM();
-    double vs_diff = tgt_vs - vs;
-
-    if (fabs(vs_diff) > .001) {
-        if (vs_diff > 0.0) {
-            vs += _climbRate * dt / 3.0; // TODO: avoid hardcoded 3 secs to attain climb rate from level flight
-
-            if (vs > tgt_vs)
-                vs = tgt_vs;
-        } else if (vs_diff < 0.0) {
-            vs -= _descentRate * dt / 3.0;
-
-            if (vs < tgt_vs)
-                vs = tgt_vs;
-        }
-    }
-
-    return vs;
+    return FGAIKinematics::verticalSpeedStep(ac->getVerticalSpeedFPM(), tgt_vs, dt, _climbRate, _descentRate);
 }
 
 bool PerformanceData::gearExtensible(const FGAIAircraft* ac)
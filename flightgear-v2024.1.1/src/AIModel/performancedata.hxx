@@ -32,6 +32,7 @@ public:
     double descentRate() const { return _descentRate; };
     double vRotate() const { return _vRotate; };
     double maximumBankAngle() const { return _maxbank; };
+    double rollRate() const { return _rollrate; };
     double acceleration() const { return _acceleration; };
     double deceleration() const { return _deceleration; };
     double brakeDeceleration() const { return _brakeDeceleration; };
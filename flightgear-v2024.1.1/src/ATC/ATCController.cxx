@@ -402,11 +402,7 @@ void FGATCController::signOff(int id)
         return;
     }
     SG_LOG(SG_ATC, SG_DEBUG, i->getCallsign() << " (" << i->getId() << ") signing off from " << getName() << "(" << getFrequency() << ")");
-    int oldSize = activeTraffic.size();
-    activeTraffic.erase(i);
-    if ((oldSize - activeTraffic.size()) != 1) {
-        SG_LOG(SG_ATC, SG_WARN, i->getCallsign() << " not removed ");
-    }
+    eraseActiveTraffic(i);
 }
 
 bool FGATCController::hasInstruction(int id)
@@ -471,13 +467,14 @@ string FGATCController::genTransponderCode(const string& fltRules)
 
 void FGATCController::eraseDeadTraffic()
 {
-    auto it = std::remove_if(activeTraffic.begin(), activeTraffic.end(), [](const FGTrafficRecord& traffic) {
-        if (traffic.isDead()) {
-            SG_LOG(SG_ATC, SG_DEBUG, "Remove dead " << traffic.getId() << " " << traffic.isDead());
+    for (auto it = activeTraffic.begin(); it != activeTraffic.end();) {
+        auto next = std::next(it);
+        if (it->isDead()) {
+            SG_LOG(SG_ATC, SG_DEBUG, "Remove dead " << it->getId() << " " << it->isDead());
+            eraseActiveTraffic(it);
         }
-        return traffic.isDead();
-    });
-    activeTraffic.erase(it, activeTraffic.end());
+        it = next;
+    }
 }
 
 /*
@@ -487,8 +484,39 @@ void FGATCController::eraseDeadTraffic()
 */
 TrafficVectorIterator FGATCController::searchActiveTraffic(int id)
 {
-    return std::find_if(activeTraffic.begin(), activeTraffic.end(),
-                        [id](const FGTrafficRecord& rec) { return rec.getId() == id; });
+    auto it = trafficById.find(id);
+    return (it == trafficById.end()) ? activeTraffic.end() : it->second;
+}
+
+/*
+* Add a record to activeTraffic and its indexes
+* @param rec the record, with position and radius set
+* @param atFront insert before all other traffic instead of after it
+* @return the inserted item
+*/
+TrafficVectorIterator FGATCController::addActiveTraffic(const FGTrafficRecord& rec, bool atFront)
+{
+    TrafficVectorIterator i = activeTraffic.insert(atFront ? activeTraffic.begin() : activeTraffic.end(), rec);
+    trafficById[i->getId()] = i;
+    trafficIndex.insert(&(*i));
+    return i;
+}
+
+void FGATCController::eraseActiveTraffic(TrafficVectorIterator i)
+{
+    auto it = trafficById.find(i->getId());
+    if ((it != trafficById.end()) && (it->second == i)) {
+        trafficById.erase(it);
+    }
+    trafficIndex.remove(&(*i));
+    activeTraffic.erase(i);
+}
+
+void FGATCController::setTrafficPosition(TrafficVectorIterator i, double lat, double lon,
+                                         double heading, double speed, double alt)
+{
+    i->setPositionAndHeading(lat, lon, heading, speed, alt);
+    trafficIndex.update(&(*i));
 }
 
 void FGATCController::clearTrafficControllers()
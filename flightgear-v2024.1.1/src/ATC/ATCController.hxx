@@ -20,6 +20,8 @@
 #ifndef ATC_CONTROLLER_HXX
 #define ATC_CONTROLLER_HXX
 
+#include <unordered_map>
+
 #include <Airports/airports_fwd.hxx>
 
 #include <osg/Geode>
@@ -87,6 +89,10 @@ protected:
     bool available;
     time_t lastTransmission;
     TrafficVector activeTraffic;
+    // lookup of activeTraffic by id and by position, kept up to date by
+    // addActiveTraffic, eraseActiveTraffic and setTrafficPosition
+    std::unordered_map<int, TrafficVectorIterator> trafficById;
+    FGTrafficSpatialIndex trafficIndex;
 
     double dt_count;
     osg::Group* group;
@@ -97,6 +103,10 @@ protected:
     bool isUserAircraft(FGAIAircraft*);
     void clearTrafficControllers();
     TrafficVectorIterator searchActiveTraffic(int id);
+    TrafficVectorIterator addActiveTraffic(const FGTrafficRecord& rec, bool atFront = false);
+    void eraseActiveTraffic(TrafficVectorIterator i);
+    void setTrafficPosition(TrafficVectorIterator i, double lat, double lon,
+                            double heading, double speed, double alt);
     void eraseDeadTraffic();
     /**Returns the frequency to be used. */
     virtual int getFrequency() = 0;
@@ -161,6 +171,9 @@ public:
     TrafficVector &getActiveTraffic() {
         return activeTraffic;
     };
+    const FGTrafficSpatialIndex& getTrafficIndex() const {
+        return trafficIndex;
+    };
 
     double getDt() {
         return dt_count;
@@ -99,9 +99,9 @@ void FGApproachController::announcePosition(int id,
         rec.setCallsign(ref->getCallSign());
         rec.setAircraft(ref);
         rec.setPlannedArrivalTime(intendedRoute->getArrivalTime());
-        activeTraffic.push_back(rec);
+        addActiveTraffic(rec);
     } else {
-        i->setPositionAndHeading(lat, lon, heading, speed, alt);
+        setTrafficPosition(i, lat, lon, heading, speed, alt);
         i->setPlannedArrivalTime(intendedRoute->getArrivalTime());
     }
 }
@@ -120,7 +120,7 @@ void FGApproachController::updateAircraftInformation(int id, SGGeod geod,
         SG_LOG(SG_ATC, SG_ALERT,
                "FGApproachController updating aircraft without traffic record at " << SG_ORIGIN);
     } else {
-        i->setPositionAndHeading(geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
+        setTrafficPosition(i, geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
         current = i;
         if(current->getAircraft()) {
             //FIXME No call to aircraft! -> set instruction
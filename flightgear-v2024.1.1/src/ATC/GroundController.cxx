@@ -120,13 +120,13 @@ void FGGroundController::announcePosition(int id,
         rec.setAircraft(aircraft);
         // add to the front of the list of activeTraffic if the aircraft is already taxiing
         if (leg == 2) {
-            activeTraffic.push_front(rec);
+            addActiveTraffic(rec, true);
         } else {
-            activeTraffic.push_back(rec);
+            addActiveTraffic(rec);
         }
     } else {
         i->setPositionAndIntentions(currentPosition, intendedRoute);
-        i->setPositionAndHeading(lat, lon, heading, speed, alt);
+        setTrafficPosition(i, lat, lon, heading, speed, alt);
     }
 }
 
@@ -164,7 +164,7 @@ void FGGroundController::updateAircraftInformation(int id, SGGeod geod,
         return;
     }
 
-    i->setPositionAndHeading(geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
+    setTrafficPosition(i, geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
     TrafficVectorIterator current = i;
 
     setDt(getDt() + dt);
@@ -229,7 +229,7 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
         double speed, double alt)
 {
 
-    TrafficVectorIterator current, closest, closestOnNetwork;
+    FGTrafficRecord *current, *closest, *closestOnNetwork;
     // bool previousInstruction;
 	TrafficVectorIterator i = FGATCController::searchActiveTraffic(id);
     if (!activeTraffic.size()) {
@@ -238,8 +238,9 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
     if (i == activeTraffic.end() || (activeTraffic.size() == 0)) {
         SG_LOG(SG_GENERAL, SG_ALERT,
                "AI error: Trying to access non-existing aircraft in FGGroundNetwork::checkSpeedAdjustment at " << SG_ORIGIN);
+        return;
     }
-    current = i;
+    current = &(*i);
     //closest = current;
 
     // previousInstruction = current->getSpeedAdjustment();
@@ -253,8 +254,15 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
         closest = current;
         closestOnNetwork = current;
 
-        for (TrafficVectorIterator iter = activeTraffic.begin();
-                iter != activeTraffic.end(); ++iter) {
+        // Only traffic within twice the separation below can make us slow
+        // down, so there is no need to look at aircraft further away.
+        const double maxOtherRadius = std::max(trafficIndex.getMaxRadius(),
+                                               towerController->getTrafficIndex().getMaxRadius());
+        const double searchRange = 2 * ((1.1 * current->getRadius()) + (1.1 * maxOtherRadius));
+
+        nearbyTraffic.clear();
+        trafficIndex.query(curr, searchRange, nearbyTraffic);
+        for (FGTrafficRecord* iter : nearbyTraffic) {
             if (iter == current) {
                 continue;
             }
@@ -274,9 +282,9 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
 
         // Next check with the tower controller
         if (towerController->hasActiveTraffic()) {
-            for (TrafficVectorIterator iter =
-                        towerController->getActiveTraffic().begin();
-                    iter != towerController->getActiveTraffic().end(); ++iter) {
+            nearbyTraffic.clear();
+            towerController->getTrafficIndex().query(curr, searchRange, nearbyTraffic);
+            for (FGTrafficRecord* iter : nearbyTraffic) {
                 if( current->getId() == iter->getId()) {
                     continue;
                 }
@@ -359,7 +367,7 @@ void FGGroundController::checkSpeedAdjustment(int id, double lat,
         }
 
         if ((closest->getId() == closestOnNetwork->getId()) && (current->getPriority() < closest->getPriority()) && needBraking) {
-            swap(current, closest);
+            std::swap(current, closest);
         }
     }
 }
@@ -378,23 +386,16 @@ void FGGroundController::checkHoldPosition(int id, double lat,
 {
     FGGroundNetwork* network = parent->parent()->groundNetwork();
     TrafficVectorIterator current;
-    TrafficVectorIterator i = activeTraffic.begin();
-    if (activeTraffic.size()) {
-        //while ((i->getId() != id) && i != activeTraffic.end())
-        while (i != activeTraffic.end()) {
-            if (i->getId() == id) {
-                break;
-            }
-            i++;
-        }
-    } else {
+    if (activeTraffic.empty()) {
         return;
     }
+    TrafficVectorIterator i = FGATCController::searchActiveTraffic(id);
 
     time_t now = globals->get_time_params()->get_cur_time();
     if (i == activeTraffic.end() || (activeTraffic.size() == 0)) {
         SG_LOG(SG_GENERAL, SG_ALERT,
                "AI error: Trying to access non-existing aircraft in FGGroundNetwork::checkHoldPosition at " << SG_ORIGIN);
+        return;
     }
     current = i;
     if (current->getAircraft()->getTakeOffStatus() == AITakeOffStatus::QUEUED) {
@@ -527,22 +528,16 @@ bool FGGroundController::checkForCircularWaits(int id)
     SG_LOG(SG_ATC, SG_DEBUG, "Performing circular check for " << id);
     int target = 0;
     TrafficVectorIterator current, other;
-    TrafficVectorIterator i = activeTraffic.begin();
     int trafficSize = activeTraffic.size();
-    if (trafficSize) {
-        while (i != activeTraffic.end()) {
-            if (i->getId() == id) {
-                break;
-            }
-            i++;
-        }
-    } else {
+    if (!trafficSize) {
         return false;
     }
+    TrafficVectorIterator i = FGATCController::searchActiveTraffic(id);
 
     if (i == activeTraffic.end()) {
         SG_LOG(SG_GENERAL, SG_ALERT,
                "AI error: Trying to access non-existing aircraft in FGGroundNetwork::checkForCircularWaits at " << SG_ORIGIN);
+        return false;
     }
 
     current = i;
@@ -557,17 +552,7 @@ bool FGGroundController::checkForCircularWaits(int id)
 
     while ((target > 0) && (target != id) && counter++ < trafficSize) {
         //printed = true;
-        TrafficVectorIterator iter = activeTraffic.begin();
-        if (trafficSize) {
-            while (iter != activeTraffic.end()) {
-                if (iter->getId() == target) {
-                    break;
-                }
-                ++iter;
-            }
-        } else {
-            return false;
-        }
+        TrafficVectorIterator iter = FGATCController::searchActiveTraffic(target);
 
         if (iter == activeTraffic.end()) {
             SG_LOG(SG_ATC, SG_DEBUG, "[Waiting for traffic at Runway: DONE] ");
@@ -817,6 +802,21 @@ void FGGroundController::update(double dt)
     TrafficVector& startupTraffic(parent->getStartupController()->getActiveTraffic());
     TrafficVectorIterator i;
 
+    // Collect the reverse of every segment in use once, instead of for
+    // every aircraft waiting for pushback
+    occupiedOppositeSegments.clear();
+    if (!startupTraffic.empty()) {
+        for (i = activeTraffic.begin(); i != activeTraffic.end(); ++i) {
+            int pos = i->getCurrentPosition();
+            if (pos > 0) {
+                FGTaxiSegment *seg = network->findOppositeSegment(pos-1);
+                if (seg) {
+                    occupiedOppositeSegments.insert(seg->getIndex());
+                }
+            }
+        }
+    }
+
     //sort(activeTraffic.begin(), activeTraffic.end(), compare_trafficrecords);
     // Handle traffic that is under ground control first; this way we'll prevent clutter at the gate areas.
     // Don't allow an aircraft to pushback when a taxiing aircraft is currently using part of the intended route.
@@ -864,19 +864,10 @@ void FGGroundController::updateStartupTraffic(TrafficVectorIterator i,
 
     // Check for all active aircraft whether it's current pos segment is
     // an opposite of one of the departing aircraft's intentions
-    for (TrafficVectorIterator j = activeTraffic.begin(); j != activeTraffic.end(); j++) {
-        int pos = j->getCurrentPosition();
-        if (pos > 0) {
-            FGTaxiSegment *seg = network->findOppositeSegment(pos-1);
-            if (seg) {
-                int posReverse = seg->getIndex();
-                for (intVecIterator k = i->getIntentions().begin(); k != i->getIntentions().end(); k++) {
-                    if ((*k) == posReverse) {
-                        i->denyPushBack();
-                        network->findSegment(posReverse)->block(i->getId(), now, now);
-                    }
-                }
-            }
+    for (intVecIterator k = i->getIntentions().begin(); k != i->getIntentions().end(); k++) {
+        if (occupiedOppositeSegments.count(*k)) {
+            i->denyPushBack();
+            network->findSegment(*k)->block(i->getId(), now, now);
         }
     }
     // if the current aircraft is still allowed to pushback, we can start reserving a route for if by blocking all the entry taxiways.
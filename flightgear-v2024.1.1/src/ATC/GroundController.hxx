@@ -26,6 +26,8 @@
 #include <simgear/compiler.h>
 
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include <ATC/trafficcontrol.hxx>
 #include <ATC/TowerController.hxx>
@@ -46,12 +48,18 @@ private:
     int version;
 
     FGTowerController *towerController;
+    // reverse direction of the segments taxiing aircraft are on, refreshed
+    // every update for the pushback checks of the startup traffic
+    std::unordered_set<int> occupiedOppositeSegments;
+    std::vector<FGTrafficRecord*> nearbyTraffic;
     /**Returns the frequency to be used. */
     int getFrequency();
 
-
+protected:
     void checkSpeedAdjustment(int id, double lat, double lon,
                               double heading, double speed, double alt);
+
+private:
     void checkHoldPosition(int id, double lat, double lon,
                            double heading, double speed, double alt);
 
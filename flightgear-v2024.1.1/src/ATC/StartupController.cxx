@@ -97,10 +97,10 @@ void FGStartupController::announcePosition(int id,
         rec.setCallsign(ref->getCallSign());
         rec.setAircraft(ref);
         rec.setHoldPosition(true);
-        activeTraffic.push_back(rec);
+        addActiveTraffic(rec);
     } else {
         i->setPositionAndIntentions(currentPosition, intendedRoute);
-        i->setPositionAndHeading(lat, lon, heading, speed, alt);
+        setTrafficPosition(i, lat, lon, heading, speed, alt);
 
     }
 }
@@ -117,7 +117,7 @@ void FGStartupController::updateAircraftInformation(int id, SGGeod geod, double
                "AI error: updating aircraft without traffic record at " << SG_ORIGIN);
         return;
     } else {
-        i->setPositionAndHeading(geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
+        setTrafficPosition(i, geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
         current = i;
     }
     setDt(getDt() + dt);
@@ -99,7 +99,7 @@ void FGTowerController::announcePosition(int id,
         rec.setCallsign(ref->getCallSign());
         rec.setRadius(radius);
         rec.setAircraft(ref);
-        activeTraffic.push_back(rec);
+        addActiveTraffic(rec);
         // Don't just schedule the aircraft for the tower controller, also assign if to the correct active runway.
         ActiveRunwayVecIterator rwy = activeRunways.begin();
         if (! activeRunways.empty()) {
@@ -127,7 +127,7 @@ void FGTowerController::announcePosition(int id,
 
         SG_LOG(SG_ATC, SG_DEBUG, ref->getTrafficRef()->getCallSign() << " You are number " << rwy->getdepartureQueueSize() << " for takeoff from " << rwy->getRunwayName());
     } else {
-        i->setPositionAndHeading(lat, lon, heading, speed, alt);
+        setTrafficPosition(i, lat, lon, heading, speed, alt);
     }
 }
 
@@ -150,7 +150,7 @@ void FGTowerController::updateAircraftInformation(int id, SGGeod geod,
 
     // Update the position of the current aircraft
     FGTrafficRecord& current = *i;
-    current.setPositionAndHeading(geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
+    setTrafficPosition(i, geod.getLatitudeDeg(), geod.getLongitudeDeg(), heading, speed, alt);
 
     // see if we already have a clearance record for the currently active runway
     // NOTE: dd. 2011-08-07: Because the active runway has been constructed in the announcePosition function, we may safely assume that is
@@ -23,6 +23,7 @@
 #include <config.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <random>
 
@@ -556,6 +557,103 @@ bool FGTrafficRecord::pushBackAllowed() const
 
 
 
+/***************************************************************************
+ * FGTrafficSpatialIndex
+ *
+ **************************************************************************/
+
+// Larger than the separation checked between two airliners, so a query
+// mostly touches the cell of the position and its neighbours.
+static const double TRAFFIC_GRID_CELL_SIZE_M = 250.0;
+
+size_t FGTrafficSpatialIndex::CellHash::operator()(const Cell& c) const
+{
+    size_t h = std::hash<int>()(c.x);
+    h = h * 31 + std::hash<int>()(c.y);
+    return h * 31 + std::hash<int>()(c.z);
+}
+
+FGTrafficSpatialIndex::Cell FGTrafficSpatialIndex::cellFor(const SGVec3d& cart)
+{
+    return Cell{static_cast<int>(std::floor(cart.x() / TRAFFIC_GRID_CELL_SIZE_M)),
+                static_cast<int>(std::floor(cart.y() / TRAFFIC_GRID_CELL_SIZE_M)),
+                static_cast<int>(std::floor(cart.z() / TRAFFIC_GRID_CELL_SIZE_M))};
+}
+
+void FGTrafficSpatialIndex::insert(FGTrafficRecord* rec)
+{
+    const Cell cell = cellFor(SGVec3d::fromGeod(rec->getPos()));
+    cells[cell].push_back(rec);
+    cellOf[rec] = cell;
+    maxRadius = std::max(maxRadius, rec->getRadius());
+}
+
+void FGTrafficSpatialIndex::update(FGTrafficRecord* rec)
+{
+    auto it = cellOf.find(rec);
+    if (it == cellOf.end()) {
+        insert(rec);
+        return;
+    }
+
+    const Cell cell = cellFor(SGVec3d::fromGeod(rec->getPos()));
+    if (cell == it->second) {
+        return;
+    }
+
+    remove(rec);
+    insert(rec);
+}
+
+void FGTrafficSpatialIndex::remove(FGTrafficRecord* rec)
+{
+    auto it = cellOf.find(rec);
+    if (it == cellOf.end()) {
+        return;
+    }
+
+    auto cellIt = cells.find(it->second);
+    if (cellIt != cells.end()) {
+        auto& recs = cellIt->second;
+        recs.erase(std::remove(recs.begin(), recs.end(), rec), recs.end());
+        if (recs.empty()) {
+            cells.erase(cellIt);
+        }
+    }
+    cellOf.erase(it);
+}
+
+void FGTrafficSpatialIndex::clear()
+{
+    cells.clear();
+    cellOf.clear();
+    maxRadius = 0.0;
+}
+
+void FGTrafficSpatialIndex::query(const SGGeod& pos, double range,
+                                  std::vector<FGTrafficRecord*>& result) const
+{
+    if (cells.empty()) {
+        return;
+    }
+
+    const SGVec3d cart = SGVec3d::fromGeod(pos);
+    const Cell lo = cellFor(cart - SGVec3d(range, range, range));
+    const Cell hi = cellFor(cart + SGVec3d(range, range, range));
+    for (int x = lo.x; x <= hi.x; ++x) {
+        for (int y = lo.y; y <= hi.y; ++y) {
+            for (int z = lo.z; z <= hi.z; ++z) {
+                auto it = cells.find(Cell{x, y, z});
+                if (it != cells.end()) {
+                    result.insert(result.end(), it->second.begin(), it->second.end());
+                }
+            }
+        }
+    }
+}
+
+
+
 /***************************************************************************
  * FGATCInstruction
  *
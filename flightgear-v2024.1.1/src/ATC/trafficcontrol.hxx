@@ -28,6 +28,9 @@
 #include <osg/MatrixTransform>
 #include <osg/Shape>
 
+#include <unordered_map>
+#include <vector>
+
 #include <simgear/compiler.h>
 // There is probably a better include than sg_geodesy to get the SG_NM_TO_METER...
 #include <simgear/math/sg_geodesy.hxx>
@@ -345,6 +348,49 @@ public:
     int getPriority() const { return priority; };
 };
 
+/***********************************************************************
+ * Uniform grid over the (cartesian) positions of traffic records, to find
+ * the aircraft near a position without comparing against all of them.
+ * Records are referenced, not owned: they live in the TrafficVector of a
+ * controller, which never moves its elements.
+ **********************************************************************/
+class FGTrafficSpatialIndex
+{
+public:
+    void insert(FGTrafficRecord* rec);
+    /** File a record again after its position changed. */
+    void update(FGTrafficRecord* rec);
+    void remove(FGTrafficRecord* rec);
+    void clear();
+
+    /**
+     * Append the records which may be within range metres of pos to
+     * result. This is a superset, the caller still checks the distance.
+     */
+    void query(const SGGeod& pos, double range, std::vector<FGTrafficRecord*>& result) const;
+
+    /** Largest radius of the records inserted since the last clear(). */
+    double getMaxRadius() const { return maxRadius; };
+    size_t size() const { return cellOf.size(); };
+
+private:
+    struct Cell {
+        int x, y, z;
+        bool operator==(const Cell& other) const {
+            return (x == other.x) && (y == other.y) && (z == other.z);
+        }
+    };
+    struct CellHash {
+        size_t operator()(const Cell& c) const;
+    };
+
+    static Cell cellFor(const SGVec3d& cart);
+
+    std::unordered_map<Cell, std::vector<FGTrafficRecord*>, CellHash> cells;
+    std::unordered_map<const FGTrafficRecord*, Cell> cellOf;
+    double maxRadius = 0.0;
+};
+
 /***********************************************************************
  * Active runway, a utility class to keep track of which aircraft has
  * clearance for a given runway.
@@ -1060,6 +1060,13 @@ FGGroundNetwork *FGAirport::groundNetwork() const
     return _groundNetwork.get();
 }
 
+void FGAirport::setGroundNetwork(std::unique_ptr<FGGroundNetwork> net) const
+{
+    if (!_groundNetwork.get()) {
+        _groundNetwork = std::move(net);
+    }
+}
+
 flightgear::Transition* FGAirport::selectSIDByEnrouteTransition(FGPositioned* enroute) const
 {
     loadProcedures();
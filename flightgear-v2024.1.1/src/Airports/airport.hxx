@@ -94,6 +94,17 @@ public:
 
     FGGroundNetwork* groundNetwork() const;
 
+    /// true once groundNetwork() or setGroundNetwork() provided one
+    bool hasGroundNetwork() const
+    { return _groundNetwork.get() != nullptr; }
+
+    /**
+     * Use a ground network loaded and initialised elsewhere, such as by
+     * the AI flight plan builder's worker thread. Ignored if there is one
+     * already.
+     */
+    void setGroundNetwork(std::unique_ptr<FGGroundNetwork> net) const;
+
     unsigned int numRunways() const;
     unsigned int numHelipads() const;
     FGRunwayRef getRunwayByIndex(unsigned int aIndex) const;
@@ -54,16 +54,8 @@ void XMLLoader::load(FGGroundNetwork* net)
   SG_LOG(SG_NAVAID, SG_DEBUG, "reading groundnet data from " << path);
   SGTimeStamp t;
   t.stamp();
-  try {
-      FGGroundNetXMLLoader visitor(net);
-      readXML(path, visitor);
-
-      if (visitor.hasErrors() && fgGetBool("/sim/terrasync/enabled")) {
-          flightgear::updateSentryTag("ground-net", net->airport()->ident());
-          flightgear::sentryReportException("Ground-net load error", path.utf8Str());
-      }
-  } catch (sg_exception& e) {
-    SG_LOG(SG_NAVAID, SG_DEV_WARN, "parsing groundnet XML failed:" << e.getFormattedMessage());
+  if (!parseGroundnet(net, path)) {
+      reportGroundnetErrors(net, path);
   }
 
   SG_LOG(SG_NAVAID, SG_DEBUG, "parsing groundnet XML took " << t.elapsedMSec());
@@ -84,18 +76,30 @@ void XMLLoader::loadFromStream(FGGroundNetwork* net, std::istream& inData)
 }
 
 void XMLLoader::loadFromPath(FGGroundNetwork* net, const SGPath& path)
+{
+  if (!parseGroundnet(net, path)) {
+      reportGroundnetErrors(net, path);
+  }
+}
+
+bool XMLLoader::parseGroundnet(FGGroundNetwork* net, const SGPath& path)
 {
   try {
       FGGroundNetXMLLoader visitor(net);
       readXML(path, visitor);
-
-      if (visitor.hasErrors() && fgGetBool("/sim/terrasync/enabled")) {
-          flightgear::updateSentryTag("ground-net", net->airport()->ident());
-          flightgear::sentryReportException("Ground-net load error", path.utf8Str());
-      }
+      return !visitor.hasErrors();
   } catch (sg_exception& e) {
     SG_LOG(SG_NAVAID, SG_DEV_WARN, "parsing groundnet XML failed:" << e.getFormattedMessage());
   }
+  return true; // unreadable files are only logged
+}
+
+void XMLLoader::reportGroundnetErrors(FGGroundNetwork* net, const SGPath& path)
+{
+  if (fgGetBool("/sim/terrasync/enabled")) {
+      flightgear::updateSentryTag("ground-net", net->airport()->ident());
+      flightgear::sentryReportException("Ground-net load error", path.utf8Str());
+  }
 }
 
 void XMLLoader::load(FGRunwayPreference* p) {
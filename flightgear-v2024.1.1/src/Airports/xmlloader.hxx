@@ -33,6 +33,14 @@ public:
   static void loadFromStream(FGGroundNetwork* net, std::istream& inData);
   static void loadFromPath(FGGroundNetwork* net, const SGPath& path);
 
+  /**
+   * Parse the ground network at path into net, without reporting errors
+   * anywhere but the log, so it can run on a worker thread. Returns false
+   * if the data had errors, see reportGroundnetErrors().
+   */
+  static bool parseGroundnet(FGGroundNetwork* net, const SGPath& path);
+  static void reportGroundnetErrors(FGGroundNetwork* net, const SGPath& path);
+
   /**
    * Search the scenery for a file name of the form:
    *   I/C/A/ICAO.filename.xml
@@ -670,13 +670,6 @@ NavDisplay::update (double delta_time_sec)
         _pos = globals->get_aircraft_position();
     }
     
-    // invalidate the cache of positioned items, if we travelled more than 1nm
-    if (_cachedItemsValid) {
-        SGVec3d cartNow(SGVec3d::fromGeod(_pos));
-        double movedNm = dist(_cachedPos, cartNow) * SG_METER_TO_NM;
-        _cachedItemsValid = (movedNm < 1.0);
-    }
-    
   _vertices->clear();
   _lineVertices->clear();
   _lineColors->clear();
@@ -965,28 +958,44 @@ private:
 
 void NavDisplay::findItems()
 {
-    if (!_cachedItemsValid) {
-        Filter filt(this);
-        filt.minRunwayLengthFt = fgGetDouble("/sim/navdb/min-runway-length-ft", 2000);
-        bool wasTimeLimited;
-        _itemsInRange = FGPositioned::findClosestNPartial(_pos, _maxSymbols, _rangeNm,
-                                                          &filt, wasTimeLimited);
+    // the cursor only loads the items around us when we move, but it
+    // does not notice when the rules or the item states (route, tuned
+    // stations, departure and destination) change which items are shown
+    if (!_cachedItemsValid || positionedStatesChanged()) {
+        _itemsInRange.reset();
         _cachedItemsValid = true;
-        _cachedPos = SGVec3d::fromGeod(_pos);
-        
-        if (wasTimeLimited) {
-            // re-query next frame, to load incrementally
-            _cachedItemsValid = false;
-        }
     }
-    
-  // sort by distance from pos, so symbol limits are accurate
-    FGPositioned::sortByRange(_itemsInRange, _pos);
-    for (FGPositioned* pos : _itemsInRange) {
+
+    Filter filt(this);
+    filt.minRunwayLengthFt = fgGetDouble("/sim/navdb/min-runway-length-ft", 2000);
+    // results are sorted by distance from pos, so symbol limits are accurate;
+    // if loading was time limited, the next frame continues
+    _itemsInRange.update(_pos, _maxSymbols, _rangeNm, &filt);
+    for (FGPositioned* pos : _itemsInRange.results()) {
         foundPositionedItem(pos);
     }
 }
 
+bool NavDisplay::positionedStatesChanged()
+{
+    // everything computePositionedState() looks at
+    std::vector<FGPositioned*> inputs(_routeSources.begin(), _routeSources.end());
+    inputs.push_back(_nav1Station);
+    inputs.push_back(_nav2Station);
+    flightgear::FlightPlan* fp = _route->flightPlan();
+    inputs.push_back(fp->departureAirport());
+    inputs.push_back(fp->destinationAirport());
+    inputs.push_back(fp->departureRunway());
+    inputs.push_back(fp->destinationRunway());
+
+    if (inputs == _positionedStateInputs) {
+        return false;
+    }
+
+    _positionedStateInputs.swap(inputs);
+    return true;
+}
+
 void NavDisplay::processRoute()
 {
     _routeSources.clear();
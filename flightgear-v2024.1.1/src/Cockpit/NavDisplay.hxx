@@ -37,6 +37,7 @@
 #include <memory>
 
 #include <Navaids/positioned.hxx>
+#include <Navaids/PositionedCursor.hxx>
 
 class FGODGauge;
 class FGRouteMgr;
@@ -115,6 +116,7 @@ private:
     void limitDisplayedSymbols();
 
     void findItems();
+    bool positionedStatesChanged();
     void isPositionedShownInner(FGPositioned* pos, SymbolRuleVector& rules);
     void foundPositionedItem(FGPositioned* pos);
     void computePositionedPropsAndHeading(FGPositioned* pos, SGPropertyNode* nd, double& heading);
@@ -195,8 +197,8 @@ private:
     std::set<FGPositioned*> _routeSources;
 
     bool _cachedItemsValid;
-    SGVec3d _cachedPos;
-    FGPositionedList _itemsInRange;
+    flightgear::PositionedCursor _itemsInRange;
+    std::vector<FGPositioned*> _positionedStateInputs;
     SGPropertyNode_ptr _excessDataNode;
     int _maxSymbols;
     SGPropertyNode_ptr _customSymbols;
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileName: ExternalShm.cxx
+ * SPDX-FileComment: a shared memory interface to an external flight dynamics model
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <simgear/debug/logstream.hxx>
+
+#include <Main/fg_props.hxx>
+#include <Network/native_structs.hxx>
+
+#include "ExternalShm.hxx"
+
+FGExternalShm::FGExternalShm(double dt, const std::string& name, int waitMSec) :
+    _channel(name),
+    _waitMSec(waitMSec)
+{
+    if (!_channel.open(SG_IO_BI)) {
+        SG_LOG(SG_FLIGHT, SG_ALERT, "Error opening shared memory FDM channel " << name);
+    }
+}
+
+FGExternalShm::~FGExternalShm()
+{
+    _channel.close();
+}
+
+void FGExternalShm::init()
+{
+    // Explicitly call the superclass's
+    // init method first.
+    common_init();
+
+    SG_LOG(SG_FLIGHT, SG_INFO, "Shared memory FDM " << _channel.get_name()
+           << (_channel.hasPeer() ? " connected" : " waiting for the FDM process"));
+}
+
+// Run an iteration of the EOM.
+void FGExternalShm::update(double dt)
+{
+    if (is_suspended() || !_channel.isvalid()) {
+        return;
+    }
+
+    if (!_channel.hasPeer()) {
+        if (!_warnedNoPeer) {
+            SG_LOG(SG_FLIGHT, SG_WARN, "No FDM process attached to shared memory " << _channel.get_name());
+            _warnedNoPeer = true;
+        }
+        return;
+    }
+    _warnedNoPeer = false;
+
+    // Send control positions to the FDM
+    FGProps2Ctrls<FGNetCtrls>(globals->get_props(), &_ctrls, true, true);
+    if (_channel.write(reinterpret_cast<const char*>(&_ctrls), sizeof(_ctrls)) != sizeof(_ctrls)) {
+        SG_LOG(SG_FLIGHT, SG_DEBUG, "Error writing control data.");
+    }
+
+    // wait for the answer to keep in step, then apply the latest state
+    if (_waitMSec > 0) {
+        _channel.waitForData(_waitMSec);
+    }
+    while (_channel.read(reinterpret_cast<char*>(&_fdm), sizeof(_fdm)) == sizeof(_fdm)) {
+        FGFDM2Props<FGNetFDM>(globals->get_props(), &_fdm);
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileName: ExternalShm.hxx
+ * SPDX-FileComment: a shared memory interface to an external flight dynamics model
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <string>
+
+#include <simgear/io/sg_shm.hxx>
+
+#include <FDM/flight.hxx>
+#include <Network/net_ctrls.hxx>
+#include <Network/net_fdm.hxx>
+
+/**
+ * Same exchange as FGExternalNet - FGNetCtrls out, FGNetFDM in, in
+ * network byte order - through an SGSharedMemory segment, for an FDM
+ * process on the same host. Selected with --fdm=shm,name[,wait-msec]:
+ * with a wait, each update blocks up to that long for the FDM answer
+ * to the controls just sent, keeping both in lock step.
+ */
+class FGExternalShm : public FGInterface
+{
+public:
+    FGExternalShm(double dt, const std::string& name, int waitMSec);
+    ~FGExternalShm();
+
+    // Subsystem API.
+    void init() override;
+    void update(double dt) override;
+
+    // Subsystem identification.
+    static const char* staticSubsystemClassId() { return "shm"; }
+
+private:
+    SGSharedMemory _channel;
+    int _waitMSec;
+    bool _warnedNoPeer = false;
+
+    FGNetCtrls _ctrls;
+    FGNetFDM _fdm;
+};
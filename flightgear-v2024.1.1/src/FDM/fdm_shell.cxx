@@ -26,6 +26,7 @@
 
 #include <cassert>
 #include <simgear/structure/exception.hxx>
+#include <simgear/misc/strutils.hxx>
 #include <simgear/props/props_io.hxx>
 
 #include <FDM/fdm_shell.hxx>
@@ -47,6 +48,7 @@
 #endif
 #include <FDM/ExternalNet/ExternalNet.hxx>
 #include <FDM/ExternalPipe/ExternalPipe.hxx>
+#include <FDM/ExternalShm/ExternalShm.hxx>
 
 #ifdef ENABLE_JSBSIM
 #include <FDM/JSBSim/JSBSim.hxx>
@@ -355,6 +357,18 @@ void FDMShell::createImplementation()
     // protocol (last option)
     pipe_protocol = pipe_options.substr(begin);
     _impl = new FGExternalPipe( dt, pipe_path, pipe_protocol );
+  } else if ( model.find("shm") == 0 ) {
+    // shm,name[,wait-msec]
+    string_list shm_options = simgear::strutils::split( model, "," );
+    string shm_name = "flightgear-fdm";
+    int shm_wait = 0;
+    if ( shm_options.size() > 1 ) {
+      shm_name = simgear::strutils::strip( shm_options[1] );
+    }
+    if ( shm_options.size() > 2 ) {
+      shm_wait = atoi( shm_options[2].c_str() );
+    }
+    _impl = new FGExternalShm( dt, shm_name, shm_wait );
   } else if ( model == "null" ) {
     _impl = new FGNullFDM( dt );
   }
@@ -22,6 +22,7 @@
 #include <simgear/props/props.hxx>
 #include <simgear/props/props_io.hxx>
 #include <simgear/sg_inlines.h>
+#include <simgear/structure/SGTraceRecorder.hxx>
 #include <simgear/structure/commands.hxx>
 #include <simgear/structure/event_mgr.hxx>
 #include <simgear/structure/exception.hxx>
@@ -1084,6 +1085,59 @@ do_profiler_stop(const SGPropertyNode *arg, SGPropertyNode *root)
 #endif
 }
 
+/**
+ * Built-in commands: start and stop the trace recorder, as the property
+ * /sim/performance-monitor/trace does.
+ */
+static bool
+do_trace_start(const SGPropertyNode *arg, SGPropertyNode *root)
+{
+    fgSetBool("/sim/performance-monitor/trace", true);
+    simgear::TraceRecorder::setEnabled(true);
+    return true;
+}
+
+static bool
+do_trace_stop(const SGPropertyNode *arg, SGPropertyNode *root)
+{
+    fgSetBool("/sim/performance-monitor/trace", false);
+    simgear::TraceRecorder::setEnabled(false);
+    return true;
+}
+
+/**
+ * Built-in command: write the spans recorded by the trace recorder, for
+ * chrome://tracing or Perfetto.
+ *
+ * file (optional): the file to write. Defaults to "fgfs-trace.json".
+ * clear (optional): forget the written spans. Defaults to false.
+ */
+static bool
+do_trace_dump(const SGPropertyNode *arg, SGPropertyNode *root)
+{
+    SGPath file(arg->getStringValue("file", "fgfs-trace.json"));
+    if (file.extension() != "json")
+        file.concat(".json");
+
+    const SGPath validated_path = SGPath(file).validate(true);
+    if (validated_path.isNull()) {
+        SG_LOG(SG_IO, SG_ALERT, "trace-dump: writing '" << file << "' denied "
+                "(unauthorized access)");
+        return false;
+    }
+
+    if (!simgear::TraceRecorder::writeChromeTrace(validated_path)) {
+        SG_LOG(SG_IO, SG_ALERT, "Cannot write trace to " << file);
+        return false;
+    }
+
+    if (arg->getBoolValue("clear", false)) {
+        simgear::TraceRecorder::clear();
+    }
+    SG_LOG(SG_IO, SG_INFO, "Wrote trace to " << file);
+    return true;
+}
+
 static bool do_reload_nasal_module(const SGPropertyNode* arg, SGPropertyNode*)
 {
     auto nasalSys = globals->get_subsystem<FGNasalSys>();
@@ -1154,6 +1208,10 @@ static struct {
     {"profiler-start", do_profiler_start},
     {"profiler-stop", do_profiler_stop},
 
+    {"trace-start", do_trace_start},
+    {"trace-stop", do_trace_stop},
+    {"trace-dump", do_trace_dump},
+
     {"video-start", do_video_start},
     {"video-stop", do_video_stop},
 
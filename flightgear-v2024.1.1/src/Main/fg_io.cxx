@@ -26,19 +26,24 @@
 
 #include <cstdlib>             // atoi()
 
-#include <string>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iochannel.hxx>
 #include <simgear/io/sg_file.hxx>
 #include <simgear/io/sg_serial.hxx>
+#include <simgear/io/sg_shm.hxx>
 #include <simgear/io/sg_socket.hxx>
 #include <simgear/io/sg_socket_udp.hxx>
 #include <simgear/math/sg_types.hxx>
 #include <simgear/timing/timestamp.hxx>
 #include <simgear/misc/strutils.hxx>
 #include <simgear/structure/commands.hxx>
+#include <simgear/threads/SGThread.hxx>
 
 #include <Network/ATC-Main.hxx>
 #include <Network/AV400.hxx>
@@ -246,11 +251,11 @@ FGIO::parse_port_config( const string_list& tokens, bool& o_ok )
 #if FG_HAVE_DDS
         SG_LOG( SG_IO, SG_ALERT, "Too few arguments for network protocol. At least 3 arguments required. " <<
                 "Usage: --" << protocol <<
-                "=(file|socket|serial|dds), (in|out|bi|broadcast), hertz");
+                "=(file|socket|serial|shm|dds), (in|out|bi|broadcast), hertz");
 #else
         SG_LOG( SG_IO, SG_ALERT, "Too few arguments for network protocol. At least 3 arguments required. " <<
                 "Usage: --" << protocol <<
-                "=(file|socket|serial), (in|out|bi|broadcast), hertz");
+                "=(file|socket|serial|shm), (in|out|bi|broadcast), hertz");
 #endif
         delete io;
         return NULL;
@@ -353,6 +358,21 @@ FGIO::parse_port_config( const string_list& tokens, bool& o_ok )
 	} else {
              io->set_io_channel( new SGSocket( hostname, port, style ) );
         }
+    } else if ( medium == "shm" ) {
+        if ( tokens.size() < 5) {
+            SG_LOG( SG_IO, SG_ALERT, "Too few arguments for shared memory I/O. " <<
+                    "Usage --" << protocol << "=shm, (in|out|bi), hertz, name (,ring-size-kb)");
+            delete io;
+            return NULL;
+        }
+        string shm_name = tokens[4];
+        size_t ring_size = SGSharedMemory::DEFAULT_RING_SIZE;
+        if (tokens.size() >= 6) {
+            ring_size = static_cast<size_t>(atoi(tokens[5].c_str())) * 1024;
+        }
+
+        SG_LOG( SG_IO, SG_INFO, "  shared memory name = " << shm_name );
+        io->set_io_channel( new SGSharedMemory( shm_name, ring_size ) );
     }
 #if FG_HAVE_DDS
     else if ( medium == "dds")  {
@@ -370,6 +390,95 @@ FGIO::parse_port_config( const string_list& tokens, bool& o_ok )
 }
 
 
+/**
+ * Runs the channels which can_thread() at their own rate, outside the main
+ * loop, so that the timing of their output does not depend on the frame
+ * rate. The main loop exchanges property values or messages with them in
+ * sync().
+ */
+class FGIOThread : public SGThread
+{
+public:
+    ~FGIOThread()
+    {
+        stop();
+        join();
+    }
+
+    void add(FGProtocol* p)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _channels.push_back({p, Clock::now()});
+        _wake.notify_one();
+    }
+
+    void remove(FGProtocol* p)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _channels.erase(std::remove_if(_channels.begin(), _channels.end(),
+                                       [p](const Channel& c) { return c.protocol == p; }),
+                        _channels.end());
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _wake.notify_one();
+    }
+
+    /// held while channels are processed, to change their configuration
+    std::mutex& mutex() { return _mutex; }
+
+protected:
+    void run() override
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_stop) {
+            const auto now = Clock::now();
+            auto next = now + std::chrono::milliseconds(100);
+
+            for (auto& c : _channels) {
+                if (c.due <= now) {
+                    if (c.protocol->is_enabled()) {
+                        c.protocol->process_io();
+                    }
+
+                    const double hz = c.protocol->get_hz();
+                    const auto period = std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>((hz > 0.0) ? 1.0 / hz : 0.001));
+                    c.due += period;
+                    // after a stall, skip the missed messages rather than bursting them
+                    if (c.due <= now) {
+                        c.due = now + period;
+                    }
+                }
+                next = std::min(next, c.due);
+            }
+
+            _wake.wait_until(lock, next);
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Channel {
+        FGProtocol* protocol;
+        Clock::time_point due;
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::vector<Channel> _channels;
+    bool _stop = false;
+};
+
+
+FGIO::FGIO() = default;
+
+FGIO::~FGIO() = default;
+
 // step through the port config streams (from fgOPTIONS) and setup
 // serial port channels for each
 void
@@ -380,6 +489,12 @@ FGIO::init()
 
     _realDeltaTime = fgGetNode("/sim/time/delta-realtime-sec");
 
+    if (fgGetBool("/sim/io/threaded", false)) {
+        SG_LOG(SG_IO, SG_INFO, "I/O channels run in their own thread where supported");
+        _ioThread.reset(new FGIOThread);
+        _ioThread->start();
+    }
+
     // we could almost do this in a single step except pushing a valid
     // port onto the port list copies the structure and destroys the
     // original, which closes the port and frees up the fd ... doh!!!
@@ -426,6 +541,9 @@ FGProtocol* FGIO::add_channel(const string& config, bool& o_ok)
     }
 
     io_channels.push_back( p );
+    if (_ioThread && p->can_thread()) {
+        _ioThread->add(p);
+    }
     return p;
 }
 
@@ -434,6 +552,11 @@ FGIO::reinit()
 {
     SG_LOG(SG_IO, SG_INFO, "FGIO::reinit()");
 
+    std::unique_lock<std::mutex> lock;
+    if (_ioThread) {
+        lock = std::unique_lock<std::mutex>(_ioThread->mutex());
+    }
+
     std::for_each(io_channels.begin(), io_channels.end(), [](FGProtocol* p) {
         SG_LOG(SG_IO, SG_INFO, "Restarting channel \"" << p->get_name() << "\"");
         p->reinit();
@@ -460,7 +583,12 @@ FGIO::update( double /* delta_time_sec */ )
         p->dec_count_down( delta_time_sec );
         double dt = 1 / p->get_hz();
         if ( p->get_count_down() < 0.33 * dt ) {
-            p->process();
+            if (_ioThread && p->can_thread()) {
+                // the I/O happens in the thread, at its own pace
+                p->sync();
+            } else {
+                p->process();
+            }
             p->inc_count();
             while ( p->get_count_down() < 0.33 * dt ) {
                 p->inc_count_down( dt );
@@ -472,6 +600,12 @@ FGIO::update( double /* delta_time_sec */ )
 void
 FGIO::shutdown()
 {
+    if (_ioThread) {
+        _ioThread->stop();
+        _ioThread->join();
+        _ioThread.reset();
+    }
+
     ProtocolVec::iterator i = io_channels.begin();
     ProtocolVec::iterator end = io_channels.end();
     for (; i != end; ++i )
@@ -583,6 +717,9 @@ bool FGIO::commandRemoveChannel(const SGPropertyNode * arg, SGPropertyNode * roo
     removeFromPropertyTree(name);
 
     FGProtocol* p = *it;
+    if (_ioThread) {
+        _ioThread->remove(p);
+    }
     if (p->is_enabled()) {
         p->close();
     }
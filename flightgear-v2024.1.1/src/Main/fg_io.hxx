@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,12 +17,13 @@
 
 
 class FGProtocol;
+class FGIOThread;
 
 class FGIO : public SGSubsystem
 {
 public:
-    FGIO() = default;
-    ~FGIO() = default;
+    FGIO();
+    ~FGIO();
 
     // Subsystem API.
     void bind() override;
@@ -60,6 +62,9 @@ private:
 
     SGPropertyNode_ptr _realDeltaTime;
 
+    // runs the channels which can, when /sim/io/threaded is set
+    std::unique_ptr<FGIOThread> _ioThread;
+
     bool commandAddChannel(const SGPropertyNode* arg, SGPropertyNode* root);
     bool commandRemoveChannel(const SGPropertyNode* arg, SGPropertyNode* root);
 };
@@ -22,6 +22,7 @@
 #include <simgear/debug/logdelta.hxx>
 #include <simgear/emesary/Emesary.hxx>
 #include <simgear/emesary/notifications.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/io/raw_socket.hxx>
 #include <simgear/math/SGMath.hxx>
 #include <simgear/math/sg_random.hxx>
@@ -33,6 +34,7 @@
 #include <simgear/scene/material/matlib.hxx>
 #include <simgear/scene/model/modellib.hxx>
 #include <simgear/scene/tsync/terrasync.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 #include <simgear/structure/commands.hxx>
 #include <simgear/timing/sg_time.hxx>
 
@@ -400,6 +402,13 @@ static void fgIdleFunction ( void ) {
         if ( status == SGSubsystem::INIT_DONE) {
           ++idle_state;
           fgSplashProgress("finishing-subsystems");
+
+          // e.g. --prop:/sim/startup/init-trace=init.json, for chrome://tracing
+          const std::string initTrace = fgGetString("/sim/startup/init-trace");
+          if (!initTrace.empty()) {
+              sg_ofstream trace(SGPath::fromUtf8(initTrace), std::ios::out | std::ios::trunc);
+              mgr->writeInitTrace(trace);
+          }
         } else {
           fgSplashProgress("init-subsystems");
         }
@@ -555,6 +564,7 @@ int fgMainInit( int argc, char **argv )
 {
     sglog().setLogLevels( SG_ALL, SG_WARN );
     sglog().setStartupLoggingEnabled(true);
+    simgear::TraceRecorder::setThreadName("main");
     
     globals = new FGGlobals;
     auto initHomeResult = fgInitHome();
@@ -624,6 +634,10 @@ int fgMainInit( int argc, char **argv )
         // now home is initialised, we can log to a file inside it
         const auto level = flightgear::Options::getArgValue(argc, argv, "--log-level");
         logToHome(level);
+
+        // compiled copies of the XML files read at startup, FG_ROOT can't
+        // be relied on to be writeable
+        setReadPropertiesCacheDir(globals->get_fg_home() / "PropertyCache");
     }
 
     if (readOnlyFGHome) {
@@ -2074,6 +2074,9 @@ const std::initializer_list<OptionDesc> fgOptionArray = {
     {"ignore-autosave",                  ParamType::VAL_BOOL, OptionType::OPT_FUNC,   "", false, "true",  fgOptIgnoreAutosave },
     {"disable-ignore-autosave",          ParamType::NONE,     OptionType::OPT_FUNC,   "", false, "false", fgOptIgnoreAutosave },
     {"enable-ignore-autosave",           ParamType::NONE,     OptionType::OPT_FUNC,   "", false, "true",  fgOptIgnoreAutosave },
+    {"io-thread",                        ParamType::VAL_BOOL, OptionType::OPT_BOOL,   "/sim/io/threaded", true,  "", nullptr },
+    {"disable-io-thread",                ParamType::NONE,     OptionType::OPT_BOOL,   "/sim/io/threaded", false, "", nullptr },
+    {"enable-io-thread",                 ParamType::NONE,     OptionType::OPT_BOOL,   "/sim/io/threaded", true,  "", nullptr },
     {"launcher",                         ParamType::VAL_BOOL, OptionType::OPT_IGNORE, "", true,  "", nullptr },
     {"disable-launcher",                 ParamType::NONE,     OptionType::OPT_IGNORE, "", false, "", nullptr },
     {"enable-launcher",                  ParamType::NONE,     OptionType::OPT_IGNORE, "", true,  "", nullptr },
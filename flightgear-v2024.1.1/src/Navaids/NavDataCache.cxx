@@ -10,6 +10,7 @@
 #include "NavDataCache.hxx"
 
 // std
+#include <atomic>
 #include <cstddef>  // for std::size_t
 #include <map>
 #include <cstring>  // for memcoy
@@ -52,8 +53,10 @@
 #include <simgear/sg_inlines.h>
 #include <simgear/structure/exception.hxx>
 #include <simgear/threads/SGThread.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include "CacheSchema.h"
+#include "NavaidFrequencyIndex.hxx"
 #include "PositionedOctree.hxx"
 #include "fix.hxx"
 #include "markerbeacon.hxx"
@@ -633,13 +636,9 @@ public:
                              "positioned.rowid=comm.rowid AND freq_khz=?1 "
                              AND_TYPED " ORDER BY distanceCartSqr(cart_x, cart_y, cart_z, ?4, ?5, ?6)");
 
-    findNavsByFreq = prepare("SELECT positioned.rowid FROM positioned, navaid WHERE "
-                             "positioned.rowid=navaid.rowid "
-                             "AND navaid.freq=?1 " AND_TYPED
-                             " ORDER BY distanceCartSqr(cart_x, cart_y, cart_z, ?4, ?5, ?6)");
-
-    findNavsByFreqNoPos = prepare("SELECT positioned.rowid FROM positioned, navaid WHERE "
-                                  "positioned.rowid=navaid.rowid AND freq=?1 " AND_TYPED);
+    loadNavaidFrequencies = prepare("SELECT positioned.rowid, type, freq, lon, lat, elev_m "
+                                    "FROM positioned, navaid WHERE positioned.rowid=navaid.rowid "
+                                    "ORDER BY positioned.rowid");
 
     findNavaidForRunway = prepare("SELECT positioned.rowid FROM positioned, navaid WHERE "
                                   "positioned.rowid=navaid.rowid AND runway=?1 AND type=?2");
@@ -938,6 +937,30 @@ public:
     return result;
   }
 
+  const NavaidFrequencyIndex& navaidFrequencyIndex()
+  {
+    if (!frequencyIndex) {
+      SGTimeStamp st;
+      st.stamp();
+      frequencyIndex.reset(new NavaidFrequencyIndex);
+      while (stepSelect(loadNavaidFrequencies)) {
+        const auto id = sqlite3_column_int64(loadNavaidFrequencies, 0);
+        const auto ty = static_cast<FGPositioned::Type>(sqlite3_column_int(loadNavaidFrequencies, 1));
+        const int freq = sqlite3_column_int(loadNavaidFrequencies, 2);
+        const SGGeod pos = SGGeod::fromDegM(sqlite3_column_double(loadNavaidFrequencies, 3),
+                                            sqlite3_column_double(loadNavaidFrequencies, 4),
+                                            sqlite3_column_double(loadNavaidFrequencies, 5));
+        frequencyIndex->add(id, ty, freq, pos);
+      }
+      reset(loadNavaidFrequencies);
+      frequencyIndex->finalize();
+      SG_LOG(SG_NAVCACHE, SG_INFO, "built navaid frequency index of " << frequencyIndex->size()
+             << " navaids in " << st.elapsedMSec() << " msec");
+    }
+
+    return *frequencyIndex;
+  }
+
   PositionedIDVec selectIds(sqlite3_stmt_ptr query)
   {
     PositionedIDVec result;
@@ -992,6 +1015,9 @@ public:
     PositionedCache cache;
     unsigned int cacheHits, cacheMisses;
 
+    /// navaids by frequency, built on demand and dropped when navaids change
+    std::unique_ptr<NavaidFrequencyIndex> frequencyIndex;
+
     /**
    * record the levels of open transaction objects we have
    */
@@ -1022,8 +1048,7 @@ public:
         getOctreeLeafChildren;
 
     sqlite3_stmt_ptr searchAirports, getAllAirports;
-    sqlite3_stmt_ptr findCommByFreq, findNavsByFreq,
-        findNavsByFreqNoPos, findNavaidForRunway;
+    sqlite3_stmt_ptr findCommByFreq, loadNavaidFrequencies, findNavaidForRunway;
     sqlite3_stmt_ptr getAirportItems, getAirportItemByIdent;
     sqlite3_stmt_ptr findAirportRunway,
         findILS;
@@ -1051,8 +1076,9 @@ public:
     std::unique_ptr<RebuildThread> rebuilder;
 
     // transient rowIDs (not actually present in the on-disk DB, only in our
-    // in-memory cache / temporary table) start at this value and count down
-    PositionedID nextTransientId = -1000;
+    // in-memory cache / temporary table) start at this value and count down.
+    // Ground networks are also loaded on the AI flight plan builder's thread.
+    std::atomic<PositionedID> nextTransientId{-1000};
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -2002,6 +2028,9 @@ void NavDataCache::commitTransaction()
     // still abort the entire transaction. That's bad, but safer than
     // committing.
     sqlite3_stmt_ptr q = d->transactionAborted ? d->rollbackTransactionStmt : d->commitTransactionStmt;
+    if (d->transactionAborted) {
+      d->frequencyIndex.reset();
+    }
 
     int retries = 0;
     int result;
@@ -2050,6 +2079,7 @@ void NavDataCache::abortTransaction()
   if (--d->transactionLevel == 0) {
     d->stepSelect(d->rollbackTransactionStmt);
     sqlite3_reset(d->rollbackTransactionStmt);
+    d->frequencyIndex.reset(); // might hold navaids which are gone now
   }
 
   d->transactionAborted = true;
@@ -2122,6 +2152,13 @@ void NavDataCache::updatePosition(PositionedID item, const SGGeod &pos)
     SGVec3d cartPos(SGVec3d::fromGeod(pos));
     auto it = d->cache.find(item);
 
+    // the frequency index has the position of every navaid; airports and
+    // waypoints moving around do not concern it
+    if ((it == d->cache.end()) ||
+        ((it->second->type() >= FGPositioned::NDB) && (it->second->type() <= FGPositioned::MOBILE_TACAN))) {
+        d->frequencyIndex.reset();
+    }
+
     // transient item, update the transient octree : this is much easier than the
     // persistent octree case (see logic below) becuase we know the tree is fully
     // loaded, and there's no DB table to keep in sync; we just update the in-memory
@@ -2266,6 +2303,7 @@ NavDataCache::insertNavaid(FGPositioned::Type ty, const string& ident,
 
   sqlite3_int64 rowId = d->insertPositioned(ty, ident, name, pos, apt,
                                             spatialIndex);
+  d->frequencyIndex.reset();
   sqlite3_bind_int64(d->insertNavaid, 1, rowId);
   sqlite3_bind_int(d->insertNavaid, 2, freq);
   sqlite3_bind_int(d->insertNavaid, 3, range);
@@ -2571,36 +2609,32 @@ NavDataCache::findCommsByFreq(int freqKhz, const SGGeod& aPos, FGPositioned::Fil
 PositionedIDVec
 NavDataCache::findNavaidsByFreq(int freqKhz, const SGGeod& aPos, FGPositioned::Filter* aFilter)
 {
-  sqlite3_bind_int(d->findNavsByFreq, 1, freqKhz);
+  return findNavaidsByFreq(freqKhz, aPos, 0.0, aFilter);
+}
+
+PositionedIDVec
+NavDataCache::findNavaidsByFreq(int freqKhz, const SGGeod& aPos, double rangeM,
+                                FGPositioned::Filter* aFilter)
+{
   if (aFilter) {
-    sqlite3_bind_int(d->findNavsByFreq, 2, aFilter->minType());
-    sqlite3_bind_int(d->findNavsByFreq, 3, aFilter->maxType());
-  } else { // full type range
-    sqlite3_bind_int(d->findNavsByFreq, 2, FGPositioned::NDB);
-    sqlite3_bind_int(d->findNavsByFreq, 3, FGPositioned::GS);
+    return d->navaidFrequencyIndex().find(freqKhz, aPos, rangeM,
+                                          aFilter->minType(), aFilter->maxType());
   }
 
-  SGVec3d cartPos(SGVec3d::fromGeod(aPos));
-  sqlite3_bind_double(d->findNavsByFreq, 4, cartPos.x());
-  sqlite3_bind_double(d->findNavsByFreq, 5, cartPos.y());
-  sqlite3_bind_double(d->findNavsByFreq, 6, cartPos.z());
-
-  return d->selectIds(d->findNavsByFreq);
+  // full type range
+  return d->navaidFrequencyIndex().find(freqKhz, aPos, rangeM,
+                                        FGPositioned::NDB, FGPositioned::GS);
 }
 
 PositionedIDVec
 NavDataCache::findNavaidsByFreq(int freqKhz, FGPositioned::Filter* aFilter)
 {
-  sqlite3_bind_int(d->findNavsByFreqNoPos, 1, freqKhz);
   if (aFilter) {
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 2, aFilter->minType());
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 3, aFilter->maxType());
-  } else { // full type range
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 2, FGPositioned::NDB);
-    sqlite3_bind_int(d->findNavsByFreqNoPos, 3, FGPositioned::GS);
+    return d->navaidFrequencyIndex().find(freqKhz, aFilter->minType(), aFilter->maxType());
   }
 
-  return d->selectIds(d->findNavsByFreqNoPos);
+  // full type range
+  return d->navaidFrequencyIndex().find(freqKhz, FGPositioned::NDB, FGPositioned::GS);
 }
 
 PositionedIDVec
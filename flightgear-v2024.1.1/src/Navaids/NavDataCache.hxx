@@ -245,6 +245,13 @@ public:
    */
     PositionedIDVec findNavaidsByFreq(int freqKhz, const SGGeod& pos, FGPositioned::Filter* filt);
 
+    /**
+     * As above, but only the navaids within rangeM of the position, found
+     * using the in-memory frequency index.
+     */
+    PositionedIDVec findNavaidsByFreq(int freqKhz, const SGGeod& pos, double rangeM,
+                                      FGPositioned::Filter* filt);
+
     /// overload version of the above that does not consider positioned when
     /// returning results. Only used by TACAN carrier search
     PositionedIDVec findNavaidsByFreq(int freqKhz, FGPositioned::Filter* filt);
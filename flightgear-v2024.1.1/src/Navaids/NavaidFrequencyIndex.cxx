@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileName: NavaidFrequencyIndex.cxx
+ * SPDX-FileComment: in-memory index of navaids by frequency and position
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "NavaidFrequencyIndex.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <simgear/constants.h>
+
+namespace flightgear
+{
+
+namespace {
+
+const int CELLS_PER_ROW = 360;
+const int NUM_ROWS = 180;
+
+// the smallest earth radius, so the angle covering a range is never too small
+const double MIN_EARTH_RADIUS_M = 6356752.0;
+
+} // of anonymous namespace
+
+void NavaidFrequencyIndex::clear()
+{
+    _entries.clear();
+}
+
+void NavaidFrequencyIndex::add(PositionedID id, FGPositioned::Type ty, int freq, const SGGeod& pos)
+{
+    Entry e;
+    e.freq = freq;
+    e.cell = cellForPos(pos);
+    e.order = static_cast<uint32_t>(_entries.size());
+    e.type = ty;
+    e.id = id;
+    e.cart = SGVec3d::fromGeod(pos);
+    _entries.push_back(e);
+}
+
+void NavaidFrequencyIndex::finalize()
+{
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.freq != b.freq) {
+            return a.freq < b.freq;
+        }
+        if (a.cell != b.cell) {
+            return a.cell < b.cell;
+        }
+        return a.order < b.order;
+    });
+}
+
+uint32_t NavaidFrequencyIndex::cellForPos(const SGGeod& pos)
+{
+    const int row = SGMisc<int>::clip(static_cast<int>(std::floor(pos.getLatitudeDeg() + 90.0)), 0, NUM_ROWS - 1);
+    int column = static_cast<int>(std::floor(pos.getLongitudeDeg() + 180.0)) % CELLS_PER_ROW;
+    if (column < 0) {
+        column += CELLS_PER_ROW;
+    }
+    return row * CELLS_PER_ROW + column;
+}
+
+void NavaidFrequencyIndex::frequencyRange(int freq, EntryIter& begin, EntryIter& end) const
+{
+    begin = std::lower_bound(_entries.begin(), _entries.end(), freq,
+                             [](const Entry& e, int f) { return e.freq < f; });
+    end = std::upper_bound(begin, _entries.cend(), freq,
+                           [](int f, const Entry& e) { return f < e.freq; });
+}
+
+PositionedIDVec NavaidFrequencyIndex::find(int freq, const SGGeod& pos, double rangeM,
+                                           FGPositioned::Type minType, FGPositioned::Type maxType) const
+{
+    EntryIter freqBegin, freqEnd;
+    frequencyRange(freq, freqBegin, freqEnd);
+
+    const SGVec3d cartPos = SGVec3d::fromGeod(pos);
+    const double rangeSqr = rangeM * rangeM;
+    std::vector<std::pair<double, const Entry*>> matches;
+
+    auto collect = [&](EntryIter it, EntryIter end) {
+        for (; it != end; ++it) {
+            if ((it->type < minType) || (it->type > maxType)) {
+                continue;
+            }
+            const double d2 = distSqr(it->cart, cartPos);
+            if ((rangeM > 0.0) && (d2 > rangeSqr)) {
+                continue;
+            }
+            matches.emplace_back(d2, &*it);
+        }
+    };
+
+    // the angle covering the range, with a cell of margin for the elevation
+    // and the difference between geodetic and geocentric latitude
+    double radiusDeg = 360.0;
+    if (rangeM > 0.0) {
+        const double chord = std::min(1.0, rangeM / (2.0 * MIN_EARTH_RADIUS_M));
+        radiusDeg = 2.0 * std::asin(chord) * SG_RADIANS_TO_DEGREES + 1.0;
+    }
+
+    if (radiusDeg >= 90.0) {
+        collect(freqBegin, freqEnd);
+    } else {
+        const double lat = pos.getLatitudeDeg();
+        const double maxAbsLat = std::max(std::fabs(lat - radiusDeg), std::fabs(lat + radiusDeg));
+        double lonSpanDeg = 360.0;
+        if (maxAbsLat < 89.0) {
+            const double s = std::sin(radiusDeg * SG_DEGREES_TO_RADIANS) / std::cos(maxAbsLat * SG_DEGREES_TO_RADIANS);
+            if (s < 1.0) {
+                lonSpanDeg = std::asin(s) * SG_RADIANS_TO_DEGREES;
+            }
+        }
+
+        const int firstRow = std::max(0, static_cast<int>(std::floor(lat - radiusDeg + 90.0)));
+        const int lastRow = std::min(NUM_ROWS - 1, static_cast<int>(std::floor(lat + radiusDeg + 90.0)));
+        int firstColumn = 0, lastColumn = CELLS_PER_ROW - 1;
+        if (lonSpanDeg < 180.0) {
+            firstColumn = static_cast<int>(std::floor(pos.getLongitudeDeg() - lonSpanDeg + 180.0));
+            lastColumn = static_cast<int>(std::floor(pos.getLongitudeDeg() + lonSpanDeg + 180.0));
+        }
+
+        // the column ranges to look at, wrapping at the date line
+        std::vector<std::pair<int, int>> columns;
+        if (lastColumn - firstColumn >= CELLS_PER_ROW - 1) {
+            columns.emplace_back(0, CELLS_PER_ROW - 1);
+        } else if (firstColumn < 0) {
+            columns.emplace_back(0, lastColumn);
+            columns.emplace_back(firstColumn + CELLS_PER_ROW, CELLS_PER_ROW - 1);
+        } else if (lastColumn >= CELLS_PER_ROW) {
+            columns.emplace_back(firstColumn, CELLS_PER_ROW - 1);
+            columns.emplace_back(0, lastColumn - CELLS_PER_ROW);
+        } else {
+            columns.emplace_back(firstColumn, lastColumn);
+        }
+
+        auto cellLess = [](const Entry& e, uint32_t cell) { return e.cell < cell; };
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (const auto& c : columns) {
+                const uint32_t firstCell = row * CELLS_PER_ROW + c.first;
+                const uint32_t endCell = row * CELLS_PER_ROW + c.second + 1;
+                auto begin = std::lower_bound(freqBegin, freqEnd, firstCell, cellLess);
+                auto end = std::lower_bound(begin, freqEnd, endCell, cellLess);
+                collect(begin, end);
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return a.second->order < b.second->order;
+    });
+
+    PositionedIDVec result;
+    result.reserve(matches.size());
+    for (const auto& m : matches) {
+        result.push_back(m.second->id);
+    }
+    return result;
+}
+
+PositionedIDVec NavaidFrequencyIndex::find(int freq, FGPositioned::Type minType, FGPositioned::Type maxType) const
+{
+    EntryIter freqBegin, freqEnd;
+    frequencyRange(freq, freqBegin, freqEnd);
+
+    std::vector<const Entry*> matches;
+    for (auto it = freqBegin; it != freqEnd; ++it) {
+        if ((it->type >= minType) && (it->type <= maxType)) {
+            matches.push_back(&*it);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Entry* a, const Entry* b) {
+        return a->order < b->order;
+    });
+
+    PositionedIDVec result;
+    result.reserve(matches.size());
+    for (auto e : matches) {
+        result.push_back(e->id);
+    }
+    return result;
+}
+
+} // namespace flightgear
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileName: NavaidFrequencyIndex.hxx
+ * SPDX-FileComment: in-memory index of navaids by frequency and position
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+#include <Navaids/positioned.hxx>
+
+namespace flightgear
+{
+
+/**
+ * Navaids grouped by frequency, each group sorted by a one degree lat/lon
+ * cell. Radios retune and re-search their station all the time; with the
+ * index a search only looks at the few stations on the frequency which
+ * are in the cells around the aircraft, instead of asking the database
+ * for every station on the frequency world-wide and sorting them.
+ *
+ * NavDataCache builds it from the navaid table the first time a
+ * frequency is searched, and drops it when navaids are added or moved.
+ */
+class NavaidFrequencyIndex
+{
+public:
+    void clear();
+
+    /// add a navaid, call finalize() once all are added
+    void add(PositionedID id, FGPositioned::Type ty, int freq, const SGGeod& pos);
+
+    /// sort the entries, must be called before searching
+    void finalize();
+
+    size_t size() const { return _entries.size(); }
+
+    /**
+     * The navaids on freq with a type between minType and maxType, sorted
+     * by distance from pos. Only those closer than rangeM are returned,
+     * or all of them if rangeM is not positive.
+     */
+    PositionedIDVec find(int freq, const SGGeod& pos, double rangeM,
+                         FGPositioned::Type minType, FGPositioned::Type maxType) const;
+
+    /// as above but regardless of the position, in the order they were added
+    PositionedIDVec find(int freq, FGPositioned::Type minType, FGPositioned::Type maxType) const;
+
+private:
+    struct Entry {
+        int freq;
+        uint32_t cell;
+        uint32_t order; ///< position in the order of add()
+        FGPositioned::Type type;
+        PositionedID id;
+        SGVec3d cart;
+    };
+
+    static uint32_t cellForPos(const SGGeod& pos);
+
+    using EntryIter = std::vector<Entry>::const_iterator;
+
+    /// the entries on freq, as a range of _entries
+    void frequencyRange(int freq, EntryIter& begin, EntryIter& end) const;
+
+    std::vector<Entry> _entries; ///< sorted by frequency, then cell
+};
+
+} // namespace flightgear
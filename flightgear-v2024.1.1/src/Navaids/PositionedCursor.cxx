@@ -0,0 +1,173 @@
+/*
+ * SPDX-FileName: PositionedCursor.cxx
+ * SPDX-FileComment: incremental search for the positioned items around a moving point
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "PositionedCursor.hxx"
+
+#include <algorithm>
+#include <limits>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/structure/exception.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include "PositionedOctree.hxx"
+
+namespace flightgear
+{
+
+namespace {
+
+// same bound as FGPositioned::findClosestNPartial
+const int LOAD_LIMIT_MSEC = 32;
+
+} // of anonymous namespace
+
+PositionedCursor::PositionedCursor()
+{
+}
+
+void PositionedCursor::reset()
+{
+    _coveredM = -1.0;
+    _loadedLeaves.clear();
+    _pendingLeaves.clear();
+    _items.clear();
+    _results.clear();
+}
+
+bool PositionedCursor::update(const SGGeod& aPos, unsigned int aN, double aCutoffNm,
+                              FGPositioned::Filter* aFilter)
+{
+    if (SGMisc<double>::isNaN(aPos.getLatitudeDeg()) || SGMisc<double>::isNaN(aPos.getLongitudeDeg())) {
+        throw sg_range_exception("position is invalid, NaNs");
+    }
+
+    _results.clear();
+    if (aFilter->maxType() < aFilter->minType()) {
+        SG_LOG(SG_GENERAL, SG_WARN, "invalid positioned filter specified");
+        return false;
+    }
+
+    const SGVec3d cart = SGVec3d::fromGeod(aPos);
+    const double cutoffM = aCutoffNm * SG_NM_TO_METER;
+
+    // while the search area stays inside the area covered by the leaves,
+    // there is nothing to load
+    if ((_coveredM < 0.0) || (dist(cart, _anchor) + cutoffM > _coveredM)) {
+        findLeaves(cart, cutoffM);
+    }
+
+    std::vector<Item> added;
+    const bool partial = loadPendingLeaves(cart, aFilter, added);
+
+    // the order changes little between updates: re-sort by insertion
+    for (auto& item : _items) {
+        item.distM = dist(cart, item.positioned->cart());
+    }
+    for (size_t i = 1; i < _items.size(); ++i) {
+        for (size_t j = i; (j > 0) && (_items[j] < _items[j - 1]); --j) {
+            std::swap(_items[j], _items[j - 1]);
+        }
+    }
+
+    if (!added.empty()) {
+        std::sort(added.begin(), added.end());
+        const size_t previousSize = _items.size();
+        _items.insert(_items.end(), added.begin(), added.end());
+        std::inplace_merge(_items.begin(), _items.begin() + previousSize, _items.end());
+    }
+
+    // transient items can appear and move at any time, look for them each time
+    std::vector<Octree::Leaf*> transientLeaves;
+    Octree::findLeavesWithinRange(Octree::globalTransientOctree(), cart, cutoffM, transientLeaves);
+    Octree::FindNearestResults transient;
+    Octree::FindNearestPQueue unused;
+    for (auto leaf : transientLeaves) {
+        leaf->visit(cart, cutoffM, aFilter, transient, unused);
+    }
+
+    auto it = _items.begin();
+    auto tit = transient.begin();
+    while (_results.size() < aN) {
+        const bool haveItem = (it != _items.end()) && (it->distM <= cutoffM);
+        const bool haveTransient = (tit != transient.end());
+        if (!haveItem && !haveTransient) {
+            break;
+        }
+
+        if (haveItem && (!haveTransient || (it->distM <= tit->order()))) {
+            _results.push_back(it->positioned);
+            ++it;
+        } else {
+            _results.push_back(tit->get());
+            ++tit;
+        }
+    }
+
+    return partial;
+}
+
+void PositionedCursor::findLeaves(const SGVec3d& aCart, double aRangeM)
+{
+    // cover a leaf size more than needed, so the leaf set is only
+    // recomputed after moving that far
+    _anchor = aCart;
+    _coveredM = aRangeM + Octree::LEAF_SIZE;
+
+    std::vector<Octree::Leaf*> leaves;
+    Octree::findLeavesWithinRange(Octree::globalPersistentOctree(), aCart, _coveredM, leaves);
+    const std::set<Octree::Leaf*> inRange(leaves.begin(), leaves.end());
+
+    // drop the leaves which left the area, and their items
+    for (auto lit = _loadedLeaves.begin(); lit != _loadedLeaves.end();) {
+        if (inRange.count(*lit) == 0) {
+            lit = _loadedLeaves.erase(lit);
+        } else {
+            ++lit;
+        }
+    }
+
+    _items.erase(std::remove_if(_items.begin(), _items.end(), [&inRange](const Item& item) {
+                     return inRange.count(item.leaf) == 0;
+                 }),
+                 _items.end());
+
+    // nearest first, so a partial result has the closest items
+    _pendingLeaves.clear();
+    for (auto leaf : leaves) {
+        if (_loadedLeaves.count(leaf) == 0) {
+            _pendingLeaves.push_back(leaf);
+        }
+    }
+}
+
+bool PositionedCursor::loadPendingLeaves(const SGVec3d& aCart, FGPositioned::Filter* aFilter,
+                                         std::vector<Item>& aAdded)
+{
+    SGTimeStamp tm;
+    tm.stamp();
+
+    const double everything = std::numeric_limits<double>::max();
+    size_t done = 0;
+    for (; (done < _pendingLeaves.size()) && (tm.elapsedMSec() < LOAD_LIMIT_MSEC); ++done) {
+        Octree::Leaf* leaf = _pendingLeaves[done];
+        Octree::FindNearestResults found;
+        Octree::FindNearestPQueue unused;
+        leaf->visit(aCart, everything, aFilter, found, unused);
+
+        for (const auto& f : found) {
+            aAdded.push_back(Item{f.get(), leaf, f.order()});
+        }
+        _loadedLeaves.insert(leaf);
+    }
+
+    _pendingLeaves.erase(_pendingLeaves.begin(), _pendingLeaves.begin() + done);
+    return !_pendingLeaves.empty();
+}
+
+} // namespace flightgear
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileName: PositionedCursor.hxx
+ * SPDX-FileComment: incremental search for the positioned items around a moving point
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+#include <Navaids/positioned.hxx>
+
+namespace flightgear
+{
+
+namespace Octree
+{
+class Leaf;
+}
+
+/**
+ * The closest N items around a position which moves a little between
+ * queries, such as the aircraft position for a map display.
+ *
+ * FGPositioned::findClosestN() starts from scratch every time. The cursor
+ * instead remembers the octree leaves around the last search position,
+ * with the items in them which passed the filter. When the position
+ * moves, only leaves entering the search area are loaded and those
+ * leaving it are dropped; the leaf set is only recomputed once the
+ * position has moved by more than a leaf size. The items are kept sorted
+ * by distance between queries, so resorting them is cheap.
+ *
+ * The filter is only applied to items when their leaf is loaded: if the
+ * filter changes its mind about items, call reset(). Transient items
+ * (temporary waypoints) are searched afresh on each update.
+ */
+class PositionedCursor
+{
+public:
+    PositionedCursor();
+
+    /// forget all items, the next update() searches from scratch
+    void reset();
+
+    /**
+     * Move the search to aPos. Returns true if the results are partial
+     * because loading leaves took too long, like
+     * FGPositioned::findClosestNPartial(); the next update() continues.
+     * A filter is required, with the type range to search.
+     */
+    bool update(const SGGeod& aPos, unsigned int aN, double aCutoffNm,
+                FGPositioned::Filter* aFilter);
+
+    /// the up to N items within the cutoff, nearest first
+    const FGPositionedList& results() const
+    { return _results; }
+
+private:
+    struct Item {
+        FGPositioned* positioned;
+        Octree::Leaf* leaf;
+        double distM;
+
+        bool operator<(const Item& other) const
+        { return distM < other.distM; }
+    };
+
+    void findLeaves(const SGVec3d& aCart, double aRangeM);
+    bool loadPendingLeaves(const SGVec3d& aCart, FGPositioned::Filter* aFilter,
+                           std::vector<Item>& aAdded);
+
+    SGVec3d _anchor;          ///< where the leaf set was computed
+    double _coveredM = -1.0;  ///< radius around _anchor covered by the leaf set
+
+    std::set<Octree::Leaf*> _loadedLeaves;
+    std::vector<Octree::Leaf*> _pendingLeaves; ///< in range, not loaded yet
+    std::vector<Item> _items;                  ///< of the loaded leaves, by distance
+    FGPositionedList _results;
+};
+
+} // namespace flightgear
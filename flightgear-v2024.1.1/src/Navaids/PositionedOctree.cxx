@@ -399,6 +399,27 @@ bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filte
   return !pq.empty();
 }
 
+void findLeavesWithinRange(Node* aRoot, const SGVec3d& aPos, double aRangeM, std::vector<Leaf*>& aLeaves)
+{
+  aLeaves.clear();
+  FindNearestPQueue pq;
+  FindNearestResults unused;
+  pq.push(Ordered<Node*>(aRoot, 0));
+
+  while (!pq.empty()) {
+    Node* nd = pq.top().get();
+    pq.pop();
+
+    Leaf* leaf = dynamic_cast<Leaf*>(nd);
+    if (leaf) {
+      aLeaves.push_back(leaf);
+    } else {
+      // branches only queue their children within range
+      nd->visit(aPos, aRangeM, nullptr, unused, pq);
+    }
+  } // of queue iteration
+}
+
 } // of namespace Octree
 
 } // of namespace flightgear
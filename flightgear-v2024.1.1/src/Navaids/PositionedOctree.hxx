@@ -231,6 +231,12 @@ private:
 
   bool findNearestN(const SGVec3d& aPos, unsigned int aN, double aCutoffM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec);
   bool findAllWithinRange(const SGVec3d& aPos, double aRangeM, FGPositioned::Filter* aFilter, FGPositionedList& aResults, int aCutoffMsec);
+
+  /**
+   * Collect the leaves below aRoot which are (partly) within aRangeM of
+   * aPos, nearest first. Only branches are loaded, not the leaf contents.
+   */
+  void findLeavesWithinRange(Node* aRoot, const SGVec3d& aPos, double aRangeM, std::vector<Leaf*>& aLeaves);
 } // of namespace Octree
 
 
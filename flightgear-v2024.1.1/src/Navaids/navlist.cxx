@@ -190,7 +190,9 @@ FGNavRecordRef FGNavList::findByFreq( double freq,
 {
   flightgear::NavDataCache* cache = flightgear::NavDataCache::instance();
   int freqKhz = static_cast<int>(freq * 100 + 0.5);
-  PositionedIDVec stations(cache->findNavaidsByFreq(freqKhz, position, filter));
+  PositionedIDVec stations(cache->findNavaidsByFreq(freqKhz, position,
+                                                    FG_NAV_MAX_RANGE * SG_NM_TO_METER,
+                                                    filter));
   if (stations.empty()) {
     return NULL;
   }
@@ -316,6 +318,7 @@ bool FGTACANList::init()
 bool FGTACANList::add( FGTACANRecord *c )
 {
     ident_channels[c->get_channel()].push_back(c);
+    frequencies[c->get_freq()].push_back(c);
     return true;
 }
 
@@ -329,13 +332,19 @@ FGTACANRecord *FGTACANList::findByFrequency(int frequency_kHz)
 {
     //029Y    10925 (encoded) = 109.25 = 109250khz - so we divide the input by 10
     int tfreq = frequency_kHz / 10;
-    for (tacan_ident_map_type::iterator it = ident_channels.begin(); it != ident_channels.end(); it++)
-    {
-        for (tacan_list_type::iterator lit = it->second.begin(); lit != it->second.end(); lit++)
-            if ((*lit)->get_freq() == tfreq)
-                return (*lit);
+    tacan_map_type::const_iterator it = frequencies.find(tfreq);
+    if (it == frequencies.end()) {
+        return nullptr;
     }
-    return nullptr;
+
+    // the first channel in order, as a search of ident_channels would find
+    FGTACANRecord* result = nullptr;
+    for (const auto& rec : it->second) {
+        if (!result || (rec->get_channel() < result->get_channel())) {
+            result = rec;
+        }
+    }
+    return result;
 }
 // Given a TACAN Channel return the first matching frequency
 FGTACANRecord *FGTACANList::findByChannel( const string& channel )
@@ -133,6 +133,7 @@ class FGTACANList {
     tacan_list_type channellist;
     tacan_map_type channels;
     tacan_ident_map_type ident_channels;
+    tacan_map_type frequencies;   ///< by ground reply frequency
 
 public:
 
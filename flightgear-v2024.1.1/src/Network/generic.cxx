@@ -12,6 +12,7 @@
 #include <string.h>                // strstr()
 #include <stdlib.h>                // strtod(), atoi()
 #include <cstdio>
+#include <utility>
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iochannel.hxx>
@@ -250,8 +251,34 @@ union u64 {
     double doubleVal;
 };
 
+// take the values of the output chunks, with the precision the message uses
+void FGGeneric::read_output(_serial_values& values) {
+    values.resize(_out_message.size());
+    for (unsigned int i = 0; i < _out_message.size(); i++) {
+        _serial_value& v = values[i];
+        v.set = true;
+        switch (_out_message[i].type) {
+        case FG_BOOL:
+            v.flag = _out_message[i].prop->getBoolValue();
+            break;
+
+        case FG_DOUBLE:
+            v.num = _out_message[i].prop->getDoubleValue();
+            break;
+
+        case FG_STRING:
+            v.str = _out_message[i].prop->getStringValue();
+            break;
+
+        default:
+            v.num = _out_message[i].prop->getFloatValue();
+            break;
+        }
+    }
+}
+
 // generate the message
-bool FGGeneric::gen_message_binary() {
+bool FGGeneric::gen_message_binary(const _serial_values& values) {
     std::string generic_sentence;
     length = 0;
 
@@ -262,7 +289,7 @@ bool FGGeneric::gen_message_binary() {
         case FG_INT:
         {
             val = _out_message[i].offset +
-                  _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                  values[i].num * _out_message[i].factor;
             int32_t intVal = val;
             if (binary_byte_order != BYTE_ORDER_MATCHES_NETWORK_ORDER) {
                 intVal = (int32_t) sg_bswap_32((uint32_t)intVal);
@@ -273,14 +300,14 @@ bool FGGeneric::gen_message_binary() {
         }
 
         case FG_BOOL:
-            buf[length] = (char) (_out_message[i].prop->getBoolValue() ? true : false);
+            buf[length] = (char) (values[i].flag ? true : false);
             length += 1;
             break;
 
         case FG_FIXED:
         {
             val = _out_message[i].offset +
-                 _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                 values[i].num * _out_message[i].factor;
 
             int32_t fixed = (int)(val * 65536.0f);
             if (binary_byte_order != BYTE_ORDER_MATCHES_NETWORK_ORDER) {
@@ -294,7 +321,7 @@ bool FGGeneric::gen_message_binary() {
         case FG_FLOAT:
         {
             val = _out_message[i].offset +
-                 _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                 values[i].num * _out_message[i].factor;
             u32 tmpun32;
             tmpun32.floatVal = static_cast<float>(val);
 
@@ -309,7 +336,7 @@ bool FGGeneric::gen_message_binary() {
         case FG_DOUBLE:
         {
             val = _out_message[i].offset +
-                 _out_message[i].prop->getDoubleValue() * _out_message[i].factor;
+                 values[i].num * _out_message[i].factor;
             u64 tmpun64;
             tmpun64.doubleVal = val;
 
@@ -324,7 +351,7 @@ bool FGGeneric::gen_message_binary() {
         case FG_BYTE:
         {
             val = _out_message[i].offset +
-                  _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                  values[i].num * _out_message[i].factor;
             int8_t byteVal = val;
             memcpy(&buf[length], &byteVal, sizeof(int8_t));
             length += sizeof(int8_t);
@@ -334,7 +361,7 @@ bool FGGeneric::gen_message_binary() {
         case FG_WORD:
         {
             val = _out_message[i].offset +
-                  _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                  values[i].num * _out_message[i].factor;
             int16_t wordVal = val;
             memcpy(&buf[length], &wordVal, sizeof(int16_t));
             length += sizeof(int16_t);
@@ -342,7 +369,7 @@ bool FGGeneric::gen_message_binary() {
         }
 
         default: // SG_STRING
-            std::string strdata = _out_message[i].prop->getStringValue();
+            const std::string& strdata = values[i].str;
             size_t strlength = strdata.length();
 
             if (binary_byte_order == BYTE_ORDER_NEEDS_CONVERSION) {
@@ -392,7 +419,7 @@ bool FGGeneric::gen_message_binary() {
     return true;
 }
 
-bool FGGeneric::gen_message_ascii() {
+bool FGGeneric::gen_message_ascii(const _serial_values& values) {
     std::string generic_sentence;
     char tmp[255];
     length = 0;
@@ -411,36 +438,36 @@ bool FGGeneric::gen_message_ascii() {
         case FG_WORD:
         case FG_INT:
             val = _out_message[i].offset +
-                  _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                  values[i].num * _out_message[i].factor;
             snprintf(tmp, 255, format.c_str(), (int)val);
             break;
 
         case FG_BOOL:
             snprintf(tmp, 255, format.c_str(),
-                               _out_message[i].prop->getBoolValue());
+                               values[i].flag);
             break;
 
         case FG_FIXED:
             val = _out_message[i].offset +
-                _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                values[i].num * _out_message[i].factor;
             snprintf(tmp, 255, format.c_str(), (float)val);
             break;
 
         case FG_FLOAT:
             val = _out_message[i].offset +
-                _out_message[i].prop->getFloatValue() * _out_message[i].factor;
+                values[i].num * _out_message[i].factor;
             snprintf(tmp, 255, format.c_str(), (float)val);
             break;
 
         case FG_DOUBLE:
             val = _out_message[i].offset +
-                _out_message[i].prop->getDoubleValue() * _out_message[i].factor;
+                values[i].num * _out_message[i].factor;
             snprintf(tmp, 255, format.c_str(), (double)val);
             break;
 
         default: // SG_STRING
             snprintf(tmp, 255, format.c_str(),
-                                   _out_message[i].prop->getStringValue().c_str());
+                                   values[i].str.c_str());
         }
 
         generic_sentence += tmp;
@@ -458,20 +485,24 @@ bool FGGeneric::gen_message_ascii() {
 }
 
 bool FGGeneric::gen_message() {
+    read_output(_out_values);
     if (binary_mode) {
-        return gen_message_binary();
+        return gen_message_binary(_out_values);
     } else {
-        return gen_message_ascii();
+        return gen_message_ascii(_out_values);
     }
 }
 
-bool FGGeneric::parse_message_binary(int length) {
+bool FGGeneric::parse_message_binary(int length, _serial_values& values) {
     char *p2, *p1 = buf;
     int32_t tmp32;
     int i = -1;
 
+    values.clear();
     p2 = p1 + length;
     while ((++i < (int)_in_message.size()) && (p1  < p2)) {
+        values.push_back({0.0, false, std::string(), true});
+        _serial_value& v = values.back();
 
         switch (_in_message[i].type) {
         case FG_INT:
@@ -480,12 +511,12 @@ bool FGGeneric::parse_message_binary(int length) {
             } else {
                 tmp32 = *(int32_t *)p1;
             }
-            updateValue(_in_message[i], (int)tmp32);
+            v.num = (int)tmp32;
             p1 += sizeof(int32_t);
             break;
 
         case FG_BOOL:
-            updateValue(_in_message[i], p1[0] != 0);
+            v.flag = p1[0] != 0;
             p1 += 1;
             break;
 
@@ -495,7 +526,7 @@ bool FGGeneric::parse_message_binary(int length) {
             } else {
                 tmp32 = *(int32_t *)p1;
             }
-            updateValue(_in_message[i], (float)tmp32 / 65536.0f);
+            v.num = (float)tmp32 / 65536.0f;
             p1 += sizeof(int32_t);
             break;
 
@@ -506,7 +537,7 @@ bool FGGeneric::parse_message_binary(int length) {
             } else {
                 tmpun32.floatVal = *(float *)p1;
             }
-            updateValue(_in_message[i], tmpun32.floatVal);
+            v.num = tmpun32.floatVal;
             p1 += sizeof(int32_t);
             break;
 
@@ -517,13 +548,13 @@ bool FGGeneric::parse_message_binary(int length) {
             } else {
                 tmpun64.doubleVal = *(double *)p1;
             }
-            updateValue(_in_message[i], tmpun64.doubleVal);
+            v.num = tmpun64.doubleVal;
             p1 += sizeof(int64_t);
             break;
 
         case FG_BYTE:
             tmp32 = *(int8_t *)p1;
-            updateValue(_in_message[i], (int)tmp32);
+            v.num = (int)tmp32;
             p1 += sizeof(int8_t);
             break;
 
@@ -533,13 +564,14 @@ bool FGGeneric::parse_message_binary(int length) {
             } else {
                 tmp32 = *(int16_t *)p1;
             }
-            updateValue(_in_message[i], (int)tmp32);
+            v.num = (int)tmp32;
             p1 += sizeof(int16_t);
             break;
 
         default: // SG_STRING
             SG_LOG( SG_IO, SG_ALERT, "Generic protocol: "
                     "Ignoring unsupported binary input chunk type.");
+            v.set = false;
             break;
         }
     }
@@ -547,7 +579,7 @@ bool FGGeneric::parse_message_binary(int length) {
     return true;
 }
 
-bool FGGeneric::parse_message_ascii(int length) {
+bool FGGeneric::parse_message_ascii(int length, _serial_values& values) {
     char *p1 = buf;
     int i = -1;
     int chunks = _in_message.size();
@@ -562,9 +594,12 @@ bool FGGeneric::parse_message_ascii(int length) {
         buf[length - line_separator_size] = 0;
     }
 
+    values.clear();
     size_t varsep_len = var_separator.length();
     while ((++i < chunks) && p1) {
         char* p2 = NULL;
+        values.push_back({0.0, false, std::string(), true});
+        _serial_value& v = values.back();
 
         if (varsep_len > 0)
         {
@@ -579,24 +614,24 @@ bool FGGeneric::parse_message_ascii(int length) {
         case FG_BYTE:
         case FG_WORD:
         case FG_INT:
-            updateValue(_in_message[i], atoi(p1));
+            v.num = atoi(p1);
             break;
 
         case FG_BOOL:
-            updateValue(_in_message[i], atof(p1) != 0.0);
+            v.flag = atof(p1) != 0.0;
             break;
 
         case FG_FIXED:
         case FG_FLOAT:
-            updateValue(_in_message[i], (float)strtod(p1, 0));
+            v.num = (float)strtod(p1, 0);
             break;
 
         case FG_DOUBLE:
-            updateValue(_in_message[i], (double)strtod(p1, 0));
+            v.num = (double)strtod(p1, 0);
             break;
 
         default: // SG_STRING
-            _in_message[i].prop->setStringValue(p1);
+            v.str = p1;
             break;
         }
 
@@ -606,11 +641,54 @@ bool FGGeneric::parse_message_ascii(int length) {
     return true;
 }
 
-bool FGGeneric::parse_message_len(int length) {
+bool FGGeneric::parse_message_len(int length, _serial_values& values) {
     if (binary_mode) {
-        return parse_message_binary(length);
+        return parse_message_binary(length, values);
     } else {
-        return parse_message_ascii(length);
+        return parse_message_ascii(length, values);
+    }
+}
+
+bool FGGeneric::parse_message_len(int length) {
+    if (!parse_message_len(length, _in_values)) {
+        return false;
+    }
+    apply_input(_in_values);
+    return true;
+}
+
+// set the properties of the input chunks received in a message
+void FGGeneric::apply_input(const _serial_values& values) {
+    for (unsigned int i = 0; (i < values.size()) && (i < _in_message.size()); i++) {
+        const _serial_value& v = values[i];
+        if (!v.set) {
+            continue;
+        }
+
+        switch (_in_message[i].type) {
+        case FG_BYTE:
+        case FG_WORD:
+        case FG_INT:
+            updateValue(_in_message[i], (int)v.num);
+            break;
+
+        case FG_BOOL:
+            updateValue(_in_message[i], v.flag);
+            break;
+
+        case FG_FIXED:
+        case FG_FLOAT:
+            updateValue(_in_message[i], (float)v.num);
+            break;
+
+        case FG_DOUBLE:
+            updateValue(_in_message[i], v.num);
+            break;
+
+        default: // SG_STRING
+            _in_message[i].prop->setStringValue(v.str);
+            break;
+        }
     }
 }
 
@@ -645,64 +723,98 @@ bool FGGeneric::open() {
 }
 
 
-// process work for this port
-bool FGGeneric::process() {
+// send a message with the given output values
+bool FGGeneric::write_message(const _serial_values& values) {
+    if (binary_mode) {
+        gen_message_binary(values);
+    } else {
+        gen_message_ascii(values);
+    }
+
+    if ( ! get_io_channel()->write( buf, length ) ) {
+        SG_LOG( SG_IO, SG_WARN, "Error writing data." );
+        return false;
+    }
+    return true;
+}
+
+
+// receive the pending messages: applied to the properties, or queued for
+// sync() when running in the I/O thread
+bool FGGeneric::read_messages(bool queue) {
     SGIOChannel *io = get_io_channel();
 
-    if ( (get_direction() == SG_IO_OUT) ||
-         (get_direction() == SG_IO_BI) ) {
-        gen_message();
-        if ( ! io->write( buf, length ) ) {
-            SG_LOG( SG_IO, SG_WARN, "Error writing data." );
-            goto error_out;
+    auto received = [this, queue](int length) {
+        if (!queue) {
+            parse_message_len( length );
+            return;
         }
-    }
 
-    if (( get_direction() == SG_IO_IN ) ||
-        (get_direction() == SG_IO_BI) ) {
-        if ( io->get_type() == sgFileType ) {
-            if (!binary_mode) {
-                length = io->readline( buf, FG_MAX_MSG_SIZE );
-                if ( length > 0 ) {
-                    parse_message_len( length );
-                } else {
-                    SG_LOG( SG_IO, SG_ALERT, "Error reading data." );
-                    return false;
-                }
+        _serial_values values;
+        parse_message_len( length, values );
+        _io_in.push_back( std::move(values) );
+    };
+
+    if ( io->get_type() == sgFileType ) {
+        if (!binary_mode) {
+            length = io->readline( buf, FG_MAX_MSG_SIZE );
+            if ( length > 0 ) {
+                received( length );
             } else {
-                length = io->read( buf, binary_record_length );
-                if ( length == binary_record_length ) {
-                    parse_message_len( length );
-                } else {
-                    SG_LOG( SG_IO, SG_ALERT,
-                            "Generic protocol: Received binary "
-                            "record of unexpected size, expected: "
-                            << binary_record_length << " but received: "
-                            << length);
-                }
+                SG_LOG( SG_IO, SG_ALERT, "Error reading data." );
+                return false;
             }
         } else {
-            if (!binary_mode) {
-                while ((length = io->readline( buf, FG_MAX_MSG_SIZE )) > 0 ) {
-                    parse_message_len( length );
-                }
+            length = io->read( buf, binary_record_length );
+            if ( length == binary_record_length ) {
+                received( length );
             } else {
-                while ((length = io->read( buf, binary_record_length )) 
-                          == binary_record_length ) {
-                    parse_message_len( length );
-                }
-
-                if ( length > 0 ) {
-                    SG_LOG( SG_IO, SG_ALERT,
+                SG_LOG( SG_IO, SG_ALERT,
                         "Generic protocol: Received binary "
                         "record of unexpected size, expected: "
                         << binary_record_length << " but received: "
                         << length);
-                }
+            }
+        }
+    } else {
+        if (!binary_mode) {
+            while ((length = io->readline( buf, FG_MAX_MSG_SIZE )) > 0 ) {
+                received( length );
+            }
+        } else {
+            while ((length = io->read( buf, binary_record_length )) 
+                      == binary_record_length ) {
+                received( length );
+            }
+
+            if ( length > 0 ) {
+                SG_LOG( SG_IO, SG_ALERT,
+                    "Generic protocol: Received binary "
+                    "record of unexpected size, expected: "
+                    << binary_record_length << " but received: "
+                    << length);
             }
         }
     }
     return true;
+}
+
+
+// process work for this port
+bool FGGeneric::process() {
+    if ( (get_direction() == SG_IO_OUT) ||
+         (get_direction() == SG_IO_BI) ) {
+        read_output( _out_values );
+        if ( ! write_message( _out_values ) ) {
+            goto error_out;
+        }
+    }
+
+    if (( get_direction() == SG_IO_IN ) ||
+        (get_direction() == SG_IO_BI) ) {
+        return read_messages( false );
+    }
+    return true;
 error_out:
     if (exitOnError) {
         fgOSExit(1);
@@ -712,6 +824,82 @@ error_out:
 }
 
 
+// threaded mode, main loop side: publish a snapshot of the output
+// properties and apply the messages received since the last call
+void FGGeneric::sync() {
+    if ( (get_direction() == SG_IO_OUT) ||
+         (get_direction() == SG_IO_BI) ) {
+        read_output( _out_values );
+        std::lock_guard<std::mutex> lock(_io_mutex);
+        std::swap( _out_values, _shared_out );
+        _shared_out_fresh = true;
+    }
+
+    if (( get_direction() == SG_IO_IN ) ||
+        (get_direction() == SG_IO_BI) ) {
+        {
+            std::lock_guard<std::mutex> lock(_io_mutex);
+            std::swap( _shared_in, _sync_in );
+        }
+
+        // all of them, in order: relative chunks add up
+        for (const auto& values : _sync_in) {
+            apply_input( values );
+        }
+        _sync_in.clear();
+    }
+
+    if (_io_failed && exitOnError) {
+        fgOSExit(1);
+    }
+}
+
+
+// threaded mode, I/O thread side: send the latest snapshot, and queue the
+// messages received for sync(). Does not touch the property tree.
+bool FGGeneric::process_io() {
+    // bound the queue when the main loop stalls, the newest messages matter
+    const size_t MAX_QUEUED_MESSAGES = 1024;
+
+    if ( (get_direction() == SG_IO_OUT) ||
+         (get_direction() == SG_IO_BI) ) {
+        {
+            std::lock_guard<std::mutex> lock(_io_mutex);
+            if (_shared_out_fresh) {
+                std::swap( _shared_out, _io_out );
+                _shared_out_fresh = false;
+                _io_out_valid = true;
+            }
+        }
+
+        // the last snapshot again if the main loop has not made a new one,
+        // none taken before a reinit() changed the chunks
+        if ( _io_out_valid && (_io_out.size() == _out_message.size()) &&
+             ! write_message( _io_out ) ) {
+            _io_failed = true;
+            return false;
+        }
+    }
+
+    if (( get_direction() == SG_IO_IN ) ||
+        (get_direction() == SG_IO_BI) ) {
+        const bool ok = read_messages( true );
+        if (!_io_in.empty()) {
+            std::lock_guard<std::mutex> lock(_io_mutex);
+            for (auto& values : _io_in) {
+                _shared_in.push_back( std::move(values) );
+            }
+            while (_shared_in.size() > MAX_QUEUED_MESSAGES) {
+                _shared_in.pop_front();
+            }
+        }
+        _io_in.clear();
+        return ok;
+    }
+    return true;
+}
+
+
 // close the channel
 bool FGGeneric::close() {
     SGIOChannel *io = get_io_channel();
@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <simgear/compiler.h>
 
@@ -31,6 +35,11 @@ public:
     // process work for this port
     bool process();
 
+    // threaded mode: property exchange in the main loop, I/O in the FGIO thread
+    bool can_thread() const override { return true; }
+    void sync() override;
+    bool process_io() override;
+
     // close the channel
     bool close();
 
@@ -59,6 +68,15 @@ protected:
         SGPropertyNode_ptr prop;
     } _serial_prot;
 
+    // a chunk value, read from or to be written to its property
+    typedef struct {
+        double num;
+        bool flag;
+        std::string str;
+        bool set;
+    } _serial_value;
+    typedef std::vector<_serial_value> _serial_values;
+
 private:
     std::string file_name;
 
@@ -83,10 +101,32 @@ private:
     enum { BYTE_ORDER_NEEDS_CONVERSION,
            BYTE_ORDER_MATCHES_NETWORK_ORDER } binary_byte_order;
 
-    bool gen_message_ascii();
-    bool gen_message_binary();
-    bool parse_message_ascii(int length);
-    bool parse_message_binary(int length);
+    // buffers of the main loop
+    _serial_values _out_values;
+    _serial_values _in_values;
+
+    // threaded mode: snapshots handed over under _io_mutex, swapped with the
+    // buffers of either side so that neither blocks on the other's work
+    std::mutex _io_mutex;
+    _serial_values _shared_out;
+    bool _shared_out_fresh = false;
+    std::deque<_serial_values> _shared_in;
+    _serial_values _io_out;
+    bool _io_out_valid = false;
+    std::deque<_serial_values> _io_in;
+    std::deque<_serial_values> _sync_in;
+    std::atomic<bool> _io_failed{false};
+
+    void read_output(_serial_values& values);
+    void apply_input(const _serial_values& values);
+    bool write_message(const _serial_values& values);
+    bool read_messages(bool queue);
+
+    bool gen_message_ascii(const _serial_values& values);
+    bool gen_message_binary(const _serial_values& values);
+    bool parse_message_ascii(int length, _serial_values& values);
+    bool parse_message_binary(int length, _serial_values& values);
+    bool parse_message_len(int length, _serial_values& values);
     bool read_config(SGPropertyNode* root, std::vector<_serial_prot>& msg);
     bool exitOnError;
     bool initOk;
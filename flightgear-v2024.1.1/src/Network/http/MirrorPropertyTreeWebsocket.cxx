@@ -22,6 +22,8 @@
 #include "jsonprops.hxx"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <unordered_map>
 #include <set>
 
@@ -133,6 +135,90 @@ using std::string;
         }
     };
     
+    /// little endian encoding of the binary subprotocol
+    class BinaryWriter
+    {
+    public:
+        explicit BinaryWriter(std::string& out) : _out(out) {}
+
+        void putUInt8(uint8_t v) { _out.push_back(static_cast<char>(v)); }
+
+        void putUInt16(uint16_t v) { putLE(v, 2); }
+        void putUInt32(uint32_t v) { putLE(v, 4); }
+        void putUInt64(uint64_t v) { putLE(v, 8); }
+
+        void putFloat(float v)
+        {
+            uint32_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            putUInt32(bits);
+        }
+
+        void putDouble(double v)
+        {
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            putUInt64(bits);
+        }
+
+        void putString16(const std::string& s)
+        {
+            const size_t len = std::min<size_t>(s.size(), UINT16_MAX);
+            putUInt16(len);
+            _out.append(s, 0, len);
+        }
+
+        void putString32(const std::string& s)
+        {
+            putUInt32(s.size());
+            _out.append(s);
+        }
+
+        void putValue(SGPropertyNode* prop)
+        {
+            switch (prop->getType()) {
+            case simgear::props::NONE:
+                putUInt8(0);
+                break;
+            case simgear::props::BOOL:
+                putUInt8(1);
+                putUInt8(prop->getBoolValue());
+                break;
+            case simgear::props::INT:
+                putUInt8(2);
+                putUInt32(static_cast<uint32_t>(prop->getIntValue()));
+                break;
+            case simgear::props::LONG:
+                putUInt8(3);
+                putUInt64(static_cast<uint64_t>(prop->getLongValue()));
+                break;
+            case simgear::props::FLOAT:
+                putUInt8(4);
+                putFloat(prop->getFloatValue());
+                break;
+            case simgear::props::DOUBLE:
+                putUInt8(5);
+                putDouble(prop->getDoubleValue());
+                break;
+            default:
+                // strings, and everything else the way JSON sends it
+                putUInt8(6);
+                putString32(prop->getStringValue());
+                break;
+            }
+        }
+
+    private:
+        void putLE(uint64_t v, unsigned bytes)
+        {
+            for (unsigned i = 0; i < bytes; ++i) {
+                _out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+            }
+        }
+
+        std::string& _out;
+    };
+
     class MirrorTreeListener : public SGPropertyChangeListener
     {
     public:
@@ -259,6 +345,39 @@ using std::string;
             return it->second;
         }
 
+        /// the binary counterpart of makeJSONData(), appends to out
+        void makeBinaryData(std::string& out)
+        {
+            BinaryWriter w(out);
+            w.putUInt8(1); // version
+
+            w.putUInt32(newNodes.size());
+            for (auto prop : newNodes) {
+                changedNodes.erase(prop); // avoid duplicate send
+                w.putUInt32(idForProperty(prop));
+                w.putUInt32(prop->getIndex());
+                w.putUInt32(prop->getPosition());
+                w.putString16(prop->getPath(true));
+                w.putValue(prop);
+            }
+            newNodes.clear();
+
+            w.putUInt32(removedNodes.size());
+            for (auto propId : removedNodes) {
+                w.putUInt32(propId);
+            }
+            removedNodes.clear();
+
+            w.putUInt32(changedNodes.size());
+            for (auto prop : changedNodes) {
+                w.putUInt32(idForProperty(prop));
+                w.putValue(prop);
+            }
+            changedNodes.clear();
+
+            recentlyRemoved.clear();
+        }
+
         cJSON* makeJSONData()
         {
 #if defined (MIRROR_DEBUG)
@@ -417,10 +536,13 @@ static void handleExecCommand(cJSON* json)
 }
 #endif
 
-MirrorPropertyTreeWebsocket::MirrorPropertyTreeWebsocket(const std::string& path) :
+const char* MirrorPropertyTreeWebsocket::BINARY_SUBPROTOCOL = "flightgear-mirror-binary-v1";
+
+MirrorPropertyTreeWebsocket::MirrorPropertyTreeWebsocket(const std::string& path, bool binary) :
     _rootPath(path),
     _listener(new MirrorTreeListener),
-    _minSendInterval(100)
+    _minSendInterval(100),
+    _binary(binary)
 {
     checkNodeExists();
 }
@@ -531,6 +653,14 @@ void MirrorPropertyTreeWebsocket::poll(WebsocketWriter & writer)
     // okay, we will send now, update the send stamp
     _lastSendTime.stamp();
 
+    if (_binary) {
+        // the buffer keeps its capacity, so steady updates don't allocate
+        _sendBuffer.clear();
+        _listener->makeBinaryData(_sendBuffer);
+        writer.writeBinary(_sendBuffer.data(), _sendBuffer.size());
+        return;
+    }
+
     cJSON * json = _listener->makeJSONData();
     char * jsonString = cJSON_PrintUnformatted( json );
     writer.writeText( jsonString );
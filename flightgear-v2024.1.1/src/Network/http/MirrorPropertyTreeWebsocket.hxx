@@ -34,16 +34,44 @@ namespace http {
 
     class MirrorTreeListener;
     
+/**
+ * Mirrors a property sub-tree to a websocket client. Every update lists
+ * the created, removed and changed properties since the previous one,
+ * created properties are assigned a numeric id which the later updates
+ * refer to.
+ *
+ * By default updates are JSON text frames. Clients which offer the
+ * binary subprotocol (see BINARY_SUBPROTOCOL) get binary frames instead,
+ * all values little endian:
+ *
+ *   uint8 version (1)
+ *   uint32 count, count * created:
+ *       uint32 id, uint32 index, uint32 position,
+ *       uint16 path length, path, value
+ *   uint32 count, count * uint32 id of a removed property
+ *   uint32 count, count * changed: uint32 id, value
+ *
+ * where a value is a uint8 type code followed by its data:
+ *   0 none, 1 bool (uint8), 2 int (int32), 3 long (int64),
+ *   4 float (float32), 5 double (float64), 6 string (uint32 length, bytes)
+ */
 class MirrorPropertyTreeWebsocket : public Websocket
 {
 public:
-    MirrorPropertyTreeWebsocket(const std::string& path);
+    static const char* BINARY_SUBPROTOCOL;
+
+    MirrorPropertyTreeWebsocket(const std::string& path, bool binary = false);
     ~MirrorPropertyTreeWebsocket() override;
 
     void close() override;
     void handleRequest(const HTTPRequest & request, WebsocketWriter & writer) override;
     void poll(WebsocketWriter & writer) override;
 
+    bool isBinary() const { return _binary; }
+
+    /// minimum interval between two updates in msec, 100 by default
+    void setMinSendInterval(int msec) { _minSendInterval = msec; }
+
 private:
     void checkNodeExists();
 
@@ -54,6 +82,8 @@ private:
     std::unique_ptr<MirrorTreeListener> _listener;
     int _minSendInterval;
     SGTimeStamp _lastSendTime;
+    const bool _binary;
+    std::string _sendBuffer;
 };
 
 }
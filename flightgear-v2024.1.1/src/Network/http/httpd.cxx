@@ -34,6 +34,9 @@
 #include "PropertyChangeObserver.hxx"
 #include <Main/fg_props.hxx>
 
+#include <simgear/misc/sg_hash.hxx>
+#include <simgear/misc/strutils.hxx>
+
 #include <mongoose.h>
 #include <cJSON.h>
 
@@ -199,10 +202,17 @@ public:
         return _uriHandler.findHandler(uri);
     }
 
-    Websocket * newWebsocket(const string & uri);
+    Websocket * newWebsocket(const string & uri, const string & subprotocol = string());
+
+    /**
+     * Returns the websocket subprotocol to use for a connection, or an
+     * empty string if the client offered none we support for its uri
+     */
+    static string selectSubprotocol(struct mg_connection * connection);
 
 private:
     int poll(struct mg_connection * connection);
+    int handshake(struct mg_connection * connection);
     int auth(struct mg_connection * connection);
     int request(struct mg_connection * connection);
     int onConnect(struct mg_connection * connection);
@@ -398,7 +408,7 @@ int WebsocketConnection::onConnect(struct mg_connection * connection)
   setConnection(connection);
   MongooseHTTPRequest request(connection);
   SG_LOG(SG_NETWORK, SG_INFO, "WebsocketConnection::connect for " << request.Uri);
-  if ( NULL == _websocket) _websocket = _httpd->newWebsocket(request.Uri);
+  if ( NULL == _websocket) _websocket = _httpd->newWebsocket(request.Uri, MongooseHttpd::selectSubprotocol(connection));
   if ( NULL == _websocket) {
     SG_LOG(SG_NETWORK, SG_WARN, "httpd: unhandled websocket uri: " << request.Uri);
     return 0;
@@ -593,19 +603,75 @@ void MongooseHttpd::close(struct mg_connection * connection)
   c->close(connection);
   delete c;
 }
-Websocket * MongooseHttpd::newWebsocket(const string & uri)
+Websocket * MongooseHttpd::newWebsocket(const string & uri, const string & subprotocol)
 {
   if (uri.find("/PropertyListener") == 0) {
     SG_LOG(SG_NETWORK, SG_INFO, "new PropertyChangeWebsocket for: " << uri);
     return new PropertyChangeWebsocket(&_propertyChangeObserver);
   } else if (uri.find("/PropertyTreeMirror/") == 0) {
     const auto path = uri.substr(20);
-    SG_LOG(SG_NETWORK, SG_INFO, "new MirrorPropertyTreeWebsocket for: " << path);
-    return new MirrorPropertyTreeWebsocket(path);
+    const bool binary = (subprotocol == MirrorPropertyTreeWebsocket::BINARY_SUBPROTOCOL);
+    SG_LOG(SG_NETWORK, SG_INFO, "new " << (binary ? "binary " : "") << "MirrorPropertyTreeWebsocket for: " << path);
+    return new MirrorPropertyTreeWebsocket(path, binary);
   }
   return NULL;
 }
 
+string MongooseHttpd::selectSubprotocol(struct mg_connection * connection)
+{
+  const char * offered = mg_get_header(connection, "Sec-WebSocket-Protocol");
+  if (NULL == offered || NULL == connection->uri) return string();
+  if (string(connection->uri).find("/PropertyTreeMirror/") != 0) return string();
+
+  using namespace simgear::strutils;
+  for (const auto & p : split(offered, ",")) {
+    if (strip(p) == MirrorPropertyTreeWebsocket::BINARY_SUBPROTOCOL) {
+      return MirrorPropertyTreeWebsocket::BINARY_SUBPROTOCOL;
+    }
+  }
+  return string();
+}
+
+static string base64Encode(const uint8_t * data, size_t len)
+{
+  static const char * chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  string r;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = data[i] << 16;
+    if (i + 1 < len) v |= data[i + 1] << 8;
+    if (i + 2 < len) v |= data[i + 2];
+    r += chars[(v >> 18) & 0x3f];
+    r += chars[(v >> 12) & 0x3f];
+    r += (i + 1 < len) ? chars[(v >> 6) & 0x3f] : '=';
+    r += (i + 2 < len) ? chars[v & 0x3f] : '=';
+  }
+  return r;
+}
+
+int MongooseHttpd::handshake(struct mg_connection * connection)
+{
+  // mongoose's own handshake can't confirm a subprotocol, send ours if
+  // the client asked for one we support
+  const string subprotocol = selectSubprotocol(connection);
+  const char * key = mg_get_header(connection, "Sec-WebSocket-Key");
+  if (subprotocol.empty() || NULL == key) return MG_FALSE;
+
+  // ref: http://tools.ietf.org/html/rfc6455#section-4.2.2
+  const string accept = string(key) + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  simgear::sha1nfo sha;
+  simgear::sha1_init(&sha);
+  simgear::sha1_write(&sha, accept.data(), accept.size());
+  const uint8_t * digest = simgear::sha1_result(&sha);
+
+  const string reply = "HTTP/1.1 101 Switching Protocols\r\n"
+                       "Upgrade: websocket\r\n"
+                       "Connection: Upgrade\r\n"
+                       "Sec-WebSocket-Accept: " + base64Encode(digest, HASH_LENGTH) + "\r\n"
+                       "Sec-WebSocket-Protocol: " + subprotocol + "\r\n\r\n";
+  mg_write(connection, reply.data(), reply.size());
+  return MG_TRUE;
+}
+
 int MongooseHttpd::staticRequestHandler(struct mg_connection * connection, mg_event event)
 {
   switch (event) {
@@ -630,6 +696,9 @@ int MongooseHttpd::staticRequestHandler(struct mg_connection * connection, mg_ev
     case MG_REPLY:       // If callback returns MG_FALSE, Mongoose closes connection
       return MG_FALSE;
 
+    case MG_WS_HANDSHAKE: // If callback returns MG_FALSE, Mongoose sends the handshake
+      return static_cast<MongooseHttpd*>(connection->server_param)->handshake(connection);
+
     case MG_WS_CONNECT: // New websocket connection established, return value ignored
       return static_cast<MongooseHttpd*>(connection->server_param)->onConnect(connection);
 
@@ -25,6 +25,8 @@
 #  include <config.h>
 #endif
 
+#include <cstring>
+
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iochannel.hxx>
 #include <simgear/io/lowlevel.hxx> // endian tests
@@ -125,6 +127,66 @@ bool FGNativeCtrls::process() {
     return true;
 }
 
+// threaded mode, main loop side: publish the controls properties and apply
+// the records received since the last call
+void FGNativeCtrls::sync() {
+    SGIOChannel *io = get_io_channel();
+    const bool dds = io->get_type() == sgDDSType;
+    char *buf = dds ? reinterpret_cast<char*>(&ctrls.dds)
+                    : reinterpret_cast<char*>(&ctrls.net);
+    const int length = dds ? sizeof(FG_DDS_Ctrls) : sizeof(FGNetCtrls);
+
+    if ( get_direction() == SG_IO_OUT ) {
+        if ( dds ) {
+            FGProps2Ctrls( globals->get_props(), &ctrls.dds, true, true );
+        } else {
+            FGProps2Ctrls( globals->get_props(), &ctrls.net, true, true );
+        }
+        _handoff.post( std::string( buf, length ) );
+    } else if ( get_direction() == SG_IO_IN ) {
+        _handoff.take_received( _sync_in );
+        for (const auto& record : _sync_in) {
+            memcpy( buf, record.data(), length );
+            if ( dds ) {
+                FGCtrls2Props( globals->get_props(), &ctrls.dds, true, true );
+            } else {
+                FGCtrls2Props( globals->get_props(), &ctrls.net, true, true );
+            }
+        }
+        _sync_in.clear();
+    }
+}
+
+// threaded mode, I/O thread side: send the latest record and queue the
+// received ones for sync(). Does not touch the property tree.
+bool FGNativeCtrls::process_io() {
+    SGIOChannel *io = get_io_channel();
+    const int length = io->get_type() == sgDDSType ? sizeof(FG_DDS_Ctrls)
+                                                   : sizeof(FGNetCtrls);
+
+    if ( get_direction() == SG_IO_OUT ) {
+        // the last record again if the main loop has not made a new one
+        if ( _handoff.latest( _io_out ) &&
+             ! io->write( _io_out.data(), _io_out.size() ) ) {
+            SG_LOG( SG_IO, SG_ALERT, "Error writing data." );
+            return false;
+        }
+    } else if ( get_direction() == SG_IO_IN ) {
+        std::string record( length, '\0' );
+        if ( io->get_type() == sgFileType ) {
+            if ( io->read( &record[0], length ) == length ) {
+                _handoff.push_received( record );
+            }
+        } else {
+            while ( io->read( &record[0], length ) == length ) {
+                _handoff.push_received( record );
+            }
+        }
+    }
+
+    return true;
+}
+
 // close the channel
 bool FGNativeCtrls::close() {
     SGIOChannel *io = get_io_channel();
@@ -43,6 +43,10 @@ class FGNativeCtrls : public FGProtocol {
         FGNetCtrls net;
     } ctrls;
 
+    FGProtocolHandoff _handoff;
+    std::string _io_out;
+    std::deque<std::string> _sync_in;
+
 public:
 
     FGNativeCtrls() = default;
@@ -54,6 +58,12 @@ public:
     // process work for this port
     bool process();
 
+    // threaded mode: the structure is filled and applied in sync(), only
+    // the raw records go through the I/O thread
+    bool can_thread() const override { return true; }
+    void sync() override;
+    bool process_io() override;
+
     // close the channel
     bool close();
 };
@@ -25,6 +25,8 @@
 #  include <config.h>
 #endif
 
+#include <cstring>
+
 #include <simgear/debug/logstream.hxx>
 #include <simgear/io/iochannel.hxx>
 #include <simgear/timing/sg_time.hxx>
@@ -128,6 +130,66 @@ bool FGNativeFDM::process() {
     return true;
 }
 
+// threaded mode, main loop side: publish the FDM properties and apply
+// the records received since the last call
+void FGNativeFDM::sync() {
+    SGIOChannel *io = get_io_channel();
+    const bool dds = io->get_type() == sgDDSType;
+    char *buf = dds ? reinterpret_cast<char*>(&fdm.dds)
+                    : reinterpret_cast<char*>(&fdm.net);
+    const int length = dds ? sizeof(FG_DDS_FDM) : sizeof(FGNetFDM);
+
+    if ( get_direction() == SG_IO_OUT ) {
+        if ( dds ) {
+            FGProps2FDM( globals->get_props(), &fdm.dds );
+        } else {
+            FGProps2FDM( globals->get_props(), &fdm.net );
+        }
+        _handoff.post( std::string( buf, length ) );
+    } else if ( get_direction() == SG_IO_IN ) {
+        _handoff.take_received( _sync_in );
+        for (const auto& record : _sync_in) {
+            memcpy( buf, record.data(), length );
+            if ( dds ) {
+                FGFDM2Props( globals->get_props(), &fdm.dds );
+            } else {
+                FGFDM2Props( globals->get_props(), &fdm.net );
+            }
+        }
+        _sync_in.clear();
+    }
+}
+
+// threaded mode, I/O thread side: send the latest record and queue the
+// received ones for sync(). Does not touch the property tree.
+bool FGNativeFDM::process_io() {
+    SGIOChannel *io = get_io_channel();
+    const int length = io->get_type() == sgDDSType ? sizeof(FG_DDS_FDM)
+                                                   : sizeof(FGNetFDM);
+
+    if ( get_direction() == SG_IO_OUT ) {
+        // the last record again if the main loop has not made a new one
+        if ( _handoff.latest( _io_out ) &&
+             ! io->write( _io_out.data(), _io_out.size() ) ) {
+            SG_LOG( SG_IO, SG_ALERT, "Error writing data." );
+            return false;
+        }
+    } else if ( get_direction() == SG_IO_IN ) {
+        std::string record( length, '\0' );
+        if ( io->get_type() == sgFileType ) {
+            if ( io->read( &record[0], length ) == length ) {
+                _handoff.push_received( record );
+            }
+        } else {
+            while ( io->read( &record[0], length ) == length ) {
+                _handoff.push_received( record );
+            }
+        }
+    }
+
+    return true;
+}
+
 // close the channel
 bool FGNativeFDM::close() {
     SGIOChannel *io = get_io_channel();
@@ -41,6 +41,10 @@ class FGNativeGUI : public FGProtocol {
         FG_DDS_GUI dds;
         FGNetGUI net;
     } gui;
+
+    FGProtocolHandoff _handoff;
+    std::string _io_out;
+    std::deque<std::string> _sync_in;
     
 public:
 
@@ -53,6 +57,12 @@ public:
     // process work for this port
     bool process();
 
+    // threaded mode: the structure is filled and applied in sync(), only
+    // the raw records go through the I/O thread
+    bool can_thread() const override { return true; }
+    void sync() override;
+    bool process_io() override;
+
     // close the channel
     bool close();
 };
@@ -9,6 +9,7 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <cstdio>
@@ -411,6 +412,67 @@ bool FGNMEA::process() {
 }
 
 
+// threaded mode, main loop side: publish the current sentences and parse
+// the lines received since the last call
+void FGNMEA::sync() {
+    if (( get_direction() == SG_IO_OUT )||
+        ( get_direction() == SG_IO_BI))
+    {
+        gen_message();
+        mHandoff.post( mNmeaSentence );
+        mNmeaSentence = "";
+    }
+
+    if (( get_direction() == SG_IO_IN )||
+        ( get_direction() == SG_IO_BI))
+    {
+        mHandoff.take_received( mSyncLines );
+        for (const auto& line : mSyncLines)
+        {
+            mLength = std::min<size_t>( line.size(), FG_MAX_MSG_SIZE-1 );
+            memcpy( mBuf, line.data(), mLength );
+            mBuf[mLength] = 0;
+            parse_line();
+        }
+        mSyncLines.clear();
+    }
+}
+
+
+// threaded mode, I/O thread side: send the latest sentences and queue the
+// received lines for sync(). Does not touch the property tree.
+bool FGNMEA::process_io() {
+    SGIOChannel *io = get_io_channel();
+
+    if (( get_direction() == SG_IO_OUT )||
+        ( get_direction() == SG_IO_BI))
+    {
+        // the last sentences again if the main loop has not made new ones
+        if ((mHandoff.latest( mIoSentence ))&&
+            (!io->write( mIoSentence.c_str(), mIoSentence.length() )))
+        {
+            SG_LOG( SG_IO, SG_WARN, "Error writing data." );
+        }
+    }
+
+    if (( get_direction() == SG_IO_IN )||
+        ( get_direction() == SG_IO_BI))
+    {
+        for (unsigned int i=0;i<mMaxReceiveLines;i++)
+        {
+            const int length = io->readline( mIoBuf, FG_MAX_MSG_SIZE );
+            if ( length > 0 ) {
+                mHandoff.push_received( std::string( mIoBuf, length ) );
+            } else {
+                SG_LOG( SG_IO, SG_WARN, "Error reading data." );
+            }
+        }
+    }
+
+    return true;
+}
+
+
 // close the channel
 bool FGNMEA::close() {
     SGIOChannel *io = get_io_channel();
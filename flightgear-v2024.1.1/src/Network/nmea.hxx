@@ -52,6 +52,13 @@ protected:
     const char* mLineFeed;
     std::string mNmeaSentence;
 
+    // threaded mode: sentences are generated and parsed in sync(), the
+    // I/O thread only moves the lines
+    FGProtocolHandoff mHandoff;
+    std::string mIoSentence;
+    std::deque<std::string> mSyncLines;
+    char mIoBuf[FG_MAX_MSG_SIZE];
+
     void add_with_checksum(char *sentence, unsigned int buf_size);
 
     // process a single NMEA line
@@ -73,6 +80,10 @@ public:
     // process work for this port
     virtual bool process();
 
+    bool can_thread() const override { return true; }
+    void sync() override;
+    bool process_io() override;
+
     // close the channel
     virtual bool close();
 };
@@ -119,3 +119,40 @@ void FGProtocol::set_direction( const std::string& d ) {
 	dir = SG_IO_NONE;
     }
 }
+
+
+void FGProtocolHandoff::post( std::string message ) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _out = std::move(message);
+    _out_fresh = true;
+}
+
+
+void FGProtocolHandoff::take_received( std::deque<std::string>& messages ) {
+    messages.clear();
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::swap( _in, messages );
+}
+
+
+bool FGProtocolHandoff::latest( std::string& io_out ) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_out_fresh) {
+        std::swap( _out, io_out );
+        _out_fresh = false;
+    }
+    return !io_out.empty();
+}
+
+
+void FGProtocolHandoff::push_received( std::string message ) {
+    // bound the queue when the main loop stalls, the newest messages matter
+    const size_t MAX_QUEUED_MESSAGES = 1024;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _in.push_back( std::move(message) );
+    while (_in.size() > MAX_QUEUED_MESSAGES) {
+        _in.pop_front();
+    }
+}
+
@@ -26,6 +26,8 @@
 #include <simgear/compiler.h>
 #include <simgear/io/iochannel.hxx>
 
+#include <deque>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -77,6 +79,17 @@ public:
     virtual bool gen_message();
     virtual bool parse_message();
 
+    /**
+     * Channels which can run on the FGIO thread (/sim/io/threaded) split
+     * process() in two: sync() runs in the main loop at the channel rate,
+     * at most once per frame, and exchanges property values with buffers,
+     * process_io() runs on the I/O thread at the channel rate and only
+     * uses the buffers and the I/O channel.
+     */
+    virtual bool can_thread() const { return false; }
+    virtual void sync() {}
+    virtual bool process_io() { return process(); }
+
     // inline std::string get_protocol() const { return protocol_str; }
     // inline void set_protocol( const std::string& str ) { protocol_str = str; }
 
@@ -96,6 +109,30 @@ public:
 };
 
 
+/**
+ * Hands the raw messages over between sync() and process_io() for the
+ * channels which build and parse their messages in the main loop: the
+ * latest outgoing message, and the ones received since the last sync().
+ */
+class FGProtocolHandoff {
+public:
+    // main loop side
+    void post( std::string message );
+    void take_received( std::deque<std::string>& messages );
+
+    // I/O thread side: swaps the latest posted message into io_out, which
+    // is kept as is when there is no new one. False until one was posted.
+    bool latest( std::string& io_out );
+    void push_received( std::string message );
+
+private:
+    std::mutex _mutex;
+    std::string _out;
+    bool _out_fresh = false;
+    std::deque<std::string> _in;
+};
+
+
 typedef std::vector < FGProtocol * > io_container;
 typedef io_container::iterator io_iterator;
 typedef io_container::const_iterator const_io_iterator;
@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileName: TilePrefetcher.cxx
+ * SPDX-FileComment: request the tiles ahead of the aircraft before they are in view range
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "TilePrefetcher.hxx"
+
+#include <algorithm>
+
+#include <simgear/constants.h>
+#include <simgear/debug/logstream.hxx>
+#include <simgear/math/SGGeodesy.hxx>
+#include <simgear/scene/tsync/terrasync.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
+
+#include <Autopilot/route_mgr.hxx>
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+#include <Navaids/FlightPlan.hxx>
+#include <Navaids/route.hxx>
+
+namespace flightgear
+{
+
+namespace {
+
+// the projection changes slowly, no need to redo it every frame
+const double UPDATE_INTERVAL_SEC = 2.0;
+
+// keep prefetched tiles a little longer than it takes to reach them
+const double EXPIRY_MARGIN_SEC = 60.0;
+
+// bound the bookkeeping on long flights
+const size_t MAX_COUNTED = 4096;
+const size_t MAX_SYNCED_DIRS = 4096;
+
+} // of anonymous namespace
+
+TilePrefetcher::TilePrefetcher()
+{
+}
+
+void TilePrefetcher::init()
+{
+    SGPropertyNode* root = fgGetNode("/sim/tile-prefetch", true);
+    _enabled = root->getNode("enabled", true);
+    _lookahead = root->getNode("lookahead-sec", true);
+    _syncLookahead = root->getNode("terrasync-lookahead-sec", true);
+    _minSpeed = root->getNode("min-speed-kt", true);
+    if (!_enabled->hasValue()) {
+        _enabled->setBoolValue(true);
+    }
+    if (!_lookahead->hasValue()) {
+        _lookahead->setDoubleValue(300.0);
+    }
+    if (!_syncLookahead->hasValue()) {
+        _syncLookahead->setDoubleValue(900.0);
+    }
+    if (!_minSpeed->hasValue()) {
+        _minSpeed->setDoubleValue(40.0);
+    }
+
+    SGPropertyNode* stats = root->getNode("stats", true);
+    _scheduledTiles = stats->getNode("scheduled-tiles", true);
+    _scheduledDirs = stats->getNode("terrasync-dirs", true);
+    _hits = stats->getNode("hits", true);
+    _late = stats->getNode("late", true);
+    _misses = stats->getNode("misses", true);
+
+    _groundSpeed = fgGetNode("/velocities/groundspeed-kt", true);
+    _track = fgGetNode("/orientation/track-deg", true);
+
+    reset();
+}
+
+void TilePrefetcher::reset()
+{
+    _sinceUpdate = UPDATE_INTERVAL_SEC;
+    _time = 0.0;
+    _prefetched.clear();
+    _counted.clear();
+    _syncedDirs.clear();
+
+    if (_hits) {
+        _scheduledTiles->setIntValue(0);
+        _scheduledDirs->setIntValue(0);
+        _hits->setIntValue(0);
+        _late->setIntValue(0);
+        _misses->setIntValue(0);
+    }
+}
+
+void TilePrefetcher::update(double dt, const SGGeod& aircraftPos, const ScheduleTile& scheduleTile,
+                            simgear::SGTerraSync* terraSync)
+{
+    _time += dt;
+    _sinceUpdate += dt;
+    if (!_enabled || (_sinceUpdate < UPDATE_INTERVAL_SEC)) {
+        return;
+    }
+    _sinceUpdate = 0.0;
+
+    // the tile cache drops our requests once they expire, forget them too
+    for (auto it = _prefetched.begin(); it != _prefetched.end();) {
+        if (it->second < _time) {
+            it = _prefetched.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const double speedKt = _groundSpeed->getDoubleValue();
+    if (!_enabled->getBoolValue() || (speedKt < _minSpeed->getDoubleValue())) {
+        return;
+    }
+
+    simgear::TraceScope trace("tile", "prefetch");
+    const double speedMps = speedKt * SG_KT_TO_MPS;
+    const double tileRangeM = speedMps * _lookahead->getDoubleValue();
+    const double syncRangeM = speedMps * std::max(_lookahead->getDoubleValue(),
+                                                  _syncLookahead->getDoubleValue());
+
+    const SGBucket here(aircraftPos);
+    if (!here.isValid()) {
+        return;
+    }
+
+    // sample at half a tile, so no tile crossed by the path is skipped
+    const double stepM = std::max(1000.0, 0.5 * std::min(here.get_width_m(), here.get_height_m()));
+    const auto path = projectPath(aircraftPos, _track->getDoubleValue(), activeRoute(),
+                                  syncRangeM, stepM);
+
+    int scheduled = 0, dirs = 0;
+    long lastIndex = -1;
+    for (const auto& p : path) {
+        const SGBucket b(p.position);
+        if (!b.isValid() || (b.gen_index() == lastIndex)) {
+            continue;
+        }
+        lastIndex = b.gen_index();
+
+        if (p.distanceM <= tileRangeM) {
+            // same ordering as the view range: nearer tiles first
+            const double tiles = p.distanceM / b.get_width_m();
+            const double expiry = p.distanceM / speedMps + EXPIRY_MARGIN_SEC;
+            scheduleTile(b, -(tiles * tiles), expiry);
+            if (_prefetched.find(lastIndex) == _prefetched.end()) {
+                ++scheduled;
+            }
+            _prefetched[lastIndex] = _time + expiry;
+        }
+
+        if (terraSync) {
+            if (_syncedDirs.size() > MAX_SYNCED_DIRS) {
+                _syncedDirs.clear();
+            }
+            if (_syncedDirs.insert(b.gen_base_path()).second) {
+                terraSync->scheduleTile(b);
+                ++dirs;
+            }
+        }
+    }
+
+    if (scheduled || dirs) {
+        SG_LOG(SG_TERRAIN, SG_DEBUG, "tile prefetch: " << scheduled << " new tiles, "
+               << dirs << " TerraSync dirs along " << path.size() << " path points");
+    }
+    _scheduledTiles->setIntValue(_scheduledTiles->getIntValue() + scheduled);
+    _scheduledDirs->setIntValue(_scheduledDirs->getIntValue() + dirs);
+}
+
+void TilePrefetcher::tileNeeded(const SGBucket& b, bool loaded)
+{
+    if (!_hits) {
+        return;
+    }
+
+    const long index = b.gen_index();
+    if (_counted.size() > MAX_COUNTED) {
+        _counted.clear();
+    }
+    if (!_counted.insert(index).second) {
+        return;
+    }
+
+    // tiles loaded without being prefetched were already in view range
+    const bool prefetched = _prefetched.find(index) != _prefetched.end();
+    if (prefetched) {
+        SGPropertyNode* counter = loaded ? _hits.get() : _late.get();
+        counter->setIntValue(counter->getIntValue() + 1);
+    } else if (!loaded) {
+        _misses->setIntValue(_misses->getIntValue() + 1);
+    }
+}
+
+std::vector<TilePrefetcher::PathPoint>
+TilePrefetcher::projectPath(const SGGeod& pos, double trackDeg,
+                            const std::vector<SGGeod>& route,
+                            double rangeM, double stepM)
+{
+    std::vector<PathPoint> result;
+    if ((rangeM <= 0.0) || (stepM <= 0.0)) {
+        return result;
+    }
+
+    result.push_back({pos, 0.0});
+    double travelled = 0.0;
+    SGGeod from = pos;
+
+    // follow the route legs, then continue along the last leg's course
+    double course = trackDeg;
+    for (const auto& to : route) {
+        const double legM = SGGeodesy::distanceM(from, to);
+        if (legM < 1.0) {
+            continue;
+        }
+        course = SGGeodesy::courseDeg(from, to);
+        for (double d = stepM; d < legM; d += stepM) {
+            if (travelled + d > rangeM) {
+                return result;
+            }
+            result.push_back({SGGeodesy::direct(from, course, d), travelled + d});
+        }
+
+        travelled += legM;
+        if (travelled > rangeM) {
+            return result;
+        }
+        result.push_back({to, travelled});
+
+        // the course arriving at the waypoint, for after the last one
+        course = SGGeodesy::courseDeg(to, from) + 180.0;
+        from = to;
+    }
+
+    for (double d = stepM; travelled + d <= rangeM; d += stepM) {
+        result.push_back({SGGeodesy::direct(from, course, d), travelled + d});
+    }
+    return result;
+}
+
+std::vector<SGGeod> TilePrefetcher::activeRoute() const
+{
+    std::vector<SGGeod> route;
+    auto routeMgr = globals->get_subsystem<FGRouteMgr>();
+    if (!routeMgr || !routeMgr->isRouteActive()) {
+        return route;
+    }
+
+    FlightPlanRef fp = routeMgr->flightPlan();
+    if (!fp) {
+        return route;
+    }
+
+    for (int i = std::max(0, routeMgr->currentIndex()); i < fp->numLegs(); ++i) {
+        Waypt* wpt = fp->legAtIndex(i)->waypoint();
+        // dynamic waypoints (vectors, headings to altitude) have no fixed position
+        if (!wpt || wpt->flag(WPT_DYNAMIC)) {
+            continue;
+        }
+        const SGGeod p = wpt->position();
+        if (p.isValid()) {
+            route.push_back(p);
+        }
+    }
+    return route;
+}
+
+} // namespace flightgear
@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileName: TilePrefetcher.hxx
+ * SPDX-FileComment: request the tiles ahead of the aircraft before they are in view range
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <simgear/bucket/newbucket.hxx>
+#include <simgear/math/SGMath.hxx>
+#include <simgear/props/props.hxx>
+
+namespace simgear
+{
+class SGTerraSync;
+}
+
+namespace flightgear
+{
+
+/**
+ * FGTileMgr only schedules the tiles in view range around the current
+ * bucket, so fast aircraft reach tiles which are still loading. The
+ * prefetcher projects where the aircraft will be - along the active
+ * route manager flight plan, or else along the current track - and
+ * requests the tiles on the way, by time to reach them, and the
+ * TerraSync directories further ahead.
+ *
+ * Configured and reported under /sim/tile-prefetch:
+ *  - enabled, lookahead-sec, terrasync-lookahead-sec, min-speed-kt
+ *  - stats/hits: prefetched tiles which were loaded when needed
+ *  - stats/late: prefetched tiles which were still loading when needed
+ *  - stats/misses: tiles not prefetched and not loaded when needed
+ */
+class TilePrefetcher
+{
+public:
+    /// request a tile with a priority for the given time, returns true if loaded
+    using ScheduleTile = std::function<bool(const SGBucket&, double priority, double duration)>;
+
+    /// a point on the projected path
+    struct PathPoint {
+        SGGeod position;
+        double distanceM;
+    };
+
+    TilePrefetcher();
+
+    void init();
+    void reset();
+
+    void update(double dt, const SGGeod& aircraftPos, const ScheduleTile& scheduleTile,
+                simgear::SGTerraSync* terraSync);
+
+    /**
+     * The tile manager needs b for the current view now: counts whether
+     * it was prefetched and loaded in time. Each bucket counts once.
+     */
+    void tileNeeded(const SGBucket& b, bool loaded);
+
+    /**
+     * Points every stepM along the path starting at pos, up to
+     * rangeM: through the route points in order if there are any,
+     * else along trackDeg.
+     */
+    static std::vector<PathPoint> projectPath(const SGGeod& pos, double trackDeg,
+                                              const std::vector<SGGeod>& route,
+                                              double rangeM, double stepM);
+
+private:
+    /// the remaining waypoints of the active flight plan
+    std::vector<SGGeod> activeRoute() const;
+
+    SGPropertyNode_ptr _enabled, _lookahead, _syncLookahead, _minSpeed;
+    SGPropertyNode_ptr _groundSpeed, _track;
+    SGPropertyNode_ptr _scheduledTiles, _scheduledDirs, _hits, _late, _misses;
+
+    double _sinceUpdate = 0.0;
+    double _time = 0.0;
+
+    std::map<long, double> _prefetched;    ///< bucket index to expiry time
+    std::unordered_set<long> _counted;     ///< buckets counted by tileNeeded()
+    std::set<std::string> _syncedDirs;     ///< TerraSync directories requested
+};
+
+} // namespace flightgear
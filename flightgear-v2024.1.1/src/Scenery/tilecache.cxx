@@ -24,6 +24,9 @@
 #  include <config.h>
 #endif
 
+#include <algorithm>
+#include <vector>
+
 #include <simgear/bucket/newbucket.hxx>
 #include <simgear/debug/logstream.hxx>
 #include <simgear/misc/sg_path.hxx>
@@ -31,6 +34,13 @@
 #include "tileentry.hxx"
 #include "tilecache.hxx"
 
+namespace {
+
+// paged children keep loading into a tile, so estimates get stale
+const double MEMORY_ESTIMATE_INTERVAL = 10.0;
+
+} // of anonymous namespace
+
 TileCache::TileCache( void ) :
     max_cache_size(100), current_time(0.0)
 {
@@ -152,6 +162,59 @@ long TileCache::get_first_expired_tile() const
 }
 
 
+long TileCache::get_evict_tile(const SGVec3d& view_pos, double distance_weight) const
+{
+    long max_index = -1;
+    double max_score = -DBL_MAX;
+
+    for (const auto& it : tile_cache) {
+        const TileEntry* e = it.second;
+        // unloaded tiles hold no memory, and tiles still needed would be
+        // loaded again right away
+        if (!e->is_loaded() || e->is_current_view() || !e->is_expired(current_time)) {
+            continue;
+        }
+
+        const SGVec3d center = SGVec3d::fromGeod(e->get_tile_bucket().get_center());
+        const double score = (current_time - e->get_time_used()) +
+                             distance_weight * dist(center, view_pos) * 0.001;
+        if (score > max_score) {
+            max_score = score;
+            max_index = it.first;
+        }
+    }
+
+    return max_index;
+}
+
+void TileCache::update_memory(int max_tiles)
+{
+    std::vector<TileEntry*> stale;
+    for (const auto& it : tile_cache) {
+        TileEntry* e = it.second;
+        if (e->is_loaded() && (e->get_time_estimated() < current_time - MEMORY_ESTIMATE_INTERVAL)) {
+            stale.push_back(e);
+        }
+    }
+
+    const size_t count = std::min(stale.size(), static_cast<size_t>(std::max(max_tiles, 0)));
+    std::partial_sort(stale.begin(), stale.begin() + count, stale.end(),
+                      [](const TileEntry* a, const TileEntry* b) {
+                          return a->get_time_estimated() < b->get_time_estimated();
+                      });
+    for (size_t i = 0; i < count; ++i) {
+        stale[i]->estimate_memory(current_time);
+    }
+
+    memory = TileMemory();
+    for (const auto& it : tile_cache) {
+        const TileMemory& m = it.second->get_memory();
+        memory.geometry += m.geometry;
+        memory.textures += m.textures;
+        memory.randomObjects += m.randomObjects;
+    }
+}
+
 // Clear all flags indicating tiles belonging to the current view
 void TileCache::clear_current_view()
 {
@@ -164,6 +227,7 @@ void TileCache::clear_current_view()
         {
             // update expiry time for tiles belonging to most recent position
             e->update_time_expired( current_time );
+            e->update_time_used( current_time );
             e->set_current_view( false );
         }
     }
@@ -234,6 +298,8 @@ void TileCache::request_tile(TileEntry* t,float priority,bool current_view,doubl
         t->set_priority( priority );
     }
 
+    t->update_time_used( current_time );
+
     if (current_view)
     {
         t->update_time_expired( current_time + request_time );
@@ -26,6 +26,7 @@
 #include <map>
 
 #include <simgear/bucket/newbucket.hxx>
+#include <simgear/math/SGMath.hxx>
 #include "tileentry.hxx"
 
 
@@ -47,6 +48,9 @@ private:
 
     double current_time;
 
+    // sum of the last memory estimates of all tiles
+    TileMemory memory;
+
     // Free a tile cache entry
     void entry_free( long cache_index );
 
@@ -74,6 +78,16 @@ public:
     long get_drop_tile();
   
     long get_first_expired_tile() const;
+
+    // Return the index of the loaded, expired tile to evict first when
+    // over the memory budget, or -1: the least recently used, with
+    // distance from view_pos counting as distance_weight seconds per km.
+    long get_evict_tile(const SGVec3d& view_pos, double distance_weight) const;
+
+    // Re-estimate the memory of up to max_tiles loaded tiles, those
+    // never estimated or estimated longest ago first, and update the sum.
+    void update_memory(int max_tiles);
+    inline const TileMemory& get_memory() const { return memory; }
   
     // Clear all flags indicating tiles belonging to the current view
     void clear_current_view();
@@ -28,23 +28,116 @@
 #include <sstream>
 #include <istream>
 
+#include <unordered_set>
+
+#include <osg/Geometry>
 #include <osg/LOD>
+#include <osg/NodeVisitor>
+#include <osg/Texture>
 
 #include <simgear/bucket/newbucket.hxx>
 #include <simgear/debug/logstream.hxx>
+#include <simgear/misc/strutils.hxx>
 #include <simgear/scene/tgdb/SGOceanTile.hxx>
 
 #include "tileentry.hxx"
 
 using std::string;
 
+namespace {
+
+// the random objects generated for a tile, see SGTileDetailsCallback
+bool isRandomObjects(const osg::Node& node)
+{
+    const std::string& name = node.getName();
+    return simgear::strutils::starts_with(name, "Random ") ||
+           (name == "rotateBuildings") || (name == "rotateTrees");
+}
+
+class MemoryEstimateVisitor : public osg::NodeVisitor
+{
+public:
+    MemoryEstimateVisitor() :
+        osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN)
+    {
+    }
+
+    void apply(osg::Node& node) override
+    {
+        const bool wasRandom = _inRandom;
+        _inRandom = _inRandom || isRandomObjects(node);
+        addStateSet(node.getStateSet());
+        traverse(node);
+        _inRandom = wasRandom;
+    }
+
+    void apply(osg::Geometry& geom) override
+    {
+        addStateSet(geom.getStateSet());
+        add(geom.getVertexArray(), false);
+        add(geom.getNormalArray(), false);
+        add(geom.getColorArray(), false);
+        add(geom.getSecondaryColorArray(), false);
+        add(geom.getFogCoordArray(), false);
+        for (const auto& array : geom.getTexCoordArrayList()) {
+            add(array.get(), false);
+        }
+        for (const auto& array : geom.getVertexAttribArrayList()) {
+            add(array.get(), false);
+        }
+        for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); ++i) {
+            add(geom.getPrimitiveSet(i), false);
+        }
+    }
+
+    TileMemory memory;
+
+private:
+    void add(const osg::BufferData* data, bool texture)
+    {
+        if (!data || !_seen.insert(data).second) {
+            return;
+        }
+
+        size_t& bytes = _inRandom ? memory.randomObjects :
+                        (texture ? memory.textures : memory.geometry);
+        bytes += data->getTotalDataSize();
+    }
+
+    void addStateSet(const osg::StateSet* stateSet)
+    {
+        if (!stateSet || !_seen.insert(stateSet).second) {
+            return;
+        }
+
+        const unsigned int units = stateSet->getTextureAttributeList().size();
+        for (unsigned int unit = 0; unit < units; ++unit) {
+            auto texture = dynamic_cast<const osg::Texture*>(
+                stateSet->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+            if (!texture) {
+                continue;
+            }
+            for (unsigned int i = 0; i < texture->getNumImages(); ++i) {
+                add(texture->getImage(i), true);
+            }
+        }
+    }
+
+    bool _inRandom = false;
+    std::unordered_set<const osg::Referenced*> _seen;
+};
+
+} // of anonymous namespace
+
 // Base constructor
 TileEntry::TileEntry ( const SGBucket& b )
     : tile_bucket( b ),
       _node( new osg::LOD ),
       _priority(-FLT_MAX),
       _current_view(false),
-      _time_expired(-1.0)
+      _time_expired(-1.0),
+      _time_used(-1.0),
+      _time_estimated(-1.0)
 {
     _create_orthophoto();
     
@@ -60,7 +153,9 @@ TileEntry::TileEntry( const TileEntry& t )
   _node( new osg::LOD ),
   _priority(t._priority),
   _current_view(t._current_view),
-  _time_expired(t._time_expired)
+  _time_expired(t._time_expired),
+  _time_used(t._time_used),
+  _time_estimated(-1.0)
 {
     _create_orthophoto();
 
@@ -97,6 +192,14 @@ void TileEntry::prep_ssg_node(float vis) {
     _node->setRange( 0, 0, vis + bounding_radius );
 }
 
+void TileEntry::estimate_memory(double current_time)
+{
+    MemoryEstimateVisitor visitor;
+    _node->accept(visitor);
+    _memory = visitor.memory;
+    _time_estimated = current_time;
+}
+
 void
 TileEntry::addToSceneGraph(osg::Group *terrain_branch)
 {
@@ -47,6 +47,20 @@
 #include <osg/Group>
 #include <osg/LOD>
 
+/**
+ * Estimated memory held by the scene graph of a tile, in bytes. Arrays,
+ * primitive sets and images shared inside the tile are counted once;
+ * textures owned by the material effects are shared between all tiles
+ * and not counted.
+ */
+struct TileMemory {
+    size_t geometry = 0;      ///< vertex arrays and primitive sets
+    size_t textures = 0;      ///< images of textures attached to the tile
+    size_t randomObjects = 0; ///< random objects, buildings and trees
+
+    size_t total() const { return geometry + textures + randomObjects; }
+};
+
 /**
  * A class to encapsulate everything we need to know about a scenery tile.
  */
@@ -79,6 +93,12 @@ private:
     bool _current_view;
     /** Time when tile expires. */
     double _time_expired;
+    /** Time when tile was last requested or in the current view. */
+    double _time_used;
+
+    TileMemory _memory;
+    /** Time of the last memory estimate, negative if never estimated. */
+    double _time_estimated;
 
     void _create_orthophoto();
 
@@ -128,6 +148,17 @@ public:
     inline double get_time_expired() const { return _time_expired; }
     inline void update_time_expired( double time_expired ) { if (_time_expired<time_expired) _time_expired = time_expired; }
 
+    inline double get_time_used() const { return _time_used; }
+    inline void update_time_used( double time_used ) { if (_time_used<time_used) _time_used = time_used; }
+
+    /**
+     * Walk the scene graph of the tile to estimate its memory, including
+     * the paged children loaded so far.
+     */
+    void estimate_memory(double current_time);
+    inline const TileMemory& get_memory() const { return _memory; }
+    inline double get_time_estimated() const { return _time_estimated; }
+
     inline void set_priority(float priority) { _priority=priority; }
     inline float get_priority() const { return _priority; }
     inline void set_current_view(bool current_view) { _current_view = current_view; }
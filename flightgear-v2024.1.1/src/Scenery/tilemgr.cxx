@@ -26,6 +26,7 @@
 #endif
 
 #include <algorithm>
+#include <cstdlib>
 #include <functional>
 
 #include <osgViewer/Viewer>
@@ -34,12 +35,14 @@
 #include <simgear/constants.h>
 #include <simgear/debug/logstream.hxx>
 #include <simgear/structure/exception.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 #include <simgear/scene/model/modellib.hxx>
 #include <simgear/scene/util/SGReaderWriterOptions.hxx>
 #include <simgear/scene/tgdb/VPBTechnique.hxx>
 #include <simgear/scene/tgdb/VPBLineFeatureRenderer.hxx>
 #include <simgear/scene/tsync/terrasync.hxx>
 #include <simgear/misc/strutils.hxx>
+#include <simgear/scene/material/Effect.hxx>
 #include <simgear/scene/material/matlib.hxx>
 
 #include <Main/fg_props.hxx>
@@ -56,6 +59,34 @@
 
 using flightgear::SceneryPager;
 
+namespace {
+
+const double MB = 1024.0 * 1024.0;
+
+// estimating walks the tile scene graphs, spread it over the frames
+const int MEMORY_ESTIMATES_PER_FRAME = 4;
+const double MEMORY_PUBLISH_INTERVAL = 5.0;
+
+// Build the effects listed under /sim/rendering/preload-effects, or the
+// common terrain ones, before the pager threads need them for the first
+// tiles.
+void preloadTerrainEffects(const simgear::SGReaderWriterOptions* options)
+{
+    string_list names;
+    for (auto node : fgGetNode("/sim/rendering/preload-effects", true)->getChildren("effect")) {
+        names.push_back(node->getStringValue());
+    }
+
+    if (names.empty()) {
+        names = {"Effects/terrain-default", "Effects/water", "Effects/runway",
+                 "Effects/model-default"};
+    }
+
+    simgear::preloadEffects(names, options);
+}
+
+} // namespace
+
 class FGTileMgr::TileManagerListener : public SGPropertyChangeListener
 {
 public:
@@ -152,10 +183,22 @@ FGTileMgr::FGTileMgr():
     _disableNasalHooks(fgGetNode("/sim/temp/disable-scenery-nasal", true)),
     _scenery_loaded(fgGetNode("/sim/sceneryloaded", true)),
     _scenery_override(fgGetNode("/sim/sceneryloaded-override", true)),
+    _memoryBudgetMB(fgGetNode("/sim/tile-cache/memory-budget-mb", true)),
+    _distanceWeight(fgGetNode("/sim/tile-cache/distance-weight-sec-per-km", true)),
+    _memoryNode(fgGetNode("/sim/tile-cache/memory", true)),
+    _memoryPublished(-1.0),
+    _memoryEvicted(0),
     _pager(FGScenery::getPagerSingleton()),
     _enableCache(true),
     _use_vpb(false)
 {
+    // 0 means no budget
+    if (!_memoryBudgetMB->hasValue()) {
+        _memoryBudgetMB->setDoubleValue(0.0);
+    }
+    if (!_distanceWeight->hasValue()) {
+        _distanceWeight->setDoubleValue(10.0);
+    }
 }
 
 
@@ -240,6 +283,10 @@ void FGTileMgr::reinit()
     }
     _options->setSceneryPathSuffixes(scenerySuffixes);
 
+    if ((state == Start) && fgGetBool("/sim/rendering/preload-effects/enabled", false)) {
+        preloadTerrainEffects(_options);
+    }
+
     if (state != Start)
     {
       // protect against multiple scenery reloads and properly reset flags,
@@ -259,6 +306,7 @@ void FGTileMgr::reinit()
     osg::Group* group = globals->get_scenery()->get_terrain_branch();
     group->removeChildren(0, group->getNumChildren());
     tile_cache.init();
+    _prefetcher.init();
 
     // clear OSG cache, except on initial start-up
     if (state != Start)
@@ -409,7 +457,12 @@ void FGTileMgr::schedule_needed(const SGBucket& curr_bucket, double vis)
             }
 
             float priority = (-1.0) * (x*x+y*y);
-            sched_tile( b, priority, true, 0.0 );
+            const bool loaded = sched_tile( b, priority, true, 0.0 );
+
+            // the tiles around the viewer are needed right now
+            if ((std::abs(x) <= 1) && (std::abs(y) <= 1)) {
+                _prefetcher.tileNeeded(b, loaded);
+            }
 
             if (terraSync) {
                 terraSync->scheduleTile(b);
@@ -424,6 +477,7 @@ void FGTileMgr::schedule_needed(const SGBucket& curr_bucket, double vis)
  */
 void FGTileMgr::update_queues(bool& isDownloadingScenery)
 {
+    simgear::TraceScope trace("tile", "update queues");
     osg::FrameStamp* framestamp = globals->get_renderer()->getFrameStamp();
     double current_time = framestamp->getReferenceTime();
     double vis = _visibilityMeters->getDoubleValue();
@@ -481,23 +535,7 @@ void FGTileMgr::update_queues(bool& isDownloadingScenery)
                                          tile_cache.get_first_expired_tile();
         while ( drop_index > -1 )
         {
-            // schedule tile for deletion with osg pager
-            TileEntry* old = tile_cache.get_tile(drop_index);
-            SG_LOG(SG_TERRAIN, SG_DEBUG, "Dropping:" << old->get_tile_bucket());
-
-            tile_cache.clear_entry(drop_index);
-
-            if (_use_vpb) {
-                // Clear out any VPB data - e.g. roads
-                simgear::VPBLineFeatureRenderer::unloadFeatures(old->get_tile_bucket());
-            }
-
-            osg::ref_ptr<osg::Object> subgraph = old->getNode();
-            old->removeFromSceneGraph();
-            delete old;
-            // zeros out subgraph ref_ptr, so subgraph is owned by
-            // the pager and will be deleted in the pager thread.
-            _pager->queueDeleteRequest(subgraph);
+            drop_tile(drop_index);
 
             if (!_enableCache)
                 drop_index = tile_cache.get_first_expired_tile();
@@ -508,16 +546,102 @@ void FGTileMgr::update_queues(bool& isDownloadingScenery)
                drop_index = -1;
         }
     } // of dropping tiles loop
+
+    update_memory(current_time);
+}
+
+void FGTileMgr::drop_tile(long index)
+{
+    // schedule tile for deletion with osg pager
+    TileEntry* old = tile_cache.get_tile(index);
+    SG_LOG(SG_TERRAIN, SG_DEBUG, "Dropping:" << old->get_tile_bucket());
+
+    tile_cache.clear_entry(index);
+
+    if (_use_vpb) {
+        // Clear out any VPB data - e.g. roads
+        simgear::VPBLineFeatureRenderer::unloadFeatures(old->get_tile_bucket());
+    }
+
+    osg::ref_ptr<osg::Object> subgraph = old->getNode();
+    old->removeFromSceneGraph();
+    delete old;
+    // zeros out subgraph ref_ptr, so subgraph is owned by
+    // the pager and will be deleted in the pager thread.
+    _pager->queueDeleteRequest(subgraph);
+}
+
+void FGTileMgr::update_memory(double current_time)
+{
+    tile_cache.update_memory(MEMORY_ESTIMATES_PER_FRAME);
+
+    // only tiles nobody needs any more are evicted: a budget smaller than
+    // the tiles in view range is simply exceeded
+    const double budget = _memoryBudgetMB->getDoubleValue() * MB;
+    if (budget > 0.0) {
+        double used = tile_cache.get_memory().total();
+        const SGVec3d viewPos = globals->get_view_position_cart();
+        while (used > budget) {
+            const long index = tile_cache.get_evict_tile(viewPos, _distanceWeight->getDoubleValue());
+            if (index < 0) {
+                break;
+            }
+
+            used -= tile_cache.get_tile(index)->get_memory().total();
+            drop_tile(index);
+            ++_memoryEvicted;
+        }
+    }
+
+    if (current_time < _memoryPublished + MEMORY_PUBLISH_INTERVAL) {
+        return;
+    }
+    _memoryPublished = current_time;
+
+    const TileMemory& total = tile_cache.get_memory();
+    _memoryNode->setDoubleValue("total-mb", total.total() / MB);
+    _memoryNode->setDoubleValue("geometry-mb", total.geometry / MB);
+    _memoryNode->setDoubleValue("textures-mb", total.textures / MB);
+    _memoryNode->setDoubleValue("random-objects-mb", total.randomObjects / MB);
+    _memoryNode->setIntValue("evicted", _memoryEvicted);
+
+    int i = 0;
+    for (auto it = tile_cache.begin(); it != tile_cache.end(); ++it) {
+        const TileEntry* e = it->second;
+        if (!e->is_loaded()) {
+            continue;
+        }
+
+        const TileMemory& m = e->get_memory();
+        SGPropertyNode* tile = _memoryNode->getChild("tile", i++, true);
+        tile->setStringValue("name", e->tileFileName);
+        tile->setBoolValue("current-view", e->is_current_view());
+        tile->setDoubleValue("total-kb", m.total() / 1024.0);
+        tile->setDoubleValue("geometry-kb", m.geometry / 1024.0);
+        tile->setDoubleValue("textures-kb", m.textures / 1024.0);
+        tile->setDoubleValue("random-objects-kb", m.randomObjects / 1024.0);
+    }
+    while (_memoryNode->getChild("tile", i)) {
+        _memoryNode->removeChild("tile", i++);
+    }
 }
 
 // given the current lon/lat (in degrees), fill in the array of local
 // chunks.  If the chunk isn't already in the cache, then read it from
 // disk.
-void FGTileMgr::update(double)
+void FGTileMgr::update(double dt)
 {
     double vis = _visibilityMeters->getDoubleValue();
     schedule_tiles_at(globals->get_view_position(), vis);
 
+    if (state == Running) {
+        _prefetcher.update(dt, globals->get_aircraft_position(),
+                           [this](const SGBucket& b, double priority, double duration) {
+                               return sched_tile(b, priority, false, duration);
+                           },
+                           globals->get_subsystem<simgear::SGTerraSync>());
+    }
+
     bool waitingOnTerrasync = false;
     update_queues(waitingOnTerrasync);
 
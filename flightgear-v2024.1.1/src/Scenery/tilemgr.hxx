@@ -29,6 +29,7 @@
 #include <simgear/bucket/newbucket.hxx>
 #include "SceneryPager.hxx"
 #include "tilecache.hxx"
+#include "TilePrefetcher.hxx"
 
 namespace osg
 {
@@ -72,7 +73,10 @@ private:
      * tile cache
      */
     TileCache tile_cache;
-    
+
+    /// requests the tiles along the projected flight path
+    flightgear::TilePrefetcher _prefetcher;
+
     class TileManagerListener;
     friend class TileManagerListener;
     std::unique_ptr<TileManagerListener> _listener;
@@ -80,12 +84,21 @@ private:
     // update various queues internal queues
     void update_queues(bool& isDownloadingScenery);
 
+    // remove a tile from the cache and the scene graph
+    void drop_tile(long index);
+
+    // drop expired tiles while over the memory budget, publish the totals
+    void update_memory(double current_time);
+
     // schedule tiles for the viewer bucket
     void schedule_tiles_at(const SGGeod& location, double rangeM);
 
     SGPropertyNode_ptr _visibilityMeters;
     SGPropertyNode_ptr _lodDetailed, _lodRoughDelta, _lodBareDelta, _disableNasalHooks;
     SGPropertyNode_ptr _scenery_loaded, _scenery_override;
+    SGPropertyNode_ptr _memoryBudgetMB, _distanceWeight, _memoryNode;
+    double _memoryPublished;
+    int _memoryEvicted;
 
     osg::ref_ptr<flightgear::SceneryPager> _pager;
 
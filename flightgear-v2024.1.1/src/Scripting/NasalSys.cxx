@@ -44,6 +44,7 @@
 #include <simgear/nasal/iolib.h>
 #include <simgear/nasal/nasal.h>
 #include <simgear/props/props.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 #include <simgear/structure/commands.hxx>
 #include <simgear/structure/event_mgr.hxx>
 #include <simgear/io/sg_mmap.hxx>
@@ -155,7 +156,8 @@ public:
   void stop()
   {
     if (_isRunning) {
-      globals->get_event_mgr()->removeTask(_name);
+      globals->get_event_mgr()->removeTask(_handle);
+      _handle.clear();
       _isRunning = false;
     }
   }
@@ -180,11 +182,11 @@ public:
 
     _isRunning = true;
     if (_singleShot) {
-      globals->get_event_mgr()->addEvent(_name, [this](){ this->invoke(); }, _interval, _isSimTime);
+      _handle = globals->get_event_mgr()->addEvent(_name, [this](){ this->invoke(); }, _interval, _isSimTime);
     } else {
-      globals->get_event_mgr()->addTask(_name, [this](){ this->invoke(); },
-                                        _interval, _interval /* delay */,
-                                        _isSimTime);
+      _handle = globals->get_event_mgr()->addTask(_name, [this](){ this->invoke(); },
+                                                  _interval, _interval /* delay */,
+                                                  _isSimTime);
     }
   }
 
@@ -220,6 +222,7 @@ public:
   { return _name; }
 private:
   std::string _name;
+  SGTimerHandle _handle;
   FGNasalSys* _sys;
   naRef _func, _self;
   int _gcRoot, _gcSelf;
@@ -320,6 +323,21 @@ naRef FGNasalSys::callWithContext(naContext ctx, naRef code, int argc, naRef* ar
   return callMethodWithContext(ctx, code, naNil(), argc, args, locals);
 }
 
+// name of a call in the trace recorder, where the function is defined
+static const char* traceNameForCall(naRef code)
+{
+    if (!simgear::TraceRecorder::isEnabled()) {
+        return nullptr;
+    }
+
+    int line;
+    naRef file = naGetFuncSourceFile(code, &line);
+    if (naIsNil(file)) {
+        return "<native>";
+    }
+    return simgear::TraceRecorder::intern(std::string(naStr_data(file)) + ":" + std::to_string(line));
+}
+
 // Does a naCall() in a new context.  Wrapped here to make lock
 // tracking easier.  Extension functions are called with the lock, but
 // we have to release it before making a new naCall().  So rather than
@@ -329,6 +347,7 @@ naRef FGNasalSys::callWithContext(naContext ctx, naRef code, int argc, naRef* ar
 
 naRef FGNasalSys::callMethod(naRef code, naRef self, int argc, naRef* args, naRef locals)
 {
+    simgear::TraceScope trace("nasal", traceNameForCall(code));
     try {
         return naCallMethod(code, self, argc, args, locals);
     } catch (sg_exception& e) {
@@ -339,6 +358,7 @@ naRef FGNasalSys::callMethod(naRef code, naRef self, int argc, naRef* args, naRe
 
 naRef FGNasalSys::callMethodWithContext(naContext ctx, naRef code, naRef self, int argc, naRef* args, naRef locals)
 {
+    simgear::TraceScope trace("nasal", traceNameForCall(code));
     try {
         return naCallMethodCtx(ctx, code, self, argc, args, locals);
     } catch (sg_exception& e) {
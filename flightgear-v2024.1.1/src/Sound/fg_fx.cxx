@@ -208,8 +208,15 @@ FGFX::update (double dt)
         resume();
 
         // update sound effects if not paused
-        for (auto xs : _xmlSounds) {
-            xs->update(dt);
+        _accumulatedDt += dt;
+        if (++_updateCount >= _updateInterval) {
+            for (auto xs : _xmlSounds) {
+                xs->update(_accumulatedDt);
+            }
+            _updateCount = 0;
+            _accumulatedDt = 0.0;
+        } else {
+            ++_skippedUpdates;
         }
 
         SGSampleGroup::update(dt);
@@ -218,4 +225,10 @@ FGFX::update (double dt)
         suspend();
 }
 
+void
+FGFX::setUpdateInterval(unsigned frames)
+{
+    _updateInterval = std::max(1u, frames);
+}
+
 // end of fg_fx.cxx
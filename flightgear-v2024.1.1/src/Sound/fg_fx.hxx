@@ -57,6 +57,14 @@ public:
     void update (double dt) override;
     void shutdown();
 
+    /**
+     * Only update the sound effects every @a frames calls of update(),
+     * with the accumulated time. Used to throttle the sounds of distant
+     * AI models.
+     */
+    void setUpdateInterval(unsigned frames);
+    unsigned getSkippedUpdates() const { return _skippedUpdates; }
+
 private:
 
     bool _active;
@@ -66,6 +74,11 @@ private:
 
     std::vector<SGXmlSoundRef> _xmlSounds;
 
+    unsigned _updateInterval = 1;
+    unsigned _updateCount = 0;
+    unsigned _skippedUpdates = 0;
+    double _accumulatedDt = 0.0;
+
     SGPropertyNode_ptr _props;
     SGPropertyNode_ptr _enabled;
     SGPropertyNode_ptr _volume;
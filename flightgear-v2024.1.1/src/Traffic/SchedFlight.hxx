@@ -89,6 +89,7 @@ public:
   time_t getDepartureTime() { return departureTime; };
   time_t getArrivalTime  () { return arrivalTime;   };
 
+  const std::string& getDepartureAirportId() const { return depId; };
   void setDepartureAirport(const std::string& port) { depId = port; };
   void setArrivalAirport  (const std::string& port) { arrId = port; };
   FGAirport *getDepartureAirport();
@@ -44,6 +44,7 @@
 
 #include <AIModel/AIAircraft.hxx>
 #include <AIModel/AIFlightPlan.hxx>
+#include <AIModel/AIFlightPlanBuilder.hxx>
 #include <AIModel/AIManager.hxx>
 #include <Airports/airport.hxx>
 #include <Main/fg_props.hxx>
@@ -71,7 +72,9 @@ FGAISchedule::FGAISchedule()
       courseToDest(0),
       initialized(false),
       valid(false),
-      scheduleComplete(false)
+      scheduleComplete(false),
+      nextUpdateTime(0),
+      planTicket(0)
 {
 }
 
@@ -109,7 +112,9 @@ FGAISchedule::FGAISchedule(const string& model,
       courseToDest(0),
       initialized(false),
       valid(true),
-      scheduleComplete(false)
+      scheduleComplete(false),
+      nextUpdateTime(0),
+      planTicket(0)
 {
 }
 
@@ -139,6 +144,8 @@ FGAISchedule::FGAISchedule(const FGAISchedule& other) : modelPath{other.modelPat
     initialized = other.initialized;
     valid = other.valid;
     scheduleComplete = other.scheduleComplete;
+    nextUpdateTime = other.nextUpdateTime;
+    planTicket = 0;
 }
 
 
@@ -149,6 +156,14 @@ FGAISchedule::~FGAISchedule()
         aiAircraft->setDie(true);
     }
 
+    if (planTicket) {
+        auto tmgr = globals->get_subsystem<FGTrafficManager>();
+        FGAIFlightPlanBuilder* builder = tmgr ? tmgr->getFlightPlanBuilder() : nullptr;
+        if (builder) {
+            builder->cancel(planTicket);
+        }
+    }
+
     /*  for (FGScheduledFlightVecIterator flt = flights.begin(); flt != flights.end(); flt++)
     {
       delete (*flt);
@@ -195,19 +210,28 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
     time_t deptime = 0;
 
     if (!valid) {
+        nextUpdateTime = 0;
         return true; // processing complete
     }
 
+    if (planTicket) {
+        // waiting for the flight plan, the aircraft is created when it's ready
+        nextUpdateTime = now + TRAFFIC_AI_RECHECK_INTERVAL;
+        return true;
+    }
+
     if (!scheduleComplete) {
         scheduleComplete = scheduleFlights(now);
     }
 
     if (!scheduleComplete) {
+        nextUpdateTime = now;
         return false; // not ready yet, continue processing in next iteration
     }
 
     if (flights.empty()) { // No flights available for this aircraft
         valid = false;
+        nextUpdateTime = 0;
         return true;       // processing complete
     }
 
@@ -235,6 +259,7 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
         if (aiAircraft->getDie()) {
             aiAircraft = NULL;
         } else {
+            nextUpdateTime = now + TRAFFIC_AI_RECHECK_INTERVAL;
             return true; // in visual range, let the AIManager handle it
         }
     }
@@ -248,12 +273,14 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
         // and detach it from the current list of aircraft.
         flight->update();
         flights.erase(flights.begin()); // pop_front(), effectively
+        nextUpdateTime = now;           // look at the next leg right away
         return true;                    // processing complete
     }
 
     FGAirport* dep = flight->getDepartureAirport();
     FGAirport* arr = flight->getArrivalAirport();
     if (!dep || !arr) {
+        nextUpdateTime = now + TRAFFIC_MAX_RECHECK_INTERVAL;
         return true; // processing complete
     }
 
@@ -308,17 +335,35 @@ bool FGAISchedule::update(time_t now, const SGVec3d& userCart)
         SG_LOG(SG_AI, SG_BULK, "Traffic manager: " << registration << " is scheduled for a flight from " << dep->getId() << " to " << arr->getId() << ". Current distance to user: " << distanceToUser);
     }
     if (distanceToUser >= TRAFFIC_TO_AI_DIST_TO_START) {
+        nextUpdateTime = distantRecheckTime(now, flight);
         return true; // out of visual range, for the moment.
     }
 
-    if (!createAIAircraft(flight, speed, deptime, remainingTimeEnroute)) {
-        valid = false;
+    if (!requestAIAircraft(flight, speed, deptime, remainingTimeEnroute)) {
+        nextUpdateTime = now + 1; // too many plans in preparation, try again
+    } else if (!valid) {
+        nextUpdateTime = 0;
+    } else {
+        nextUpdateTime = now + TRAFFIC_AI_RECHECK_INTERVAL;
     }
 
 
     return true; // processing complete
 }
 
+/**
+ * Earliest time a distant aircraft could come into range: the user and
+ * the aircraft can't close the gap faster than TRAFFIC_MAX_CLOSING_SPEED_KTS.
+ * The flight is looked at again once it has arrived in any case.
+ */
+time_t FGAISchedule::distantRecheckTime(time_t now, FGScheduledFlight* flight) const
+{
+    const double gapNm = distanceToUser - TRAFFIC_TO_AI_DIST_TO_START;
+    time_t wait = static_cast<time_t>(gapNm * 3600.0 / TRAFFIC_MAX_CLOSING_SPEED_KTS);
+    SG_CLAMP_RANGE<time_t>(wait, 1, TRAFFIC_MAX_RECHECK_INTERVAL);
+    return std::min(now + wait, std::max(now + 1, flight->getArrivalTime()));
+}
+
 bool FGAISchedule::validModelPath(const std::string& modelPath)
 {
     return (resolveModelPath(modelPath) != SGPath());
@@ -344,7 +389,35 @@ SGPath FGAISchedule::resolveModelPath(const std::string& modelPath)
     return SGPath();
 }
 
-bool FGAISchedule::createAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime)
+bool FGAISchedule::requestAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime)
+{
+    const string flightPlanName = flight->getDepartureAirport()->getId() + "-" + flight->getArrivalAirport()->getId() + ".xml";
+
+    auto tmgr = globals->get_subsystem<FGTrafficManager>();
+    FGAIFlightPlanBuilder* builder = tmgr ? tmgr->getFlightPlanBuilder() : nullptr;
+    if (!builder) {
+        // no traffic manager running, build it right away
+        if (!createAIAircraft(flight, speedKnots, deptime, remainingTime, FGAIFlightPlan::loadFiledPlan(flightPlanName))) {
+            valid = false;
+        }
+        return true;
+    }
+
+    // The schedule doesn't update while the ticket is set, so flight stays
+    // the front of the flights. Pending plans are cancelled before the
+    // schedules are deleted.
+    const std::vector<FGAirport*> airports{flight->getDepartureAirport(), flight->getArrivalAirport()};
+    planTicket = builder->request(flightPlanName, airports, [this, flight, speedKnots, deptime, remainingTime](const SGPropertyNode* filedPlan) {
+        planTicket = 0;
+        if (!createAIAircraft(flight, speedKnots, deptime, remainingTime, filedPlan)) {
+            valid = false;
+        }
+    });
+    return planTicket != 0;
+}
+
+bool FGAISchedule::createAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime,
+                                    const SGPropertyNode* filedPlan)
 {
     //FIXME The position must be set here not in update
     FGAirport* dep = flight->getDepartureAirport();
@@ -366,7 +439,7 @@ bool FGAISchedule::createAIAircraft(FGScheduledFlight* flight, double speedKnots
 
     courseToDest = SGGeodesy::courseDeg(position, arr->geod());
     std::unique_ptr<FGAIFlightPlan> fp(new FGAIFlightPlan(aiAircraft,
-                                                          flightPlanName,
+                                                          filedPlan,
                                                           courseToDest,
                                                           deptime,
                                                           remainingTime,
@@ -573,8 +646,15 @@ FGScheduledFlight* FGAISchedule::findAvailableFlight(const string& currentDestin
 
     auto tmgr = globals->get_subsystem<FGTrafficManager>();
     FGScheduledFlightVecIterator fltBegin, fltEnd;
-    fltBegin = tmgr->getFirstFlight(req);
-    fltEnd = tmgr->getLastFlight(req);
+    if (currentDestination.empty()) {
+        fltBegin = tmgr->getFirstFlight(req);
+        fltEnd = tmgr->getLastFlight(req);
+    } else {
+        // only flights departing where the aircraft is can match
+        FGScheduledFlightVec& departures = tmgr->getDepartures(req, currentDestination);
+        fltBegin = departures.begin();
+        fltEnd = departures.end();
+    }
 
 
     SG_LOG(SG_AI, SG_BULK, "Finding available flight for " << req << " at " << now);
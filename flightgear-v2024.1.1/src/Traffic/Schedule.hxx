@@ -31,6 +31,14 @@
 constexpr double TRAFFIC_TO_AI_DIST_TO_START = 150.0;
 constexpr double TRAFFIC_TO_AI_DIST_TO_DIE = 200.0;
 
+// how often a schedule is looked at while its AI aircraft is alive,
+// and at most while it is distant (seconds)
+constexpr time_t TRAFFIC_AI_RECHECK_INTERVAL = 30;
+constexpr time_t TRAFFIC_MAX_RECHECK_INTERVAL = 600;
+// closing speed of user and traffic assumed when estimating how long a
+// distant schedule can be left alone
+constexpr double TRAFFIC_MAX_CLOSING_SPEED_KTS = 1200.0;
+
 // forward decls
 class FGAIAircraft;
 class FGScheduledFlight;
@@ -66,15 +74,26 @@ private:
     bool initialized;
     bool valid;
     bool scheduleComplete;
+    time_t nextUpdateTime;
+    unsigned planTicket; ///< flight plan being prepared, see requestAIAircraft()
 
     bool scheduleFlights(time_t now);
+    time_t distantRecheckTime(time_t now, FGScheduledFlight* flight) const;
     int groundTimeFromRadius();
 
+    /**
+   * Ask the traffic manager's flight plan builder to prepare the flight
+   * plan, createAIAircraft() is called once it is ready. Returns false if
+   * the builder is busy.
+   */
+    bool requestAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime);
+
     /**
    * Transition this schedule from distant mode to AI mode;
    * create the AIAircraft (and flight plan) and register with the AIManager
    */
-    bool createAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime);
+    bool createAIAircraft(FGScheduledFlight* flight, double speedKnots, time_t deptime, time_t remainingTime,
+                          const SGPropertyNode* filedPlan);
 
     // the aiAircraft associated with us
     SGSharedPtr<FGAIAircraft> aiAircraft;
@@ -103,6 +122,13 @@ public:
     bool update(time_t now, const SGVec3d& userCart);
     bool init();
 
+    /**
+     * The time the last completed update() considers worth looking at the
+     * schedule again, or 0 if the schedule became invalid and can be
+     * dropped.
+     */
+    time_t getNextUpdateTime() const { return nextUpdateTime; }
+
     double getSpeed();
     //void setClosestDistanceToUser();
     bool next(); // forces the schedule to move on to the next flight.
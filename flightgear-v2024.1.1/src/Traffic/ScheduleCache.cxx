@@ -0,0 +1,373 @@
+/*
+ * SPDX-FileName: ScheduleCache.cxx
+ * SPDX-FileComment: Binary cache of parsed traffic schedule files
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "ScheduleCache.hxx"
+
+#include <cstring>
+
+#include <simgear/debug/logstream.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/io/sg_file.hxx>
+#include <simgear/io/sg_mmap.hxx>
+
+namespace {
+
+const char CACHE_MAGIC[4] = {'F', 'G', 'T', 'S'};
+// bump when the record layout or the parser semantics change
+const uint32_t CACHE_VERSION = 1;
+
+// Appends values to a buffer in host byte order: the cache lives in
+// FG_HOME and is only ever read back on the machine which wrote it.
+class Writer
+{
+public:
+    template <typename T>
+    void put(T value)
+    {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        _buffer.append(bytes, sizeof(T));
+    }
+
+    void putString(const std::string& s)
+    {
+        put<uint32_t>(s.size());
+        _buffer.append(s);
+    }
+
+    const std::string& buffer() const { return _buffer; }
+
+private:
+    std::string _buffer;
+};
+
+// Reads values back from the mapped file. Any read past the end marks the
+// reader as failed, the caller then throws everything away.
+class Reader
+{
+public:
+    Reader(const char* data, size_t size) : _pos(data), _end(data + size) {}
+
+    template <typename T>
+    T get()
+    {
+        T value{};
+        if (!need(sizeof(T))) {
+            return value;
+        }
+        std::memcpy(&value, _pos, sizeof(T));
+        _pos += sizeof(T);
+        return value;
+    }
+
+    std::string getString()
+    {
+        const uint32_t len = get<uint32_t>();
+        if (!need(len)) {
+            return {};
+        }
+        std::string s(_pos, len);
+        _pos += len;
+        return s;
+    }
+
+    void fail() { _failed = true; }
+    bool failed() const { return _failed; }
+    bool atEnd() const { return _pos == _end; }
+
+private:
+    bool need(size_t n)
+    {
+        if (_failed || (static_cast<size_t>(_end - _pos) < n)) {
+            _failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    const char* _pos;
+    const char* _end;
+    bool _failed = false;
+};
+
+} // of anonymous namespace
+
+void FGTrafficScheduleCache::Entry::add(const AircraftRecord& rec)
+{
+    order.push_back(AIRCRAFT);
+    aircraft.push_back(rec);
+}
+
+void FGTrafficScheduleCache::Entry::add(const FlightRecord& rec)
+{
+    order.push_back(FLIGHT);
+    flights.push_back(rec);
+}
+
+FGTrafficScheduleCache::FGTrafficScheduleCache(const SGPath& cacheFile) : _cacheFile(cacheFile)
+{
+}
+
+bool FGTrafficScheduleCache::load()
+{
+    _entries.clear();
+    _modified = false;
+
+    if (!SGPath::fromUtf8(_cacheFile.utf8Str()).exists()) {
+        return false;
+    }
+
+    SGMMapFile mapped(_cacheFile);
+    if (!mapped.open(SG_IO_IN)) {
+        SG_LOG(SG_AI, SG_WARN, "Traffic schedule cache: failed to open " << _cacheFile);
+        return false;
+    }
+
+    Reader r(mapped.get(), mapped.get_size());
+    char magic[sizeof(CACHE_MAGIC)];
+    for (auto& c : magic) {
+        c = r.get<char>();
+    }
+    if (std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) || (r.get<uint32_t>() != CACHE_VERSION)) {
+        SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: ignoring outdated " << _cacheFile);
+        return false;
+    }
+
+    const uint32_t numEntries = r.get<uint32_t>();
+    for (uint32_t e = 0; (e < numEntries) && !r.failed(); ++e) {
+        Entry entry;
+        const uint32_t numFiles = r.get<uint32_t>();
+        for (uint32_t i = 0; (i < numFiles) && !r.failed(); ++i) {
+            FileStamp stamp;
+            stamp.path = r.getString();
+            stamp.modTime = static_cast<time_t>(r.get<int64_t>());
+            stamp.size = r.get<uint64_t>();
+            stamp.hash = r.getString();
+            entry.files.push_back(std::move(stamp));
+        }
+
+        const uint32_t numRecords = r.get<uint32_t>();
+        for (uint32_t i = 0; (i < numRecords) && !r.failed(); ++i) {
+            const auto kind = r.get<uint8_t>();
+            if (kind == Entry::AIRCRAFT) {
+                AircraftRecord rec;
+                rec.model = r.getString();
+                rec.livery = r.getString();
+                rec.homePort = r.getString();
+                rec.registration = r.getString();
+                rec.requiredAircraft = r.getString();
+                rec.acType = r.getString();
+                rec.airline = r.getString();
+                rec.perfClass = r.getString();
+                rec.flightType = r.getString();
+                rec.radius = r.get<double>();
+                rec.offset = r.get<double>();
+                rec.heavy = r.get<uint8_t>() != 0;
+                entry.add(rec);
+            } else if (kind == Entry::FLIGHT) {
+                FlightRecord rec;
+                rec.callsign = r.getString();
+                rec.fltRules = r.getString();
+                rec.departurePort = r.getString();
+                rec.arrivalPort = r.getString();
+                rec.departureTime = r.getString();
+                rec.arrivalTime = r.getString();
+                rec.repeat = r.getString();
+                rec.requiredAircraft = r.getString();
+                rec.cruiseAlt = r.get<int32_t>();
+                entry.add(rec);
+            } else {
+                r.fail(); // unknown record kind
+                break;
+            }
+        }
+
+        if (entry.files.empty()) {
+            break;
+        }
+        const std::string key = entry.files.front().path;
+        _entries[key] = std::move(entry);
+    }
+
+    if (r.failed() || !r.atEnd()) {
+        SG_LOG(SG_AI, SG_WARN, "Traffic schedule cache: " << _cacheFile << " is damaged, discarding it");
+        _entries.clear();
+        return false;
+    }
+
+    SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: loaded " << _entries.size() << " files from " << _cacheFile);
+    return true;
+}
+
+bool FGTrafficScheduleCache::save()
+{
+    // drop the entries of files which have disappeared
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        if (!it->second.used) {
+            it = _entries.erase(it);
+            _modified = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (!_modified) {
+        return true;
+    }
+
+    Writer w;
+    for (char c : CACHE_MAGIC) {
+        w.put<char>(c);
+    }
+    w.put<uint32_t>(CACHE_VERSION);
+    w.put<uint32_t>(_entries.size());
+    for (const auto& it : _entries) {
+        const Entry& entry = it.second;
+        w.put<uint32_t>(entry.files.size());
+        for (const auto& stamp : entry.files) {
+            w.putString(stamp.path);
+            w.put<int64_t>(stamp.modTime);
+            w.put<uint64_t>(stamp.size);
+            w.putString(stamp.hash);
+        }
+
+        w.put<uint32_t>(entry.order.size());
+        auto ac = entry.aircraft.begin();
+        auto flt = entry.flights.begin();
+        for (auto kind : entry.order) {
+            w.put<uint8_t>(kind);
+            if (kind == Entry::AIRCRAFT) {
+                const AircraftRecord& rec = *ac++;
+                w.putString(rec.model);
+                w.putString(rec.livery);
+                w.putString(rec.homePort);
+                w.putString(rec.registration);
+                w.putString(rec.requiredAircraft);
+                w.putString(rec.acType);
+                w.putString(rec.airline);
+                w.putString(rec.perfClass);
+                w.putString(rec.flightType);
+                w.put<double>(rec.radius);
+                w.put<double>(rec.offset);
+                w.put<uint8_t>(rec.heavy ? 1 : 0);
+            } else {
+                const FlightRecord& rec = *flt++;
+                w.putString(rec.callsign);
+                w.putString(rec.fltRules);
+                w.putString(rec.departurePort);
+                w.putString(rec.arrivalPort);
+                w.putString(rec.departureTime);
+                w.putString(rec.arrivalTime);
+                w.putString(rec.repeat);
+                w.putString(rec.requiredAircraft);
+                w.put<int32_t>(rec.cruiseAlt);
+            }
+        }
+    }
+
+    // write a temporary file and move it into place, so a crash or a
+    // second instance never sees a half-written cache
+    SGPath tmpFile(_cacheFile.utf8Str() + ".tmp");
+    tmpFile.create_dir(0755);
+    {
+        sg_ofstream out(tmpFile, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(w.buffer().data(), w.buffer().size());
+        if (!out) {
+            SG_LOG(SG_AI, SG_WARN, "Traffic schedule cache: failed to write " << tmpFile);
+            return false;
+        }
+    }
+
+    // SGPath caches the stat() results, look at the written file afresh
+    if (!SGPath::fromUtf8(tmpFile.utf8Str()).rename(_cacheFile)) {
+        SG_LOG(SG_AI, SG_WARN, "Traffic schedule cache: failed to replace " << _cacheFile);
+        return false;
+    }
+
+    _modified = false;
+    SG_LOG(SG_AI, SG_INFO, "Traffic schedule cache: saved " << _entries.size() << " files to " << _cacheFile);
+    return true;
+}
+
+const FGTrafficScheduleCache::Entry* FGTrafficScheduleCache::lookup(const SGPath& file)
+{
+    auto it = _entries.find(file.utf8Str());
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+
+    Entry& entry = it->second;
+    for (auto& stamp : entry.files) {
+        bool restamped = false;
+        if (!isCurrent(stamp, restamped)) {
+            SG_LOG(SG_AI, SG_DEBUG, "Traffic schedule cache: " << stamp.path << " changed");
+            _entries.erase(it);
+            _modified = true;
+            return nullptr;
+        }
+        _modified |= restamped;
+    }
+
+    entry.used = true;
+    return &entry;
+}
+
+FGTrafficScheduleCache::Entry& FGTrafficScheduleCache::beginEntry(const SGPath& file)
+{
+    Entry& entry = _entries[file.utf8Str()];
+    entry = Entry();
+    entry.files.push_back(stampFile(file));
+    entry.used = true;
+    _modified = true;
+    return entry;
+}
+
+void FGTrafficScheduleCache::addDependency(Entry& entry, const SGPath& file)
+{
+    entry.files.push_back(stampFile(file));
+}
+
+void FGTrafficScheduleCache::discard(const SGPath& file)
+{
+    if (_entries.erase(file.utf8Str())) {
+        _modified = true;
+    }
+}
+
+FGTrafficScheduleCache::FileStamp FGTrafficScheduleCache::stampFile(const SGPath& file)
+{
+    FileStamp stamp;
+    stamp.path = file.utf8Str();
+    stamp.modTime = file.modTime();
+    stamp.size = file.sizeInBytes();
+    stamp.hash = SGFile(file).computeHash();
+    return stamp;
+}
+
+bool FGTrafficScheduleCache::isCurrent(FileStamp& stamp, bool& restamped)
+{
+    const SGPath path = SGPath::fromUtf8(stamp.path);
+    if (!path.exists()) {
+        return false;
+    }
+
+    if ((path.modTime() == stamp.modTime) && (path.sizeInBytes() == stamp.size)) {
+        return true;
+    }
+
+    // touched but maybe not modified (e.g. by TerraSync): compare contents
+    const std::string hash = SGFile(path).computeHash();
+    if (hash.empty() || (hash != stamp.hash)) {
+        return false;
+    }
+
+    stamp.modTime = path.modTime();
+    stamp.size = path.sizeInBytes();
+    restamped = true;
+    return true;
+}
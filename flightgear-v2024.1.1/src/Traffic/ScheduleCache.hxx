@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileName: ScheduleCache.hxx
+ * SPDX-FileComment: Binary cache of parsed traffic schedule files
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <simgear/misc/sg_path.hxx>
+
+/**
+ * Keeps the aircraft and flights parsed from each traffic XML file, so
+ * that unchanged files don't have to be parsed again on the next launch.
+ *
+ * A file is considered unchanged if its modification time and size match
+ * the values recorded when it was parsed, or failing that, if its SHA-1
+ * still matches (as NavDataCache does with its stat_cache table). Files
+ * pulled in with include="..." are recorded as dependencies of the file
+ * including them.
+ *
+ * The records are stored before any of the per-launch processing (model
+ * checks, random thinning, numbering of anonymous aircraft), so replaying
+ * them gives the same result as parsing the file again.
+ *
+ * The whole cache is a single file which is memory mapped on load and
+ * rewritten on save if anything changed.
+ */
+class FGTrafficScheduleCache
+{
+public:
+    struct AircraftRecord {
+        std::string model, livery, homePort, registration, requiredAircraft,
+            acType, airline, perfClass, flightType;
+        double radius = 0.0;
+        double offset = 0.0;
+        bool heavy = false;
+    };
+
+    struct FlightRecord {
+        std::string callsign, fltRules, departurePort, arrivalPort,
+            departureTime, arrivalTime, repeat, requiredAircraft;
+        int cruiseAlt = 0;
+    };
+
+    struct FileStamp {
+        std::string path;
+        time_t modTime = 0;
+        uint64_t size = 0;
+        std::string hash;
+    };
+
+    /// everything parsed from one traffic file, in file order
+    struct Entry {
+        enum RecordKind : uint8_t {
+            AIRCRAFT,
+            FLIGHT
+        };
+
+        std::vector<FileStamp> files;
+        std::vector<RecordKind> order;
+        std::vector<AircraftRecord> aircraft;
+        std::vector<FlightRecord> flights;
+        bool used = false;
+
+        void add(const AircraftRecord& rec);
+        void add(const FlightRecord& rec);
+    };
+
+    explicit FGTrafficScheduleCache(const SGPath& cacheFile);
+
+    /**
+     * Read the cache file. A missing, outdated or damaged file leaves the
+     * cache empty.
+     */
+    bool load();
+
+    /**
+     * Write the entries looked up or added since load() back, dropping
+     * the ones for files which were not seen in this run.
+     */
+    bool save();
+
+    /**
+     * The entry of a traffic file if neither it nor any of its includes
+     * changed, else nullptr.
+     */
+    const Entry* lookup(const SGPath& file);
+
+    /**
+     * Start a new entry for a file about to be parsed, replacing any
+     * existing one.
+     */
+    Entry& beginEntry(const SGPath& file);
+
+    /// note that the entry's contents also depend on another file
+    static void addDependency(Entry& entry, const SGPath& file);
+
+    /// forget the entry of a file which failed to parse
+    void discard(const SGPath& file);
+
+    size_t size() const { return _entries.size(); }
+
+private:
+    static FileStamp stampFile(const SGPath& file);
+    static bool isCurrent(FileStamp& stamp, bool& restamped);
+
+    SGPath _cacheFile;
+    std::map<std::string, Entry> _entries;
+    bool _modified = false;
+};
@@ -62,12 +62,14 @@
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/threads/SGThread.hxx>
 #include <simgear/timing/sg_time.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include <simgear/xml/easyxml.hxx>
 #include <simgear/scene/tsync/terrasync.hxx>
 
 #include <AIModel/AIAircraft.hxx>
 #include <AIModel/AIFlightPlan.hxx>
+#include <AIModel/AIFlightPlanBuilder.hxx>
 #include <AIModel/AIBase.hxx>
 #include <AIModel/performancedb.hxx>
 
@@ -77,6 +79,7 @@
 #include <Main/fg_props.hxx>
 #include <Main/sentryIntegration.hxx>
 
+#include "ScheduleCache.hxx"
 #include "TrafficMgr.hxx"
 
 using std::sort;
@@ -95,6 +98,8 @@ public:
     _trafficManager(traffic),
     _isFinished(false),
     _cancelThread(false),
+    _cache(nullptr),
+    _cacheEntry(nullptr),
     cruiseAlt(0),
     score(0),
     acCounter(0),
@@ -123,6 +128,12 @@ public:
     _trafficDirPaths = dirs;
   }
 
+  /// file keeping the parsed schedules between runs, none if empty
+  void setCacheFile(const SGPath& path)
+  {
+    _cacheFile = path;
+  }
+
   bool isFinished() const
   {
     std::lock_guard<std::mutex> g(_lock);
@@ -131,13 +142,26 @@ public:
 
   void run() override
   {
+      std::unique_ptr<FGTrafficScheduleCache> cache;
+      if (!_cacheFile.isNull()) {
+          cache.reset(new FGTrafficScheduleCache(_cacheFile));
+          cache->load();
+          _cache = cache.get();
+      }
+
       for (const auto& p : _trafficDirPaths) {
           parseTrafficDir(p);
           if (_cancelThread) {
+              _cache = nullptr;
               return;
           }
       }
 
+      if (_cache) {
+          _cache->save();
+          _cache = nullptr;
+      }
+
     std::lock_guard<std::mutex> g(_lock);
     _isFinished = true;
   }
@@ -168,6 +192,9 @@ public:
             SGPath path = globals->get_fg_root();
             path.append("/Traffic/");
             path.append(attval);
+            if (_cacheEntry) {
+                FGTrafficScheduleCache::addDependency(*_cacheEntry, path);
+            }
             readXML(path, *this);
         }
         elementValueStack.push_back("");
@@ -244,39 +271,20 @@ public:
             //                                arrivalTime,
             //                                repeat));
 
-            if (requiredAircraft == "") {
-                char buffer[16];
-                snprintf(buffer, 16, "%d", acCounter);
-                requiredAircraft = buffer;
-            }
-            SG_LOG(SG_AI, SG_BULK, "Adding flight: " << callsign << " "
-                   << fltrules << " "
-                   << departurePort << " "
-                   << arrivalPort << " "
-                   << cruiseAlt << " "
-                   << departureTime << " "
-                   << arrivalTime << " " << repeat << " " << requiredAircraft);
-            // For database maintenance purposes, it may be convenient to
-            //
-            if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
-                SG_LOG(SG_AI, SG_ALERT, "Traffic Dump FLIGHT," << callsign << ","
-                       << fltrules << ","
-                       << departurePort << ","
-                       << arrivalPort << ","
-                       << cruiseAlt << ","
-                       << departureTime << ","
-                       << arrivalTime << "," << repeat << "," << requiredAircraft);
+            FGTrafficScheduleCache::FlightRecord rec;
+            rec.callsign = callsign;
+            rec.fltRules = fltrules;
+            rec.departurePort = departurePort;
+            rec.arrivalPort = arrivalPort;
+            rec.cruiseAlt = cruiseAlt;
+            rec.departureTime = departureTime;
+            rec.arrivalTime = arrivalTime;
+            rec.repeat = repeat;
+            rec.requiredAircraft = requiredAircraft;
+            if (_cacheEntry) {
+                _cacheEntry->add(rec);
             }
-
-            _trafficManager->flights[requiredAircraft].push_back(new FGScheduledFlight(callsign,
-                                                                      fltrules,
-                                                                      departurePort,
-                                                                      arrivalPort,
-                                                                      cruiseAlt,
-                                                                      departureTime,
-                                                                      arrivalTime,
-                                                                      repeat,
-                                                                      requiredAircraft));
+            addFlight(rec);
             requiredAircraft = "";
         } else if (!strcmp(name, "aircraft")) {
             endAircraft();
@@ -313,18 +321,44 @@ public:
 private:
     void endAircraft()
     {
-        string isHeavy = heavy ? "true" : "false";
+        FGTrafficScheduleCache::AircraftRecord rec;
+        rec.model = mdl;
+        rec.livery = livery;
+        // an aircraft without home port is based where its last flight left
+        rec.homePort = homePort.empty() ? departurePort : homePort;
+        rec.registration = registration;
+        rec.requiredAircraft = requiredAircraft;
+        rec.heavy = heavy;
+        rec.acType = acType;
+        rec.airline = airline;
+        rec.perfClass = m_class;
+        rec.flightType = flighttype;
+        rec.radius = radius;
+        rec.offset = offset;
+        if (_cacheEntry) {
+            _cacheEntry->add(rec);
+        }
+        addAircraft(rec);
+
+        requiredAircraft = "";
+        homePort = "";
+        score = 0;
+    }
+
+    // Everything from here on must not depend on the parser state, records
+    // may come from the cache as well.
+    void addAircraft(const FGTrafficScheduleCache::AircraftRecord& rec)
+    {
+        string isHeavy = rec.heavy ? "true" : "false";
 
-        if (missingModels.find(mdl) != missingModels.end()) {
+        if (missingModels.find(rec.model) != missingModels.end()) {
             // don't stat() or warn again
-            requiredAircraft = homePort = "";
             return;
         }
 
-        if (!FGAISchedule::validModelPath(mdl)) {
-            missingModels.insert(mdl);
-            simgear::reportFailure(simgear::LoadFailure::NotFound, simgear::ErrorCode::AITrafficSchedule, "Missing traffic model path:" + mdl, _currentFile);
-            requiredAircraft = homePort = "";
+        if (!FGAISchedule::validModelPath(rec.model)) {
+            missingModels.insert(rec.model);
+            simgear::reportFailure(simgear::LoadFailure::NotFound, simgear::ErrorCode::AITrafficSchedule, "Missing traffic model path:" + rec.model, _currentFile);
             return;
         }
 
@@ -332,44 +366,89 @@ private:
         (int) (fgGetDouble("/sim/traffic-manager/proportion") * 100);
         int randval = rand() & 100;
         if (randval > proportion) {
-            requiredAircraft = homePort = "";
             return;
         }
 
         if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
-            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump AC," << homePort << "," << registration << "," << requiredAircraft
-                   << "," << acType << "," << livery << ","
-                   << airline << ","  << m_class << "," << offset << "," << radius << "," << flighttype << "," << isHeavy << "," << mdl);
+            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump AC," << rec.homePort << "," << rec.registration << "," << rec.requiredAircraft
+                   << "," << rec.acType << "," << rec.livery << ","
+                   << rec.airline << ","  << rec.perfClass << "," << rec.offset << "," << rec.radius << "," << rec.flightType << "," << isHeavy << "," << rec.model);
         }
 
-        if (requiredAircraft == "") {
+        string required = rec.requiredAircraft;
+        if (required == "") {
             char buffer[16];
             snprintf(buffer, 16, "%d", acCounter);
-            requiredAircraft = buffer;
-        }
-        if (homePort == "") {
-            homePort = departurePort;
+            required = buffer;
         }
 
         // caution, modifying the scheduled aircraft structure from the
         // 'wrong' thread. This is safe because FGTrafficManager won't touch
         // the structure while we exist.
-        _trafficManager->scheduledAircraft.push_back(new FGAISchedule(mdl,
-                                                     livery,
-                                                     homePort,
-                                                     registration,
-                                                     requiredAircraft,
-                                                     heavy,
-                                                     acType,
-                                                     airline,
-                                                     m_class,
-                                                     flighttype,
-                                                     radius, offset));
+        _trafficManager->scheduledAircraft.push_back(new FGAISchedule(rec.model,
+                                                     rec.livery,
+                                                     rec.homePort,
+                                                     rec.registration,
+                                                     required,
+                                                     rec.heavy,
+                                                     rec.acType,
+                                                     rec.airline,
+                                                     rec.perfClass,
+                                                     rec.flightType,
+                                                     rec.radius, rec.offset));
 
         acCounter++;
-        requiredAircraft = "";
-        homePort = "";
-        score = 0;
+    }
+
+    void addFlight(const FGTrafficScheduleCache::FlightRecord& rec)
+    {
+        string required = rec.requiredAircraft;
+        if (required == "") {
+            char buffer[16];
+            snprintf(buffer, 16, "%d", acCounter);
+            required = buffer;
+        }
+        SG_LOG(SG_AI, SG_BULK, "Adding flight: " << rec.callsign << " "
+               << rec.fltRules << " "
+               << rec.departurePort << " "
+               << rec.arrivalPort << " "
+               << rec.cruiseAlt << " "
+               << rec.departureTime << " "
+               << rec.arrivalTime << " " << rec.repeat << " " << required);
+        // For database maintenance purposes, it may be convenient to
+        //
+        if (fgGetBool("/sim/traffic-manager/dumpdata") == true) {
+            SG_LOG(SG_AI, SG_ALERT, "Traffic Dump FLIGHT," << rec.callsign << ","
+                   << rec.fltRules << ","
+                   << rec.departurePort << ","
+                   << rec.arrivalPort << ","
+                   << rec.cruiseAlt << ","
+                   << rec.departureTime << ","
+                   << rec.arrivalTime << "," << rec.repeat << "," << required);
+        }
+
+        _trafficManager->flights[required].push_back(new FGScheduledFlight(rec.callsign,
+                                                                  rec.fltRules,
+                                                                  rec.departurePort,
+                                                                  rec.arrivalPort,
+                                                                  rec.cruiseAlt,
+                                                                  rec.departureTime,
+                                                                  rec.arrivalTime,
+                                                                  rec.repeat,
+                                                                  required));
+    }
+
+    void replay(const FGTrafficScheduleCache::Entry& entry)
+    {
+        auto ac = entry.aircraft.begin();
+        auto flt = entry.flights.begin();
+        for (auto kind : entry.order) {
+            if (kind == FGTrafficScheduleCache::Entry::AIRCRAFT) {
+                addAircraft(*ac++);
+            } else {
+                addFlight(*flt++);
+            }
+        }
     }
 
     void parseTrafficDir(const SGPath& path)
@@ -381,6 +460,7 @@ private:
         simgear::PathList d = trafficDir.children(simgear::Dir::TYPE_DIR | simgear::Dir::NO_DOT_OR_DOTDOT);
 
         simgear::ErrorReportContext("ai-traffic-dir", path.utf8Str());
+        unsigned cachedFiles = 0;
 
         for (const auto& p : d) {
             simgear::Dir d2(p);
@@ -388,19 +468,35 @@ private:
             simgear::PathList trafficFiles = d2.children(simgear::Dir::TYPE_FILE, ".xml");
             for (const auto& xml : trafficFiles) {
                 _currentFile = xml;
+                if (_cache) {
+                    const auto entry = _cache->lookup(xml);
+                    if (entry) {
+                        replay(*entry);
+                        ++cachedFiles;
+                        continue;
+                    }
+                    _cacheEntry = &_cache->beginEntry(xml);
+                }
+
                 try {
                     readXML(xml, *this);
+                    _cacheEntry = nullptr;
                     if (_cancelThread) {
                         return;
                     }
                 } catch (sg_exception& e) {
+                    _cacheEntry = nullptr;
+                    if (_cache) {
+                        _cache->discard(xml);
+                    }
                     simgear::reportFailure(simgear::LoadFailure::BadData, simgear::ErrorCode::AITrafficSchedule,
                                            "XML errors parsing traffic:" + e.getFormattedMessage(), xml);
                 }
             }
         } // of sub-directories iteration
 
-        SG_LOG(SG_AI, SG_INFO, "parsing traffic schedules took:" << st.elapsedMSec() << "msec");
+        SG_LOG(SG_AI, SG_INFO, "parsing traffic schedules took:" << st.elapsedMSec() << "msec"
+               << " (" << cachedFiles << " files from cache)");
     }
 
   FGTrafficManager* _trafficManager;
@@ -409,6 +505,10 @@ private:
   bool _cancelThread;
   simgear::PathList _trafficDirPaths;
   SGPath _currentFile;
+  SGPath _cacheFile;
+  FGTrafficScheduleCache* _cache;
+  // entry receiving the records of the file being parsed
+  FGTrafficScheduleCache::Entry* _cacheEntry;
 
   // parser state
 
@@ -492,6 +592,9 @@ void FGTrafficManager::shutdown()
         }
     }
 
+    // no plan must be delivered to a schedule about to be deleted
+    planBuilder.reset();
+
     for (auto acft : scheduledAircraft) {
         if (saveData) {
             cachefile << acft->getRegistration() << " "
@@ -511,8 +614,9 @@ void FGTrafficManager::shutdown()
             delete scheduled;
     }
     flights.clear();
+    departureIndex.clear();
 
-    currAircraft = scheduledAircraft.begin();
+    scheduleQueue = {};
     doingInit = false;
     inited = false;
     trafficSyncRequested = false;
@@ -581,6 +685,9 @@ void FGTrafficManager::init()
 
         scheduleParser.reset(new ScheduleParseThread(this));
         scheduleParser->setTrafficDirs(dirs);
+        if (fgGetBool("/sim/traffic-manager/use-schedule-cache", true)) {
+            scheduleParser->setCacheFile(SGPath(globals->get_fg_home(), "traffic-schedules.cache"));
+        }
         scheduleParser->start();
     } else {
         fgSetBool("/sim/traffic-manager/heuristics", false);
@@ -623,8 +730,21 @@ void FGTrafficManager::finishInit()
     }
 
     sort(scheduledAircraft.begin(), scheduledAircraft.end(), FGAISchedule::compareSchedules);
-    currAircraft = scheduledAircraft.begin();
-    currAircraftClosest = scheduledAircraft.begin();
+
+    // everything is due right away, in order of score
+    scheduleQueue = {};
+    for (unsigned i = 0; i < scheduledAircraft.size(); ++i) {
+        scheduleQueue.push({0, i, scheduledAircraft[i]});
+    }
+    lastQueueTime = 0;
+
+    updateBudgetNode = fgGetNode("/sim/traffic-manager/update-budget-ms", true);
+    if (!updateBudgetNode->hasValue()) {
+        updateBudgetNode->setDoubleValue(1.0);
+    }
+
+    const int maxPlanJobs = fgGetInt("/sim/traffic-manager/max-flight-plan-jobs", 16);
+    planBuilder.reset(new FGAIFlightPlanBuilder(std::max(maxPlanJobs, 1)));
 
     doingInit = false;
     inited = true;
@@ -674,13 +794,13 @@ void FGTrafficManager::loadHeuristics()
       }
     }
 
-  for(currAircraft = scheduledAircraft.begin(); currAircraft != scheduledAircraft.end(); ++currAircraft) {
-        const string& registration = (*currAircraft)->getRegistration();
+    for (auto acft : scheduledAircraft) {
+        const string& registration = acft->getRegistration();
         HeuristicMapIterator itr = heurMap.find(registration);
         if (itr != heurMap.end()) {
-            (*currAircraft)->setrunCount(itr->second.runCount);
-            (*currAircraft)->setHits(itr->second.hits);
-            (*currAircraft)->setLastUsed(itr->second.lastRun);
+            acft->setrunCount(itr->second.runCount);
+            acft->setHits(itr->second.hits);
+            acft->setLastUsed(itr->second.lastRun);
         }
     }
 }
@@ -750,23 +870,92 @@ void FGTrafficManager::update(double dt)
     }
 
 
-    if (scheduledAircraft.empty()) {
+    // the budget applies to building the flight plans and to updating
+    // the schedules separately
+    const double budgetMs = updateBudgetNode->getDoubleValue();
+    planBuilder->update(budgetMs);
+
+    if (scheduleQueue.empty()) {
         return;
     }
 
     SGVec3d userCart = globals->get_aircraft_position_cart();
+    time_t now = globals->get_time_params()->get_cur_time();
 
-    if (currAircraft == scheduledAircraft.end()) {
-        currAircraft = scheduledAircraft.begin();
+    // Distant schedules are parked assuming that time goes on and that the
+    // user can't close the gap faster than TRAFFIC_MAX_CLOSING_SPEED_KTS.
+    // After a time warp backwards or a reposition, look at all of them again.
+    if (lastQueueTime != 0) {
+        const double elapsed = std::max<time_t>(now - lastQueueTime, 0) + 1;
+        const double maxMoveM = elapsed * TRAFFIC_MAX_CLOSING_SPEED_KTS * SG_KT_TO_MPS;
+        if ((now < lastQueueTime) || (dist(userCart, lastQueueUserCart) > maxMoveM)) {
+            requeueAllNow(now);
+        }
     }
+    lastQueueTime = now;
+    lastQueueUserCart = userCart;
+
+    // Update every schedule which is due, as long as the frame's budget
+    // lasts. Schedules are re-queued after the loop, so one which asks to
+    // be looked at again right away waits for the next frame.
+    SGTimeStamp start;
+    start.stamp();
+    std::vector<ScheduleQueueEntry> requeue;
+    unsigned processed = 0;
+    while (!scheduleQueue.empty() && (scheduleQueue.top().due <= now)) {
+        if ((processed > 0) && (start.elapsedUSec() >= budgetMs * 1000.0)) {
+            break;
+        }
 
-    time_t now = globals->get_time_params()->get_cur_time();
+        ScheduleQueueEntry entry = scheduleQueue.top();
+        scheduleQueue.pop();
+        ++processed;
+        if (!entry.schedule->update(now, userCart)) {
+            // not done yet, continue in the next frame
+            entry.due = now;
+        } else {
+            entry.due = entry.schedule->getNextUpdateTime();
+            if (entry.due == 0) {
+                continue; // invalid, nothing left to do
+            }
+            entry.due = std::min(entry.due, now + TRAFFIC_MAX_RECHECK_INTERVAL);
+        }
+        requeue.push_back(entry);
+    }
 
-    //cerr << "Processing << " << (*currAircraft)->getRegistration() << " with score " << (*currAircraft)->getScore() << endl;
-    if ((*currAircraft)->update(now, userCart)) {
-        // schedule is done - process another aircraft in next iteration
-        ++currAircraft;
+    for (const auto& entry : requeue) {
+        scheduleQueue.push(entry);
+    }
+}
+
+void FGTrafficManager::requeueAllNow(time_t now)
+{
+    std::vector<ScheduleQueueEntry> entries;
+    entries.reserve(scheduleQueue.size());
+    while (!scheduleQueue.empty()) {
+        ScheduleQueueEntry entry = scheduleQueue.top();
+        scheduleQueue.pop();
+        entry.due = std::min(entry.due, now);
+        entries.push_back(entry);
     }
+
+    for (const auto& entry : entries) {
+        scheduleQueue.push(entry);
+    }
+}
+
+FGScheduledFlightVec& FGTrafficManager::getDepartures(const std::string& ref, const std::string& airportId)
+{
+    auto indexIt = departureIndex.find(ref);
+    if (indexIt == departureIndex.end()) {
+        FGScheduledFlightMap& byAirport = departureIndex[ref];
+        for (auto flight : flights[ref]) {
+            byAirport[simgear::strutils::uppercase(flight->getDepartureAirportId())].push_back(flight);
+        }
+        indexIt = departureIndex.find(ref);
+    }
+
+    return indexIt->second[simgear::strutils::uppercase(airportId)];
 }
 
 void FGTrafficManager::readTimeTableFromFile(SGPath infileName)
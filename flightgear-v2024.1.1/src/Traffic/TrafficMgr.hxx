@@ -47,6 +47,7 @@
 
 #include <set>
 #include <memory>
+#include <queue>
 
 #include <simgear/structure/subsystem_mgr.hxx>
 #include <simgear/props/propertyObject.hxx>
@@ -73,9 +74,24 @@ typedef HeuristicMap::iterator             HeuristicMapIterator;
 
 
 class ScheduleParseThread;
+class FGAIFlightPlanBuilder;
 
 class FGTrafficManager : public SGSubsystem
 {
+public:
+    /// a schedule and when it needs to be updated next
+    struct ScheduleQueueEntry {
+        time_t due;
+        unsigned rank; ///< position in scheduledAircraft, orders equal times by score
+        FGAISchedule* schedule;
+
+        bool operator<(const ScheduleQueueEntry& other) const
+        {
+            // std::priority_queue puts the largest on top
+            return (due != other.due) ? (due > other.due) : (rank > other.rank);
+        }
+    };
+
 private:
     bool inited;
     bool doingInit;
@@ -85,10 +101,24 @@ private:
     std::string waitingMetarStation;
 
     ScheduleVector scheduledAircraft;
-    ScheduleVectorIterator currAircraft, currAircraftClosest;
+
+    std::priority_queue<ScheduleQueueEntry> scheduleQueue;
+    SGPropertyNode_ptr updateBudgetNode;
+
+    /// sim time and user position of the last queue update, to notice
+    /// time warps and repositioning
+    time_t lastQueueTime = 0;
+    SGVec3d lastQueueUserCart;
+
+    void requeueAllNow(time_t now);
 
     FGScheduledFlightMap flights;
 
+    /// flights per aircraft requirement and departure airport, built on demand
+    std::map<std::string, FGScheduledFlightMap> departureIndex;
+
+    std::unique_ptr<FGAIFlightPlanBuilder> planBuilder;
+
     void readTimeTableFromFile(SGPath infilename);
     void Tokenize(const std::string& str, std::vector<std::string>& tokens, const std::string& delimiters = " ");
 
@@ -123,4 +153,13 @@ public:
 
     FGScheduledFlightVecIterator getFirstFlight(const std::string &ref) { return flights[ref].begin(); }
     FGScheduledFlightVecIterator getLastFlight(const std::string &ref) { return flights[ref].end(); }
+
+    /**
+     * The flights for aircraft requirement ref which depart from an
+     * airport, a subset of getFirstFlight() .. getLastFlight()
+     */
+    FGScheduledFlightVec& getDepartures(const std::string& ref, const std::string& airportId);
+
+    /// prepares the flight plans of aircraft becoming active, nullptr until initialized
+    FGAIFlightPlanBuilder* getFlightPlanBuilder() { return planBuilder.get(); }
 };
@@ -21,6 +21,7 @@
 #include "test_AIManager.hxx"
 #include "test_groundnet.hxx"
 #include "test_traffic.hxx"
+#include "test_trafficcontrol.hxx"
 #include "test_TrafficMgr.hxx"
 #include "test_submodels.hxx"
 #include "test_AIFlightPlan.hxx"
@@ -30,6 +31,7 @@ CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AIFlightPlanTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AIManagerTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(GroundnetTests, "Unit tests");
 // CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TrafficTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TrafficControlTests, "Unit tests");
 // CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TrafficMgrTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SubmodelsTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(VectorMathTests, "Unit tests");
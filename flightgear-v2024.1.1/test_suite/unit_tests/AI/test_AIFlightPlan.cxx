@@ -19,8 +19,10 @@
 
 #include "test_AIFlightPlan.hxx"
 
+#include <chrono>
 #include <cstring>
 #include <memory>
+#include <thread>
 
 #include "config.h"
 #include "test_suite/FGTestApi/testGlobals.hxx"
@@ -30,14 +32,19 @@
 
 #include <AIModel/AIAircraft.hxx>
 #include <AIModel/AIFlightPlan.hxx>
+#include <AIModel/AIFlightPlanBuilder.hxx>
 #include <AIModel/AIManager.hxx>
 
 #include <Airports/airport.hxx>
+#include <Airports/groundnetwork.hxx>
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
 #include <Navaids/NavDataCache.hxx>
 #include <Navaids/navrecord.hxx>
 
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+
 using std::string;
 using namespace flightgear;
 
@@ -361,3 +368,142 @@ void AIFlightPlanTests::testRightTurnFlightplanXML()
     CPPUNIT_ASSERT_EQUAL(false, wp2->getInAir());
     CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, wp2->getSpeed(), 0.1);
 }
+
+namespace {
+
+// pump the builder until nothing is left or it takes unreasonably long
+void runBuilder(FGAIFlightPlanBuilder& builder)
+{
+    for (int i = 0; (i < 1000) && (builder.numJobs() > 0); ++i) {
+        builder.update(100.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+void AIFlightPlanTests::testFlightPlanBuilder()
+{
+    simgear::Dir dataDir = simgear::Dir::tempDir("fgai-plans");
+    dataDir.setRemoveOnDestroy();
+    SGPath planDir = dataDir.path() / "AI" / "FlightPlans";
+    simgear::Dir(planDir).create(0755);
+    {
+        sg_ofstream f(planDir / "EHAM-EGLL.xml");
+        f << R"(<?xml version="1.0" encoding="UTF-8"?>
+            <PropertyList>
+            <flightplan>
+                <wp><name>start</name><lat>52.3</lat><lon>4.7</lon><ktas>200</ktas><alt>5000</alt></wp>
+                <wp><name>END</name></wp>
+            </flightplan>
+            </PropertyList>)";
+    }
+    globals->append_data_path(dataDir.path());
+
+    FGAIFlightPlanBuilder builder(2);
+    const SGPropertyNode* filed = nullptr;
+    bool filedDelivered = false, missingDelivered = false;
+    auto t1 = builder.request("EHAM-EGLL.xml", [&](const SGPropertyNode* plan) {
+        filedDelivered = true;
+        CPPUNIT_ASSERT(plan);
+        filed = plan;
+
+        // the plan tree is complete and usable on the main thread
+        FGAIFlightPlan fp;
+        CPPUNIT_ASSERT(fp.readFlightplan(plan, sg_location("EHAM-EGLL.xml")));
+        CPPUNIT_ASSERT_EQUAL(2, fp.getNrOfWayPoints());
+    });
+    auto t2 = builder.request("EHAM-LFPG.xml", [&](const SGPropertyNode* plan) {
+        missingDelivered = true;
+        CPPUNIT_ASSERT(!plan);
+    });
+    CPPUNIT_ASSERT(t1 != 0);
+    CPPUNIT_ASSERT(t2 != 0);
+    CPPUNIT_ASSERT(t1 != t2);
+
+    // bounded: a third job has to wait
+    CPPUNIT_ASSERT_EQUAL(0u, builder.request("EHAM-EDDF.xml", [](const SGPropertyNode*) {
+        CPPUNIT_FAIL("rejected job delivered");
+    }));
+
+    runBuilder(builder);
+    CPPUNIT_ASSERT(filedDelivered);
+    CPPUNIT_ASSERT(missingDelivered);
+    CPPUNIT_ASSERT(filed);
+    CPPUNIT_ASSERT_EQUAL(size_t(0), builder.numJobs());
+
+    // room again after delivery
+    CPPUNIT_ASSERT(builder.request("EHAM-EDDF.xml", [](const SGPropertyNode*) {}) != 0);
+    runBuilder(builder);
+}
+
+void AIFlightPlanTests::testFlightPlanBuilderCancel()
+{
+    FGAIFlightPlanBuilder builder(4);
+    int delivered = 0;
+    auto t1 = builder.request("EHAM-EGLL.xml", [&](const SGPropertyNode*) { ++delivered; });
+    auto t2 = builder.request("EHAM-LFPG.xml", [&](const SGPropertyNode*) { ++delivered; });
+    builder.request("EHAM-EDDF.xml", [&](const SGPropertyNode*) { ++delivered; });
+    CPPUNIT_ASSERT_EQUAL(size_t(3), builder.numJobs());
+
+    builder.cancel(t1);
+    builder.cancel(t1); // unknown tickets are ignored
+    CPPUNIT_ASSERT_EQUAL(size_t(2), builder.numJobs());
+    runBuilder(builder);
+    CPPUNIT_ASSERT_EQUAL(2, delivered);
+
+    // cancelling a delivered job does nothing
+    builder.cancel(t2);
+
+    builder.request("EHAM-EGLL.xml", [&](const SGPropertyNode*) { ++delivered; });
+    builder.request("EHAM-LFPG.xml", [&](const SGPropertyNode*) { ++delivered; });
+    builder.cancelAll();
+    CPPUNIT_ASSERT_EQUAL(size_t(0), builder.numJobs());
+    for (int i = 0; i < 20; ++i) {
+        builder.update(100.0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CPPUNIT_ASSERT_EQUAL(2, delivered);
+}
+
+void AIFlightPlanTests::testFlightPlanBuilderGroundnet()
+{
+    simgear::Dir sceneryDir = simgear::Dir::tempDir("fgai-scenery");
+    sceneryDir.setRemoveOnDestroy();
+    SGPath aptDir = sceneryDir.path() / "Airports" / "Y" / "B" / "B";
+    simgear::Dir(aptDir).create(0755);
+    {
+        sg_ifstream in(SGPath::fromUtf8(FG_TEST_SUITE_DATA) / "YBBN.groundnet.xml");
+        sg_ofstream out(aptDir / "YBBN.groundnet.xml");
+        out << in.rdbuf();
+    }
+    globals->append_fg_scenery(sceneryDir.path());
+
+    FGAirport::clearAirportsCache();
+    FGAirportRef ybbn = FGAirport::getByIdent("YBBN");
+    CPPUNIT_ASSERT(!ybbn->hasGroundNetwork());
+
+    FGAIFlightPlanBuilder builder(4);
+    bool delivered = false;
+    builder.request("YBBN-YSSY.xml", {ybbn.get(), ybbn.get()}, [&](const SGPropertyNode*) {
+        delivered = true;
+        // loaded on the worker, in place before the plan is built
+        CPPUNIT_ASSERT(ybbn->hasGroundNetwork());
+    });
+
+    // already being loaded: the second job waits for the first one's
+    bool secondDelivered = false;
+    builder.request("YBBN-YSSY.xml", {ybbn.get()}, [&](const SGPropertyNode*) {
+        secondDelivered = true;
+        CPPUNIT_ASSERT(ybbn->hasGroundNetwork());
+    });
+
+    runBuilder(builder);
+    CPPUNIT_ASSERT(delivered);
+    CPPUNIT_ASSERT(secondDelivered);
+
+    FGGroundNetwork* net = ybbn->groundNetwork();
+    CPPUNIT_ASSERT(net->exists());
+    CPPUNIT_ASSERT(!net->allParkings().empty());
+    CPPUNIT_ASSERT(net->findNearestNode(ybbn->geod()));
+}
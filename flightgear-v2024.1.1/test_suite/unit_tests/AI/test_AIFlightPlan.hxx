@@ -38,6 +38,9 @@ class AIFlightPlanTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testAIFlightPlanLoadXML);
     CPPUNIT_TEST(testLeftTurnFlightplanXML);
     CPPUNIT_TEST(testRightTurnFlightplanXML);
+    CPPUNIT_TEST(testFlightPlanBuilder);
+    CPPUNIT_TEST(testFlightPlanBuilderCancel);
+    CPPUNIT_TEST(testFlightPlanBuilderGroundnet);
     CPPUNIT_TEST_SUITE_END();
 
 
@@ -54,4 +57,7 @@ public:
     void testAIFlightPlanLoadXML();
     void testLeftTurnFlightplanXML();
     void testRightTurnFlightplanXML();
+    void testFlightPlanBuilder();
+    void testFlightPlanBuilderCancel();
+    void testFlightPlanBuilderGroundnet();
 };
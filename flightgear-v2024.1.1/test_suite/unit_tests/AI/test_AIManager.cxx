@@ -129,3 +129,90 @@ void AIManagerTests::testAircraftWaypoints()
     std::unique_ptr<FGAIFlightPlan> aiFP(new FGAIFlightPlan);
     ai->setFlightPlan(std::move(aiFP));    
 }
+
+// the batched update must move aircraft exactly like FGAIAircraft::update()
+void AIManagerTests::testBatchedKinematics()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+    auto eggd = FGAirport::findByIdent("EGGD");
+    FGTestApi::setPositionAndStabilise(eggd->geod());
+
+    auto fly = [&](bool batched) {
+        fgSetBool("/sim/ai/batch-kinematics", batched);
+
+        SGPropertyNode_ptr aircraftDefinition(new SGPropertyNode);
+        aircraftDefinition->setStringValue("type", "aircraft");
+        aircraftDefinition->setStringValue("callsign", batched ? "G-BTCH" : "G-SNGL");
+        aircraftDefinition->setDoubleValue("heading", 90.0);
+        aircraftDefinition->setDoubleValue("latitude", eggd->geod().getLatitudeDeg());
+        aircraftDefinition->setDoubleValue("longitude", eggd->geod().getLongitudeDeg());
+        aircraftDefinition->setDoubleValue("altitude", 6000.0);
+        aircraftDefinition->setDoubleValue("speed", 250.0);
+
+        auto ai = aim->addObject(aircraftDefinition);
+        CPPUNIT_ASSERT(ai);
+
+        // turn, climb and accelerate at the same time
+        SGPropertyNode* controls = ai->_getProps()->getNode("controls/flight", true);
+        controls->setStringValue("lateral-mode", "hdg");
+        controls->setDoubleValue("target-hdg", 200.0);
+        controls->setStringValue("vertical-mode", "alt");
+        controls->setDoubleValue("target-alt", 9000.0);
+        controls->setDoubleValue("target-spd", 300.0);
+
+        FGTestApi::runForTime(30.0);
+        ai->setDie(true);
+        return ai;
+    };
+
+    auto single = fly(false);
+    auto batched = fly(true);
+
+    CPPUNIT_ASSERT(single->getGeodPos().getLatitudeDeg() != eggd->geod().getLatitudeDeg());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->getGeodPos().getLatitudeDeg(), batched->getGeodPos().getLatitudeDeg(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->getGeodPos().getLongitudeDeg(), batched->getGeodPos().getLongitudeDeg(), 1e-9);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->_getAltitude(), batched->_getAltitude(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->getTrueHeadingDeg(), batched->getTrueHeadingDeg(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->_getSpeed(), batched->_getSpeed(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->_getPitch(), batched->_getPitch(), 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(single->_getRoll(), batched->_getRoll(), 1e-6);
+}
+
+void AIManagerTests::testUpdateThrottleInterval()
+{
+    auto aim = globals->get_subsystem<FGAIManager>();
+
+    const SGGeod viewer = SGGeod::fromDegFt(-2.72, 51.38, 0.0);
+    fgSetDouble("/sim/current-view/viewer-lon-deg", viewer.getLongitudeDeg());
+    fgSetDouble("/sim/current-view/viewer-lat-deg", viewer.getLatitudeDeg());
+    fgSetDouble("/sim/current-view/viewer-elev-ft", viewer.getElevationFt());
+    FGTestApi::runForTime(0.1);
+
+    auto at = [&viewer](double distanceM) {
+        return SGGeodesy::direct(viewer, 45.0, distanceM);
+    };
+
+    // a 20 m model is updated every frame up to 200 radii, then every
+    // frame per 200 radii further out, up to the maximum interval
+    CPPUNIT_ASSERT_EQUAL(1u, aim->updateIntervalFor(at(100.0), 20.0));
+    CPPUNIT_ASSERT_EQUAL(1u, aim->updateIntervalFor(at(7900.0), 20.0));
+    CPPUNIT_ASSERT_EQUAL(2u, aim->updateIntervalFor(at(8100.0), 20.0));
+    CPPUNIT_ASSERT_EQUAL(5u, aim->updateIntervalFor(at(20100.0), 20.0));
+    CPPUNIT_ASSERT_EQUAL(8u, aim->updateIntervalFor(at(100000.0), 20.0));
+
+    // at the same distance, larger models are updated more often
+    CPPUNIT_ASSERT_EQUAL(2u, aim->updateIntervalFor(at(20100.0), 50.0));
+
+    // without a radius the model is not throttled
+    CPPUNIT_ASSERT_EQUAL(1u, aim->updateIntervalFor(at(100000.0), 0.0));
+
+    // the configuration is read on the next update
+    fgSetInt("/sim/ai/update-throttle/max-interval", 3);
+    FGTestApi::runForTime(0.1);
+    CPPUNIT_ASSERT_EQUAL(3u, aim->updateIntervalFor(at(100000.0), 20.0));
+
+    fgSetBool("/sim/ai/update-throttle/enabled", false);
+    FGTestApi::runForTime(0.1);
+    CPPUNIT_ASSERT_EQUAL(1u, aim->updateIntervalFor(at(100000.0), 20.0));
+    CPPUNIT_ASSERT_EQUAL(0L, fgGetLong("/sim/ai/update-throttle/skipped-animation-updates"));
+}
@@ -21,19 +21,52 @@
 
 #include "test_TrafficMgr.hxx"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <queue>
+#include <random>
+#include <vector>
 
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 #include "test_suite/FGTestApi/TestDataLogger.hxx"
 #include "test_suite/FGTestApi/testGlobals.hxx"
 
+#include <simgear/io/iostreams/sgstream.hxx>
+
 #include <Airports/airport.hxx>
+#include <Traffic/Schedule.hxx>
+#include <Traffic/ScheduleCache.hxx>
 #include <Traffic/TrafficMgr.hxx>
 
 #include <Main/fg_props.hxx>
 #include <Main/globals.hxx>
 
+namespace {
+
+using ScheduleQueue = std::priority_queue<FGTrafficManager::ScheduleQueueEntry>;
+
+// Pop the schedules due at now, like FGTrafficManager::update() without
+// a budget, and requeue them due at next.
+ScheduleVector updateDue(ScheduleQueue& queue, time_t now, time_t next)
+{
+    ScheduleVector updated;
+    std::vector<FGTrafficManager::ScheduleQueueEntry> requeue;
+    while (!queue.empty() && (queue.top().due <= now)) {
+        auto entry = queue.top();
+        queue.pop();
+        updated.push_back(entry.schedule);
+        entry.due = next;
+        requeue.push_back(entry);
+    }
+    for (const auto& entry : requeue) {
+        queue.push(entry);
+    }
+    return updated;
+}
+
+} // namespace
+
 // Set up function for each test.
 void TrafficMgrTests::setUp()
 {
@@ -150,3 +183,119 @@ void TrafficMgrTests::testTrafficManager()
     }
    CPPUNIT_ASSERT_EQUAL(25, counter);
 }
+
+void TrafficMgrTests::testScheduleCache()
+{
+    SGPath trafficFile(globals->get_fg_home(), "cache-test.xml");
+    SGPath cacheFile(globals->get_fg_home(), "cache-test.cache");
+    {
+        sg_ofstream out(trafficFile);
+        out << "<trafficlist/>";
+    }
+
+    {
+        FGTrafficScheduleCache cache(cacheFile);
+        CPPUNIT_ASSERT(!cache.load());
+        CPPUNIT_ASSERT(!cache.lookup(trafficFile));
+
+        auto& entry = cache.beginEntry(trafficFile);
+        FGTrafficScheduleCache::AircraftRecord ac;
+        ac.model = "Aircraft/A320/Models/A320.xml";
+        ac.registration = "G-ABCD";
+        ac.radius = 18.0;
+        ac.heavy = true;
+        entry.add(ac);
+        FGTrafficScheduleCache::FlightRecord flt;
+        flt.callsign = "TST123";
+        flt.departurePort = "EGEO";
+        flt.arrivalPort = "EGPH";
+        flt.cruiseAlt = 120;
+        entry.add(flt);
+        CPPUNIT_ASSERT(cache.save());
+    }
+
+    {
+        FGTrafficScheduleCache cache(cacheFile);
+        CPPUNIT_ASSERT(cache.load());
+        auto entry = cache.lookup(trafficFile);
+        CPPUNIT_ASSERT(entry);
+        CPPUNIT_ASSERT_EQUAL(size_t{2}, entry->order.size());
+        CPPUNIT_ASSERT_EQUAL(FGTrafficScheduleCache::Entry::AIRCRAFT, entry->order[0]);
+        CPPUNIT_ASSERT_EQUAL(std::string{"G-ABCD"}, entry->aircraft[0].registration);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(18.0, entry->aircraft[0].radius, 1e-9);
+        CPPUNIT_ASSERT(entry->aircraft[0].heavy);
+        CPPUNIT_ASSERT_EQUAL(std::string{"EGPH"}, entry->flights[0].arrivalPort);
+        CPPUNIT_ASSERT_EQUAL(120, entry->flights[0].cruiseAlt);
+    }
+
+    // a modified file must be parsed again
+    {
+        sg_ofstream out(trafficFile);
+        out << "<trafficlist></trafficlist>";
+    }
+    FGTrafficScheduleCache cache(cacheFile);
+    CPPUNIT_ASSERT(cache.load());
+    CPPUNIT_ASSERT(!cache.lookup(SGPath(trafficFile.utf8Str())));
+}
+
+void TrafficMgrTests::testScheduleQueueOrder()
+{
+    // schedules with distinct scores, from the heuristics
+    std::vector<std::unique_ptr<FGAISchedule>> owned;
+    ScheduleVector scheduledAircraft;
+    for (unsigned i = 0; i < 10; ++i) {
+        owned.emplace_back(new FGAISchedule);
+        FGAISchedule* schedule = owned.back().get();
+        schedule->setrunCount(10);
+        schedule->setHits((i * 7) % 10);
+        schedule->setLastUsed(i % 2);
+        schedule->setScore();
+        scheduledAircraft.push_back(schedule);
+    }
+
+    // the order the linear scan went through them, as in finishInit()
+    std::sort(scheduledAircraft.begin(), scheduledAircraft.end(), FGAISchedule::compareSchedules);
+
+    // queued in any order, all due right away
+    std::vector<unsigned> ranks(scheduledAircraft.size());
+    for (unsigned i = 0; i < ranks.size(); ++i) {
+        ranks[i] = i;
+    }
+    std::shuffle(ranks.begin(), ranks.end(), std::mt19937(42));
+    ScheduleQueue queue;
+    for (unsigned i : ranks) {
+        queue.push({0, i, scheduledAircraft[i]});
+    }
+
+    // the first pass updates them in score order, like the linear scan
+    CPPUNIT_ASSERT(updateDue(queue, 1000, 1030) == scheduledAircraft);
+    CPPUNIT_ASSERT(updateDue(queue, 1010, 1040).empty());
+
+    // and so does every later pass of schedules due at the same time
+    CPPUNIT_ASSERT(updateDue(queue, 1030, 1060) == scheduledAircraft);
+    CPPUNIT_ASSERT_EQUAL(scheduledAircraft.size(), queue.size());
+
+    // a schedule due earlier comes first, the others keep the score order
+    std::vector<FGTrafficManager::ScheduleQueueEntry> entries;
+    while (!queue.empty()) {
+        entries.push_back(queue.top());
+        queue.pop();
+    }
+    for (auto& entry : entries) {
+        if (entry.rank == 7) {
+            entry.due = 1050;
+        } else if (entry.rank >= 5) {
+            entry.due = 1100;
+        }
+        queue.push(entry);
+    }
+
+    ScheduleVector expected{scheduledAircraft[7]};
+    for (unsigned i = 0; i < 5; ++i) {
+        expected.push_back(scheduledAircraft[i]);
+    }
+    CPPUNIT_ASSERT(updateDue(queue, 1060, 1200) == expected);
+
+    expected = {scheduledAircraft[5], scheduledAircraft[6], scheduledAircraft[8], scheduledAircraft[9]};
+    CPPUNIT_ASSERT(updateDue(queue, 1100, 1200) == expected);
+}
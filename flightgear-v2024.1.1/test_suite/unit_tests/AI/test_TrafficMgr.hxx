@@ -37,6 +37,8 @@ class TrafficMgrTests : public CppUnit::TestFixture
     CPPUNIT_TEST_SUITE(TrafficMgrTests);
     CPPUNIT_TEST(testParse);
     CPPUNIT_TEST(testTrafficManager);
+    CPPUNIT_TEST(testScheduleCache);
+    CPPUNIT_TEST(testScheduleQueueOrder);
     CPPUNIT_TEST_SUITE_END();
 
 
@@ -50,4 +52,6 @@ public:
     // The tests.
     void testTrafficManager();
     void testParse();
+    void testScheduleCache();
+    void testScheduleQueueOrder();
 };
@@ -0,0 +1,241 @@
+/*
+ * SPDX-FileName: test_trafficcontrol.cxx
+ * SPDX-FileComment: Tests of the ATC traffic record indexes and conflict scan
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "test_trafficcontrol.hxx"
+
+#include <algorithm>
+#include <random>
+
+#include <simgear/math/sg_geodesy.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <AIModel/AIAircraft.hxx>
+#include <ATC/GroundController.hxx>
+#include <ATC/TowerController.hxx>
+#include <ATC/atc_mgr.hxx>
+#include <ATC/trafficcontrol.hxx>
+#include <Main/globals.hxx>
+
+namespace {
+
+// separation range used by FGGroundController::checkSpeedAdjustment for
+// two aircraft of radius 40 m
+const double SEARCH_RANGE_M = 2 * (1.1 * 40.0 + 1.1 * 40.0);
+
+// Scatter traffic over an area the size of a large airport around EGPH
+void makeTraffic(TrafficVector& traffic, int count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> lat(55.93, 55.97);
+    std::uniform_real_distribution<double> lon(-3.40, -3.33);
+    std::uniform_real_distribution<double> hdg(0.0, 360.0);
+    for (int i = 0; i < count; ++i) {
+        FGTrafficRecord rec;
+        rec.setId(i + 1);
+        rec.setRadius(40.0);
+        rec.setPositionAndHeading(lat(rng), lon(rng), hdg(rng), 15.0, 100.0);
+        traffic.push_back(rec);
+    }
+}
+
+// Controllers with the traffic list open to the tests
+class TestTowerController : public FGTowerController
+{
+public:
+    TestTowerController() : FGTowerController(nullptr) {}
+    using FGATCController::addActiveTraffic;
+};
+
+class TestGroundController : public FGGroundController
+{
+public:
+    TestGroundController() : FGGroundController(nullptr) {}
+    using FGATCController::addActiveTraffic;
+    using FGGroundController::checkSpeedAdjustment;
+};
+
+FGTrafficRecord makeRecord(int id, const SGGeod& pos, double heading, double speed)
+{
+    FGTrafficRecord rec;
+    rec.setId(id);
+    rec.setRadius(40.0);
+    rec.setPositionAndHeading(pos.getLatitudeDeg(), pos.getLongitudeDeg(), heading, speed, pos.getElevationFt());
+    return rec;
+}
+
+SGGeod offset(const SGGeod& from, double course, double distM)
+{
+    SGGeod result;
+    double az2;
+    SGGeodesy::direct(from, course, distM, result, az2);
+    return result;
+}
+
+} // of anonymous namespace
+
+// Set up function for each test.
+void TrafficControlTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("TrafficControl");
+}
+
+// Clean up after each test.
+void TrafficControlTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+void TrafficControlTests::testSpatialIndexQuery()
+{
+    std::mt19937 rng(42);
+    TrafficVector traffic;
+    makeTraffic(traffic, 300, rng);
+
+    FGTrafficSpatialIndex index;
+    for (auto& rec : traffic) {
+        index.insert(&rec);
+    }
+    CPPUNIT_ASSERT_EQUAL(size_t{300}, index.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(40.0, index.getMaxRadius(), 1e-9);
+
+    // everything within range must be found
+    std::vector<FGTrafficRecord*> found;
+    for (auto& current : traffic) {
+        found.clear();
+        index.query(current.getPos(), SEARCH_RANGE_M, found);
+        CPPUNIT_ASSERT(std::find(found.begin(), found.end(), &current) != found.end());
+        for (auto& other : traffic) {
+            if (SGGeodesy::distanceM(current.getPos(), other.getPos()) < SEARCH_RANGE_M) {
+                CPPUNIT_ASSERT(std::find(found.begin(), found.end(), &other) != found.end());
+            }
+        }
+    }
+}
+
+void TrafficControlTests::testSpatialIndexUpdate()
+{
+    TrafficVector traffic;
+    FGTrafficRecord rec;
+    rec.setId(1);
+    rec.setPositionAndHeading(55.95, -3.37, 0.0, 0.0, 100.0);
+    traffic.push_back(rec);
+
+    FGTrafficSpatialIndex index;
+    FGTrafficRecord* moving = &traffic.front();
+    index.insert(moving);
+
+    std::vector<FGTrafficRecord*> found;
+    const SGGeod there = SGGeod::fromDegFt(-3.30, 55.95, 100.0);
+    index.query(there, 100.0, found);
+    CPPUNIT_ASSERT(found.empty());
+
+    // taxi a few kilometres away
+    moving->setPositionAndHeading(55.95, -3.30, 90.0, 15.0, 100.0);
+    index.update(moving);
+    index.query(there, 100.0, found);
+    CPPUNIT_ASSERT_EQUAL(size_t{1}, found.size());
+    CPPUNIT_ASSERT_EQUAL(moving, found.front());
+
+    found.clear();
+    index.query(SGGeod::fromDegFt(-3.37, 55.95, 100.0), 100.0, found);
+    CPPUNIT_ASSERT(found.empty());
+
+    index.remove(moving);
+    CPPUNIT_ASSERT_EQUAL(size_t{0}, index.size());
+    found.clear();
+    index.query(there, 100.0, found);
+    CPPUNIT_ASSERT(found.empty());
+}
+
+/**
+ * Run the speed checks of a ground controller over a growing number of
+ * groups of taxiing aircraft, all heading north except the last one, each
+ * waiting behind an aircraft of the tower controller:
+ *  - lead: 120 m behind the tower aircraft, slows down to follow it
+ *  - follower: 50 m behind the lead, which is closer than the tower
+ *    aircraft, so there is no speed adjustment
+ *  - crossing: heading west 80 m east of the tower aircraft, stops
+ *  - leaving: heading south behind the others, nothing ahead
+ * The groups are too far apart to affect each other.
+ */
+void TrafficControlTests::testConflictScanScaling()
+{
+    globals->get_subsystem_mgr()->add<FGATCManager>();
+
+    const double towerSpeed = 10.0;
+    for (int groups : {10, 50, 200}) {
+        TestTowerController tower;
+        TestGroundController ground;
+        ground.setTowerController(&tower);
+
+        struct Group {
+            int lead, follower, crossing, leaving, tower;
+            double leadDist;
+        };
+        std::vector<Group> expected;
+        std::vector<FGTrafficRecord> taxiing;
+
+        int id = 1;
+        for (int g = 0; g < groups; ++g) {
+            const SGGeod lead = SGGeod::fromDegFt(-3.40 + 0.01 * (g % 20), 55.90 + 0.005 * (g / 20), 100.0);
+            const SGGeod holding = offset(lead, 0.0, 120.0);
+
+            Group group;
+            group.tower = id++;
+            tower.addActiveTraffic(makeRecord(group.tower, holding, 0.0, towerSpeed));
+
+            group.lead = id++;
+            taxiing.push_back(makeRecord(group.lead, lead, 0.0, 15.0));
+            group.follower = id++;
+            taxiing.push_back(makeRecord(group.follower, offset(lead, 180.0, 50.0), 0.0, 15.0));
+            group.crossing = id++;
+            taxiing.push_back(makeRecord(group.crossing, offset(holding, 90.0, 80.0), 270.0, 15.0));
+            group.leaving = id++;
+            taxiing.push_back(makeRecord(group.leaving, offset(lead, 180.0, 150.0), 180.0, 15.0));
+
+            group.leadDist = SGGeodesy::distanceM(lead, holding);
+            expected.push_back(group);
+        }
+
+        for (const auto& rec : taxiing) {
+            ground.addActiveTraffic(rec);
+        }
+        for (auto rec : taxiing) {
+            const SGGeod pos = rec.getPos();
+            ground.checkSpeedAdjustment(rec.getId(), pos.getLatitudeDeg(), pos.getLongitudeDeg(),
+                                        rec.getHeading(), rec.getSpeed(), pos.getElevationM());
+        }
+
+        auto waitsFor = [&ground](int id) {
+            const auto it = std::find_if(ground.getActiveTraffic().begin(), ground.getActiveTraffic().end(),
+                                         [id](const FGTrafficRecord& rec) { return rec.getId() == id; });
+            CPPUNIT_ASSERT(it != ground.getActiveTraffic().end());
+            return it->getWaitsForId();
+        };
+
+        for (const auto& group : expected) {
+            // slows down to the tower aircraft speed scaled by the distance
+            FGATCInstruction instruction = ground.getInstruction(group.lead);
+            CPPUNIT_ASSERT(instruction.getChangeSpeed());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(towerSpeed * group.leadDist / 100, instruction.getSpeed(), 1e-3);
+            CPPUNIT_ASSERT_EQUAL(group.tower, waitsFor(group.lead));
+
+            CPPUNIT_ASSERT(!ground.getInstruction(group.follower).getChangeSpeed());
+            CPPUNIT_ASSERT_EQUAL(0, waitsFor(group.follower));
+
+            // closer than the separation of the two aircraft
+            instruction = ground.getInstruction(group.crossing);
+            CPPUNIT_ASSERT(instruction.getChangeSpeed());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, instruction.getSpeed(), 1e-9);
+            CPPUNIT_ASSERT_EQUAL(group.tower, waitsFor(group.crossing));
+
+            CPPUNIT_ASSERT(!ground.getInstruction(group.leaving).getChangeSpeed());
+            CPPUNIT_ASSERT_EQUAL(0, waitsFor(group.leaving));
+        }
+    }
+}
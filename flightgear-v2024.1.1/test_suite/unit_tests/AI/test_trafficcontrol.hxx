@@ -0,0 +1,33 @@
+/*
+ * SPDX-FileName: test_trafficcontrol.hxx
+ * SPDX-FileComment: Tests of the ATC traffic record indexes
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+// The ATC traffic index unit tests.
+class TrafficControlTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(TrafficControlTests);
+    CPPUNIT_TEST(testSpatialIndexQuery);
+    CPPUNIT_TEST(testSpatialIndexUpdate);
+    CPPUNIT_TEST(testConflictScanScaling);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testSpatialIndexQuery();
+    void testSpatialIndexUpdate();
+    void testConflictScanScaling();
+};
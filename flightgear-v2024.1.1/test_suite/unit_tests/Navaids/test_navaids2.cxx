@@ -1,11 +1,19 @@
 #include "test_navaids2.hxx"
 
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <simgear/timing/timestamp.hxx>
+
 #include "test_suite/FGTestApi/testGlobals.hxx"
 #include "test_suite/FGTestApi/NavDataCache.hxx"
 
 #include <Airports/airport.hxx>
 
 #include <Navaids/NavDataCache.hxx>
+#include <Navaids/NavaidFrequencyIndex.hxx>
+#include <Navaids/PositionedCursor.hxx>
 #include <Navaids/navrecord.hxx>
 #include <Navaids/navlist.hxx>
 
@@ -146,3 +154,146 @@ void NavaidsTests::testTemporaryWaypoint()
     closest = FGPositioned::findClosestN(vhhh->geod(), 1, 50.0, &filt);
     CPPUNIT_ASSERT_EQUAL(closest.size(), static_cast<size_t>(0));
 }
+
+void NavaidsTests::benchmarkFrequencyIndex()
+{
+    // a nav.dat sized world: 30000 stations spread over the VOR/ILS and
+    // NDB bands, so a few hundred share each frequency
+    const int numNavaids = 30000;
+    const int numQueries = 2000;
+    const double rangeM = FG_NAV_MAX_RANGE * SG_NM_TO_METER;
+
+    struct Navaid {
+        PositionedID id;
+        FGPositioned::Type type;
+        int freq;
+        SGVec3d cart;
+    };
+    std::vector<Navaid> navaids;
+    flightgear::NavaidFrequencyIndex index;
+
+    // deterministic pseudo-random positions, including the poles and the date line
+    unsigned seed = 12345;
+    auto next = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) & 0xffff;
+    };
+
+    for (int i = 0; i < numNavaids; ++i) {
+        const auto type = (i % 3) ? FGPositioned::VOR : FGPositioned::NDB;
+        const int freq = (type == FGPositioned::VOR) ? 10800 + (next() % 100) * 10 : 200 + next() % 100;
+        SGGeod pos = SGGeod::fromDeg(next() * 360.0 / 0x10000 - 180.0, next() * 180.0 / 0x10000 - 90.0);
+        if (i < 20) {
+            pos = SGGeod::fromDeg((i % 2) ? 179.9 : -179.9, 89.9 - i);
+        }
+        navaids.push_back({i + 1, type, freq, SGVec3d::fromGeod(pos)});
+        index.add(i + 1, type, freq, pos);
+    }
+    index.finalize();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(numNavaids), index.size());
+
+    double indexUSec = 0.0, scanUSec = 0.0;
+    size_t numFound = 0;
+    for (int q = 0; q < numQueries; ++q) {
+        const int freq = (q % 3) ? 10800 + (next() % 100) * 10 : 200 + next() % 100;
+        SGGeod pos = SGGeod::fromDeg(next() * 360.0 / 0x10000 - 180.0, next() * 180.0 / 0x10000 - 90.0);
+        if (q < 20) {
+            pos = SGGeod::fromDeg((q % 2) ? -179.95 : 179.95, 89.95 - q);
+        }
+
+        SGTimeStamp st;
+        st.stamp();
+        const PositionedIDVec found = index.find(freq, pos, rangeM, FGPositioned::NDB, FGPositioned::GS);
+        indexUSec += st.elapsedUSec();
+
+        // what the database query did: every station on the frequency,
+        // sorted by distance, then cut at the range
+        st.stamp();
+        const SGVec3d cart = SGVec3d::fromGeod(pos);
+        std::vector<std::pair<double, PositionedID>> all;
+        for (const auto& n : navaids) {
+            if (n.freq == freq) {
+                all.emplace_back(distSqr(n.cart, cart), n.id);
+            }
+        }
+        std::sort(all.begin(), all.end());
+        PositionedIDVec expected;
+        for (const auto& a : all) {
+            if (a.first <= rangeM * rangeM) {
+                expected.push_back(a.second);
+            }
+        }
+        scanUSec += st.elapsedUSec();
+
+        CPPUNIT_ASSERT(expected == found);
+        numFound += found.size();
+    }
+
+    std::cout << "\nnavaid frequency search, " << numNavaids << " navaids, " << numQueries << " queries, "
+              << numFound << " stations in range:"
+              << "\n  index: " << (indexUSec / numQueries) << " usec per query"
+              << "\n  scan and sort: " << (scanUSec / numQueries) << " usec per query"
+              << std::endl;
+
+    // unlimited range and no position keep the old behaviour
+    const SGGeod egccPos = SGGeod::fromDeg(-2.27, 53.35);
+    const PositionedIDVec everywhere = index.find(250, egccPos, 0.0, FGPositioned::NDB, FGPositioned::NDB);
+    const PositionedIDVec noPos = index.find(250, FGPositioned::NDB, FGPositioned::NDB);
+    CPPUNIT_ASSERT_EQUAL(everywhere.size(), noPos.size());
+    CPPUNIT_ASSERT(std::is_sorted(noPos.begin(), noPos.end()));
+    CPPUNIT_ASSERT(index.find(250, FGPositioned::VOR, FGPositioned::VOR).empty());
+
+    // and the real navaids are found through it
+    FGNavRecordRef tnt = FGNavList::findByFreq(115.7, egccPos);
+    CPPUNIT_ASSERT(tnt);
+    CPPUNIT_ASSERT(tnt->ident() == "TNT");
+    auto all = FGNavList::findAllByFreq(115.7, egccPos, FGNavList::navFilter());
+    CPPUNIT_ASSERT(!all.empty());
+    CPPUNIT_ASSERT_EQUAL(tnt, all.front());
+}
+
+void NavaidsTests::testPositionedCursor()
+{
+    FGPositioned::TypeFilter filt({FGPositioned::AIRPORT, FGPositioned::NDB, FGPositioned::VOR});
+    flightgear::PositionedCursor cursor;
+
+    // fly from Manchester towards London, the cursor must find what a
+    // search from scratch finds at every step
+    SGGeod pos = SGGeod::fromDeg(-2.27, 53.35);
+    for (int step = 0; step < 40; ++step) {
+        const double rangeNm = (step < 20) ? 40.0 : 25.0;
+        while (cursor.update(pos, 50, rangeNm, &filt)) {
+            // loading was time limited, continue
+        }
+
+        const FGPositionedList fresh = FGPositioned::findClosestN(pos, 50, rangeNm, &filt);
+        const FGPositionedList& incremental = cursor.results();
+        CPPUNIT_ASSERT_EQUAL(fresh.size(), incremental.size());
+        CPPUNIT_ASSERT(!incremental.empty());
+
+        FGPositionedList sortedFresh(fresh), sortedIncremental(incremental);
+        std::sort(sortedFresh.begin(), sortedFresh.end());
+        std::sort(sortedIncremental.begin(), sortedIncremental.end());
+        CPPUNIT_ASSERT(sortedFresh == sortedIncremental);
+
+        const SGVec3d cart = SGVec3d::fromGeod(pos);
+        for (size_t i = 1; i < incremental.size(); ++i) {
+            CPPUNIT_ASSERT(dist(cart, incremental[i - 1]->cart()) <= dist(cart, incremental[i]->cart()));
+        }
+
+        pos = SGGeodesy::direct(pos, 140.0, 3.0 * SG_NM_TO_METER);
+    }
+
+    // transient items are found without resetting
+    auto wp = FGPositioned::createWaypoint(FGPositioned::WAYPOINT, "TEST_CURSOR",
+                                           SGGeodesy::direct(pos, 0.0, 1.0 * SG_NM_TO_METER), true);
+    FGPositioned::TypeFilter wpFilter(FGPositioned::WAYPOINT);
+    flightgear::PositionedCursor wpCursor;
+    wpCursor.update(pos, 10, 5.0, &wpFilter);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), wpCursor.results().size());
+    CPPUNIT_ASSERT_EQUAL(wp, wpCursor.results().front());
+
+    CPPUNIT_ASSERT(FGPositioned::deleteWaypoint(wp));
+    wpCursor.update(pos, 10, 5.0, &wpFilter);
+    CPPUNIT_ASSERT(wpCursor.results().empty());
+}
@@ -34,6 +34,8 @@ class NavaidsTests : public CppUnit::TestFixture
     CPPUNIT_TEST(testBasic);
     CPPUNIT_TEST(testCustomWaypoint);
     CPPUNIT_TEST(testTemporaryWaypoint);
+    CPPUNIT_TEST(benchmarkFrequencyIndex);
+    CPPUNIT_TEST(testPositionedCursor);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,6 +49,8 @@ public:
     void testBasic();
     void testCustomWaypoint();
     void testTemporaryWaypoint();
+    void benchmarkFrequencyIndex();
+    void testPositionedCursor();
 };
 
 #endif  // _FG_NAVAIDS_UNIT_TESTS_HXX
@@ -5,12 +5,16 @@
 
 #include "config.h"
 
+#include "test_mirrorPropertyTree.hxx"
+
+// Set up the unit tests.
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MirrorPropertyTreeTests, "Unit tests");
+
 #if defined(ENABLE_SWIFT)
 
 #include "test_swiftAircraftManager.hxx"
 #include "test_swiftService.hxx"
 
-// Set up the unit tests.
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SwiftAircraftManagerTest, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SwiftServiceTest, "Unit tests");
 
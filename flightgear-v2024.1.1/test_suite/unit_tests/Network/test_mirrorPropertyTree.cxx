@@ -0,0 +1,253 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "test_mirrorPropertyTree.hxx"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/timing/timestamp.hxx>
+
+#include <Main/fg_props.hxx>
+#include <Main/globals.hxx>
+#include <Network/http/MirrorPropertyTreeWebsocket.hxx>
+
+using namespace flightgear::http;
+
+namespace {
+
+// collects the frames a websocket sends
+class RecordingWriter : public WebsocketWriter
+{
+public:
+    int writeToWebsocket(int opcode, const char* data, size_t len) override
+    {
+        frames.emplace_back(opcode, std::string(data, len));
+        bytes += len;
+        return 0;
+    }
+
+    std::vector<std::pair<int, std::string>> frames;
+    size_t bytes = 0;
+};
+
+// decodes the binary frames, see MirrorPropertyTreeWebsocket.hxx
+class BinaryReader
+{
+public:
+    explicit BinaryReader(const std::string& d) : data(d) {}
+
+    uint64_t get(unsigned bytes)
+    {
+        uint64_t v = 0;
+        for (unsigned i = 0; i < bytes; ++i) {
+            v |= uint64_t(static_cast<uint8_t>(data.at(pos++))) << (8 * i);
+        }
+        return v;
+    }
+
+    std::string getString(unsigned lengthBytes)
+    {
+        const size_t len = get(lengthBytes);
+        std::string s = data.substr(pos, len);
+        pos += len;
+        return s;
+    }
+
+    double getDouble()
+    {
+        const uint64_t bits = get(8);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+
+    bool atEnd() const { return pos == data.size(); }
+
+    const std::string& data;
+    size_t pos = 0;
+};
+
+} // namespace
+
+/////////////////////////////////////////////////////////////////////////////
+
+// Set up function for each test.
+void MirrorPropertyTreeTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("MirrorPropertyTree");
+}
+
+// Clean up after each test.
+void MirrorPropertyTreeTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+void MirrorPropertyTreeTests::testBinaryEncoding()
+{
+    fgSetDouble("/mirror-test/a", 1.5);
+    fgSetInt("/mirror-test/b", -7);
+    fgSetString("/mirror-test/c", "hello");
+
+    MirrorPropertyTreeWebsocket ws("/mirror-test", true);
+    ws.setMinSendInterval(0);
+    CPPUNIT_ASSERT(ws.isBinary());
+
+    RecordingWriter writer;
+    ws.poll(writer);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), writer.frames.size());
+    CPPUNIT_ASSERT_EQUAL(2, writer.frames[0].first);
+
+    BinaryReader r(writer.frames[0].second);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r.get(1));
+    // the root and its three children
+    const uint64_t created = r.get(4);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(4), created);
+
+    uint64_t idA = 0;
+    bool sawB = false, sawC = false;
+    for (uint64_t i = 0; i < created; ++i) {
+        const uint64_t id = r.get(4);
+        r.get(4); // index
+        r.get(4); // position
+        const std::string path = r.getString(2);
+        const unsigned type = r.get(1);
+        if (path == "/mirror-test/a") {
+            CPPUNIT_ASSERT_EQUAL(5u, type);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, r.getDouble(), 1e-9);
+            idA = id;
+        } else if (path == "/mirror-test/b") {
+            CPPUNIT_ASSERT_EQUAL(2u, type);
+            CPPUNIT_ASSERT_EQUAL(-7, static_cast<int>(static_cast<int32_t>(r.get(4))));
+            sawB = true;
+        } else if (path == "/mirror-test/c") {
+            CPPUNIT_ASSERT_EQUAL(6u, type);
+            CPPUNIT_ASSERT_EQUAL(std::string("hello"), r.getString(4));
+            sawC = true;
+        } else {
+            CPPUNIT_ASSERT_EQUAL(std::string("/mirror-test"), path);
+            CPPUNIT_ASSERT_EQUAL(0u, type);
+        }
+    }
+    CPPUNIT_ASSERT(idA != 0);
+    CPPUNIT_ASSERT(sawB && sawC);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), r.get(4)); // removed
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), r.get(4)); // changed
+    CPPUNIT_ASSERT(r.atEnd());
+
+    // no changes, nothing sent
+    ws.poll(writer);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), writer.frames.size());
+
+    // a change refers to the id only
+    fgSetDouble("/mirror-test/a", 2.5);
+    ws.poll(writer);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), writer.frames.size());
+    BinaryReader r2(writer.frames[1].second);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r2.get(1));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), r2.get(4));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), r2.get(4));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r2.get(4));
+    CPPUNIT_ASSERT_EQUAL(idA, r2.get(4));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(5), r2.get(1));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5, r2.getDouble(), 1e-9);
+    CPPUNIT_ASSERT(r2.atEnd());
+
+    ws.close();
+}
+
+void MirrorPropertyTreeTests::testBinaryRemoveAndChange()
+{
+    fgSetBool("/mirror-test/flag", false);
+    fgSetInt("/mirror-test/gone", 1);
+
+    MirrorPropertyTreeWebsocket ws("/mirror-test", true);
+    ws.setMinSendInterval(0);
+    RecordingWriter writer;
+    ws.poll(writer);
+    CPPUNIT_ASSERT_EQUAL(size_t(1), writer.frames.size());
+
+    fgGetNode("/mirror-test")->removeChild("gone");
+    fgSetBool("/mirror-test/flag", true);
+    ws.poll(writer);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), writer.frames.size());
+
+    BinaryReader r(writer.frames[1].second);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r.get(1));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), r.get(4)); // created
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r.get(4)); // removed
+    r.get(4);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r.get(4)); // changed
+    r.get(4);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r.get(1)); // bool
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), r.get(1));
+    CPPUNIT_ASSERT(r.atEnd());
+
+    ws.close();
+}
+
+void MirrorPropertyTreeTests::benchmarkJsonVsBinary()
+{
+    // a glass cockpit sized tree: 2000 properties of which 500 change per
+    // update, mirrored in both encodings at the same time
+    const int numProps = 2000;
+    const int numChanged = 500;
+    const int numUpdates = 50;
+
+    auto root = fgGetNode("/mirror-bench", true);
+    std::vector<SGPropertyNode_ptr> props;
+    for (int i = 0; i < numProps; ++i) {
+        auto n = root->getNode("display", i / 100, true)->getNode("value", i % 100, true);
+        n->setDoubleValue(i);
+        props.push_back(n);
+    }
+
+    MirrorPropertyTreeWebsocket json("/mirror-bench", false);
+    MirrorPropertyTreeWebsocket binary("/mirror-bench", true);
+    json.setMinSendInterval(0);
+    binary.setMinSendInterval(0);
+
+    RecordingWriter jsonWriter, binaryWriter;
+    json.poll(jsonWriter);
+    binary.poll(binaryWriter);
+    const size_t jsonInitial = jsonWriter.bytes;
+    const size_t binaryInitial = binaryWriter.bytes;
+
+    double jsonMSec = 0.0, binaryMSec = 0.0;
+    for (int u = 0; u < numUpdates; ++u) {
+        for (int i = 0; i < numChanged; ++i) {
+            props[(u * 7 + i * 3) % numProps]->setDoubleValue(u * 1000.0 + i * 0.25);
+        }
+
+        SGTimeStamp st;
+        st.stamp();
+        json.poll(jsonWriter);
+        jsonMSec += st.elapsedMSec();
+
+        st.stamp();
+        binary.poll(binaryWriter);
+        binaryMSec += st.elapsedMSec();
+    }
+
+    const size_t jsonBytes = (jsonWriter.bytes - jsonInitial) / numUpdates;
+    const size_t binaryBytes = (binaryWriter.bytes - binaryInitial) / numUpdates;
+    std::cout << "\nmirror of " << numProps << " properties, " << numChanged << " changed per update:"
+              << "\n  initial: JSON " << jsonInitial << " bytes, binary " << binaryInitial << " bytes"
+              << "\n  per update: JSON " << jsonBytes << " bytes, " << (jsonMSec / numUpdates) << " msec"
+              << "\n  per update: binary " << binaryBytes << " bytes, " << (binaryMSec / numUpdates) << " msec"
+              << std::endl;
+
+    CPPUNIT_ASSERT_EQUAL(size_t(numUpdates + 1), jsonWriter.frames.size());
+    CPPUNIT_ASSERT_EQUAL(size_t(numUpdates + 1), binaryWriter.frames.size());
+    CPPUNIT_ASSERT(binaryBytes < jsonBytes);
+
+    json.close();
+    binary.close();
+}
@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+// Tests of the property tree mirror websocket
+class MirrorPropertyTreeTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(MirrorPropertyTreeTests);
+    CPPUNIT_TEST(testBinaryEncoding);
+    CPPUNIT_TEST(testBinaryRemoveAndChange);
+    CPPUNIT_TEST(benchmarkJsonVsBinary);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testBinaryEncoding();
+    void testBinaryRemoveAndChange();
+    void benchmarkJsonVsBinary();
+};
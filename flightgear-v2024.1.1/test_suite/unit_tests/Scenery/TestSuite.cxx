@@ -0,0 +1,10 @@
+/*
+ * SPDX-FileName: TestSuite.cxx
+ * SPDX-FileComment: Scenery unit test registration
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "test_tilePrefetcher.hxx"
+
+// Set up the unit tests.
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TilePrefetcherTests, "Unit tests");
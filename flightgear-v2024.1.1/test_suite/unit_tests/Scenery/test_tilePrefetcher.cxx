@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileName: test_tilePrefetcher.cxx
+ * SPDX-FileComment: Tests of the tile prefetcher path projection
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include "test_tilePrefetcher.hxx"
+
+#include <vector>
+
+#include <simgear/math/SGMath.hxx>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <Scenery/TilePrefetcher.hxx>
+
+using flightgear::TilePrefetcher;
+using Path = std::vector<TilePrefetcher::PathPoint>;
+
+namespace {
+
+const double STEP_M = 1000.0;
+
+// leg lengths which are no multiple of the step
+const double LEG1_M = 10500.0;
+const double LEG2_M = 8300.0;
+
+const SGGeod start = SGGeod::fromDeg(-3.37, 55.95);
+const SGGeod wp1 = SGGeodesy::direct(start, 90.0, LEG1_M);
+const SGGeod wp2 = SGGeodesy::direct(wp1, 30.0, LEG2_M);
+
+double courseDiff(double a, double b)
+{
+    return SGMiscd::normalizePeriodic(-180.0, 180.0, a - b);
+}
+
+// consecutive points are no more than a step apart, and the distances
+// along the path add up
+void checkSpacing(const Path& path, double rangeM)
+{
+    for (size_t i = 1; i < path.size(); ++i) {
+        const double diff = path[i].distanceM - path[i - 1].distanceM;
+        CPPUNIT_ASSERT(diff > 0.0);
+        CPPUNIT_ASSERT(diff <= STEP_M + 1e-6);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(diff, SGGeodesy::distanceM(path[i - 1].position, path[i].position), 0.1);
+    }
+    CPPUNIT_ASSERT(path.back().distanceM <= rangeM);
+}
+
+// point i is at the waypoint, after distanceM along the path
+void checkWaypoint(const Path& path, size_t i, const SGGeod& wp, double distanceM)
+{
+    CPPUNIT_ASSERT(i < path.size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, SGGeodesy::distanceM(path[i].position, wp), 0.01);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(distanceM, path[i].distanceM, 0.1);
+}
+
+// the points between first and last lie on the leg from a to b
+void checkOnLeg(const Path& path, size_t first, size_t last, const SGGeod& a, const SGGeod& b)
+{
+    const double legM = SGGeodesy::distanceM(a, b);
+    for (size_t i = first; i <= last; ++i) {
+        const SGGeod& p = path[i].position;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(legM, SGGeodesy::distanceM(a, p) + SGGeodesy::distanceM(p, b), 0.1);
+    }
+}
+
+void checkSamePath(const Path& a, const Path& b)
+{
+    CPPUNIT_ASSERT_EQUAL(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, SGGeodesy::distanceM(a[i].position, b[i].position), 0.01);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(a[i].distanceM, b[i].distanceM, 0.01);
+    }
+}
+
+} // namespace
+
+// Set up function for each test.
+void TilePrefetcherTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("tilePrefetcher");
+}
+
+// Clean up after each test.
+void TilePrefetcherTests::tearDown()
+{
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+void TilePrefetcherTests::testTrackOnly()
+{
+    const Path path = TilePrefetcher::projectPath(start, 45.0, {}, 5500.0, STEP_M);
+
+    // the aircraft position, then every step along the track
+    CPPUNIT_ASSERT_EQUAL(size_t{6}, path.size());
+    checkWaypoint(path, 0, start, 0.0);
+    for (size_t i = 1; i < path.size(); ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(i * STEP_M, path[i].distanceM, 1e-6);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(i * STEP_M, SGGeodesy::distanceM(start, path[i].position), 0.1);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, courseDiff(SGGeodesy::courseDeg(start, path[i].position), 45.0), 0.01);
+    }
+    checkSpacing(path, 5500.0);
+}
+
+void TilePrefetcherTests::testRouteLegs()
+{
+    // ends at the second waypoint
+    const double rangeM = LEG1_M + LEG2_M + 1.0;
+    const Path path = TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, rangeM, STEP_M);
+
+    // position, 10 steps, wp1, 8 steps, wp2: the track is ignored
+    CPPUNIT_ASSERT_EQUAL(size_t{21}, path.size());
+    checkWaypoint(path, 0, start, 0.0);
+    checkOnLeg(path, 1, 10, start, wp1);
+    checkWaypoint(path, 11, wp1, LEG1_M);
+    checkOnLeg(path, 12, 19, wp1, wp2);
+    checkWaypoint(path, 20, wp2, LEG1_M + LEG2_M);
+    checkSpacing(path, rangeM);
+
+    // the steps restart at each waypoint
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10 * STEP_M, path[10].distanceM, 1e-6);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(LEG1_M + STEP_M, path[12].distanceM, 0.01);
+}
+
+void TilePrefetcherTests::testContinueAfterRoute()
+{
+    const double rangeM = 30000.0;
+    const Path path = TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, rangeM, STEP_M);
+
+    // then every step from wp2 up to the range
+    const double routeM = LEG1_M + LEG2_M;
+    const size_t extra = static_cast<size_t>((rangeM - routeM) / STEP_M);
+    CPPUNIT_ASSERT_EQUAL(size_t{21} + extra, path.size());
+    checkWaypoint(path, 20, wp2, routeM);
+    checkSpacing(path, rangeM);
+    CPPUNIT_ASSERT(path.back().distanceM > rangeM - STEP_M);
+
+    // straight on along the course arriving at wp2
+    const double arrivingCourse = SGGeodesy::courseDeg(wp2, wp1) + 180.0;
+    for (size_t i = 21; i < path.size(); ++i) {
+        const SGGeod& p = path[i].position;
+        const double d = (i - 20) * STEP_M;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(routeM + d, path[i].distanceM, 0.01);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(d, SGGeodesy::distanceM(wp2, p), 0.1);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, courseDiff(SGGeodesy::courseDeg(wp2, p), arrivingCourse), 0.01);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(LEG2_M + d, SGGeodesy::distanceM(wp1, p), 1.0);
+    }
+}
+
+void TilePrefetcherTests::testSkipShortLegs()
+{
+    const double rangeM = 30000.0;
+    const Path plain = TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, rangeM, STEP_M);
+
+    // legs shorter than a metre add no points and don't change the course
+    const SGGeod nearStart = SGGeodesy::direct(start, 0.0, 0.5);
+    const SGGeod nearWp1 = SGGeodesy::direct(wp1, 180.0, 0.3);
+    const Path padded = TilePrefetcher::projectPath(start, 270.0,
+                                                    {nearStart, wp1, wp1, nearWp1, wp2, wp2},
+                                                    rangeM, STEP_M);
+    checkSamePath(plain, padded);
+
+    // a route only at the aircraft position leaves the track
+    const Path track = TilePrefetcher::projectPath(start, 45.0, {}, rangeM, STEP_M);
+    const Path atPosition = TilePrefetcher::projectPath(start, 45.0, {start, nearStart}, rangeM, STEP_M);
+    checkSamePath(track, atPosition);
+}
+
+void TilePrefetcherTests::testRangeCutoff()
+{
+    // within the first leg: no waypoint
+    Path path = TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, 7200.0, STEP_M);
+    CPPUNIT_ASSERT_EQUAL(size_t{8}, path.size());
+    checkOnLeg(path, 1, 7, start, wp1);
+    checkSpacing(path, 7200.0);
+
+    // a step past wp1, the second leg is cut off
+    path = TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, 12000.0, STEP_M);
+    CPPUNIT_ASSERT_EQUAL(size_t{13}, path.size());
+    checkWaypoint(path, 11, wp1, LEG1_M);
+    checkOnLeg(path, 12, 12, wp1, wp2);
+    checkSpacing(path, 12000.0);
+
+    // a range just short of a waypoint leaves it out
+    path = TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, LEG1_M - 1.0, STEP_M);
+    CPPUNIT_ASSERT_EQUAL(size_t{11}, path.size());
+    checkSpacing(path, LEG1_M - 1.0);
+
+    // nothing without a range or a step
+    CPPUNIT_ASSERT(TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, 0.0, STEP_M).empty());
+    CPPUNIT_ASSERT(TilePrefetcher::projectPath(start, 270.0, {wp1, wp2}, 10000.0, 0.0).empty());
+}
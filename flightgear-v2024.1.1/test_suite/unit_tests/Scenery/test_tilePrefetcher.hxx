@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileName: test_tilePrefetcher.hxx
+ * SPDX-FileComment: Tests of the tile prefetcher path projection
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+// The tile prefetcher unit tests.
+class TilePrefetcherTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(TilePrefetcherTests);
+    CPPUNIT_TEST(testTrackOnly);
+    CPPUNIT_TEST(testRouteLegs);
+    CPPUNIT_TEST(testContinueAfterRoute);
+    CPPUNIT_TEST(testSkipShortLegs);
+    CPPUNIT_TEST(testRangeCutoff);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The tests.
+    void testTrackOnly();
+    void testRouteLegs();
+    void testContinueAfterRoute();
+    void testSkipShortLegs();
+    void testRangeCutoff();
+};
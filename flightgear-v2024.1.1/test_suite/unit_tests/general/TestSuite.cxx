@@ -18,8 +18,10 @@
  */
 
 #include "test-mktime.hxx"
+#include "test_PropertyCache.hxx"
 #include "test_Views.hxx"
 
 // Set up the unit tests.
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MktimeTests, "Unit tests");
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(PropertyCacheTests, "Unit tests");
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ViewsTests, "Unit tests");
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileName: test_PropertyCache.cxx
+ * SPDX-FileComment: checks and times the compiled property list cache on $FG_ROOT
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "test_PropertyCache.hxx"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_suite/FGTestApi/testGlobals.hxx"
+
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/props/props_io.hxx>
+#include <simgear/structure/exception.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+#include <Main/globals.hxx>
+
+namespace {
+
+// keep the run time of the test reasonable
+const size_t MAX_FILES = 2000;
+
+void findPropertyLists(const SGPath& dir, std::vector<SGPath>& files)
+{
+    simgear::Dir d(dir);
+    for (const auto& f : d.children(simgear::Dir::TYPE_FILE, ".xml")) {
+        if (files.size() >= MAX_FILES) {
+            return;
+        }
+        files.push_back(f);
+    }
+
+    for (const auto& sub : d.children(simgear::Dir::TYPE_DIR | simgear::Dir::NO_DOT_OR_DOTDOT)) {
+        findPropertyLists(sub, files);
+    }
+}
+
+// read all files, returning the written trees of the ones which are property lists
+double readAll(const std::vector<SGPath>& files, std::vector<std::string>& trees)
+{
+    trees.clear();
+    SGTimeStamp st;
+    st.stamp();
+    double readMSec = 0.0;
+    for (const auto& f : files) {
+        SGPropertyNode_ptr root = new SGPropertyNode;
+        SGTimeStamp fileSt;
+        fileSt.stamp();
+        try {
+            readProperties(f, root);
+        } catch (const sg_exception&) {
+            trees.emplace_back();
+            continue;
+        }
+        readMSec += fileSt.elapsedMSec();
+
+        std::ostringstream os;
+        writeProperties(os, root, true);
+        trees.push_back(os.str());
+    }
+    return readMSec;
+}
+
+} // of anonymous namespace
+
+void PropertyCacheTests::setUp()
+{
+    FGTestApi::setUp::initTestGlobals("PropertyCache");
+}
+
+void PropertyCacheTests::tearDown()
+{
+    setReadPropertiesCacheDir(SGPath());
+    FGTestApi::tearDown::shutdownTestGlobals();
+}
+
+void PropertyCacheTests::testFGRootFiles()
+{
+    const SGPath root = globals->get_fg_root();
+    std::vector<SGPath> files = {root / "defaults.xml", root / "preferences.xml"};
+    for (const auto& dir : {"Materials", "Effects", "Aircraft", "Sounds", "Models"}) {
+        findPropertyLists(root / dir, files);
+    }
+
+    simgear::Dir cacheDir = simgear::Dir::tempDir("fgPropertyCache");
+    cacheDir.setRemoveOnDestroy();
+
+    std::vector<std::string> xmlTrees, recordedTrees, cachedTrees;
+    const double xmlMSec = readAll(files, xmlTrees);
+
+    setReadPropertiesCacheDir(cacheDir.path());
+    const double recordMSec = readAll(files, recordedTrees);
+    const double cachedMSec = readAll(files, cachedTrees);
+
+    CPPUNIT_ASSERT_EQUAL(xmlTrees.size(), cachedTrees.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(files[i].utf8Str(), xmlTrees[i], recordedTrees[i]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(files[i].utf8Str(), xmlTrees[i], cachedTrees[i]);
+    }
+
+    std::cout << "\nreadProperties on " << files.size() << " files from $FG_ROOT: "
+              << xmlMSec << " ms from XML, " << recordMSec << " ms recording, "
+              << cachedMSec << " ms from the cache" << std::endl;
+}
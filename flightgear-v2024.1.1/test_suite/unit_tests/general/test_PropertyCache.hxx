@@ -0,0 +1,28 @@
+/*
+ * SPDX-FileName: test_PropertyCache.hxx
+ * SPDX-FileComment: checks and times the compiled property list cache on $FG_ROOT
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class PropertyCacheTests : public CppUnit::TestFixture
+{
+    // Set up the test suite.
+    CPPUNIT_TEST_SUITE(PropertyCacheTests);
+    CPPUNIT_TEST(testFGRootFiles);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    // Set up function for each test.
+    void setUp();
+
+    // Clean up after each test.
+    void tearDown();
+
+    // The unit tests.
+    void testFGRootFiles();
+};
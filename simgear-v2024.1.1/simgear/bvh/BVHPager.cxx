@@ -22,6 +22,7 @@
 #include <list>
 #include <mutex>
 
+#include <simgear/structure/SGTraceRecorder.hxx>
 #include <simgear/threads/SGThread.hxx>
 
 #include "BVHPageNode.hxx"
@@ -96,11 +97,13 @@ struct BVHPager::_PrivateData : protected SGThread {
 
     virtual void run()
     {
+        TraceRecorder::setThreadName("bvh-pager");
         for (;;) {
             _Request request = _pendingRequests._pop();
             // This means stop working
             if (!request.valid())
                 return;
+            TraceScope trace("bvh", "load request");
             request->load();
             _processedRequests._push(request);
         }
@@ -160,6 +163,7 @@ struct BVHPager::_PrivateData : protected SGThread {
             request = _processedRequests._pop();
             if (!request.valid())
                 break;
+            TraceScope trace("bvh", "insert request");
             request->insert();
         }
 
@@ -23,6 +23,8 @@
 #include "Canvas.hxx"
 #include "CanvasEventManager.hxx"
 
+#include <simgear/canvas/elements/CanvasText.hxx>
+
 namespace simgear
 {
 namespace canvas
@@ -61,6 +63,29 @@ namespace canvas
     return static_cast<Canvas*>( getElement(name).get() );
   }
 
+  //----------------------------------------------------------------------------
+  void CanvasMgr::shutdown()
+  {
+    PropertyBasedMgr::shutdown();
+    _layoutCacheNode.reset();
+
+    // Release the fonts and glyph textures held by the cached text layouts
+    // while OSG is still up
+    Text::clearLayoutCache();
+  }
+
+  //----------------------------------------------------------------------------
+  void CanvasMgr::update(double delta_time_sec)
+  {
+    PropertyBasedMgr::update(delta_time_sec);
+
+    if( !_layoutCacheNode )
+      _layoutCacheNode = _props->getNode("text-layout-cache", true);
+    _layoutCacheNode->setLongValue("hits", Text::layoutCacheHits());
+    _layoutCacheNode->setLongValue("misses", Text::layoutCacheMisses());
+    _layoutCacheNode->setIntValue("entries", Text::layoutCacheSize());
+  }
+
   //----------------------------------------------------------------------------
   void CanvasMgr::elementCreated(PropertyBasedElementPtr element)
   {
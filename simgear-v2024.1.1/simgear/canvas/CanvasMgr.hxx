@@ -60,8 +60,15 @@ public:
      */
     CanvasPtr getCanvas(const std::string& name) const;
 
+    // Subsystem API.
+    void shutdown() override;
+    void update(double delta_time_sec) override;
+
 protected:
     void elementCreated(PropertyBasedElementPtr element) override;
+
+    /** Statistics of the text layout cache, below the property root */
+    SGPropertyNode_ptr _layoutCacheNode;
 };
 
 } // namespace canvas
@@ -90,46 +90,93 @@ namespace canvas
   {
     Group::updateImpl(dt);
 
-    for(auto& it: _geo_nodes)
+    if( _geo_pairs_dirty )
+      updateGeoPairs();
+
+    // Parse the coordinates which changed. Pairs which fail to parse stay
+    // dirty, so they are neither projected nor written.
+    std::vector<size_t> changed;
+    for(size_t i = 0; i < _geo_pairs.size(); ++i)
     {
-      GeoNodePair* geo_node = it.second.get();
-      if(    !geo_node->isComplete()
-          || (!geo_node->isDirty() && !_projection_dirty) )
+      GeoNodePair* geo_node = _geo_pairs[i];
+      if( !geo_node->isDirty() )
         continue;
 
-      double latD = -9999.0, lonD = -9999.0;
-      if (geo_node->isDirty()) {
-        GeoCoord lat = parseGeoCoord(geo_node->getLat());
-        if( lat.type != GeoCoord::LATITUDE )
-          continue;
-        
-        GeoCoord lon = parseGeoCoord(geo_node->getLon());
-        if( lon.type != GeoCoord::LONGITUDE )
-          continue;
-        
-        // save the parsed values so we can re-use them if only projection
-        // is changed (very common case for moving vehicle)
-        latD = lat.value;
-        lonD = lon.value;
-        geo_node->setCachedLatLon(std::make_pair(latD, lonD));
-      } else {
-        std::tie(latD, lonD) = geo_node->getCachedLatLon();
-      }
-      
-      Projection::ScreenPosition pos = _projection->worldToScreen(latD, lonD);
-      geo_node->setScreenPos(pos.x, pos.y);
+      GeoCoord lat = parseGeoCoord(geo_node->getLat());
+      if( lat.type != GeoCoord::LATITUDE )
+        continue;
+
+      GeoCoord lon = parseGeoCoord(geo_node->getLon());
+      if( lon.type != GeoCoord::LONGITUDE )
+        continue;
 
-//      geo_node->print();
+      // save the parsed values so we can re-use them if only projection
+      // is changed (very common case for moving vehicle)
+      geo_node->setCachedLatLon(std::make_pair(lat.value, lon.value));
+      _geo_lat[i] = lat.value;
+      _geo_lon[i] = lon.value;
       geo_node->setDirty(false);
+      changed.push_back(i);
+    }
+
+    if( _projection_dirty )
+    {
+      _projection->worldToScreen( _geo_pairs.size(),
+                                  _geo_lat.data(), _geo_lon.data(),
+                                  _screen_x.data(), _screen_y.data() );
+      for(size_t i = 0; i < _geo_pairs.size(); ++i)
+      {
+        if( !_geo_pairs[i]->isDirty() )
+          _geo_pairs[i]->setScreenPos(_screen_x[i], _screen_y[i]);
+      }
+    }
+    else
+    {
+      for(size_t i: changed)
+      {
+        Projection::ScreenPosition pos =
+          _projection->worldToScreen(_geo_lat[i], _geo_lon[i]);
+        _geo_pairs[i]->setScreenPos(pos.x, pos.y);
+      }
     }
+
     _projection_dirty = false;
   }
 
+  //----------------------------------------------------------------------------
+  void Map::updateGeoPairs()
+  {
+    // Both nodes of a pair map to it, only take it for its latitude node
+    _geo_pairs.clear();
+    for(auto& it: _geo_nodes)
+    {
+      GeoNodePair* geo_node = it.second.get();
+      if( geo_node->isComplete() && geo_node->getNodeLat() == it.first )
+        _geo_pairs.push_back(geo_node);
+    }
+
+    const size_t count = _geo_pairs.size();
+    _geo_lat.resize(count);
+    _geo_lon.resize(count);
+    _screen_x.resize(count);
+    _screen_y.resize(count);
+    for(size_t i = 0; i < count; ++i)
+      std::tie(_geo_lat[i], _geo_lon[i]) = _geo_pairs[i]->getCachedLatLon();
+
+    // New pairs need a projection anyway, and the order of the arrays has
+    // changed: simply project everything
+    _projection_dirty = true;
+    _geo_pairs_dirty = false;
+  }
+
   //----------------------------------------------------------------------------
   void Map::childAdded(SGPropertyNode* parent, SGPropertyNode* child)
   {
     if( strutils::ends_with(child->getNameString(), GEO) )
+    {
       _geo_nodes[child].reset(new GeoNodePair());
+      _geo_pairs_dirty = true;
+    }
     else if( parent != _node && child->getNameString() == HDG )
       _hdg_nodes.insert(child);
     else
@@ -140,8 +187,11 @@ namespace canvas
   void Map::childRemoved(SGPropertyNode* parent, SGPropertyNode* child)
   {
     if( strutils::ends_with(child->getNameString(), GEO) )
+    {
       // TODO remove from other node
       _geo_nodes.erase(child);
+      _geo_pairs_dirty = true;
+    }
     else if( parent != _node && child->getNameString() == HDG )
     {
       _hdg_nodes.erase(child);
@@ -238,6 +288,9 @@ namespace canvas
     if( !(geo_node->getStatus() & GeoNodePair::INCOMPLETE) )
       return;
 
+    // The pairing may change below
+    _geo_pairs_dirty = true;
+
     // Detect lat, lon tuples...
     GeoCoord coord = parseGeoCoord(child->getStringValue());
     int index_other = -1;
@@ -26,6 +26,7 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace simgear
 {
@@ -65,6 +66,15 @@ namespace canvas
       std::shared_ptr<HorizontalProjection> _projection;
       bool _projection_dirty = false;
 
+      /// Every complete GeoNodePair once, with its coordinates packed into
+      /// arrays so a projection change is a single batch transform.
+      std::vector<GeoNodePair*> _geo_pairs;
+      std::vector<double> _geo_lat,
+                          _geo_lon,
+                          _screen_x,
+                          _screen_y;
+      bool _geo_pairs_dirty = false;
+
       struct GeoCoord
       {
         enum
@@ -76,6 +86,8 @@ namespace canvas
         double value = 0;
       };
 
+      void updateGeoPairs();
+
       void projectionNodeChanged(SGPropertyNode* child);
       void geoNodeChanged(SGPropertyNode* child);
       void hdgNodeChanged(SGPropertyNode* child);
@@ -22,21 +22,113 @@
 #include "CanvasText.hxx"
 #include <simgear/canvas/Canvas.hxx>
 #include <simgear/canvas/CanvasSystemAdapter.hxx>
+#include <simgear/misc/lru_cache.hxx>
 #include <simgear/scene/util/parse_color.hxx>
 #include <osg/Version>
 #include <osgDB/Registry>
 #include <osgText/Text>
 
+#include <atomic>
+#include <tuple>
+
 namespace simgear
 {
 namespace canvas
 {
+#if !OSG_VERSION_LESS_THAN(3,6,5)
+  /**
+   * Everything osgText::Text::computeGlyphRepresentation() depends on, and
+   * the padding and backdrop which grow the bounding box around the glyphs
+   */
+  struct TextLayoutKey
+  {
+    osg::ref_ptr<osgText::Font> font;
+    unsigned int font_width,
+                 font_height;
+    float character_height,
+          character_aspect,
+          line_spacing,
+          maximum_width,
+          maximum_height,
+          margin,
+          backdrop_horizontal_offset,
+          backdrop_vertical_offset;
+    int alignment,
+        layout,
+        kerning,
+        technique,
+        backdrop;
+    osgText::String text;
+
+    bool operator<(const TextLayoutKey& rhs) const
+    {
+      return std::tie( text, font, font_width, font_height,
+                       character_height, character_aspect, line_spacing,
+                       maximum_width, maximum_height,
+                       margin, backdrop_horizontal_offset,
+                       backdrop_vertical_offset,
+                       alignment, layout, kerning, technique, backdrop )
+           < std::tie( rhs.text, rhs.font, rhs.font_width, rhs.font_height,
+                       rhs.character_height, rhs.character_aspect,
+                       rhs.line_spacing,
+                       rhs.maximum_width, rhs.maximum_height,
+                       rhs.margin, rhs.backdrop_horizontal_offset,
+                       rhs.backdrop_vertical_offset,
+                       rhs.alignment, rhs.layout, rhs.kerning, rhs.technique,
+                       rhs.backdrop );
+    }
+  };
+
+  /**
+   * The glyph quads of a laid out text, in text coordinates. Shared by all
+   * text elements showing the same string with the same font and layout.
+   */
+  struct TextLayout
+  {
+    struct Quads
+    {
+      osg::ref_ptr<osgText::GlyphTexture> texture;
+      osgText::Text::GlyphQuads::Glyphs glyphs;
+      std::vector<unsigned int> indices;
+    };
+
+    std::vector<osg::Vec3> coords;
+    std::vector<osg::Vec2> tex_coords;
+    std::vector<Quads> quads;
+    unsigned int line_count = 0;
+    /// around the glyphs only, padding and backdrop are added by
+    /// computePositions()
+    osg::BoundingBox glyph_bb;
+  };
+
+  using TextLayoutPtr = std::shared_ptr<const TextLayout>;
+
+  using TextLayoutCache = lru_cache<TextLayoutKey, TextLayoutPtr>;
+
+  // Instruments keep redrawing the same readouts, remember the most
+  // recently used layouts of all text elements.
+  //
+  // The layouts reference fonts and glyph textures. Releasing those from a
+  // static destructor could run after OSG's own statics are gone, so the
+  // cache is never destroyed: CanvasMgr::shutdown() empties it instead.
+  static TextLayoutCache& textLayoutCache()
+  {
+    static TextLayoutCache* cache = new TextLayoutCache(4096);
+    return *cache;
+  }
+  static std::atomic<size_t> text_layout_hits{0},
+                             text_layout_misses{0};
+#endif
+
   class Text::TextOSG:
     public osgText::Text
   {
     public:
       TextOSG(canvas::Text* text);
 
+      /// Set UTF-8 encoded text, ignoring the unchanged text
+      void setTextUTF8(const std::string& text);
+
       void setFontResolution(int res);
       void setCharacterAspect(float aspect);
       void setLineHeight(float factor);
@@ -67,8 +159,16 @@ namespace canvas
       friend class TextLine;
 
       canvas::Text *_text_element;
+      std::string _utf8_text;
 
      void computePositionsImplementation() override;
+#if !OSG_VERSION_LESS_THAN(3,6,5)
+      void computeGlyphRepresentation() override;
+
+      TextLayoutKey layoutKey(osgText::Font* font) const;
+      TextLayoutPtr captureLayout() const;
+      void restoreLayout(const TextLayout& layout);
+#endif
 };
 
   class TextLine
@@ -231,6 +331,18 @@ namespace canvas
     setBackdropImplementation(NO_DEPTH_BUFFER);
   }
 
+  //----------------------------------------------------------------------------
+  void Text::TextOSG::setTextUTF8(const std::string& text)
+  {
+    // Most text properties are rewritten every frame with the same value,
+    // skip decoding them
+    if( text == _utf8_text )
+      return;
+
+    _utf8_text = text;
+    setText(text, osgText::String::ENCODING_UTF8);
+  }
+
   //----------------------------------------------------------------------------
   void Text::TextOSG::setFontResolution(int res)
   {
@@ -636,6 +748,135 @@ namespace canvas
     TextBase::computePositionsImplementation();
   }
 
+#if !OSG_VERSION_LESS_THAN(3,6,5)
+  //----------------------------------------------------------------------------
+  void Text::TextOSG::computeGlyphRepresentation()
+  {
+    osgText::Font* font = getActiveFont();
+    if( !font || _text.empty() )
+      return osgText::Text::computeGlyphRepresentation();
+
+    const TextLayoutKey key = layoutKey(font);
+    if( auto layout = textLayoutCache().get(key) )
+    {
+      ++text_layout_hits;
+      return restoreLayout(**layout);
+    }
+
+    ++text_layout_misses;
+    osgText::Text::computeGlyphRepresentation();
+    textLayoutCache().insert(key, captureLayout());
+  }
+
+  //----------------------------------------------------------------------------
+  TextLayoutKey Text::TextOSG::layoutKey(osgText::Font* font) const
+  {
+    return TextLayoutKey{
+      font,
+      _fontSize.first,
+      _fontSize.second,
+      _characterHeight,
+      getCharacterAspectRatio(),
+      _lineSpacing,
+      _maximumWidth,
+      _maximumHeight,
+      _textBBMargin,
+      _backdropHorizontalOffset,
+      _backdropVerticalOffset,
+      _alignment,
+      _layout,
+      _kerningType,
+      _shaderTechnique,
+      _backdropType,
+      _text
+    };
+  }
+
+  //----------------------------------------------------------------------------
+  TextLayoutPtr Text::TextOSG::captureLayout() const
+  {
+    auto layout = std::make_shared<TextLayout>();
+    layout->coords.assign(_coords->begin(), _coords->end());
+    layout->tex_coords.assign(_texcoords->begin(), _texcoords->end());
+
+    for(const auto& it: _textureGlyphQuadMap)
+    {
+      const GlyphQuads& glyph_quads = it.second;
+      if( glyph_quads._glyphs.empty() || !glyph_quads._primitives.valid() )
+        continue;
+
+      TextLayout::Quads quads;
+      quads.texture = it.first;
+      quads.glyphs = glyph_quads._glyphs;
+
+      const osg::DrawElements* primitives = glyph_quads._primitives.get();
+      quads.indices.resize(primitives->getNumIndices());
+      for(unsigned int i = 0; i < quads.indices.size(); ++i)
+        quads.indices[i] = primitives->index(i);
+
+      layout->quads.push_back(std::move(quads));
+    }
+
+    layout->line_count = _lineCount;
+    layout->glyph_bb = _textBB;
+    return layout;
+  }
+
+  //----------------------------------------------------------------------------
+  void Text::TextOSG::restoreLayout(const TextLayout& layout)
+  {
+    // Same state as osgText::Text::computeGlyphRepresentation() leaves
+    // behind, reusing our arrays and primitives
+    _coords->assign(layout.coords.begin(), layout.coords.end());
+    _coords->dirty();
+    _texcoords->assign(layout.tex_coords.begin(), layout.tex_coords.end());
+    _texcoords->dirty();
+    _colorCoords->clear();
+
+    for(auto& it: _textureGlyphQuadMap)
+    {
+      GlyphQuads& glyph_quads = it.second;
+      glyph_quads._glyphs.clear();
+      if( glyph_quads._primitives.valid() )
+      {
+        glyph_quads._primitives->resizeElements(0);
+        glyph_quads._primitives->dirty();
+      }
+    }
+
+    for(const auto& quads: layout.quads)
+    {
+      GlyphQuads& glyph_quads = _textureGlyphQuadMap[quads.texture];
+      glyph_quads._glyphs = quads.glyphs;
+
+      osg::DrawElements* primitives = glyph_quads._primitives.get();
+      if( !primitives )
+      {
+        if( _text.size() * 4 >= 16384 )
+          primitives = new osg::DrawElementsUInt(GL_TRIANGLES);
+        else
+          primitives = new osg::DrawElementsUShort(GL_TRIANGLES);
+        primitives->setBufferObject(_ebo.get());
+        glyph_quads._primitives = primitives;
+      }
+
+      primitives->reserveElements(quads.indices.size());
+      for(unsigned int index: quads.indices)
+        primitives->addElement(index);
+      primitives->dirty();
+    }
+
+    // the alignment offsets are taken from the glyph box, then it is grown
+    // by the padding and backdrop, as after a fresh layout
+    _lineCount = layout.line_count;
+    _textBB = layout.glyph_bb;
+
+    computePositions();
+    computeColorGradients();
+    setupDecoration();
+  }
+#endif
+
  //----------------------------------------------------------------------------
 
   //----------------------------------------------------------------------------
@@ -706,7 +947,7 @@ namespace canvas
   //----------------------------------------------------------------------------
   void Text::setText(const std::string &text)
   {
-    _text->setText(text, osgText::String::ENCODING_UTF8);
+    _text->setTextUTF8(text);
   }
 
   //----------------------------------------------------------------------------
@@ -790,6 +1031,44 @@ namespace canvas
     return _text->lineAt(line).cursorPos(character);
   }
 
+  //----------------------------------------------------------------------------
+  size_t Text::layoutCacheHits()
+  {
+#if OSG_VERSION_LESS_THAN(3,6,5)
+    return 0;
+#else
+    return text_layout_hits;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  size_t Text::layoutCacheMisses()
+  {
+#if OSG_VERSION_LESS_THAN(3,6,5)
+    return 0;
+#else
+    return text_layout_misses;
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  size_t Text::layoutCacheSize()
+  {
+#if OSG_VERSION_LESS_THAN(3,6,5)
+    return 0;
+#else
+    return textLayoutCache().size();
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+  void Text::clearLayoutCache()
+  {
+#if !OSG_VERSION_LESS_THAN(3,6,5)
+    textLayoutCache().clear();
+#endif
+  }
+
   //----------------------------------------------------------------------------
   osg::StateSet* Text::getOrCreateStateSet()
   {
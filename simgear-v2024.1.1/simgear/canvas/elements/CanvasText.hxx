@@ -75,6 +75,24 @@ namespace canvas
        */
       osg::Vec2 getCursorPos(size_t line, size_t character) const;
 
+      /**
+       * Lookups of the glyph layout cache shared by all text elements,
+       * which found a layout for the text, font and alignment.
+       */
+      static size_t layoutCacheHits();
+
+      /// Lookups of the glyph layout cache which had to lay out the text.
+      static size_t layoutCacheMisses();
+
+      /// Number of layouts in the glyph layout cache.
+      static size_t layoutCacheSize();
+
+      /**
+       * Drop all cached glyph layouts, and with them the references to
+       * their fonts. The elements keep their current layout.
+       */
+      static void clearLayoutCache();
+
     protected:
 
       friend class TextLine;
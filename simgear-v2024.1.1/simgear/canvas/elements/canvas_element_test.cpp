@@ -4,9 +4,281 @@
 
 #include "CanvasElement.hxx"
 #include "CanvasGroup.hxx"
+#include "CanvasText.hxx"
+#include "map/projection.hxx"
+
+#include <osg/Version>
+
+#include <algorithm>
+#include <cmath>
 
 namespace sc = simgear::canvas;
 
+namespace
+{
+  const double EARTH_RADIUS_EQUATOR_NM = 6378137.0 / 1852,
+               EARTH_RADIUS_POLAR_NM = 6356752.314 / 1852;
+
+  /// Reference map parameters, in the units of the projection setters
+  struct MapView
+  {
+    double lat, lon, orientation, range, screen_range;
+  };
+
+  /// Scale and rotate unscaled projected coordinates onto the screen
+  sc::Projection::ScreenPosition toScreen( const MapView& view,
+                                           double x, double y )
+  {
+    // the orientation is a float, as in HorizontalProjection::setOrientation
+    const float hdg = SGMiscf::deg2rad(float(view.orientation));
+    const double scale = view.screen_range / view.range,
+                 cos_hdg = cos(hdg),
+                 sin_hdg = sin(hdg);
+    x *= scale;
+    y *= scale;
+    return sc::Projection::ScreenPosition( cos_hdg * x - sin_hdg * y,
+                                          -sin_hdg * x - cos_hdg * y );
+  }
+
+  /// Sanson-Flamsteed, one point at a time
+  sc::Projection::ScreenPosition sansonReference( const MapView& view,
+                                                  double lat, double lon )
+  {
+    lat = SGMiscd::deg2rad(lat);
+    const double d_lat = lat - SGMiscd::deg2rad(view.lat),
+                 d_lon = SGMiscd::deg2rad(lon) - SGMiscd::deg2rad(view.lon),
+                 a = cos(lat) / EARTH_RADIUS_EQUATOR_NM,
+                 b = sin(lat) / EARTH_RADIUS_POLAR_NM,
+                 r = 1.0 / sqrt(a * a + b * b);
+    return toScreen(view, r * cos(lat) * d_lon, r * d_lat);
+  }
+
+  /// WebMercator, one point at a time
+  sc::Projection::ScreenPosition mercatorReference( const MapView& view,
+                                                    double lat, double lon )
+  {
+    const double d_lat = SGMiscd::deg2rad(lat - view.lat),
+                 d_lon = SGMiscd::deg2rad(lon - view.lon),
+                 r = 6378137.f / 1852;
+    return toScreen(view, r * d_lon, r * log(tan(d_lat) + 1.0 / cos(d_lat)));
+  }
+
+  void checkClose(double value, double expected)
+  {
+    BOOST_CHECK_SMALL(value - expected, 1e-9 * std::max(1.0, fabs(expected)));
+  }
+
+  /**
+   * Project points in one batch and compare them with the reference: the
+   * center, points at the edge of the range, near the poles, and across
+   * the antimeridian, which the projections do not wrap.
+   */
+  template<class Proj>
+  void checkBatchProjection( const MapView& view,
+                             sc::Projection::ScreenPosition (*reference)
+                               (const MapView&, double, double) )
+  {
+    Proj proj;
+    proj.setWorldPosition(view.lat, view.lon);
+    proj.setOrientation(view.orientation);
+    proj.setRange(view.range);
+    proj.setScreenRange(view.screen_range);
+
+    // one degree of latitude is 60 nm, one of longitude 60 * cos(lat) nm
+    const double edge_lat = view.range / 60,
+                 edge_lon = view.range / (60 * cos(SGMiscd::deg2rad(view.lat)));
+    const double lat[] = {
+      view.lat, view.lat + edge_lat, view.lat - edge_lat, view.lat, view.lat,
+      60.0, -10.0, 89.9, -38.0,
+      view.lat, view.lat, view.lat + 0.1
+    };
+    const double lon[] = {
+      view.lon, view.lon, view.lon, view.lon + edge_lon, view.lon - edge_lon,
+      170.0, 179.8, 179.8, 179.0,
+      -179.9, -180.0, 180.0
+    };
+    const size_t count = sizeof(lat) / sizeof(lat[0]);
+    double x[count], y[count];
+
+    proj.worldToScreen(count, lat, lon, x, y);
+    for(size_t i = 0; i < count; ++i)
+    {
+      const sc::Projection::ScreenPosition expected =
+        reference(view, lat[i], lon[i]);
+      checkClose(x[i], expected.x);
+      checkClose(y[i], expected.y);
+    }
+
+    BOOST_CHECK_SMALL(x[0], 1e-9);
+    BOOST_CHECK_SMALL(y[0], 1e-9);
+  }
+}
+
+namespace
+{
+  /// Cursor positions of all characters, taken from the glyph quads
+  std::vector<osg::Vec2> textLayout(const sc::Text& text)
+  {
+    std::vector<osg::Vec2> positions;
+    for(size_t line = 0; line < text.lineCount(); ++line)
+      for(size_t c = 0; c <= text.lineLength(line); ++c)
+        positions.push_back(text.getCursorPos(line, c));
+    return positions;
+  }
+
+  void checkSameLayout(const sc::Text& a, const sc::Text& b)
+  {
+    BOOST_CHECK_EQUAL(a.lineCount(), b.lineCount());
+    BOOST_CHECK(textLayout(a) == textLayout(b));
+
+    const osg::BoundingBox bb_a = a.getBoundingBox(),
+                           bb_b = b.getBoundingBox();
+    BOOST_CHECK(bb_a._min == bb_b._min);
+    BOOST_CHECK(bb_a._max == bb_b._max);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( text_layout_cache )
+{
+#if !OSG_VERSION_LESS_THAN(3,6,5)
+  sc::Text::clearLayoutCache();
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheSize(), 0u);
+
+  // the default font, no canvas needed
+  SGPropertyNode_ptr node_a = new SGPropertyNode,
+                     node_b = new SGPropertyNode;
+  sc::TextPtr a = new sc::Text(sc::CanvasWeakPtr(), node_a, sc::Style()),
+              b = new sc::Text(sc::CanvasWeakPtr(), node_b, sc::Style());
+
+  const size_t hits = sc::Text::layoutCacheHits(),
+               misses = sc::Text::layoutCacheMisses();
+
+  // laid out by osgText
+  a->setText("ALT 12500\nHDG 270");
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses + 1);
+  BOOST_CHECK_EQUAL(a->lineCount(), 2u);
+
+  // the same text and style comes from the cache, with the same layout
+  b->setText("ALT 12500\nHDG 270");
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheHits(), hits + 1);
+  checkSameLayout(*a, *b);
+
+  // editing the text lays it out again
+  b->setText("ALT 12600\nHDG 275\nVS -500");
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses + 2);
+  BOOST_CHECK_EQUAL(b->lineCount(), 3u);
+  BOOST_CHECK(textLayout(*a) != textLayout(*b));
+
+  a->setText("ALT 12600\nHDG 275\nVS -500");
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheHits(), hits + 2);
+  checkSameLayout(*a, *b);
+
+  // so does changing the style
+  node_b->setDoubleValue("character-size", 64);
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses + 3);
+  BOOST_CHECK(textLayout(*a) != textLayout(*b));
+
+  // back to a cached text, the layout from before the edits
+  b->setText("ALT 12500\nHDG 270");
+  node_b->setDoubleValue("character-size", 32);
+  a->setText("ALT 12500\nHDG 270");
+  checkSameLayout(*a, *b);
+
+  // without the cache, osgText lays out the same again
+  sc::Text::clearLayoutCache();
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheSize(), 0u);
+
+  SGPropertyNode_ptr node_c = new SGPropertyNode;
+  sc::TextPtr c = new sc::Text(sc::CanvasWeakPtr(), node_c, sc::Style());
+  const size_t misses_before = sc::Text::layoutCacheMisses();
+  c->setText("ALT 12500\nHDG 270");
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses_before + 1);
+  checkSameLayout(*a, *c);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE( text_layout_cache_key )
+{
+#if !OSG_VERSION_LESS_THAN(3,6,5)
+  // the same text, differing only in padding or outline
+  enum Variant { PLAIN, PADDED, OUTLINED };
+  auto makeText = [](Variant variant)
+  {
+    SGPropertyNode_ptr node = new SGPropertyNode;
+    sc::TextPtr text = new sc::Text(sc::CanvasWeakPtr(), node, sc::Style());
+    if( variant == PADDED )
+      node->setDoubleValue("padding", 8);
+    else if( variant == OUTLINED )
+      node->setStringValue("stroke", "#ff0000");
+    text->setText("FL350");
+    return text;
+  };
+  const Variant variants[] = { PLAIN, PADDED, OUTLINED };
+
+  sc::Text::clearLayoutCache();
+  const size_t misses = sc::Text::layoutCacheMisses();
+
+  // each has its own entry
+  std::vector<sc::TextPtr> first;
+  for(Variant variant: variants)
+    first.push_back(makeText(variant));
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses + 3);
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheSize(), 3u);
+
+  // restored from the cache...
+  std::vector<sc::TextPtr> cached;
+  for(Variant variant: variants)
+    cached.push_back(makeText(variant));
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses + 3);
+
+  // ...the same as laid out again
+  sc::Text::clearLayoutCache();
+  for(size_t i = 0; i < cached.size(); ++i)
+  {
+    sc::TextPtr fresh = makeText(variants[i]);
+    checkSameLayout(*cached[i], *fresh);
+  }
+  BOOST_CHECK_EQUAL(sc::Text::layoutCacheMisses(), misses + 6);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE( projection_batch )
+{
+  for(const MapView& view: { MapView{46.0, 179.8, 0, 40, 200},
+                             MapView{46.0, 179.8, 30, 40, 200},
+                             MapView{33.9, -118.4, -45, 10, 512},
+                             MapView{0, 0, 180, 100, 200} })
+  {
+    checkBatchProjection<sc::SansonFlamsteedProjection>(view, sansonReference);
+    checkBatchProjection<sc::WebMercatorProjection>(view, mercatorReference);
+  }
+
+  // fixed values, north up: one tenth of a degree east and north of the
+  // equator at 20 screen units per nm. On the equator both projections
+  // scale longitude by the equatorial radius.
+  const double lat[] = { 0.0, 0.1 },
+               lon[] = { 0.1, 0.0 };
+  double x[2], y[2];
+
+  sc::SansonFlamsteedProjection sanson;
+  sanson.setWorldPosition(0, 0);
+  sanson.setRange(10);
+  sanson.worldToScreen(2, lat, lon, x, y);
+  BOOST_CHECK_CLOSE(x[0], 120.21543, 1e-4);
+  BOOST_CHECK_SMALL(y[0], 1e-9);
+  BOOST_CHECK_SMALL(x[1], 1e-9);
+  BOOST_CHECK_CLOSE(y[1], -120.21543, 1e-4);
+
+  sc::WebMercatorProjection mercator;
+  mercator.setWorldPosition(0, 0);
+  mercator.setRange(10);
+  mercator.worldToScreen(2, lat, lon, x, y);
+  BOOST_CHECK_CLOSE(x[0], 120.21543, 1e-4);
+  BOOST_CHECK_SMALL(y[0], 1e-9);
+  BOOST_CHECK_SMALL(x[1], 1e-9);
+  BOOST_CHECK_CLOSE(y[1], -120.21549, 1e-4);
+}
+
 BOOST_AUTO_TEST_CASE( attr_data )
 {
   // http://www.w3.org/TR/html5/dom.html#attr-data-*
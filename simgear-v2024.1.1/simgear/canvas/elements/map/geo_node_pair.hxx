@@ -89,6 +89,11 @@ namespace canvas
         }
       }
 
+      SGPropertyNode* getNodeLat() const
+      {
+        return _node_lat;
+      }
+
       std::string getLat() const
       {
         return _node_lat ? _node_lat->getStringValue() : "";
@@ -22,6 +22,9 @@
 
 #include <simgear/math/SGMisc.hxx>
 
+#include <cmath>
+#include <cstddef>
+
 namespace simgear
 {
 namespace canvas
@@ -57,6 +60,14 @@ namespace canvas
 
       virtual ScreenPosition worldToScreen(double x, double y) = 0;
 
+      /**
+       * Transform count world positions at once, as worldToScreen(x, y)
+       * would. The output arrays must not overlap the input arrays.
+       */
+      virtual void worldToScreen( size_t count,
+                                  const double* x, const double* y,
+                                  double* screen_x, double* screen_y ) = 0;
+
     protected:
 
       double _screen_range;
@@ -121,30 +132,52 @@ namespace canvas
        * @param lat   Latitude in degrees
        * @param lon   Longitude in degrees
        */
-      ScreenPosition worldToScreen(double lat, double lon)
+      ScreenPosition worldToScreen(double lat, double lon) override
       {
-        lat = SGMiscd::deg2rad(lat);
-        lon = SGMiscd::deg2rad(lon);
-        ScreenPosition pos = project(lat, lon);
-        double scale = _screen_range / _range;
-        pos.x *= scale;
-        pos.y *= scale;
-        return ScreenPosition
-        (
-          _cos_angle * pos.x - _sin_angle * pos.y,
-         -_sin_angle * pos.x - _cos_angle * pos.y
-        );
+        ScreenPosition pos;
+        worldToScreen(1, &lat, &lon, &pos.x, &pos.y);
+        return pos;
+      }
+
+      /**
+       * Transform count world positions to screen positions. Projecting all
+       * nodes of a map in one call keeps the loops free of virtual calls,
+       * so the compiler can vectorize them.
+       *
+       * @param lat   Latitudes in degrees
+       * @param lon   Longitudes in degrees
+       */
+      void worldToScreen( size_t count,
+                          const double* lat, const double* lon,
+                          double* screen_x, double* screen_y ) override
+      {
+        project(count, lat, lon, screen_x, screen_y);
+
+        const double scale = _screen_range / _range,
+                     cos_angle = _cos_angle,
+                     sin_angle = _sin_angle;
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double x = screen_x[i] * scale,
+                       y = screen_y[i] * scale;
+          screen_x[i] =  cos_angle * x - sin_angle * y;
+          screen_y[i] = -sin_angle * x - cos_angle * y;
+        }
       }
 
     protected:
 
       /**
-       * Project given geographic world position to screen space
+       * Project given geographic world positions to screen space
        *
-       * @param lat   Latitude in radians
-       * @param lon   Longitude in radians
+       * @param lat   Latitudes in degrees
+       * @param lon   Longitudes in degrees
+       * @param x     Receives the unscaled, unrotated screen positions
+       * @param y
        */
-      virtual ScreenPosition project(double lat, double lon) const = 0;
+      virtual void project( size_t count,
+                            const double* lat, const double* lon,
+                            double* x, double* y ) const = 0;
 
       double  _ref_lat,   ///<! Reference latitude (radian)
               _ref_lon,   ///<! Reference latitude (radian)
@@ -162,32 +195,35 @@ namespace canvas
   {
     protected:
 
-      virtual ScreenPosition project(double lat, double lon) const
+      void project( size_t count,
+                    const double* lat, const double* lon,
+                    double* x, double* y ) const override
       {
-        double d_lat = lat - _ref_lat,
-               d_lon = lon - _ref_lon;
-        double r = getEarthRadius(lat);
-
-        ScreenPosition pos;
-
-        pos.x = r * cos(lat) * d_lon;
-        pos.y = r * d_lat;
-
-        return pos;
+        const double ref_lat = _ref_lat,
+                     ref_lon = _ref_lon;
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double lat_rad = SGMiscd::deg2rad(lat[i]),
+                       cos_lat = cos(lat_rad);
+          const double r = getEarthRadius(cos_lat, sin(lat_rad));
+
+          x[i] = r * cos_lat * (SGMiscd::deg2rad(lon[i]) - ref_lon);
+          y[i] = r * (lat_rad - ref_lat);
+        }
       }
 
       /**
        * Returns Earth radius at a given latitude (Ellipsoide equation with two
-       * equal axis)
+       * equal axis), from the cosine and sine of the latitude
        */
-      float getEarthRadius(float lat) const
+      static double getEarthRadius(double cos_lat, double sin_lat)
       {
-        const float rec  = 6378137.f / 1852;      // earth radius, equator (?)
-        const float rpol = 6356752.314f / 1852;   // earth radius, polar   (?)
+        const double rec  = 6378137.0 / 1852;      // earth radius, equator (?)
+        const double rpol = 6356752.314 / 1852;    // earth radius, polar   (?)
 
-        double a = cos(lat) / rec;
-        double b = sin(lat) / rpol;
-        return 1.0f / sqrt( a * a + b * b );
+        double a = cos_lat / rec;
+        double b = sin_lat / rpol;
+        return 1.0 / sqrt( a * a + b * b );
       }
   };
 
@@ -200,19 +236,21 @@ namespace canvas
   {
     protected:
 
-      virtual ScreenPosition project(double lat, double lon) const
+      void project( size_t count,
+                    const double* lat, const double* lon,
+                    double* x, double* y ) const override
       {
-        double d_lat = lat - _ref_lat,
-               d_lon = lon - _ref_lon;
-        double r = 6378137.f / 1852; // Equatorial radius divided by ?
-
-        ScreenPosition pos;
-
-        pos.x = r * d_lon;
-        pos.y = r * (log(tan(d_lat) + 1.0 / cos(d_lat)));
-        //pos.x = lon;
-        //pos.y = log(tan(lat) + 1.0 / cos(lat));
-        return pos;
+        const double r = 6378137.f / 1852; // Equatorial radius divided by ?
+        const double ref_lat = _ref_lat,
+                     ref_lon = _ref_lon;
+        for(size_t i = 0; i < count; ++i)
+        {
+          const double d_lat = SGMiscd::deg2rad(lat[i]) - ref_lat,
+                       d_lon = SGMiscd::deg2rad(lon[i]) - ref_lon;
+
+          x[i] = r * d_lon;
+          y[i] = r * (log(tan(d_lat) + 1.0 / cos(d_lat)));
+        }
       }
   };
 
@@ -14,12 +14,15 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 
 #include <simgear/sg_inlines.h>
 #include <simgear/structure/exception.hxx>
-#include <simgear/threads/SGQueue.hxx>
 #include <simgear/threads/SGThread.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 
 #include "LogCallback.hxx"
 #include <simgear/io/iostreams/sgstream.hxx>
@@ -253,6 +256,206 @@ public:
 
 #endif
 
+namespace {
+
+/**
+ * Single producer / single consumer ring of variable sized binary log
+ * records. Each thread which logs owns one, the logging thread is the only
+ * consumer and turns the records into LogEntry objects.
+ */
+class LogRing
+{
+public:
+    struct Record {
+        uint64_t sequence;
+        const char* file;
+        const char* function;
+        int32_t line;
+        uint32_t debugClass;
+        uint32_t size;          ///< message length, 0xffffffff marks padding
+        uint8_t priority;
+        uint8_t originalPriority;
+        uint16_t reserved;
+    };
+
+    static constexpr size_t CAPACITY = 64 * 1024;
+    static constexpr size_t MAX_MESSAGE = CAPACITY / 8 - sizeof(Record);
+    static constexpr uint32_t PADDING = 0xffffffff;
+
+    LogRing() : m_buffer(new uint64_t[CAPACITY / sizeof(uint64_t)]) {}
+
+    /// producer side, false if there is no room for the record
+    bool push(const Record& rec, const char* msg)
+    {
+        const size_t need = recordSize(rec.size);
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        const uint64_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t offset = head & (CAPACITY - 1);
+        const size_t contiguous = CAPACITY - offset;
+        const size_t total = (contiguous < need) ? contiguous + need : need;
+        if (CAPACITY - (head - tail) < total) {
+            return false;
+        }
+
+        char* base = reinterpret_cast<char*>(m_buffer.get());
+        uint64_t pos = head;
+        if (contiguous < need) {
+            // records never wrap, skip the rest of the buffer
+            if (contiguous >= sizeof(Record)) {
+                reinterpret_cast<Record*>(base + offset)->size = PADDING;
+            }
+            pos += contiguous;
+        }
+
+        char* dest = base + (pos & (CAPACITY - 1));
+        memcpy(dest, &rec, sizeof(Record));
+        memcpy(dest + sizeof(Record), msg, rec.size);
+        m_head.store(pos + need, std::memory_order_release);
+        return true;
+    }
+
+    /// consumer side, the oldest record or nullptr
+    const Record* front()
+    {
+        const char* base = reinterpret_cast<const char*>(m_buffer.get());
+        for (;;) {
+            const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_head.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+
+            const size_t offset = tail & (CAPACITY - 1);
+            const size_t contiguous = CAPACITY - offset;
+            const Record* rec = reinterpret_cast<const Record*>(base + offset);
+            if ((contiguous < sizeof(Record)) || (rec->size == PADDING)) {
+                m_tail.store(tail + contiguous, std::memory_order_release);
+                continue;
+            }
+            return rec;
+        }
+    }
+
+    const char* message(const Record* rec) const
+    {
+        return reinterpret_cast<const char*>(rec) + sizeof(Record);
+    }
+
+    void pop(const Record* rec)
+    {
+        const uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        m_tail.store(tail + recordSize(rec->size), std::memory_order_release);
+    }
+
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<bool> m_orphaned{false};    ///< owning thread has exited
+
+private:
+    static size_t recordSize(size_t messageSize)
+    {
+        return (sizeof(Record) + messageSize + 7) & ~size_t(7);
+    }
+
+    std::unique_ptr<uint64_t[]> m_buffer;
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_tail{0};
+};
+
+using LogRingRef = std::shared_ptr<LogRing>;
+
+/// identifies the LogStreamPrivate a thread's ring was registered with
+std::atomic<unsigned> global_logStreamInstance{0};
+
+/// the ring of the calling thread, released for reuse when it exits
+struct ThreadLogRing {
+    LogRingRef ring;
+    unsigned instance = 0;
+
+    ~ThreadLogRing()
+    {
+        if (ring) {
+            ring->m_orphaned = true;
+        }
+    }
+};
+
+thread_local ThreadLogRing threadLogRing;
+
+} // namespace
+
+namespace simgear {
+
+/// appends to a string, which keeps its capacity between messages
+class LogStringBuf : public std::streambuf
+{
+public:
+    std::string text;
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            text.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        text.append(s, n);
+        return n;
+    }
+};
+
+struct LogMessage::ThreadBuffer {
+    ThreadBuffer() : stream(&buf)
+    {
+        buf.text.reserve(256);
+        flags = stream.flags();
+        precision = stream.precision();
+        fill = stream.fill();
+    }
+
+    LogStringBuf buf;
+    std::ostream stream;
+    std::ios_base::fmtflags flags;
+    std::streamsize precision;
+    char fill;
+    bool inUse = false;
+};
+
+LogMessage::LogMessage()
+{
+    static thread_local ThreadBuffer threadBuffer;
+    if (threadBuffer.inUse) {
+        // formatting the outer message logs itself: use a buffer of our own
+        _nested.reset(new ThreadBuffer);
+        _stream = &_nested->stream;
+        _text = &_nested->buf.text;
+        return;
+    }
+
+    _buffer = &threadBuffer;
+    _buffer->inUse = true;
+    _buffer->buf.text.clear();
+    // manipulators of the previous message must not leak into this one
+    _buffer->stream.clear();
+    _buffer->stream.flags(_buffer->flags);
+    _buffer->stream.precision(_buffer->precision);
+    _buffer->stream.fill(_buffer->fill);
+    _buffer->stream.width(0);
+    _stream = &_buffer->stream;
+    _text = &_buffer->buf.text;
+}
+
+LogMessage::~LogMessage()
+{
+    if (_buffer) {
+        _buffer->inUse = false;
+    }
+}
+
+} // namespace simgear
+
 class logstream::LogStreamPrivate : public SGThread
 {
 private:
@@ -406,8 +609,25 @@ public:
         }
     }
 
+    /// entries which could not be put into a ring, in order of sequence
+    struct PendingEntry {
+        uint64_t sequence;
+        simgear::LogEntry entry;
+    };
+
     std::mutex m_lock;
-    SGBlockingQueue<simgear::LogEntry> m_entries;
+
+    std::mutex m_ringsLock;
+    std::vector<LogRingRef> m_rings;
+    std::deque<PendingEntry> m_pending;    ///< guarded by m_ringsLock
+    std::atomic<uint64_t> m_sequence{0};
+    uint64_t m_reportedDrops = 0;
+    const unsigned m_instance = ++global_logStreamInstance;
+
+    std::mutex m_wakeLock;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool> m_writerWaiting{false};
+    std::atomic<bool> m_stopRequested{false};
 
     // log entries posted during startup
     std::vector<simgear::LogEntry> m_startupEntries;
@@ -461,27 +681,132 @@ public:
         m_startupEntries.clear();
     }
 
+    void dispatch(const simgear::LogEntry& entry)
+    {
+        {
+            std::lock_guard<std::mutex> g(m_lock);
+            if (m_startupLogging) {
+                // save to the startup list for not-yet-added callbacks to
+                // pull down on startup
+                m_startupEntries.push_back(entry);
+            }
+        }
+        // submit to each installed callback in turn
+        for (simgear::LogCallback* cb : m_callbacks) {
+            cb->processEntry(entry);
+        }
+    }
+
+    /// pass all queued entries to the callbacks, merging the rings of the
+    /// different threads by sequence number. Returns false if none were queued.
+    bool drain()
+    {
+        std::vector<LogRingRef> rings;
+        std::deque<PendingEntry> pending;
+        // entries logged from now on are left for the next call: they must
+        // not overtake the pending entries queued after the swap below
+        const uint64_t limit = m_sequence.load();
+        {
+            std::lock_guard<std::mutex> g(m_ringsLock);
+            rings = m_rings;
+            pending.swap(m_pending);
+        }
+
+        bool any = false;
+        for (;;) {
+            LogRing* oldest = nullptr;
+            const LogRing::Record* oldestRecord = nullptr;
+            for (const auto& ring : rings) {
+                const LogRing::Record* rec = ring->front();
+                if (rec && (rec->sequence < limit) &&
+                    (!oldestRecord || rec->sequence < oldestRecord->sequence)) {
+                    oldest = ring.get();
+                    oldestRecord = rec;
+                }
+            }
+
+            if (!pending.empty() && (!oldestRecord || pending.front().sequence < oldestRecord->sequence)) {
+                dispatch(pending.front().entry);
+                pending.pop_front();
+            } else if (oldestRecord) {
+                // formatting the entry is deferred to this thread
+                simgear::LogEntry entry(static_cast<sgDebugClass>(oldestRecord->debugClass),
+                                        static_cast<sgDebugPriority>(oldestRecord->priority),
+                                        static_cast<sgDebugPriority>(oldestRecord->originalPriority),
+                                        oldestRecord->file, oldestRecord->line, oldestRecord->function,
+                                        std::string(oldest->message(oldestRecord), oldestRecord->size),
+                                        false);
+                oldest->pop(oldestRecord);
+                dispatch(entry);
+            } else {
+                break;
+            }
+            any = true;
+        }
+
+        const uint64_t dropped = droppedEntryCount();
+        if (dropped > m_reportedDrops) {
+            std::ostringstream os;
+            os << "log buffer full, dropped " << (dropped - m_reportedDrops) << " log messages";
+            m_reportedDrops = dropped;
+            dispatch(simgear::LogEntry(SG_GENERAL, SG_WARN, SG_WARN, __FILE__,
+                                       m_fileLine ? __LINE__ : -__LINE__, __FUNCTION__,
+                                       os.str(), false));
+        }
+
+        return any;
+    }
+
+    bool hasQueuedEntries()
+    {
+        std::lock_guard<std::mutex> g(m_ringsLock);
+        if (!m_pending.empty()) {
+            return true;
+        }
+        for (const auto& ring : m_rings) {
+            if (ring->front()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void wakeWriter()
+    {
+        // pairs with the fence in run(): either the writer sees the new
+        // entry, or we see that it is waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_writerWaiting.load()) {
+            std::lock_guard<std::mutex> g(m_wakeLock);
+            m_wakeCondition.notify_one();
+        }
+    }
+
     void run() override
     {
+        simgear::TraceRecorder::setThreadName("log");
         while (1) {
-            simgear::LogEntry entry(m_entries.pop());
-            // special marker entry detected, terminate the thread since we are
+            const uint64_t traceStart = simgear::TraceRecorder::isEnabled() ? simgear::TraceRecorder::now() : 0;
+            if (drain()) {
+                if (traceStart) {
+                    simgear::TraceRecorder::addSpan("log", "write entries", traceStart, simgear::TraceRecorder::now());
+                }
+                continue;
+            }
+
+            // everything is written, terminate the thread since we are
             // making a configuration change or quitting the app
-            if ((entry.debugClass == SG_NONE) && entry.file && !strcmp(entry.file, "done")) {
+            if (m_stopRequested) {
                 return;
             }
-            {
-                std::lock_guard<std::mutex> g(m_lock);
-                if (m_startupLogging) {
-                    // save to the startup list for not-yet-added callbacks to
-                    // pull down on startup
-                    m_startupEntries.push_back(entry);
-                }
-            }
-            // submit to each installed callback in turn
-            for (simgear::LogCallback* cb : m_callbacks) {
-                cb->processEntry(entry);
+
+            std::unique_lock<std::mutex> g(m_wakeLock);
+            m_writerWaiting = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!m_stopRequested && !hasQueuedEntries()) {
+                m_wakeCondition.wait_for(g, std::chrono::milliseconds(100));
             }
+            m_writerWaiting = false;
         } // of main thread loop
     }
 
@@ -493,16 +818,66 @@ public:
                 return false;
             }
 
-            // log a special marker value, which will cause the thread to wakeup,
-            // and then exit
-            log(SG_NONE, SG_ALERT, "done", -1, "", "", false);
+            m_stopRequested = true;
+            std::lock_guard<std::mutex> w(m_wakeLock);
+            m_wakeCondition.notify_one();
         }
         join();
 
+        m_stopRequested = false;
         m_isRunning = false;
         return true;
     }
 
+    uint64_t droppedEntryCount()
+    {
+        std::lock_guard<std::mutex> g(m_ringsLock);
+        uint64_t dropped = 0;
+        for (const auto& ring : m_rings) {
+            dropped += ring->m_dropped;
+        }
+        return dropped;
+    }
+
+    /// the ring of the calling thread, registered on first use
+    LogRing* threadRing()
+    {
+        ThreadLogRing& tr = threadLogRing;
+        if (tr.ring && (tr.instance == m_instance)) {
+            return tr.ring.get();
+        }
+
+        if (tr.ring) {
+            // left over from a previous logstream
+            tr.ring->m_orphaned = true;
+        }
+
+        std::lock_guard<std::mutex> g(m_ringsLock);
+        tr.ring.reset();
+        for (const auto& ring : m_rings) {
+            bool orphaned = true;
+            if (ring->m_orphaned.compare_exchange_strong(orphaned, false)) {
+                tr.ring = ring;
+                break;
+            }
+        }
+        if (!tr.ring) {
+            tr.ring = std::make_shared<LogRing>();
+            m_rings.push_back(tr.ring);
+        }
+        tr.instance = m_instance;
+        return tr.ring.get();
+    }
+
+    void queueEntry(uint64_t sequence, const simgear::LogEntry& entry)
+    {
+        {
+            std::lock_guard<std::mutex> g(m_ringsLock);
+            m_pending.push_back(PendingEntry{sequence, entry});
+        }
+        wakeWriter();
+    }
+
     void addCallback(simgear::LogCallback* cb)
     {
         PauseThread pause(this);
@@ -562,7 +937,7 @@ public:
 
     void log( sgDebugClass c, sgDebugPriority p,
             const char* fileName, int line, const char* function,
-            const std::string& msg, bool freeFilename)
+            const char* msg, size_t msgSize, bool freeFilename)
     {
         auto tp = translatePriority(p, fileName, line, function, freeFilename);
         if (!m_fileLine) {
@@ -570,8 +945,34 @@ public:
             line = -line;
         }
 
-        simgear::LogEntry entry(c, tp, p, fileName, line, function, msg, freeFilename);
-        m_entries.push(entry);
+        const uint64_t sequence = m_sequence++;
+        if (!freeFilename && (msgSize <= LogRing::MAX_MESSAGE)) {
+            LogRing::Record rec;
+            rec.sequence = sequence;
+            rec.file = fileName;
+            rec.function = function;
+            rec.line = line;
+            rec.debugClass = c;
+            rec.size = msgSize;
+            rec.priority = tp;
+            rec.originalPriority = p;
+            rec.reserved = 0;
+
+            LogRing* ring = threadRing();
+            if (ring->push(rec, msg)) {
+                wakeWriter();
+                return;
+            }
+
+            if (tp < SG_WARN) {
+                ++ring->m_dropped;
+                return;
+            }
+        }
+
+        // owned file names, long messages, and warnings which did not fit
+        queueEntry(sequence, simgear::LogEntry(c, tp, p, fileName, line, function,
+                                               std::string(msg, msgSize), freeFilename));
     }
 
     sgDebugPriority translatePriority(sgDebugPriority in,
@@ -594,6 +995,7 @@ public:
 /////////////////////////////////////////////////////////////////////////////
 
 static std::unique_ptr<logstream> global_logstream;
+static std::atomic<logstream*> global_logstreamPtr{nullptr};
 static std::mutex global_logStreamLock;
 
 logstream::logstream()
@@ -647,7 +1049,15 @@ logstream::log( sgDebugClass c, sgDebugPriority p,
         const char* fileName, int line, const char* function,
         const std::string& msg)
 {
-    d->log(c, p, fileName, line, function, msg, false);
+    d->log(c, p, fileName, line, function, msg.data(), msg.size(), false);
+}
+
+void
+logstream::log( sgDebugClass c, sgDebugPriority p,
+        const char* fileName, int line, const char* function,
+        const simgear::LogMessage& msg)
+{
+    d->log(c, p, fileName, line, function, msg.data(), msg.size(), false);
 }
 
 void
@@ -655,7 +1065,7 @@ logstream::logCopyingFilename( sgDebugClass c, sgDebugPriority p,
          const char* fileName, int line, const char* function,
          const std::string& msg)
 {
-    d->log(c, p, strdup(fileName), line, strdup(function), msg, true);
+    d->log(c, p, strdup(fileName), line, strdup(function), msg.data(), msg.size(), true);
 }
 
 
@@ -851,13 +1261,19 @@ sglog()
     // Force initialization of cerr.
     static std::ios_base::Init initializer;
 
-    // http://www.aristeia.com/Papers/DDJ_Jul_Aug_2004_revised.pdf
-    // in the absence of portable memory barrier ops in Simgear,
-    // let's keep this correct & safe
+    // double-checked locking, every SG_LOG() comes through here so the
+    // common case must not take the lock
+    logstream* ls = global_logstreamPtr.load(std::memory_order_acquire);
+    if (ls) {
+        return *ls;
+    }
+
     std::lock_guard<std::mutex> g(global_logStreamLock);
 
-    if( !global_logstream )
+    if( !global_logstream ) {
         global_logstream.reset(new logstream);
+        global_logstreamPtr.store(global_logstream.get(), std::memory_order_release);
+    }
     return *(global_logstream.get());
 }
 
@@ -917,6 +1333,11 @@ void logstream::requestConsole(bool ignoreErrors)
 #endif
 }
 
+uint64_t logstream::getDroppedEntryCount() const
+{
+    return d->droppedEntryCount();
+}
+
 void
 logstream::setTestingMode( bool testMode )
 {
@@ -937,6 +1358,7 @@ void requestConsole(bool ignoreErrors)
 void shutdownLogging()
 {
     std::lock_guard<std::mutex> g(global_logStreamLock);
+    global_logstreamPtr.store(nullptr, std::memory_order_release);
     global_logstream.reset();
 }
 
@@ -9,6 +9,7 @@
 #include <simgear/compiler.h>
 #include <simgear/debug/debug_types.h>
 
+#include <cstdint>
 #include <sstream>
 #include <vector>
 #include <memory>
@@ -29,6 +30,35 @@ void requestConsole(bool ignoreErrors);
 
 void shutdownLogging();
 
+/**
+ * The message text of one SG_LOG() call. It is formatted into a per-thread
+ * buffer which keeps its capacity, so logging does not allocate once the
+ * buffer has grown to the typical message size.
+ */
+class LogMessage final
+{
+public:
+    LogMessage();
+    ~LogMessage();
+
+    LogMessage(const LogMessage&) = delete;
+    LogMessage& operator=(const LogMessage&) = delete;
+
+    std::ostream& stream() { return *_stream; }
+
+    const char* data() const { return _text->data(); }
+    size_t size() const { return _text->size(); }
+    std::string str() const { return *_text; }
+
+private:
+    struct ThreadBuffer;
+
+    ThreadBuffer* _buffer = nullptr;    ///< null if nested in another message
+    std::unique_ptr<ThreadBuffer> _nested;
+    std::ostream* _stream;
+    const std::string* _text;
+};
+
 } // of namespace simgear
 
 /**
@@ -119,6 +149,11 @@ public:
             const char* fileName, int line, const char* function,
             const std::string& msg);
 
+    // overload used by SG_LOG(), avoids copying the message into a string
+    void log( sgDebugClass c, sgDebugPriority p,
+            const char* fileName, int line, const char* function,
+            const simgear::LogMessage& msg);
+
     // overload of above, which can transfer ownership of the file-name.
     // this is unecesary overhead when logging from C++, since __FILE__ points
     // to constant data, but it's needed when the filename is Nasal data (for
@@ -187,6 +222,12 @@ public:
      */
     void setTestingMode(bool testMode);
 
+    /**
+     * Number of log entries which were discarded because the buffer of the
+     * logging thread was full. Only entries below SG_WARN are discarded.
+     */
+    uint64_t getDroppedEntryCount() const;
+
 private:
     // constructor
     logstream();
@@ -200,6 +241,20 @@ logstream& sglog();
 
 
 
+/** \def SG_LOG_COMPILED_PRIORITY
+ * Messages below this priority are removed at compile time, as are
+ * messages of classes not contained in SG_LOG_COMPILED_CLASSES. Like the
+ * runtime settings these never suppress messages of SG_INFO and above.
+ */
+#ifndef SG_LOG_COMPILED_PRIORITY
+# define SG_LOG_COMPILED_PRIORITY SG_BULK
+#endif
+#ifndef SG_LOG_COMPILED_CLASSES
+# define SG_LOG_COMPILED_CLASSES SG_ALL
+#endif
+#define SG_LOG_COMPILED_IN(C,P) \
+    ((P) >= SG_INFO || (((C) & SG_LOG_COMPILED_CLASSES) && (P) >= SG_LOG_COMPILED_PRIORITY))
+
 /** \def SG_LOG(C,P,M)
  * Log a message.
  * @param C debug class
@@ -207,10 +262,11 @@ logstream& sglog();
  * @param M message
  */
 # define SG_LOGX(C,P,M) \
-    do { if(sglog().would_log(C,P, __FILE__, __LINE__, __FUNCTION__)) { \
-        std::ostringstream os; os << M;                  \
-        sglog().log(C, P, __FILE__, __LINE__, __FUNCTION__, os.str()); \
-        if ((P) == SG_POPUP) sglog().popup(os.str());    \
+    do { if(SG_LOG_COMPILED_IN(C,P) && sglog().would_log(C,P, __FILE__, __LINE__, __FUNCTION__)) { \
+        simgear::LogMessage sg_log_message_; \
+        std::ostream& os = sg_log_message_.stream(); os << M; \
+        sglog().log(C, P, __FILE__, __LINE__, __FUNCTION__, sg_log_message_); \
+        if ((P) == SG_POPUP) sglog().popup(sg_log_message_.str()); \
     } } while(0)
 #ifdef FG_NDEBUG
 # define SG_LOG(C,P,M)	do { if((P) == SG_POPUP) SG_LOGX(C,P,M) } while(0)
@@ -219,7 +275,7 @@ logstream& sglog();
 #else
 # define SG_LOG(C,P,M)	SG_LOGX(C,P,M)
 # define SG_LOG_NAN(C,P,M) do { SG_LOGX(C,P,M); throw std::overflow_error(M); } while(0)
-# define SG_LOG_HEXDUMP(C,P,MEM,LEN) if(sglog().would_log(C,P, __FILE__, __LINE__, __FUNCTION__)) \
+# define SG_LOG_HEXDUMP(C,P,MEM,LEN) if(SG_LOG_COMPILED_IN(C,P) && sglog().would_log(C,P, __FILE__, __LINE__, __FUNCTION__)) \
         sglog().hexdump(C, P, __FILE__, __LINE__, __FUNCTION__, MEM, LEN)
 #endif
 
@@ -0,0 +1,197 @@
+// Unit tests for the logstream rings
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "LogCallback.hxx"
+#include "logstream.hxx"
+
+using simgear::LogCallback;
+using simgear::LogEntry;
+
+namespace {
+
+/**
+ * Records the messages it receives. Receiving "block" stalls the logging
+ * thread until release(), so that the rings fill up.
+ */
+class RecordingCallback : public LogCallback
+{
+public:
+    RecordingCallback() : LogCallback(SG_ALL, SG_BULK) {}
+
+    bool doProcessEntry(const LogEntry& e) override
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _messages.push_back(e.message);
+        if (e.message == "block") {
+            _blocked = true;
+            _cond.notify_all();
+            _cond.wait(lock, [this] { return !_blocked; });
+        }
+        _cond.notify_all();
+        return true;
+    }
+
+    void block()
+    {
+        SG_LOG(SG_GENERAL, SG_DEBUG, "block");
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cond.wait(lock, [this] { return _blocked; });
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _blocked = false;
+        _cond.notify_all();
+    }
+
+    /// the messages received up to the "end" marker logged by this call
+    std::vector<std::string> waitForEnd()
+    {
+        // a warning, not dropped if the ring is still full
+        SG_LOG(SG_GENERAL, SG_WARN, "end");
+        std::unique_lock<std::mutex> lock(_mutex);
+        const bool ended = _cond.wait_for(lock, std::chrono::seconds(10), [this] {
+            return !_messages.empty() && (_messages.back() == "end");
+        });
+        SG_VERIFY(ended);
+
+        std::vector<std::string> result;
+        result.swap(_messages);
+        return result;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::vector<std::string> _messages;
+    bool _blocked = false;
+};
+
+struct LogsWhileFormatted {
+};
+
+std::ostream& operator<<(std::ostream& os, const LogsWhileFormatted&)
+{
+    SG_LOG(SG_GENERAL, SG_DEBUG, "inner " << 42);
+    return os << "outer";
+}
+
+void testNested(RecordingCallback* cb)
+{
+    SG_LOG(SG_GENERAL, SG_DEBUG, "message " << LogsWhileFormatted() << " " << 7);
+
+    const auto messages = cb->waitForEnd();
+    SG_CHECK_EQUAL(messages.size(), 3u);
+    SG_CHECK_EQUAL(messages[0], "inner 42");
+    SG_CHECK_EQUAL(messages[1], "message outer 7");
+}
+
+void testThreadOrdering(RecordingCallback* cb)
+{
+    // threads taking turns, each logging into its own ring
+    const int threads = 4;
+    const int rounds = 50;
+    std::mutex mutex;
+    std::condition_variable cond;
+    int turn = 0;
+
+    cb->block();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int r = 0; r < rounds; ++r) {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&] { return turn % threads == t; });
+                SG_LOG(SG_GENERAL, SG_DEBUG, "seq " << turn);
+                ++turn;
+                cond.notify_all();
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    cb->release();
+
+    const auto messages = cb->waitForEnd();
+    SG_CHECK_EQUAL(messages.size(), static_cast<size_t>(threads * rounds + 2));
+    SG_CHECK_EQUAL(messages.front(), "block");
+    for (int i = 0; i < threads * rounds; ++i) {
+        SG_CHECK_EQUAL(messages[i + 1], "seq " + std::to_string(i));
+    }
+}
+
+void testOverflow(RecordingCallback* cb)
+{
+    const uint64_t droppedBefore = sglog().getDroppedEntryCount();
+
+    // more than the ring of this thread holds
+    const int count = 10000;
+    cb->block();
+    for (int i = 0; i < count; ++i) {
+        SG_LOG(SG_GENERAL, SG_DEBUG, "fill " << i);
+    }
+    const uint64_t dropped = sglog().getDroppedEntryCount() - droppedBefore;
+    SG_CHECK_GT(dropped, 0u);
+    SG_CHECK_LT(dropped, static_cast<uint64_t>(count));
+
+    // warnings are never dropped, and still come after the earlier messages
+    SG_LOG(SG_GENERAL, SG_WARN, "warning");
+    SG_CHECK_EQUAL(sglog().getDroppedEntryCount() - droppedBefore, dropped);
+    cb->release();
+
+    auto messages = cb->waitForEnd();
+
+    // the drops are reported once, when the logging thread notices them
+    const std::string report = "log buffer full, dropped " + std::to_string(dropped) + " log messages";
+    auto it = std::find(messages.begin(), messages.end(), report);
+    SG_VERIFY(it != messages.end());
+    messages.erase(it);
+    SG_VERIFY(std::find(messages.begin(), messages.end(), report) == messages.end());
+
+    // block, kept messages, warning, end
+    const size_t kept = count - dropped;
+    SG_CHECK_EQUAL(messages.size(), kept + 3);
+    SG_CHECK_EQUAL(messages.front(), "block");
+    for (size_t i = 0; i < kept; ++i) {
+        SG_CHECK_EQUAL(messages[i + 1], "fill " + std::to_string(i));
+    }
+    SG_CHECK_EQUAL(messages[kept + 1], "warning");
+
+    // the ring is usable again
+    SG_LOG(SG_GENERAL, SG_DEBUG, "after");
+    const auto after = cb->waitForEnd();
+    SG_CHECK_EQUAL(after.size(), 2u);
+    SG_CHECK_EQUAL(after[0], "after");
+}
+
+} // of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    // also removes the default callbacks
+    sglog().setTestingMode(true);
+
+    auto cb = new RecordingCallback;
+    sglog().addCallback(cb);
+
+    testNested(cb);
+    testThreadOrdering(cb);
+    testOverflow(cb);
+
+    sglog().removeCallback(cb);
+    delete cb;
+    return EXIT_SUCCESS;
+}
@@ -21,14 +21,17 @@
 #include "HTTPRepository.hxx"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
 #include <set>
 #include <sstream>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -123,6 +126,61 @@ std::string computeHashForPath(const SGPath& p)
     return strutils::encodeHex(hashBytes);
 }
 
+/**
+ * Hash several files at once, on up to maxThreads threads. Hashing is
+ * bound by reading the files, so this also bounds the number of files
+ * read concurrently. The first exception of computeHashForPath() is
+ * re-thrown once all threads are done.
+ */
+string_list computeHashesForPaths(const PathList& paths, unsigned int maxThreads)
+{
+    string_list result(paths.size());
+    std::vector<std::exception_ptr> errors(paths.size());
+    std::atomic<size_t> next{0};
+
+    auto worker = [&paths, &result, &errors, &next]() {
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            try {
+                result[i] = computeHashForPath(paths[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    const size_t numThreads = std::min(static_cast<size_t>(maxThreads), paths.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker(); // the calling thread does its share
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    return result;
+}
+
+unsigned int defaultMaxIOThreads()
+{
+    const unsigned int n = std::thread::hardware_concurrency();
+    return std::max(1u, std::min(n, 4u));
+}
+
+/// an index entry of the local copy, as checked by verifyLocalCopy()
+struct LocalEntry {
+    HTTPDirectory* directory;
+    SGPath path;         ///< the file to hash, the .dirindex for a directory
+    SGPath relativePath; ///< of the entry, for reporting
+    std::string hash;    ///< expected, from the index
+};
+
 } // namespace
 
 class HTTPDirectory
@@ -279,8 +337,9 @@ public:
             child.path.set_cached(false);
             child.path.set_cached(true);
 
-            std::string hash = computeHashForPath(child.path);
-            updatedFileContents(child.path, hash);
+            // forget any old entry, updateChildrenBasedOnHash() hashes
+            // the copied files together
+            updatedFileContents(child.path, std::string());
         }
     }
 
@@ -303,6 +362,13 @@ public:
 
       copyInstalledChildren();
 
+      PathList childPaths;
+      childPaths.reserve(children.size());
+      for (const auto& c : children) {
+          childPaths.push_back(hashPathForChild(c));
+      }
+      updateHashesOf(childPaths);
+
       ChildInfoList toBeUpdated;
 
       simgear::Dir d(absolutePath());
@@ -462,54 +528,68 @@ public:
         return _relativePath;
     }
 
+    /**
+     * Extracts a downloaded archive on a thread of its own, so that slow
+     * extraction (Windows AV scanners, large airport archives) neither
+     * blocks the TerraSync worker nor the other tasks of the repository.
+     * At most maxIOThreads archives of a repository are extracted at once.
+     */
     class ArchiveExtractTask {
     public:
       ArchiveExtractTask(SGPath p, const std::string &relPath)
-          : relativePath(relPath), file(p), extractor(p.dir()) {
-        if (!file.open(SG_IO_IN)) {
-          SG_LOG(SG_TERRASYNC, SG_ALERT,
-                 "Unable to open " << p << " to extract");
-          return;
-        }
-
+          : relativePath(relPath), archivePath(p) {
         compressedBytes = p.sizeInBytes();
-        buffer = (uint8_t *)malloc(bufferSize);
       }
 
       ArchiveExtractTask(const ArchiveExtractTask &) = delete;
 
-      HTTPRepoPrivate::ProcessResult run(HTTPRepoPrivate* repo)
+      ~ArchiveExtractTask()
       {
-          if (!buffer) {
-              return HTTPRepoPrivate::ProcessFailed;
+          cancelled = true;
+          if (thread.joinable()) {
+              thread.join();
           }
+      }
 
-          size_t rd = file.read((char*)buffer, bufferSize);
-          repo->bytesExtracted += rd;
-          extractor.extractBytes(buffer, rd);
+      HTTPRepoPrivate::ProcessResult run(HTTPRepoPrivate* repo)
+      {
+          if (!thread.joinable()) {
+              if (repo->activeExtractions >= repo->maxIOThreads) {
+                  return HTTPRepoPrivate::ProcessContinue; // wait for a slot
+              }
 
-          if (file.eof()) {
-              extractor.flush();
-              file.close();
+              ++repo->activeExtractions;
+              thread = std::thread([this]() { extract(); });
+              return HTTPRepoPrivate::ProcessContinue;
+          }
 
-              if (!extractor.isAtEndOfArchive()) {
-                  SG_LOG(SG_TERRASYNC, SG_ALERT, "Corrupt tarball " << relativePath);
-                  repo->failedToUpdateChild(relativePath,
-                                            HTTPRepository::REPO_ERROR_IO);
-                  return HTTPRepoPrivate::ProcessFailed;
-              }
+          const size_t rd = bytesRead;
+          repo->bytesExtracted += rd - bytesReported;
+          bytesReported = rd;
 
-              if (extractor.hasError()) {
-                  SG_LOG(SG_TERRASYNC, SG_ALERT, "Error extracting " << relativePath);
-                  repo->failedToUpdateChild(relativePath,
-                                            HTTPRepository::REPO_ERROR_IO);
-                  return HTTPRepoPrivate::ProcessFailed;
-              }
+          if (!finished) {
+              return HTTPRepoPrivate::ProcessContinue;
+          }
 
+          thread.join();
+          --repo->activeExtractions;
+
+          switch (outcome) {
+          case Extracted:
               return HTTPRepoPrivate::ProcessDone;
+          case OpenFailed:
+              SG_LOG(SG_TERRASYNC, SG_ALERT, "Unable to open " << archivePath << " to extract");
+              return HTTPRepoPrivate::ProcessFailed;
+          case Corrupt:
+              SG_LOG(SG_TERRASYNC, SG_ALERT, "Corrupt tarball " << relativePath);
+              break;
+          case ExtractError:
+              SG_LOG(SG_TERRASYNC, SG_ALERT, "Error extracting " << relativePath);
+              break;
           }
 
-          return HTTPRepoPrivate::ProcessContinue;
+          repo->failedToUpdateChild(relativePath, HTTPRepository::REPO_ERROR_IO);
+          return HTTPRepoPrivate::ProcessFailed;
       }
 
       size_t archiveSizeBytes() const
@@ -517,21 +597,55 @@ public:
           return compressedBytes;
       }
 
-      ~ArchiveExtractTask() { free(buffer); }
+    private:
+      enum Outcome { Extracted, OpenFailed, Corrupt, ExtractError };
+
+      // runs on the extraction thread: touch nothing but our own members
+      void extract()
+      {
+          SGBinaryFile file(archivePath);
+          if (!file.open(SG_IO_IN)) {
+              outcome = OpenFailed;
+              finished = true;
+              return;
+          }
+
+          ArchiveExtractor extractor(archivePath.dir());
+          std::vector<uint8_t> buffer(bufferSize);
+          while (!cancelled) {
+              const size_t rd = file.read(reinterpret_cast<char*>(buffer.data()), bufferSize);
+              bytesRead += rd;
+              extractor.extractBytes(buffer.data(), rd);
+              if (file.eof()) {
+                  break;
+              }
+          }
 
+          extractor.flush();
+          file.close();
 
-    private:
-      // intentionally small so we extract incrementally on Windows
-      // where Defender throttles many small files, sorry
-      // if you make this bigger we will be more efficient but stall for
-      // longer when extracting the Airports_archive
-      const int bufferSize = 1024 * 64;
+          if (cancelled || !extractor.isAtEndOfArchive()) {
+              outcome = Corrupt;
+          } else if (extractor.hasError()) {
+              outcome = ExtractError;
+          } else {
+              outcome = Extracted;
+          }
+          finished = true;
+      }
+
+      const int bufferSize = 1024 * 256;
 
       std::string relativePath;
-      uint8_t *buffer = nullptr;
-      SGBinaryFile file;
-      ArchiveExtractor extractor;
+      SGPath archivePath;
       std::size_t compressedBytes;
+
+      std::thread thread;
+      std::atomic<bool> cancelled{false};
+      std::atomic<bool> finished{false};
+      std::atomic<size_t> bytesRead{0};
+      size_t bytesReported = 0;
+      Outcome outcome = Extracted; ///< valid once finished is set
     };
 
     using ArchiveExtractTaskPtr = std::shared_ptr<ArchiveExtractTask>;
@@ -606,6 +720,76 @@ public:
         _repository->failedToUpdateChild(fpath, status);
     }
 
+    bool hasCurrentHash(const SGPath& p) const
+    {
+        auto it = hashes.find(p.utf8Str());
+        if (it == hashes.end()) {
+            return false;
+        }
+
+        const auto& entry = it->second;
+        return (p.sizeInBytes() == entry.lengthBytes) && (p.modTime() == entry.modTime);
+    }
+
+    /**
+     * Compute the missing and stale hashes of existing files among paths,
+     * concurrently, so the hashForPath() calls which follow are answered
+     * from the cache.
+     */
+    void updateHashesOf(const PathList& paths)
+    {
+        PathList stale;
+        for (const auto& p : paths) {
+            if (p.exists() && !hasCurrentHash(p)) {
+                stale.push_back(p);
+            }
+        }
+
+        if (stale.empty()) {
+            return;
+        }
+
+        const string_list newHashes = computeHashesForPaths(stale, _repository->maxIOThreads);
+        for (size_t i = 0; i < stale.size(); ++i) {
+            updatedFileContents(stale[i], newHashes[i]);
+        }
+
+        // hashing is the expensive part of checking a directory, write the
+        // results right away rather than losing them if we are interrupted
+        writeHashCache();
+    }
+
+    /**
+     * For HTTPRepository::verifyLocalCopy(): add the children accepted by
+     * the sync predicate to entries, and the relative paths of the
+     * subdirectories present on disk to subdirs.
+     */
+    void collectLocalEntries(std::vector<LocalEntry>& entries, string_list& subdirs)
+    {
+        for (const auto& c : children) {
+            const SGPath p = hashPathForChild(c);
+            if (_repository->syncPredicate) {
+                const auto action = p.exists() ? HTTPRepository::SyncAction::UpToDate
+                                               : HTTPRepository::SyncAction::Add;
+                const HTTPRepository::SyncItem item = {relativePath(), c.type, c.name,
+                                                       action, c.path};
+                if (!_repository->syncPredicate(item)) {
+                    continue;
+                }
+            }
+
+            entries.push_back({this, p, SGPath(_relativePath) / c.name, c.hash});
+            if ((c.type == HTTPRepository::DirectoryType) && c.path.isDir()) {
+                subdirs.push_back(_relativePath.empty() ? c.name : _relativePath + "/" + c.name);
+            }
+        }
+    }
+
+    void cacheHash(const SGPath& p, const std::string& hash)
+    {
+        updatedFileContents(p, hash);
+    }
+
     std::string hashForPath(const SGPath& p) const
     {
         const auto ps = p.utf8Str();
@@ -785,13 +969,18 @@ private:
         }
     }
 
-    std::string hashForChild(const ChildInfo& child) const
+    static SGPath hashPathForChild(const ChildInfo& child)
     {
       SGPath p(child.path);
       if (child.type == HTTPRepository::DirectoryType) {
           p.append(".dirindex");
       }
-      return hashForPath(p);
+      return p;
+    }
+
+    std::string hashForChild(const ChildInfo& child) const
+    {
+      return hashForPath(hashPathForChild(child));
     }
 
     void parseHashCache()
@@ -874,6 +1063,7 @@ HTTPRepository::HTTPRepository(const SGPath& base, HTTP::Client *cl) :
 {
     _d->http = cl;
     _d->basePath = base;
+    _d->maxIOThreads = defaultMaxIOThreads();
     _d->rootDir.reset(new HTTPDirectory(_d.get(), ""));
 }
 
@@ -927,20 +1117,29 @@ void HTTPRepository::process()
     int processedCount = 0;
     const int maxToProcess = 16;
 
-    while (processedCount < maxToProcess) {
-      if (_d->pendingTasks.empty()) {
-        break;
-      }
-
-      auto task = _d->pendingTasks.front();
+    // a task which is not done yet (an archive still extracting) must not
+    // hold up the tasks behind it. Tasks may add further tasks while
+    // running, so take a copy and look the task up by index each time.
+    size_t index = 0;
+    while ((processedCount < maxToProcess) && (index < _d->pendingTasks.size())) {
+      auto task = _d->pendingTasks[index];
       auto result = task(_d.get());
+      ++processedCount;
       if (result == HTTPRepoPrivate::ProcessContinue) {
-        // assume we're not complete
-        return;
+        ++index;
+        continue;
       }
 
-      _d->pendingTasks.pop_front();
-      ++processedCount;
+      _d->pendingTasks.erase(_d->pendingTasks.begin() + index);
+    }
+
+    // don't keep dirty hash caches in memory for long, a crash or quit
+    // would lose the work of hashing
+    if (_d->lastHashCacheFlush.elapsedMSec() > 5000) {
+      if (_d->countDirtyHashCaches() > 0) {
+        _d->flushHashCaches();
+      }
+      _d->lastHashCacheFlush.stamp();
     }
 
     _d->checkForComplete();
@@ -1008,6 +1207,97 @@ HTTPRepository::FailureVec HTTPRepository::failures() const {
 
 void HTTPRepository::setFilter(SyncPredicate sp) { _d->syncPredicate = sp; }
 
+void HTTPRepository::setMaxIOThreads(unsigned int count)
+{
+    _d->maxIOThreads = std::max(1u, count);
+}
+
+HTTPRepository::ResultCode HTTPRepository::verifyLocalCopy()
+{
+    if (_d->isUpdating) {
+        SG_LOG(SG_TERRASYNC, SG_WARN, "Repo:" << _d->basePath << " can't verify while syncing");
+        return REPO_ERROR_CANCELLED;
+    }
+
+    _d->failures.clear();
+    _d->status = REPO_NO_ERROR;
+
+    // the tree is checked in batches of whole directories: enough files to
+    // keep the I/O threads busy, without holding the index of the whole
+    // tree in memory. The directories are our own, not those of a sync.
+    const size_t batchSize = 4096;
+    std::vector<HTTPDirectory_ptr> batchDirs;
+    std::vector<LocalEntry> entries;
+
+    auto checkBatch = [this, &batchDirs, &entries]() {
+        PathList stale;
+        std::vector<HTTPDirectory*> staleDirs;
+        for (const auto& e : entries) {
+            if (e.path.exists() && !e.directory->hasCurrentHash(e.path)) {
+                stale.push_back(e.path);
+                staleDirs.push_back(e.directory);
+            }
+        }
+
+        try {
+            const string_list hashes = computeHashesForPaths(stale, _d->maxIOThreads);
+            for (size_t i = 0; i < stale.size(); ++i) {
+                staleDirs[i]->cacheHash(stale[i], hashes[i]);
+            }
+        } catch (sg_exception&) {
+            // the unreadable file is reported below
+        }
+
+        for (const auto& e : entries) {
+            ResultCode code = REPO_NO_ERROR;
+            if (!e.path.exists()) {
+                code = REPO_ERROR_FILE_NOT_FOUND;
+            } else {
+                try {
+                    if (e.directory->hashForPath(e.path) != e.hash) {
+                        code = REPO_ERROR_CHECKSUM;
+                    }
+                } catch (sg_exception&) {
+                    code = REPO_ERROR_IO;
+                }
+            }
+
+            if (code != REPO_NO_ERROR) {
+                SG_LOG(SG_TERRASYNC, SG_INFO, "verify: " << e.relativePath << " "
+                                                         << innerResultCodeAsString(code));
+                _d->failures.push_back({e.relativePath, code});
+            }
+        }
+
+        for (const auto& d : batchDirs) {
+            d->writeHashCache();
+        }
+        batchDirs.clear();
+        entries.clear();
+    };
+
+    string_list pendingDirs = {std::string()};
+    while (!pendingDirs.empty()) {
+        const std::string relPath = pendingDirs.back();
+        pendingDirs.pop_back();
+
+        batchDirs.emplace_back(new HTTPDirectory(_d.get(), relPath));
+        batchDirs.back()->collectLocalEntries(entries, pendingDirs);
+        if (entries.size() >= batchSize) {
+            checkBatch();
+        }
+    }
+    checkBatch();
+
+    if (!_d->failures.empty()) {
+        SG_LOG(SG_TERRASYNC, SG_WARN, "Repo:" << _d->basePath << " verify found "
+                                              << _d->failures.size() << " damaged or missing entries");
+        _d->status = REPO_PARTIAL_UPDATE;
+    }
+
+    return _d->status;
+}
+
 HTTPRepository::ResultCode
 HTTPRepository::failure() const
 {
@@ -81,6 +81,21 @@ public:
    */
   void setInstalledCopyPath(const SGPath &copyPath);
 
+  /**
+   * limit the number of threads hashing and extracting files of this
+   * repository at the same time. Defaults to the number of cores, up to 4.
+   */
+  void setMaxIOThreads(unsigned int count);
+
+  /**
+   * Check the local copy against the directory indices on disk, without
+   * any network access: every file is re-hashed unless the hash cache
+   * entry is still valid, using the I/O threads. Missing and damaged files
+   * are reported by failures(); returns REPO_PARTIAL_UPDATE if there are
+   * any. Must not be called while syncing.
+   */
+  ResultCode verifyLocalCopy();
+
   static std::string resultCodeAsString(ResultCode code);
 
   enum class SyncAction { Add, Update, Delete, UpToDate };
@@ -27,6 +27,7 @@
 
 #include <simgear/io/HTTPClient.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 #include "HTTPRepository.hxx"
 
@@ -79,6 +80,10 @@ public:
   size_t bytesExtracted = 0;
   HTTPRepository::SyncPredicate syncPredicate;
 
+  unsigned int maxIOThreads = 1;     ///< for hashing and extracting files
+  unsigned int activeExtractions = 0;
+  SGTimeStamp lastHashCacheFlush;
+
   HTTP::Request_ptr updateFile(HTTPDirectory *dir, const std::string &name,
                                size_t sz);
   HTTP::Request_ptr updateDir(HTTPDirectory *dir, const std::string &hash,
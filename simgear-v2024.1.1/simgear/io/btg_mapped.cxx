@@ -0,0 +1,104 @@
+// Convert BTG files to the mapped variant read by SGBinObject::read_bin(),
+// and compare the load time and peak memory of both variants.
+
+#ifdef HAVE_CONFIG_H
+#  include <simgear_config.h>
+#endif
+
+#include <simgear/compiler.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "sg_binobj.hxx"
+#include <simgear/debug/logstream.hxx>
+#include <simgear/misc/sg_path.hxx>
+#include <simgear/timing/timestamp.hxx>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+static void usage(const char* prog)
+{
+    cerr << "Usage: " << prog << " file.btg[.gz] ...\n"
+         << "       write file.btgm next to each file\n"
+         << "   or: " << prog << " --bench gz|mapped file.btg[.gz] [iterations]\n"
+         << "       time reading one variant; run once per variant to compare peak memory"
+         << endl;
+}
+
+static long peakRSSKBytes()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+    return -1;
+}
+
+static int bench(const char* variant, const SGPath& path, int iterations)
+{
+    const bool mapped = !strcmp(variant, "mapped");
+    const SGPath mappedPath = SGBinObject::mapped_path(path);
+    if (mapped && !mappedPath.exists()) {
+        cerr << "no " << mappedPath << ", convert first" << endl;
+        return EXIT_FAILURE;
+    }
+
+    SGTimeStamp st;
+    st.stamp();
+    size_t nodes = 0;
+    for (int i = 0; i < iterations; ++i) {
+        SGBinObject obj;
+        const bool ok = mapped ? obj.read_mapped(mappedPath) : obj.read_bin(path, false);
+        if (!ok) {
+            cerr << "error loading " << path << endl;
+            return EXIT_FAILURE;
+        }
+        nodes = obj.get_wgs84_nodes().size();
+    }
+
+    const SGPath file = mapped ? mappedPath : (path.exists() ? path : SGPath(path.utf8Str() + ".gz"));
+    cout << variant << ": " << nodes << " nodes, " << file.sizeInBytes() << " bytes, "
+         << st.elapsedMSec() / double(iterations) << " ms per load, peak RSS "
+         << peakRSSKBytes() << " kB" << endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+    sglog().setLogLevels(SG_ALL, SG_ALERT);
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!strcmp(argv[1], "--bench")) {
+        if (argc < 4) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        const int iterations = (argc > 4) ? std::max(1, atoi(argv[4])) : 10;
+        return bench(argv[2], SGPath::fromLocal8Bit(argv[3]), iterations);
+    }
+
+    int result = EXIT_SUCCESS;
+    for (int i = 1; i < argc; ++i) {
+        const SGPath path = SGPath::fromLocal8Bit(argv[i]);
+        SGBinObject obj;
+        if (!obj.read_bin(path, false) || !obj.write_mapped(SGBinObject::mapped_path(path), path)) {
+            cerr << "error converting " << path << endl;
+            result = EXIT_FAILURE;
+        }
+    }
+    return result;
+}
@@ -50,7 +50,8 @@ enum SGChannelType {
     sgFileType = 0,
     sgSerialType = 1,
     sgSocketType = 2,
-    sgDDSType = 3
+    sgDDSType = 3,
+    sgSharedMemoryType = 4
 };
 
 
@@ -43,12 +43,16 @@
 #include <simgear/bucket/newbucket.hxx>
 #include <simgear/debug/ErrorReportingCallback.hxx>
 #include <simgear/math/SGGeometry.hxx>
+#include <simgear/misc/sg_dir.hxx>
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/strutils.hxx>
 #include <simgear/structure/exception.hxx>
 
+#include <simgear/io/iostreams/sgstream.hxx>
+
 #include "lowlevel.hxx"
 #include "sg_binobj.hxx"
+#include "sg_mmap.hxx"
 
 
 using std::string;
@@ -491,9 +495,35 @@ void SGBinObject::read_object( gzFile fp,
 }
 
 
+namespace {
+
+// the file read_bin() reads for file: file itself or file.gz, without
+// the cached file information, which may be out of date
+SGPath sourcePath(const SGPath& file)
+{
+    SGPath p = file;
+    p.set_cached(false);
+    if ( !p.exists() ) {
+        p.concat(".gz");
+    }
+    return p;
+}
+
+} // of anonymous namespace
+
 // read a binary file and populate the provided structures.
-bool SGBinObject::read_bin( const SGPath& file )
+bool SGBinObject::read_bin( const SGPath& file, bool allowMapped )
 {
+    if ( allowMapped ) {
+        const SGPath mapped = mapped_path(file);
+        if ( mapped.exists() ) {
+            if ( read_mapped(mapped, sourcePath(file)) ) {
+                return true;
+            }
+            SG_LOG(SG_IO, SG_INFO, "Ignoring out of date or unusable " << mapped);
+        }
+    }
+
     gzFile fp = NULL;
     
     try {
@@ -509,9 +539,14 @@ bool SGBinObject::read_bin( const SGPath& file )
         gbs_center = SGVec3d(0, 0, 0);
         gbs_radius = 0.0;
 
+        // also after a mapped file which failed half way
         wgs84_nodes.clear();
+        colors.clear();
         normals.clear();
         texcoords.clear();
+        overlaycoords.clear();
+        va_flt.clear();
+        va_int.clear();
 
         pts_v.clear();
         pts_n.clear();
@@ -801,6 +836,342 @@ bool SGBinObject::read_bin( const SGPath& file )
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////
+// The mapped variant of the format
+//
+// - header: magic "SGBM", format version, BTG version, layout signature,
+//           bounding sphere, size and modification time of the source
+// - lists: count (uint32), then the elements as laid out in memory
+//
+// The nodes, colors, normals, texcoords and vertex attribute lists come
+// first, then the points, triangles, strips and fans, each as a group
+// count followed by the material and the 15 index lists of each group.
+// The vector lists start on a 16 byte boundary.
+////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint32_t MAPPED_MAGIC = 0x4d424753; // "SGBM" in little endian
+const uint32_t MAPPED_VERSION = 2;
+const size_t MAPPED_ALIGN = 16;
+
+// list data is aligned for its type, so it can be read in place
+template <class T>
+size_t mappedAlignment()
+{
+    return alignof(T) > sizeof(uint32_t) ? MAPPED_ALIGN : sizeof(uint32_t);
+}
+
+struct MappedHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint32_t btgVersion;
+    // sizes of the element types, which vary with ENABLE_SIMD
+    uint8_t sizeVec3d, sizeVec4f, sizeVec3f, sizeVec2f;
+    double gbsCenter[3];
+    float gbsRadius;
+    uint32_t reserved;
+    // the file converted, which is read instead once it changes
+    uint64_t sourceSize;
+    int64_t sourceModTime;
+};
+
+MappedHeader mappedHeaderTemplate()
+{
+    MappedHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = MAPPED_MAGIC;
+    h.formatVersion = MAPPED_VERSION;
+    h.sizeVec3d = sizeof(SGVec3d);
+    h.sizeVec4f = sizeof(SGVec4f);
+    h.sizeVec3f = sizeof(SGVec3f);
+    h.sizeVec2f = sizeof(SGVec2f);
+    return h;
+}
+
+class MappedWriter {
+public:
+    explicit MappedWriter(std::ostream& os) : _os(os) {}
+
+    void bytes(const void* p, size_t n)
+    {
+        _os.write(static_cast<const char*>(p), n);
+        _offset += n;
+    }
+
+    void align(size_t alignment)
+    {
+        static const char zeros[MAPPED_ALIGN] = {0};
+        bytes(zeros, (alignment - (_offset % alignment)) % alignment);
+    }
+
+    template <class T>
+    void list(const T* data, size_t count)
+    {
+        align(sizeof(uint32_t));
+        const uint32_t n = count;
+        bytes(&n, sizeof(n));
+        align(mappedAlignment<T>());
+        bytes(data, count * sizeof(T));
+    }
+
+    template <class T>
+    void list(const std::vector<T>& v) { list(v.data(), v.size()); }
+
+    void text(const std::string& s) { list(s.data(), s.size()); }
+
+    void groups(const group_list& vertices, const group_list& normals,
+                const group_list& colors, const group_tci_list& texCoords,
+                const group_vai_list& vertexAttribs, const string_list& materials)
+    {
+        align(sizeof(uint32_t));
+        const uint32_t n = vertices.size();
+        bytes(&n, sizeof(n));
+        for (size_t i = 0; i < n; ++i) {
+            text(materials[i]);
+            list(vertices[i]);
+            list(normals[i]);
+            list(colors[i]);
+            for (const auto& tc : texCoords[i]) {
+                list(tc);
+            }
+            for (const auto& va : vertexAttribs[i]) {
+                list(va);
+            }
+        }
+    }
+
+    bool good() const { return _os.good(); }
+
+private:
+    std::ostream& _os;
+    size_t _offset = 0;
+};
+
+class MappedReader {
+public:
+    MappedReader(const char* begin, size_t size) : _p(begin), _begin(begin), _end(begin + size) {}
+
+    const char* bytes(size_t n)
+    {
+        if (static_cast<size_t>(_end - _p) < n) {
+            throw sg_io_exception("Truncated mapped BTG");
+        }
+        const char* result = _p;
+        _p += n;
+        return result;
+    }
+
+    void align(size_t alignment)
+    {
+        const size_t offset = _p - _begin;
+        bytes((alignment - (offset % alignment)) % alignment);
+    }
+
+    uint32_t count()
+    {
+        align(sizeof(uint32_t));
+        uint32_t n;
+        memcpy(&n, bytes(sizeof(n)), sizeof(n));
+        return n;
+    }
+
+    template <class T>
+    void list(std::vector<T>& v)
+    {
+        const uint32_t n = count();
+        align(mappedAlignment<T>());
+        if (n > static_cast<size_t>(_end - _p) / sizeof(T)) {
+            throw sg_io_exception("Truncated mapped BTG");
+        }
+        const T* data = reinterpret_cast<const T*>(bytes(n * sizeof(T)));
+        v.assign(data, data + n);
+    }
+
+    std::string text()
+    {
+        std::vector<char> chars;
+        list(chars);
+        return std::string(chars.begin(), chars.end());
+    }
+
+    void groups(group_list& vertices, group_list& normals, group_list& colors,
+                group_tci_list& texCoords, group_vai_list& vertexAttribs,
+                string_list& materials)
+    {
+        const uint32_t n = count();
+        // at least the counts of the material and the index lists per group
+        if (n > static_cast<size_t>(_end - _p) / (16 * sizeof(uint32_t))) {
+            throw sg_io_exception("Truncated mapped BTG");
+        }
+        vertices.resize(n);
+        normals.resize(n);
+        colors.resize(n);
+        texCoords.resize(n);
+        vertexAttribs.resize(n);
+        materials.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            materials[i] = text();
+            list(vertices[i]);
+            list(normals[i]);
+            list(colors[i]);
+            for (auto& tc : texCoords[i]) {
+                list(tc);
+            }
+            for (auto& va : vertexAttribs[i]) {
+                list(va);
+            }
+        }
+    }
+
+private:
+    const char* _p;
+    const char* _begin;
+    const char* _end;
+};
+
+} // of anonymous namespace
+
+SGPath SGBinObject::mapped_path( const SGPath& file )
+{
+    std::string name = file.utf8Str();
+    if ( simgear::strutils::ends_with(name, ".gz") ) {
+        name.resize(name.size() - 3);
+    }
+    return SGPath::fromUtf8(name + "m");
+}
+
+bool SGBinObject::read_mapped( const SGPath& file )
+{
+    return read_mapped(file, SGPath());
+}
+
+bool SGBinObject::read_mapped( const SGPath& file, const SGPath& source )
+{
+    if ( sgIsBigEndian() ) {
+        return false;
+    }
+
+    SGMMapFile mapping(file);
+    if ( !mapping.open(SG_IO_IN) ) {
+        return false;
+    }
+
+    simgear::ErrorReportContext ec("btg", file.utf8Str());
+
+    try {
+        MappedReader in(mapping.get(), mapping.get_size());
+
+        MappedHeader h;
+        memcpy(&h, in.bytes(sizeof(h)), sizeof(h));
+        const MappedHeader expected = mappedHeaderTemplate();
+        if ( (h.magic != expected.magic) || (h.formatVersion != expected.formatVersion) ||
+             (h.sizeVec3d != expected.sizeVec3d) || (h.sizeVec4f != expected.sizeVec4f) ||
+             (h.sizeVec3f != expected.sizeVec3f) || (h.sizeVec2f != expected.sizeVec2f) ) {
+            SG_LOG(SG_IO, SG_INFO, "Mapped BTG from an incompatible build: " << file);
+            return false;
+        }
+
+        if ( !source.isNull() ) {
+            SGPath src(source);
+            src.set_cached(false);
+            if ( !src.exists() || (h.sourceSize != src.sizeInBytes()) ||
+                 (h.sourceModTime != static_cast<int64_t>(src.modTime())) ) {
+                SG_LOG(SG_IO, SG_INFO, "Mapped BTG " << file << " is out of date, "
+                       << source << " has changed");
+                return false;
+            }
+        }
+
+        version = h.btgVersion;
+        gbs_center = SGVec3d(h.gbsCenter[0], h.gbsCenter[1], h.gbsCenter[2]);
+        gbs_radius = h.gbsRadius;
+
+        in.list(wgs84_nodes);
+        in.list(colors);
+        in.list(normals);
+        in.list(texcoords);
+        in.list(va_flt);
+        in.list(va_int);
+        overlaycoords.clear();
+
+        in.groups(pts_v, pts_n, pts_c, pts_tcs, pts_vas, pt_materials);
+        in.groups(tris_v, tris_n, tris_c, tris_tcs, tris_vas, tri_materials);
+        in.groups(strips_v, strips_n, strips_c, strips_tcs, strips_vas, strip_materials);
+        in.groups(fans_v, fans_n, fans_c, fans_tcs, fans_vas, fan_materials);
+    } catch (sg_exception& e) {
+        SG_LOG(SG_IO, SG_WARN, "Bad mapped BTG " << file << ": " << e.getMessage());
+        return false;
+    }
+
+    setThreadLocalSimgearReadPath(file);
+    return true;
+}
+
+bool SGBinObject::write_mapped( const SGPath& file, const SGPath& source ) const
+{
+    if ( sgIsBigEndian() ) {
+        SG_LOG(SG_IO, SG_ALERT, "Mapped BTG files are only supported on little endian hosts");
+        return false;
+    }
+
+    // write to a temporary file, so readers never map a partial one;
+    // SGPath::rename() needs absolute paths to check the permissions
+    SGPath target = file;
+    if ( !target.isAbsolute() ) {
+        target = simgear::Dir::current().file(file.utf8Str());
+    }
+    SGPath tmp = target;
+    tmp.concat(".tmp");
+    {
+        sg_ofstream os(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+        if ( !os.is_open() ) {
+            SG_LOG(SG_IO, SG_ALERT, "Unable to write " << tmp);
+            return false;
+        }
+
+        MappedHeader h = mappedHeaderTemplate();
+        h.btgVersion = version;
+        h.gbsCenter[0] = gbs_center[0];
+        h.gbsCenter[1] = gbs_center[1];
+        h.gbsCenter[2] = gbs_center[2];
+        h.gbsRadius = gbs_radius;
+        const SGPath src = sourcePath(source);
+        if ( !src.exists() ) {
+            SG_LOG(SG_IO, SG_ALERT, "No source file " << source << " for " << file);
+            return false;
+        }
+        h.sourceSize = src.sizeInBytes();
+        h.sourceModTime = src.modTime();
+
+        MappedWriter out(os);
+        out.bytes(&h, sizeof(h));
+        out.list(wgs84_nodes);
+        out.list(colors);
+        out.list(normals);
+        out.list(texcoords);
+        out.list(va_flt);
+        out.list(va_int);
+
+        out.groups(pts_v, pts_n, pts_c, pts_tcs, pts_vas, pt_materials);
+        out.groups(tris_v, tris_n, tris_c, tris_tcs, tris_vas, tri_materials);
+        out.groups(strips_v, strips_n, strips_c, strips_tcs, strips_vas, strip_materials);
+        out.groups(fans_v, fans_n, fans_c, fans_tcs, fans_vas, fan_materials);
+
+        if ( !out.good() ) {
+            SG_LOG(SG_IO, SG_ALERT, "Error writing " << tmp);
+            os.close();
+            tmp.remove();
+            return false;
+        }
+    }
+
+    if ( target.exists() ) {
+        target.remove();
+    }
+    return tmp.rename(target);
+}
+
 void SGBinObject::write_header(gzFile fp, int type, int nProps, int nElements)
 {
     sgWriteChar(fp, (unsigned char) type);
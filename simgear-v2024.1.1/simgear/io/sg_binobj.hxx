@@ -36,6 +36,7 @@
 
 #include <array>
 #include <string>
+#include <utility>
 #include <vector>
 
 #define MAX_TC_SETS     (4)
@@ -218,18 +219,21 @@ public:
 
     inline const std::vector<SGVec3d>& get_wgs84_nodes() const { return wgs84_nodes; }
     inline void set_wgs84_nodes( const std::vector<SGVec3d>& n ) { wgs84_nodes = n; }
+    inline void set_wgs84_nodes( std::vector<SGVec3d>&& n ) { wgs84_nodes = std::move(n); }
 
     inline const std::vector<SGVec4f>& get_colors() const { return colors; }
     inline void set_colors( const std::vector<SGVec4f>& c ) { colors = c; }
     
     inline const std::vector<SGVec3f>& get_normals() const { return normals; }
     inline void set_normals( const std::vector<SGVec3f>& n ) { normals = n; }
+    inline void set_normals( std::vector<SGVec3f>&& n ) { normals = std::move(n); }
     
     inline const std::vector<SGVec2f>& get_texcoords() const { return texcoords; }
     inline void set_texcoords( const std::vector<SGVec2f>& t ) { texcoords = t; }
 
     inline const std::vector<SGVec2f>& get_overlaycoords() const { return overlaycoords; }
     inline void set_overlaycoords( const std::vector<SGVec2f>& t ) { overlaycoords = t; }
+    inline void set_overlaycoords( std::vector<SGVec2f>&& t ) { overlaycoords = std::move(t); }
     
     // Points API
     bool add_point( const SGBinObjectPoint& pt );
@@ -266,10 +270,44 @@ public:
 
     /**
      * Read a binary file object and populate the provided structures.
+     * If the mapped variant of the file (see mapped_path()) exists, was
+     * written by a compatible build and converted from the current
+     * version of the file, it is read instead.
      * @param file input file name
+     * @param allowMapped look for the mapped variant first
      * @return result of read
      */
-    bool read_bin( const SGPath& file );
+    bool read_bin( const SGPath& file, bool allowMapped = true );
+
+    /**
+     * The mapped variant of the format is uncompressed, with every list
+     * stored aligned in the in-memory layout of this build. It is read
+     * through a memory mapping with one bulk copy per list, instead of
+     * decompressing and decoding the file element by element. The files
+     * are larger than the .btg.gz and only valid for builds with the
+     * same vector layout, so they are a local cache made by a conversion
+     * tool rather than a distribution format.
+     * @param file the .btg or .btg.gz
+     * @return the name read_bin() looks for: foo.btg.gz -> foo.btgm
+     */
+    static SGPath mapped_path( const SGPath& file );
+
+    /**
+     * Read the mapped variant of the format.
+     * @param source the file it must have been converted from, not
+     * checked if omitted
+     * @return false if the file is missing, damaged, from an
+     * incompatible build, or if source has changed since the conversion
+     */
+    bool read_mapped( const SGPath& file, const SGPath& source );
+    bool read_mapped( const SGPath& file );
+
+    /**
+     * Write the mapped variant of the format.
+     * @param source the file converted (foo.btg or foo.btg.gz), whose size
+     * and modification time are recorded
+     */
+    bool write_mapped( const SGPath& file, const SGPath& source ) const;
 
     /** 
      * Write out the structures to a binary file.  We assume that the
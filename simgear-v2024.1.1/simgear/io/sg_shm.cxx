@@ -0,0 +1,422 @@
+// SPDX-FileName: sg_shm.cxx
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// SPDX-FileComment: Shared memory ring I/O channel between processes on one host
+
+#include <simgear_config.h>
+
+#include "sg_shm.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <simgear/compiler.h>
+#include <simgear/debug/logstream.hxx>
+
+#if !defined(SG_WINDOWS)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<int32_t>::is_always_lock_free,
+              "shared memory rings need address-free atomics");
+
+/**
+ * One direction. Positions count the bytes written and read since the
+ * segment was created, the offset in the data is position & (size - 1).
+ * Each message is a uint32_t length and the payload, padded to 8 bytes;
+ * a WRAP length means the rest of the data up to its end is unused.
+ */
+struct SGSharedMemory::Ring {
+    alignas(64) std::atomic<uint64_t> head; ///< written by the writer
+    alignas(64) std::atomic<uint64_t> tail; ///< written by the reader
+    alignas(64) std::atomic<uint32_t> seq;  ///< futex word, bumped for each message
+    std::atomic<uint32_t> waiters;          ///< readers in waitForData()
+};
+
+struct SGSharedMemory::Segment {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ringSize;
+    std::atomic<uint32_t> ready;    ///< set once the creator initialized the segment
+    std::atomic<int32_t> peers[2];  ///< pid owning each slot, 0 if free
+    Ring rings[2];
+
+    // followed by the data of both rings
+    char* data(int ring)
+    {
+        return reinterpret_cast<char*>(this + 1) + static_cast<size_t>(ring) * ringSize;
+    }
+};
+
+namespace {
+
+const uint32_t MAGIC = 0x53474d51; // "SGMQ"
+const uint32_t VERSION = 1;
+const uint32_t WRAP = 0xffffffff;
+const size_t MIN_RING_SIZE = 4096;
+
+// how long to wait for the creator of a segment to initialize it
+const int ATTACH_TIMEOUT_MSEC = 1000;
+
+inline uint64_t recordSize(uint32_t length)
+{
+    return (sizeof(uint32_t) + length + 7) & ~static_cast<uint64_t>(7);
+}
+
+size_t roundUpPowerOfTwo(size_t n)
+{
+    size_t result = MIN_RING_SIZE;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+#if defined(__linux__)
+// the segment is shared between processes: no FUTEX_PRIVATE_FLAG
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMSec)
+{
+    struct timespec ts;
+    ts.tv_sec = timeoutMSec / 1000;
+    ts.tv_nsec = (timeoutMSec % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<uint32_t>* word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // of anonymous namespace
+
+SGSharedMemory::SGSharedMemory(const std::string& name, size_t ringSize) :
+    _name(name),
+    _ringSize(roundUpPowerOfTwo(ringSize))
+{
+    set_type(sgSharedMemoryType);
+}
+
+SGSharedMemory::~SGSharedMemory()
+{
+    close();
+}
+
+#if defined(SG_WINDOWS)
+
+bool SGSharedMemory::open(const SGProtocolDir d)
+{
+    set_dir(d);
+    SG_LOG(SG_IO, SG_ALERT, "Shared memory channels are not supported on Windows");
+    return false;
+}
+
+void SGSharedMemory::detach()
+{
+}
+
+#else
+
+bool SGSharedMemory::open(const SGProtocolDir d)
+{
+    set_dir(d);
+    if (_segment) {
+        SG_LOG(SG_IO, SG_ALERT, "Shared memory " << _name << " is already open");
+        return false;
+    }
+
+    const std::string path = "/" + _name;
+    bool creator = true;
+    _fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if ((_fd < 0) && (errno == EEXIST)) {
+        creator = false;
+        _fd = shm_open(path.c_str(), O_RDWR, 0);
+    }
+    if (_fd < 0) {
+        SG_LOG(SG_IO, SG_ALERT, "Error opening shared memory " << _name << ": " << strerror(errno));
+        return false;
+    }
+
+    if (creator) {
+        _mappedSize = sizeof(Segment) + 2 * _ringSize;
+        if (ftruncate(_fd, static_cast<off_t>(_mappedSize)) != 0) {
+            SG_LOG(SG_IO, SG_ALERT, "Error sizing shared memory " << _name << ": " << strerror(errno));
+            detach();
+            return false;
+        }
+    } else {
+        // the creator may still be sizing it
+        struct stat st;
+        int waited = 0;
+        while ((fstat(_fd, &st) != 0) || (static_cast<size_t>(st.st_size) < sizeof(Segment))) {
+            if (++waited > ATTACH_TIMEOUT_MSEC) {
+                SG_LOG(SG_IO, SG_ALERT, "Shared memory " << _name << " was not initialized");
+                detach();
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        _mappedSize = static_cast<size_t>(st.st_size);
+    }
+
+    void* p = mmap(nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (p == MAP_FAILED) {
+        SG_LOG(SG_IO, SG_ALERT, "Error mapping shared memory " << _name << ": " << strerror(errno));
+        _segment = nullptr;
+        detach();
+        return false;
+    }
+
+    if (creator) {
+        _segment = new (p) Segment();
+        _segment->magic = MAGIC;
+        _segment->version = VERSION;
+        _segment->ringSize = static_cast<uint32_t>(_ringSize);
+        _segment->ready.store(1, std::memory_order_release);
+    } else {
+        _segment = static_cast<Segment*>(p);
+        int waited = 0;
+        while (_segment->ready.load(std::memory_order_acquire) == 0) {
+            if (++waited > ATTACH_TIMEOUT_MSEC) {
+                SG_LOG(SG_IO, SG_ALERT, "Shared memory " << _name << " was not initialized");
+                detach();
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        if ((_segment->magic != MAGIC) || (_segment->version != VERSION) ||
+            (_mappedSize < sizeof(Segment) + 2 * static_cast<size_t>(_segment->ringSize))) {
+            SG_LOG(SG_IO, SG_ALERT, "Shared memory " << _name << " has an unknown layout, remove /dev/shm/" << _name);
+            detach();
+            return false;
+        }
+        _ringSize = _segment->ringSize;
+    }
+
+    // take a free slot, or one left by a process which died
+    const int32_t pid = static_cast<int32_t>(getpid());
+    for (int s = 0; (s < 2) && (_slot < 0); ++s) {
+        int32_t owner = 0;
+        if (_segment->peers[s].compare_exchange_strong(owner, pid)) {
+            _slot = s;
+        } else if ((owner != pid) && (kill(owner, 0) != 0) && (errno == ESRCH) &&
+                   _segment->peers[s].compare_exchange_strong(owner, pid)) {
+            _slot = s;
+        }
+    }
+    if (_slot < 0) {
+        SG_LOG(SG_IO, SG_ALERT, "Shared memory " << _name << " already has two peers");
+        detach();
+        return false;
+    }
+
+    // drop what was written for a previous owner of the slot
+    Ring& in = _segment->rings[1 - _slot];
+    in.tail.store(in.head.load(std::memory_order_acquire), std::memory_order_release);
+
+    SG_LOG(SG_IO, SG_INFO, "Opened shared memory " << _name << " in slot " << _slot
+           << ", ring size " << _ringSize << (creator ? " (created)" : ""));
+    set_valid(true);
+    return true;
+}
+
+void SGSharedMemory::detach()
+{
+    if (_segment) {
+        munmap(_segment, _mappedSize);
+        _segment = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _slot = -1;
+    set_valid(false);
+}
+
+#endif // !SG_WINDOWS
+
+bool SGSharedMemory::close()
+{
+    if (!_segment) {
+        return true;
+    }
+
+#if !defined(SG_WINDOWS)
+    _segment->peers[_slot].store(0);
+    // the last peer out removes the name, the memory goes with the last mapping
+    if (!hasPeer()) {
+        shm_unlink(("/" + _name).c_str());
+    }
+#endif
+    detach();
+    return true;
+}
+
+bool SGSharedMemory::hasPeer() const
+{
+    return _segment && (_segment->peers[1 - _slot].load() != 0);
+}
+
+bool SGSharedMemory::hasData() const
+{
+    if (!_segment) {
+        return false;
+    }
+
+    const Ring& in = _segment->rings[1 - _slot];
+    return in.head.load(std::memory_order_acquire) != in.tail.load(std::memory_order_relaxed);
+}
+
+int SGSharedMemory::write(const char* buf, const int length)
+{
+    if (!_segment || (length < 0)) {
+        return -1;
+    }
+
+    const uint64_t size = recordSize(static_cast<uint32_t>(length));
+    if (size > _ringSize / 2) {
+        SG_LOG(SG_IO, SG_ALERT, "Message of " << length << " bytes is too large for shared memory " << _name);
+        return -1;
+    }
+
+    // like a datagram nobody listens to
+    if (!hasPeer()) {
+        return length;
+    }
+
+    Ring& out = _segment->rings[_slot];
+    char* data = _segment->data(_slot);
+    const uint64_t mask = _ringSize - 1;
+
+    uint64_t head = out.head.load(std::memory_order_relaxed);
+    const uint64_t tail = out.tail.load(std::memory_order_acquire);
+    uint64_t offset = head & mask;
+    const uint64_t toEnd = _ringSize - offset;
+    const uint64_t needed = (size > toEnd) ? toEnd + size : size;
+    if (head + needed - tail > _ringSize) {
+        return 0;
+    }
+
+    if (size > toEnd) {
+        std::memcpy(data + offset, &WRAP, sizeof(WRAP));
+        head += toEnd;
+        offset = 0;
+    }
+
+    const uint32_t len = static_cast<uint32_t>(length);
+    std::memcpy(data + offset, &len, sizeof(len));
+    std::memcpy(data + offset + sizeof(len), buf, length);
+    out.head.store(head + size, std::memory_order_release);
+
+#if defined(__linux__)
+    out.seq.fetch_add(1);
+    if (out.waiters.load() != 0) {
+        futexWakeAll(&out.seq);
+    }
+#endif
+    return length;
+}
+
+int SGSharedMemory::writestring(const char* str)
+{
+    return write(str, static_cast<int>(strlen(str)));
+}
+
+int SGSharedMemory::read(char* buf, int length)
+{
+    if (!_segment || (length < 0)) {
+        return -1;
+    }
+
+    Ring& in = _segment->rings[1 - _slot];
+    const char* data = _segment->data(1 - _slot);
+    const uint64_t mask = _ringSize - 1;
+
+    uint64_t tail = in.tail.load(std::memory_order_relaxed);
+    const uint64_t head = in.head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return 0;
+    }
+
+    uint64_t offset = tail & mask;
+    uint32_t len;
+    std::memcpy(&len, data + offset, sizeof(len));
+    if (len == WRAP) {
+        tail += _ringSize - offset;
+        offset = 0;
+        std::memcpy(&len, data, sizeof(len));
+    }
+
+    const int n = std::min(static_cast<int>(len), length);
+    std::memcpy(buf, data + offset + sizeof(len), n);
+    in.tail.store(tail + recordSize(len), std::memory_order_release);
+    return n;
+}
+
+int SGSharedMemory::readline(char* buf, int length)
+{
+    return read(buf, length);
+}
+
+bool SGSharedMemory::waitForData(int timeoutMSec)
+{
+    if (hasData() || !_segment) {
+        return hasData();
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMSec);
+#if defined(__linux__)
+    Ring& in = _segment->rings[1 - _slot];
+    for (;;) {
+        // count ourselves as waiting before the last check, so a writer
+        // publishing after it sees us and wakes us
+        const uint32_t seq = in.seq.load();
+        in.waiters.fetch_add(1);
+        if (hasData()) {
+            in.waiters.fetch_sub(1);
+            return true;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining > 0) {
+            futexWait(&in.seq, seq, static_cast<int>(remaining));
+        }
+        in.waiters.fetch_sub(1);
+
+        if (hasData()) {
+            return true;
+        }
+        if (remaining <= 0) {
+            return false;
+        }
+    }
+#else
+    while (!hasData()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+#endif
+}
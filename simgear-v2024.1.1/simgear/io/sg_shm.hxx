@@ -0,0 +1,88 @@
+// SPDX-FileName: sg_shm.hxx
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// SPDX-FileComment: Shared memory ring I/O channel between processes on one host
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "iochannel.hxx"
+
+/**
+ * An I/O channel to another process on the same host, through a POSIX
+ * shared memory segment, for external FDMs, cockpit hardware or motion
+ * platforms exchanging a record every frame: writing and reading a
+ * message is a copy into and out of the segment, without system calls.
+ *
+ * The segment holds a ring for each direction and two peer slots. The
+ * first two channels opened with the same name take a slot each, and
+ * each writes its own ring and reads the other one, whatever the
+ * direction they were opened with. Like a datagram socket, a read
+ * returns one whole message (truncated to the buffer length), a write
+ * to a channel without peer is discarded, and a write to a full ring
+ * fails.
+ *
+ * A reader can block in waitForData(): on Linux it sleeps on a futex in
+ * the segment, and the writer only makes the wake-up system call when
+ * somebody is waiting. Elsewhere waiting polls. Not available on Windows.
+ */
+class SGSharedMemory : public SGIOChannel
+{
+public:
+    static const size_t DEFAULT_RING_SIZE = 64 * 1024;
+
+    /**
+     * @param name of the segment, shared by both peers (without the
+     *        leading '/' of POSIX shared memory names)
+     * @param ringSize bytes of each ring, rounded up to a power of two;
+     *        only used by the peer creating the segment
+     */
+    explicit SGSharedMemory(const std::string& name, size_t ringSize = DEFAULT_RING_SIZE);
+    ~SGSharedMemory() override;
+
+    bool open(const SGProtocolDir d) override;
+
+    /// read the next message, returns its length or 0 if there is none
+    int read(char* buf, int length) override;
+
+    /// messages are records: same as read()
+    int readline(char* buf, int length) override;
+
+    /// write a message, returns its length or 0 if the ring is full
+    int write(const char* buf, const int length) override;
+
+    int writestring(const char* str) override;
+
+    bool close() override;
+
+    /// true if a peer has the other slot of the segment
+    bool hasPeer() const;
+
+    /// true if a message is waiting to be read
+    bool hasData() const;
+
+    /**
+     * Wait until a message is waiting to be read, at most timeoutMSec.
+     * Returns true if there is one.
+     */
+    bool waitForData(int timeoutMSec);
+
+    const std::string& get_name() const { return _name; }
+
+private:
+    struct Segment;
+    struct Ring;
+
+    void detach();
+
+    std::string _name;
+    size_t _ringSize;
+
+    int _fd = -1;
+    Segment* _segment = nullptr;
+    size_t _mappedSize = 0;
+    int _slot = -1;          ///< our peer slot: we write ring _slot
+    bool _unlinked = false;
+};
@@ -0,0 +1,173 @@
+// Loopback latency and jitter of SGSharedMemory against UDP
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// Bounces a record (FGNetFDM sized by default) between two threads and
+// reports the one-way latency, half the round trip, for:
+//  - shared memory with the reader sleeping in waitForData()
+//  - shared memory with the reader polling, yielding between polls
+//  - UDP over the loopback interface with blocking sockets
+//
+// usage: shm_bench [rounds] [size] [udp base port]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <simgear/io/raw_socket.hxx>
+#include <simgear/io/sg_shm.hxx>
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// one endpoint: send a record, and wait for one to be received
+struct Endpoint {
+    std::function<bool(const char*, int)> send;
+    std::function<int(char*, int)> receive;
+};
+
+void report(const char* name, std::vector<double>& usec)
+{
+    if (usec.empty()) {
+        printf("%-16s failed\n", name);
+        return;
+    }
+
+    std::sort(usec.begin(), usec.end());
+    double sum = 0.0;
+    for (double u : usec) {
+        sum += u;
+    }
+    const double mean = sum / usec.size();
+    double var = 0.0;
+    for (double u : usec) {
+        var += (u - mean) * (u - mean);
+    }
+
+    auto percentile = [&usec](double p) {
+        return usec[std::min(usec.size() - 1, static_cast<size_t>(p * usec.size()))];
+    };
+    printf("%-16s min %8.2f  mean %8.2f  p50 %8.2f  p99 %8.2f  max %9.2f  stddev %8.2f usec\n",
+           name, usec.front(), mean, percentile(0.5), percentile(0.99), usec.back(),
+           std::sqrt(var / usec.size()));
+}
+
+std::vector<double> pingPong(Endpoint& ping, Endpoint& pong, int rounds, int size)
+{
+    std::vector<double> usec;
+    usec.reserve(rounds);
+
+    std::thread echo([&pong, rounds, size]() {
+        std::vector<char> buf(size);
+        for (int i = 0; i < rounds; ++i) {
+            const int n = pong.receive(buf.data(), size);
+            if ((n <= 0) || !pong.send(buf.data(), n)) {
+                return;
+            }
+        }
+    });
+
+    std::vector<char> out(size, 'x'), in(size);
+    for (int i = 0; i < rounds; ++i) {
+        const auto start = Clock::now();
+        if (!ping.send(out.data(), size) || (ping.receive(in.data(), size) != size)) {
+            fprintf(stderr, "round %d failed\n", i);
+            usec.clear();
+            break;
+        }
+        const std::chrono::duration<double, std::micro> rtt = Clock::now() - start;
+        usec.push_back(rtt.count() * 0.5);
+    }
+
+    echo.join();
+    return usec;
+}
+
+Endpoint shmEndpoint(SGSharedMemory& shm, bool poll)
+{
+    Endpoint e;
+    e.send = [&shm](const char* buf, int n) { return shm.write(buf, n) == n; };
+    e.receive = [&shm, poll](char* buf, int n) {
+        if (poll) {
+            const auto deadline = Clock::now() + std::chrono::seconds(5);
+            while (!shm.hasData()) {
+                if (Clock::now() > deadline) {
+                    return 0;
+                }
+                // lets the peer run when both share a CPU
+                std::this_thread::yield();
+            }
+        } else if (!shm.waitForData(5000)) {
+            return 0;
+        }
+        return shm.read(buf, n);
+    };
+    return e;
+}
+
+std::vector<double> benchShm(bool poll, int rounds, int size)
+{
+    const std::string name = "sg-shm-bench-" + std::to_string(getpid());
+    SGSharedMemory a(name), b(name);
+    if (!a.open(SG_IO_BI) || !b.open(SG_IO_BI)) {
+        return {};
+    }
+
+    Endpoint ping = shmEndpoint(a, poll), pong = shmEndpoint(b, poll);
+    return pingPong(ping, pong, rounds, size);
+}
+
+std::vector<double> benchUdp(int rounds, int size, int port)
+{
+    simgear::Socket::initSockets();
+    simgear::Socket a, b;
+    if (!a.open(false) || !b.open(false) ||
+        (a.bind("127.0.0.1", port) < 0) || (b.bind("127.0.0.1", port + 1) < 0) ||
+        (a.connect("127.0.0.1", port + 1) < 0) || (b.connect("127.0.0.1", port) < 0)) {
+        fprintf(stderr, "cannot set up UDP on ports %d and %d\n", port, port + 1);
+        return {};
+    }
+
+    auto udpEndpoint = [](simgear::Socket& s) {
+        Endpoint e;
+        e.send = [&s](const char* buf, int n) { return s.send(buf, n) == n; };
+        e.receive = [&s](char* buf, int n) { return s.recv(buf, n); };
+        return e;
+    };
+
+    Endpoint ping = udpEndpoint(a), pong = udpEndpoint(b);
+    auto result = pingPong(ping, pong, rounds, size);
+    a.close();
+    b.close();
+    return result;
+}
+
+} // of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    const int rounds = (argc > 1) ? atoi(argv[1]) : 20000;
+    const int size = (argc > 2) ? atoi(argv[2]) : 408; // sizeof(FGNetFDM)
+    const int port = (argc > 3) ? atoi(argv[3]) : 5620;
+
+    printf("%d round trips of %d bytes, one-way latency:\n", rounds, size);
+
+    auto shmWait = benchShm(false, rounds, size);
+    report("shm futex", shmWait);
+
+    auto shmPoll = benchShm(true, rounds, size);
+    report("shm poll", shmPoll);
+
+    auto udp = benchUdp(rounds, size, port);
+    report("udp loopback", udp);
+
+    return (shmWait.empty() || shmPoll.empty() || udp.empty()) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
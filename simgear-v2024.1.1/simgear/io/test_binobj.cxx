@@ -13,6 +13,7 @@
 #   define  random  rand
 #endif
 
+#include <simgear/io/iostreams/sgstream.hxx>
 #include <simgear/misc/sg_dir.hxx>
 #include <simgear/misc/test_macros.hxx>
 
@@ -344,6 +345,122 @@ void test_many_objects()
     compareTris(basic, rd);
 }
 
+void test_mapped()
+{
+    SGBinObject basic;
+    SGPath path(simgear::Dir::current().file("mapped.btg.gz"));
+    SGPath mappedPath = SGBinObject::mapped_path(path);
+    SG_CHECK_EQUAL(mappedPath.file(), "mapped.btgm");
+    mappedPath.remove();
+
+    SGVec3d center(1, 2, 3);
+    basic.set_gbs_center(center);
+    basic.set_gbs_radius(12345);
+
+    std::vector<SGVec3d> points;
+    generate_points(1024, points);
+    std::vector<SGVec3f> normals;
+    generate_normals(1024, normals);
+    std::vector<SGVec2f> texCoords;
+    generate_tcs(2048, texCoords);
+
+    std::vector<SGVec4f> colors;
+    for (int i = 0; i < 256; ++i) {
+        colors.push_back(SGVec4f(i / 256.0f, 0.5f, 0.25f, 1.0f));
+    }
+
+    basic.set_wgs84_nodes(points);
+    basic.set_colors(colors);
+    basic.set_normals(normals);
+    basic.set_texcoords(texCoords);
+    generate_tris(basic, 5000);
+
+    SG_VERIFY(basic.write_bin_file(path));
+
+    // convert, as the conversion tool does
+    SGBinObject gz;
+    SG_VERIFY(gz.read_bin(path));
+    SG_VERIFY(gz.write_mapped(mappedPath, path));
+    SG_VERIFY(SGBinObject::mapped_path(path).exists());
+
+    // read_bin() prefers the mapped variant
+    SGBinObject rd;
+    SG_VERIFY(rd.read_bin(path));
+    SG_CHECK_EQUAL(rd.get_version(), gz.get_version());
+    SG_CHECK_EQUAL(rd.get_gbs_center(), center);
+    SG_CHECK_EQUAL(rd.get_gbs_radius(), 12345);
+    SG_CHECK_EQUAL(rd.get_wgs84_nodes().size(), points.size());
+    SG_CHECK_EQUAL(rd.get_normals().size(), gz.get_normals().size());
+    SG_CHECK_EQUAL(rd.get_tri_materials().size(), gz.get_tri_materials().size());
+    for (unsigned int i = 0; i < points.size(); ++i) {
+        SG_CHECK_EQUAL(rd.get_wgs84_nodes()[i], gz.get_wgs84_nodes()[i]);
+        SG_CHECK_EQUAL(rd.get_normals()[i], gz.get_normals()[i]);
+    }
+    comparePoints(rd, points);
+    compareTexCoords(rd, texCoords);
+    compareTris(gz, rd);
+    SG_VERIFY(rd.get_tris_n() == gz.get_tris_n());
+    SG_CHECK_EQUAL(rd.get_colors().size(), colors.size());
+
+    // a damaged mapped file is ignored
+    {
+        sg_ofstream damaged(mappedPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        damaged << "SGBM";
+    }
+    SGBinObject fallback;
+    SG_VERIFY(!fallback.read_mapped(mappedPath));
+    SG_VERIFY(fallback.read_bin(path));
+    SG_CHECK_EQUAL(fallback.get_wgs84_nodes().size(), points.size());
+    compareTris(gz, fallback);
+
+    // a mapped file failing half way: nothing of it is left in the lists
+    // read from the .btg.gz instead
+    SG_VERIFY(gz.write_mapped(mappedPath, path));
+    {
+        std::string data;
+        {
+            sg_ifstream in(mappedPath, std::ios::in | std::ios::binary);
+            data = in.read_all();
+        }
+        sg_ofstream truncated(mappedPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        truncated.write(data.data(), data.size() * 3 / 4);
+    }
+    SGBinObject partial;
+    SG_VERIFY(!partial.read_mapped(mappedPath, path));
+    SG_VERIFY(partial.read_bin(path));
+    SG_CHECK_EQUAL(partial.get_wgs84_nodes().size(), points.size());
+    SG_CHECK_EQUAL(partial.get_colors().size(), colors.size());
+    SG_CHECK_EQUAL(partial.get_normals().size(), gz.get_normals().size());
+    compareTris(gz, partial);
+
+    // an out of date mapped file is ignored: the .btg.gz was updated
+    // after the conversion
+    SG_VERIFY(gz.write_mapped(mappedPath, path));
+    SG_VERIFY(rd.read_mapped(mappedPath, path));
+    SGBinObject updated;
+    std::vector<SGVec3d> updatedPoints;
+    generate_points(512, updatedPoints);
+    updated.set_wgs84_nodes(updatedPoints);
+    updated.set_normals(normals);
+    updated.set_texcoords(texCoords);
+    generate_tris(updated, 1000);
+    SG_VERIFY(updated.write_bin_file(path));
+
+    SGBinObject stale;
+    SG_VERIFY(!stale.read_mapped(mappedPath, path));
+    SG_VERIFY(stale.read_bin(path));
+    SG_CHECK_EQUAL(stale.get_wgs84_nodes().size(), updatedPoints.size());
+    SG_VERIFY(stale.get_colors().empty());
+
+    // converting again makes it current
+    SG_VERIFY(stale.write_mapped(mappedPath, path));
+    SG_VERIFY(rd.read_bin(path));
+    SG_CHECK_EQUAL(rd.get_wgs84_nodes().size(), updatedPoints.size());
+    SG_VERIFY(SGBinObject().read_mapped(mappedPath, path));
+
+    mappedPath.remove();
+}
+
 int main(int argc, char* argv[])
 {
     test_empty();
@@ -352,6 +469,7 @@ int main(int argc, char* argv[])
     test_big();
     test_some_objects();
     test_many_objects();
+    test_mapped();
     
     return 0;
 }
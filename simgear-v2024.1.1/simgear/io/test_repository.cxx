@@ -534,6 +534,69 @@ void testModifyLocalFiles(HTTP::Client* cl)
     std::cout << "Passed test: identify and fix locally modified files" << std::endl;
 }
 
+void testVerifyLocalCopy(HTTP::Client* cl)
+{
+    std::unique_ptr<HTTPRepository> repo;
+    SGPath p(simgear::Dir::current().path());
+    p.append("http_repo_verify_local");
+    simgear::Dir pd(p);
+    if (pd.exists()) {
+        pd.removeChildren();
+    }
+
+    repo.reset(new HTTPRepository(p, cl));
+    repo->setBaseUrl("http://localhost:2000/repo");
+    repo->update();
+    waitForUpdateComplete(cl, repo.get());
+
+    // a fresh repository object, so nothing is cached in memory
+    repo.reset(new HTTPRepository(p, cl));
+    repo->setBaseUrl("http://localhost:2000/repo");
+    repo->setMaxIOThreads(3);
+    global_repo->clearRequestCounts();
+    if (repo->verifyLocalCopy() != HTTPRepository::REPO_NO_ERROR) {
+        throw sg_exception("verify failed on a clean copy");
+    }
+
+    SGPath modFile(p / "dirB/subdirA/fileBAA");
+    {
+        sg_ofstream of(modFile, std::ios::out | std::ios::trunc);
+        of << "complete nonsense";
+        of.close();
+    }
+    (p / "dirA/fileAB").remove();
+
+    if (repo->verifyLocalCopy() != HTTPRepository::REPO_PARTIAL_UPDATE) {
+        throw sg_exception("verify didn't find damaged files");
+    }
+
+    auto failures = repo->failures();
+    if (failures.size() != 2) {
+        throw sg_exception("wrong number of verify failures");
+    }
+    for (const auto& f : failures) {
+        const bool ok = ((f.path == SGPath("dirB/subdirA/fileBAA")) && (f.error == HTTPRepository::REPO_ERROR_CHECKSUM)) ||
+                        ((f.path == SGPath("dirA/fileAB")) && (f.error == HTTPRepository::REPO_ERROR_FILE_NOT_FOUND));
+        if (!ok) {
+            throw sg_exception("unexpected verify failure:" + f.path.utf8Str());
+        }
+    }
+
+    // verifying needs no network
+    verifyRequestCount("dirB/subdirA", 0);
+    verifyRequestCount("dirB/subdirA/fileBAA", 0);
+
+    // a sync repairs what verify found
+    repo->update();
+    waitForUpdateComplete(cl, repo.get());
+    verifyFileState(p, "dirB/subdirA/fileBAA");
+    verifyFileState(p, "dirA/fileAB");
+    if (repo->verifyLocalCopy() != HTTPRepository::REPO_NO_ERROR) {
+        throw sg_exception("verify failed after repair");
+    }
+
+    std::cout << "Passed test: verify local copy" << std::endl;
+}
 
 void testMergeExistingFileWithoutDownload(HTTP::Client* cl)
 {
@@ -931,6 +994,8 @@ int main(int argc, char* argv[])
 
     testModifyLocalFiles(&cl);
 
+    testVerifyLocalCopy(&cl);
+
     testLossOfLocalFiles(&cl);
 
     testMergeExistingFileWithoutDownload(&cl);
@@ -0,0 +1,171 @@
+// Unit tests for SGSharedMemory
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "sg_shm.hxx"
+
+namespace {
+
+// unique per process, so parallel test runs do not share segments
+std::string segmentName(const char* test)
+{
+    return std::string("sg-test-shm-") + test + "-" + std::to_string(getpid());
+}
+
+void testMessages()
+{
+    const std::string name = segmentName("messages");
+    SGSharedMemory a(name), b(name);
+    SG_VERIFY(a.open(SG_IO_OUT));
+
+    // nobody listening yet: discarded
+    SG_CHECK_EQUAL(a.write("lost", 4), 4);
+    SG_VERIFY(!a.hasPeer());
+
+    SG_VERIFY(b.open(SG_IO_IN));
+    SG_VERIFY(a.hasPeer());
+    SG_VERIFY(b.hasPeer());
+    SG_VERIFY(!b.hasData());
+
+    char buf[64];
+    SG_CHECK_EQUAL(b.read(buf, sizeof(buf)), 0);
+
+    SG_CHECK_EQUAL(a.writestring("hello"), 5);
+    SG_CHECK_EQUAL(a.write("world!", 6), 6);
+    SG_VERIFY(b.hasData());
+
+    SG_CHECK_EQUAL(b.read(buf, sizeof(buf)), 5);
+    SG_VERIFY(std::memcmp(buf, "hello", 5) == 0);
+
+    // a short buffer truncates, the rest of the message is dropped
+    SG_CHECK_EQUAL(b.readline(buf, 3), 3);
+    SG_VERIFY(std::memcmp(buf, "wor", 3) == 0);
+    SG_CHECK_EQUAL(b.read(buf, sizeof(buf)), 0);
+
+    // the other direction
+    SG_CHECK_EQUAL(b.write("back", 4), 4);
+    SG_CHECK_EQUAL(a.read(buf, sizeof(buf)), 4);
+    SG_VERIFY(std::memcmp(buf, "back", 4) == 0);
+
+    // a third peer is refused
+    SGSharedMemory c(name);
+    SG_VERIFY(!c.open(SG_IO_IN));
+
+    SG_VERIFY(b.close());
+    SG_VERIFY(!a.hasPeer());
+    SG_VERIFY(a.close());
+}
+
+void testWrapAround()
+{
+    const std::string name = segmentName("wrap");
+    SGSharedMemory a(name, 4096), b(name);
+    SG_VERIFY(a.open(SG_IO_OUT));
+    SG_VERIFY(b.open(SG_IO_IN));
+
+    // too large for the ring
+    char big[4096] = {0};
+    SG_CHECK_EQUAL(a.write(big, sizeof(big)), -1);
+
+    // odd sizes, so records end everywhere in the ring
+    char out[300], in[300];
+    for (int i = 0; i < 1000; ++i) {
+        const int length = 1 + (i * 37) % 300;
+        for (int j = 0; j < length; ++j) {
+            out[j] = static_cast<char>(i + j);
+        }
+        SG_CHECK_EQUAL(a.write(out, length), length);
+        SG_CHECK_EQUAL(b.read(in, sizeof(in)), length);
+        SG_VERIFY(std::memcmp(in, out, length) == 0);
+    }
+
+    // fill it up: writes fail until the reader catches up
+    int written = 0;
+    while (a.write(out, 100) == 100) {
+        ++written;
+    }
+    SG_CHECK_GT(written, 30);
+    SG_CHECK_LT(written, 40);
+    SG_CHECK_EQUAL(a.write(out, 100), 0);
+
+    SG_CHECK_EQUAL(b.read(in, sizeof(in)), 100);
+    SG_CHECK_EQUAL(a.write(out, 100), 100);
+    for (int i = 0; i < written; ++i) {
+        SG_CHECK_EQUAL(b.read(in, sizeof(in)), 100);
+    }
+    SG_VERIFY(!b.hasData());
+}
+
+void testWait()
+{
+    const std::string name = segmentName("wait");
+    SGSharedMemory a(name), b(name);
+    SG_VERIFY(a.open(SG_IO_BI));
+    SG_VERIFY(b.open(SG_IO_BI));
+
+    SG_VERIFY(!b.waitForData(10));
+
+    // ping-pong between two threads, each blocked until the other writes
+    const int rounds = 1000;
+    std::thread echo([&b]() {
+        char buf[16];
+        for (int i = 0; i < rounds; ++i) {
+            if (!b.waitForData(5000)) {
+                return;
+            }
+            const int n = b.read(buf, sizeof(buf));
+            b.write(buf, n);
+        }
+    });
+
+    for (int i = 0; i < rounds; ++i) {
+        SG_CHECK_EQUAL(a.write(reinterpret_cast<const char*>(&i), sizeof(i)), static_cast<int>(sizeof(i)));
+        SG_VERIFY(a.waitForData(5000));
+        int answer = -1;
+        SG_CHECK_EQUAL(a.read(reinterpret_cast<char*>(&answer), sizeof(answer)), static_cast<int>(sizeof(answer)));
+        SG_CHECK_EQUAL(answer, i);
+    }
+    echo.join();
+}
+
+void testStaleSlot()
+{
+    const std::string name = segmentName("stale");
+    SGSharedMemory a(name);
+    SG_VERIFY(a.open(SG_IO_OUT));
+
+    {
+        // a peer which goes away with unread data in its ring
+        SGSharedMemory b(name);
+        SG_VERIFY(b.open(SG_IO_IN));
+        SG_CHECK_EQUAL(a.write("old", 3), 3);
+    }
+
+    SGSharedMemory c(name);
+    SG_VERIFY(c.open(SG_IO_IN));
+    SG_VERIFY(!c.hasData());
+    SG_CHECK_EQUAL(a.write("new", 3), 3);
+
+    char buf[8];
+    SG_CHECK_EQUAL(c.read(buf, sizeof(buf)), 3);
+    SG_VERIFY(std::memcmp(buf, "new", 3) == 0);
+}
+
+} // of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    testMessages();
+    testWrapAround();
+    testWait();
+    testStaleSlot();
+    return EXIT_SUCCESS;
+}
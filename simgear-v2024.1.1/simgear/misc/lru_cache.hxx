@@ -156,7 +156,7 @@ namespace simgear
     private:
         void evict()
         {
-            std::lock_guard<std::mutex> scopeLock(_mutex);
+            // called with _mutex held by insert()
             // evict item from the end of most recently used list
             typename list_type::iterator i = --m_list.end();
             m_map.erase(*i);
@@ -896,6 +896,17 @@ naRef naGetSourceFile(naContext ctx, int frame)
     return naNil();
 }
 
+naRef naGetFuncSourceFile(naRef func, int* line)
+{
+    if(IS_FUNC(func) && IS_CODE(PTR(func).func->code)) {
+        struct naCode* c = PTR(PTR(func).func->code).code;
+        if(line) *line = c->nLines ? LINEIPS(c)[1] : -1;
+        return c->srcFile;
+    }
+    if(line) *line = -1;
+    return naNil();
+}
+
 char* naGetError(naContext ctx)
 {
     if(IS_STR(ctx->dieArg))
@@ -184,6 +184,10 @@ int naGetLine(naContext ctx, int frame);
 naRef naGetSourceFile(naContext ctx, int frame);
 char* naGetError(naContext ctx);
 
+// Where a function is defined: its source file, and its first line in
+// *line if not null. Nil and -1 for C functions.
+naRef naGetFuncSourceFile(naRef func, int* line);
+
 // Type predicates
 int naIsNil(naRef r) GCC_PURE;
 int naIsNum(naRef r) GCC_PURE;
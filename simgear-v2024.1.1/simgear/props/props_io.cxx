@@ -18,7 +18,10 @@
 
 #include <simgear/sg_inlines.h>
 #include <simgear/debug/logstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/misc/sg_hash.hxx>
 #include <simgear/misc/sg_path.hxx>
+#include <simgear/misc/strutils.hxx>
 #include <simgear/xml/easyxml.hxx>
 #include <simgear/misc/ResourceManager.hxx>
 #include <simgear/io/iostreams/sgstream.hxx>
@@ -33,6 +36,10 @@
 #include <cstring>      // strcmp()
 #include <vector>
 #include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
 using std::istream;
 using std::ifstream;
@@ -405,6 +412,448 @@ PropsVisitor::warning (const char * message, int line, int column)
 }
 
 
+////////////////////////////////////////////////////////////////////////
+// Binary cache of property list files.
+//
+// Instead of the resulting tree, the cache holds a recording of the
+// events the XML parser delivered to the PropsVisitor. Replaying it
+// gives exactly the tree the XML would: values, attributes and aliases
+// are applied by the same code, and includes are resolved and read
+// again (from their own cache entries). Names, attribute values and text
+// are interned in a string table.
+////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const uint32_t PROPS_CACHE_MAGIC = 0x43504753; // "SGPC", also checks byte order
+const uint32_t PROPS_CACHE_VERSION = 1;
+
+enum PropsCacheOp : uint8_t {
+  CACHE_START_ELEMENT = 1,
+  CACHE_END_ELEMENT,
+  CACHE_DATA,
+  CACHE_WARNING
+};
+
+std::mutex propsCacheMutex;
+SGPath propsCacheDir;
+
+SGPath
+propsCacheDirectory ()
+{
+  std::lock_guard<std::mutex> lock(propsCacheMutex);
+  return propsCacheDir;
+}
+
+/**
+ * The cache entry of a source file, named after the hash of its path.
+ */
+SGPath
+propsCachePath (const SGPath &dir, const SGPath &source)
+{
+  const string path = source.utf8Str();
+  simgear::sha1nfo info;
+  simgear::sha1_init(&info);
+  simgear::sha1_write(&info, path.data(), path.size());
+  return dir / (simgear::strutils::encodeHex(simgear::sha1_result(&info), HASH_LENGTH) + ".sgpc");
+}
+
+/**
+ * Forwards the parser events to a PropsVisitor, recording them.
+ */
+class PropsRecorder : public XMLVisitor
+{
+public:
+  explicit PropsRecorder (PropsVisitor &visitor) : _visitor(visitor) {}
+
+  void startXML () override
+  {
+    _visitor.setPath(getPath());
+    _visitor.startXML();
+  }
+
+  void endXML () override
+  {
+    _visitor.endXML();
+  }
+
+  void startElement (const char * name, const XMLAttributes &atts) override
+  {
+    flushData();
+    _ops.push_back(CACHE_START_ELEMENT);
+    putInt(intern(name));
+    putPosition();
+    putInt(atts.size());
+    for (int i = 0; i < atts.size(); ++i) {
+      putInt(intern(atts.getName(i)));
+      putInt(intern(atts.getValue(i)));
+    }
+
+    _visitor.setPosition(getLine(), getColumn());
+    _visitor.startElement(name, atts);
+  }
+
+  void endElement (const char * name) override
+  {
+    flushData();
+    _ops.push_back(CACHE_END_ELEMENT);
+    putInt(intern(name));
+    putPosition();
+
+    _visitor.setPosition(getLine(), getColumn());
+    _visitor.endElement(name);
+  }
+
+  void data (const char * s, int length) override
+  {
+    // the visitor appends consecutive chunks, record them as one
+    _data.append(s, length);
+
+    _visitor.setPosition(getLine(), getColumn());
+    _visitor.data(s, length);
+  }
+
+  void warning (const char * message, int line, int column) override
+  {
+    flushData();
+    _ops.push_back(CACHE_WARNING);
+    putInt(intern(message));
+    putInt(line);
+    putInt(column);
+
+    _visitor.warning(message, line, column);
+  }
+
+  /**
+   * Write the recording, made from source with the given size and
+   * modification time. Written to a temporary file first, so readers
+   * never see a partial entry.
+   */
+  void write (const SGPath &cachePath, const SGPath &source,
+              uint64_t sourceSize, uint64_t sourceModTime) const
+  {
+    std::string header;
+    auto put = [&header](uint64_t v, size_t bytes) {
+      header.append(reinterpret_cast<const char*>(&v), bytes);
+    };
+    auto putString = [&header, &put](const string &str) {
+      put(str.size(), 4);
+      header.append(str);
+    };
+
+    put(PROPS_CACHE_MAGIC, 4);
+    put(PROPS_CACHE_VERSION, 4);
+    put(sourceSize, 8);
+    put(sourceModTime, 8);
+    putString(source.utf8Str());
+    put(_strings.size(), 4);
+    for (const auto &str : _strings)
+      putString(str);
+    put(_ops.size(), 8);
+
+    std::ostringstream tmpName;
+    tmpName << cachePath.file() << ".tmp" << std::this_thread::get_id();
+    const SGPath tmpPath = cachePath.dirPath() / tmpName.str();
+    {
+      sg_ofstream out(tmpPath, std::ios::out | std::ios::trunc | std::ios::binary);
+      if (!out.is_open())
+        return;
+      out.write(header.data(), header.size());
+      out.write(_ops.data(), _ops.size());
+      if (!out.good()) {
+        out.close();
+        SGPath(tmpPath).remove();
+        return;
+      }
+    }
+
+    SGPath(tmpPath).rename(cachePath);
+  }
+
+private:
+  uint32_t intern (const char * str)
+  {
+    auto it = _ids.emplace(str, static_cast<uint32_t>(_strings.size()));
+    if (it.second)
+      _strings.push_back(str);
+    return it.first->second;
+  }
+
+  // small numbers are the rule, stored in 7 bit groups
+  void putInt (uint32_t v)
+  {
+    while (v >= 0x80) {
+      _ops.push_back(static_cast<char>(v | 0x80));
+      v >>= 7;
+    }
+    _ops.push_back(static_cast<char>(v));
+  }
+
+  void putPosition ()
+  {
+    putInt(getLine());
+    putInt(getColumn());
+  }
+
+  void flushData ()
+  {
+    if (_data.empty())
+      return;
+    // mostly the same indentation over and over
+    _ops.push_back(CACHE_DATA);
+    putInt(intern(_data.c_str()));
+    _data.clear();
+  }
+
+  PropsVisitor &_visitor;
+  string _data;                 ///< not recorded yet
+  string _ops;
+  vector<string> _strings;
+  std::unordered_map<string, uint32_t> _ids;
+};
+
+/**
+ * Attributes of a cached element, pointing into the string table.
+ */
+class CachedAttributes : public XMLAttributes
+{
+public:
+  int size () const override { return static_cast<int>(_atts.size()); }
+  const char * getName (int i) const override { return _atts[i].first; }
+  const char * getValue (int i) const override { return _atts[i].second; }
+
+  vector<std::pair<const char*, const char*>> _atts;
+};
+
+/**
+ * Reads a cache entry, checking every read against the end of the data.
+ */
+class PropsCacheReader
+{
+public:
+  explicit PropsCacheReader (const string &buffer)
+    : _pos(buffer.data()), _end(buffer.data() + buffer.size())
+  {}
+
+  bool get (uint64_t &v, size_t bytes)
+  {
+    if (static_cast<size_t>(_end - _pos) < bytes)
+      return false;
+    v = 0;
+    memcpy(&v, _pos, bytes);
+    _pos += bytes;
+    return true;
+  }
+
+  bool get (uint32_t &v)
+  {
+    uint64_t v64;
+    if (!get(v64, 4))
+      return false;
+    v = static_cast<uint32_t>(v64);
+    return true;
+  }
+
+  bool getInt (uint32_t &v)
+  {
+    v = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+      if (_pos == _end)
+        return false;
+      const uint8_t byte = static_cast<uint8_t>(*_pos++);
+      v |= static_cast<uint32_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool getBytes (const char *&data, uint32_t &length)
+  {
+    if (!get(length) || static_cast<size_t>(_end - _pos) < length)
+      return false;
+    data = _pos;
+    _pos += length;
+    return true;
+  }
+
+  bool getString (string &str)
+  {
+    const char *data;
+    uint32_t length;
+    if (!getBytes(data, length))
+      return false;
+    str.assign(data, length);
+    return true;
+  }
+
+  bool atEnd () const { return _pos == _end; }
+  size_t remaining () const { return _end - _pos; }
+
+private:
+  const char *_pos, *_end;
+};
+
+/**
+ * Feed the recording in cachePath to the visitor, if it was made from
+ * source as it is now. Returns false, without touching the visitor, if
+ * there is no usable entry.
+ */
+bool
+replayPropsCache (const SGPath &cachePath, const SGPath &source,
+                  PropsVisitor &visitor)
+{
+  string buffer;
+  {
+    sg_ifstream in(cachePath, std::ios::in | std::ios::binary);
+    if (!in.is_open())
+      return false;
+    buffer = in.read_all();
+  }
+
+  PropsCacheReader reader(buffer);
+  uint64_t magic, version, sourceSize, sourceModTime;
+  string sourcePath;
+  if (!reader.get(magic, 4) || !reader.get(version, 4)
+      || magic != PROPS_CACHE_MAGIC || version != PROPS_CACHE_VERSION
+      || !reader.get(sourceSize, 8) || !reader.get(sourceModTime, 8)
+      || !reader.getString(sourcePath))
+    return false;
+
+  if (sourcePath != source.utf8Str() || !source.exists()
+      || sourceSize != source.sizeInBytes()
+      || sourceModTime != static_cast<uint64_t>(source.modTime()))
+    return false;
+
+  uint32_t count;
+  if (!reader.get(count))
+    return false;
+  vector<string> strings(count);
+  for (auto &str : strings) {
+    if (!reader.getString(str))
+      return false;
+  }
+
+  uint64_t opsSize;
+  // also catches a truncated entry
+  if (!reader.get(opsSize, 8) || opsSize != reader.remaining())
+    return false;
+
+  // Decode everything before replaying, a damaged entry must not leave
+  // half a file applied to the tree.
+  struct Event {
+    PropsCacheOp op;
+    uint32_t name, line, column;  ///< name is the text for CACHE_DATA
+    size_t firstAtt, numAtts;
+  };
+  vector<Event> events;
+  vector<std::pair<const char*, const char*>> atts;
+
+  auto getString = [&reader, &strings](uint32_t &id) {
+    return reader.getInt(id) && id < strings.size();
+  };
+
+  while (!reader.atEnd()) {
+    uint64_t op;
+    if (!reader.get(op, 1))
+      return false;
+
+    Event e = {static_cast<PropsCacheOp>(op), 0, 0, 0, 0, 0};
+    switch (e.op) {
+    case CACHE_START_ELEMENT: {
+      uint32_t numAtts;
+      if (!getString(e.name) || !reader.getInt(e.line) || !reader.getInt(e.column)
+          || !reader.getInt(numAtts))
+        return false;
+      e.firstAtt = atts.size();
+      e.numAtts = numAtts;
+      for (uint32_t i = 0; i < numAtts; ++i) {
+        uint32_t name, value;
+        if (!getString(name) || !getString(value))
+          return false;
+        atts.emplace_back(strings[name].c_str(), strings[value].c_str());
+      }
+      break;
+    }
+    case CACHE_END_ELEMENT:
+    case CACHE_WARNING:
+      if (!getString(e.name) || !reader.getInt(e.line) || !reader.getInt(e.column))
+        return false;
+      break;
+    case CACHE_DATA:
+      if (!getString(e.name))
+        return false;
+      break;
+    default:
+      return false;
+    }
+    events.push_back(e);
+  }
+
+  visitor.setPath(source.utf8Str());
+  visitor.startXML();
+  CachedAttributes elementAtts;
+  for (const auto &e : events) {
+    switch (e.op) {
+    case CACHE_START_ELEMENT:
+      elementAtts._atts.assign(atts.begin() + e.firstAtt,
+                               atts.begin() + e.firstAtt + e.numAtts);
+      visitor.setPosition(e.line, e.column);
+      visitor.startElement(strings[e.name].c_str(), elementAtts);
+      break;
+    case CACHE_END_ELEMENT:
+      visitor.setPosition(e.line, e.column);
+      visitor.endElement(strings[e.name].c_str());
+      break;
+    case CACHE_DATA:
+      visitor.data(strings[e.name].data(), strings[e.name].size());
+      break;
+    case CACHE_WARNING:
+      visitor.warning(strings[e.name].c_str(), e.line, e.column);
+      break;
+    }
+  }
+  visitor.endXML();
+  return true;
+}
+
+/**
+ * Read file into the visitor from the cache in cacheDir, or parse it and
+ * update the cache.
+ */
+void
+readPropsCached (const SGPath &file, const SGPath &cacheDir,
+                 PropsVisitor &visitor)
+{
+  const SGPath cachePath = propsCachePath(cacheDir, file);
+  if (replayPropsCache(cachePath, file, visitor))
+    return;
+
+  // taken before parsing, so a file changing meanwhile isn't trusted
+  const uint64_t sourceSize = file.sizeInBytes();
+  const uint64_t sourceModTime = file.modTime();
+
+  PropsRecorder recorder(visitor);
+  readXML(file, recorder);
+  if (visitor.hasException())
+    return;
+
+  simgear::Dir dir(cacheDir);
+  if (!dir.exists())
+    dir.create(0755);
+  recorder.write(cachePath, file, sourceSize, sourceModTime);
+}
+
+} // of anonymous namespace
+
+void
+setReadPropertiesCacheDir (const SGPath &dir)
+{
+  std::lock_guard<std::mutex> lock(propsCacheMutex);
+  propsCacheDir = dir;
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 // Property list reader.
 ////////////////////////////////////////////////////////////////////////
@@ -441,7 +890,11 @@ readProperties (const SGPath &file, SGPropertyNode * start_node,
                 int default_mode, bool extended)
 {
   PropsVisitor visitor(start_node, file.utf8Str(), default_mode, extended);
-  readXML(file, visitor);
+  const SGPath cacheDir = propsCacheDirectory();
+  if (cacheDir.isNull())
+    readXML(file, visitor);
+  else
+    readPropsCached(file, cacheDir, visitor);
   if (visitor.hasException())
     throw visitor.getException();
 }
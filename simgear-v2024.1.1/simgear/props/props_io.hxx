@@ -34,6 +34,16 @@ void readProperties (const SGPath &file, SGPropertyNode * start_node,
                      int default_mode = 0, bool extended = false);
 
 
+/**
+ * Keep a compact binary recording of every file read by
+ * readProperties(const SGPath&, ...) in dir, and use it instead of
+ * parsing the XML as long as the file keeps its size and modification
+ * time. Included files are cached and checked on their own. An empty
+ * path, the default, turns the cache off.
+ */
+void setReadPropertiesCacheDir (const SGPath &dir);
+
+
 /**
  * Read properties from an in-memory buffer.
  */
@@ -12,13 +12,16 @@
 #include <iostream>
 #include <map>
 #include <exception>
+#include <sstream>
 
 #include "props.hxx"
 #include "props_io.hxx"
 
 #include <simgear/misc/test_macros.hxx>
+#include <simgear/misc/sg_dir.hxx>
 #include <simgear/misc/sg_path.hxx>
 #include <simgear/misc/test_macros.hxx>
+#include <simgear/io/iostreams/sgstream.hxx>
 
 using std::cout;
 using std::cerr;
@@ -970,6 +973,66 @@ void testDeleterListener()
     }
 }
 
+static std::string
+readPropertiesText(const SGPath& file)
+{
+    SGPropertyNode_ptr root = new SGPropertyNode;
+    readProperties(file, root);
+    std::ostringstream os;
+    writeProperties(os, root, true);
+    return os.str();
+}
+
+void testReadPropertiesCache()
+{
+    simgear::Dir temp = simgear::Dir::tempDir("props_cache");
+    temp.setRemoveOnDestroy();
+    const SGPath cacheDir = temp.path() / "cache";
+
+    {
+        sg_ofstream f(temp.path() / "included.xml");
+        f << "<PropertyList>\n"
+             "  <rate type=\"double\">2.5</rate>\n"
+             "</PropertyList>\n";
+    }
+    const SGPath main = temp.path() / "main.xml";
+    {
+        sg_ofstream f(main);
+        f << "<?xml version=\"1.0\"?>\n"
+             "<PropertyList>\n"
+             "  <name>cached &amp; <![CDATA[raw <text>]]></name>\n"
+             "  <flag type=\"bool\" archive=\"y\">true</flag>\n"
+             "  <engine n=\"1\"><rpm type=\"int\">2400</rpm></engine>\n"
+             "  <engine><rpm type=\"int\">2500</rpm></engine>\n"
+             "  <engine include=\"included.xml\"/>\n"
+             "  <link alias=\"/flag\"/>\n"
+             "</PropertyList>\n";
+    }
+
+    const std::string expected = readPropertiesText(main);
+
+    setReadPropertiesCacheDir(cacheDir);
+    // recorded while parsing
+    SG_CHECK_EQUAL(readPropertiesText(main), expected);
+    SG_VERIFY(cacheDir.exists());
+    SG_CHECK_EQUAL(simgear::Dir(cacheDir).children(simgear::Dir::TYPE_FILE).size(), 2);
+
+    // replayed
+    SG_CHECK_EQUAL(readPropertiesText(main), expected);
+
+    // a changed file is parsed again
+    {
+        sg_ofstream f(main);
+        f << "<PropertyList><name>changed</name></PropertyList>\n";
+    }
+    SGPropertyNode_ptr root = new SGPropertyNode;
+    readProperties(main, root);
+    SG_CHECK_EQUAL(root->getStringValue("name"), std::string("changed"));
+    SG_VERIFY(!root->hasChild("engine"));
+
+    setReadPropertiesCacheDir(SGPath());
+}
+
 int main (int ac, char ** av)
 {
   test_value();
@@ -994,6 +1057,7 @@ int main (int ac, char ** av)
     tiedPropertiesListeners();
     testDeleterListener();
     testAliasedListeners();
+    testReadPropertiesCache();
 
     return 0;
 }
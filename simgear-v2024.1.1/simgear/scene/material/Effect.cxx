@@ -378,7 +378,46 @@ void Effect::releaseGLObjects(osg::State* state) const
 
 Effect::~Effect()
 {
-    delete _cache;
+    delete _cache.load();
+}
+
+Effect::Cache* Effect::getCache()
+{
+    Cache* cache = _cache.load(std::memory_order_acquire);
+    if (!cache) {
+        Cache* created = new Cache;
+        if (_cache.compare_exchange_strong(cache, created, std::memory_order_acq_rel)) {
+            cache = created;
+        } else {
+            delete created; // another thread won, cache holds its one
+        }
+    }
+    return cache;
+}
+
+ref_ptr<Effect> Effect::Cache::find(const Key& key)
+{
+    ref_ptr<Effect> result;
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto itr = s.map.find(key);
+    if (itr != s.map.end())
+        itr->second.lock(result);
+    return result;
+}
+
+ref_ptr<Effect> Effect::Cache::insert(const Key& key, Effect* effect)
+{
+    Shard& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto irslt = s.map.insert(make_pair(key, observer_ptr<Effect>(effect)));
+    if (!irslt.second) {
+        ref_ptr<Effect> old;
+        if (irslt.first->second.lock(old))
+            return old; // Another thread beat us in creating it!
+        irslt.first->second = effect; // update existing, but empty observer
+    }
+    return effect;
 }
 
 void buildPass(Effect* effect, Technique* tniq, const SGPropertyNode* prop,
@@ -1632,9 +1671,19 @@ void Effect::InitializeCallback::doUpdate(osg::Node* node, osg::NodeVisitor* nv)
     UniformFactory::instance()->updateListeners(root);
 }
 
+Effect::Key::Key(SGPropertyNode* unmerged_, const osgDB::FilePathList& paths_)
+    : unmerged(unmerged_), paths(paths_)
+{
+    if (unmerged.valid())
+        boost::hash_combine(hash, *unmerged);
+    boost::hash_range(hash, paths.begin(), paths.end());
+}
+
 bool Effect::Key::EqualTo::operator()(const Effect::Key& lhs,
                                       const Effect::Key& rhs) const
 {
+    if (lhs.hash != rhs.hash)
+        return false;
     if (lhs.paths.size() != rhs.paths.size()
         || !equal(lhs.paths.begin(), lhs.paths.end(), rhs.paths.begin()))
         return false;
@@ -1646,11 +1695,7 @@ bool Effect::Key::EqualTo::operator()(const Effect::Key& lhs,
 
 size_t hash_value(const Effect::Key& key)
 {
-    size_t seed = 0;
-    if (key.unmerged.valid())
-        boost::hash_combine(seed, *key.unmerged);
-    boost::hash_range(seed, key.paths.begin(), key.paths.end());
-    return seed;
+    return key.hash;
 }
 
 bool Effect_writeLocalData(const Object& obj, osgDB::Output& fw)
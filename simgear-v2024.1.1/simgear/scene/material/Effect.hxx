@@ -17,6 +17,7 @@
 #ifndef SIMGEAR_EFFECT_HXX
 #define SIMGEAR_EFFECT_HXX 1
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -119,32 +120,48 @@ protected:
     struct Key
     {
         Key() {}
-        Key(SGPropertyNode* unmerged_, const osgDB::FilePathList& paths_)
-            : unmerged(unmerged_), paths(paths_)
-        {
-        }
+        Key(SGPropertyNode* unmerged_, const osgDB::FilePathList& paths_);
         Key& operator=(const Key& rhs)
         {
             unmerged = rhs.unmerged;
             paths = rhs.paths;
+            hash = rhs.hash;
             return *this;
         }
         SGPropertyNode_ptr unmerged;
         osgDB::FilePathList paths;
+        // structural hash of unmerged and paths, computed once so
+        // lookups don't walk the property tree again
+        size_t hash = 0;
         struct EqualTo
         {
             bool operator()(const Key& lhs, const Key& rhs) const;
         };
     };
-    typedef std::unordered_map<Key, osg::observer_ptr<Effect>,
-                                    boost::hash<Key>, Key::EqualTo> Cache;
-    Cache* getCache()
+    // The cache is split into shards by key hash, each with its own
+    // lock, so the pager threads loading tiles which share a parent
+    // effect rarely wait for each other.
+    class Cache
     {
-        if (!_cache)
-            _cache = new Cache;
-        return _cache;
-    }
-    Cache* _cache;
+    public:
+        // The live effect cached for key, or null.
+        osg::ref_ptr<Effect> find(const Key& key);
+        // Cache effect for key, unless another thread cached a live
+        // effect for it first. Returns the cached effect.
+        osg::ref_ptr<Effect> insert(const Key& key, Effect* effect);
+    private:
+        enum { NumShards = 16 };
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_map<Key, osg::observer_ptr<Effect>,
+                               boost::hash<Key>, Key::EqualTo> map;
+        };
+        Shard& shard(const Key& key) { return _shards[key.hash % NumShards]; }
+        Shard _shards[NumShards];
+    };
+    Cache* getCache();
+    std::atomic<Cache*> _cache;
     friend size_t hash_value(const Key& key);
     friend Effect* makeEffect(SGPropertyNode* prop, bool realizeTechniques,
                               const SGReaderWriterOptions* options,
@@ -173,6 +190,13 @@ bool makeParametersFromStateSet(SGPropertyNode* paramRoot,
 
 void clearEffectCache();
 
+/**
+ * Load and realize the named effects ahead of time, so the first tiles
+ * using them don't pay for it in the pager threads. They stay in the
+ * effect cache until clearEffectCache(). Returns how many were built.
+ */
+int preloadEffects(const std::vector<std::string>& names, const SGReaderWriterOptions* options);
+
 namespace effect
 {
 /**
@@ -10,7 +10,9 @@
 
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <map>
+#include <mutex>
 
 #include <OpenThreads/ReentrantMutex>
 #include <OpenThreads/ScopedLock>
@@ -33,6 +35,7 @@
 #include <simgear/scene/util/SGSceneFeatures.hxx>
 #include <simgear/scene/util/SplicingVisitor.hxx>
 #include <simgear/structure/SGExpression.hxx>
+#include <simgear/timing/timestamp.hxx>
 
 namespace simgear
 {
@@ -45,7 +48,23 @@ typedef map<const string, ref_ptr<Effect> > EffectMap;
 
 namespace
 {
-EffectMap effectMap;
+// Effects by name, sharded like Effect::Cache so lookups from the
+// pager threads don't contend on one lock.
+struct EffectMapShard
+{
+    std::mutex mutex;
+    EffectMap effects;
+};
+const size_t NumEffectMapShards = 16;
+EffectMapShard effectMapShards[NumEffectMapShards];
+
+EffectMapShard& effectMapShard(const string& name)
+{
+    return effectMapShards[std::hash<string>()(name) % NumEffectMapShards];
+}
+
+// Realizing techniques runs the attribute builders, whose caches are
+// not all thread safe.
 OpenThreads::ReentrantMutex effectMutex;
 }
 
@@ -107,10 +126,11 @@ Effect* makeEffect(const string& name,
                    const SGReaderWriterOptions* options,
                    const SGPath& modelPath)
 {
+    EffectMapShard& shard = effectMapShard(name);
     {
-        OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(effectMutex);
-        EffectMap::iterator itr = effectMap.find(name);
-        if ((itr != effectMap.end())&&
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        EffectMap::iterator itr = shard.effects.find(name);
+        if ((itr != shard.effects.end())&&
             itr->second.valid())
             return itr->second.get();
     }
@@ -133,9 +153,9 @@ Effect* makeEffect(const string& name,
     ref_ptr<Effect> result = makeEffect(effectProps.ptr(), realizeTechniques,
                                         options, SGPath::fromUtf8(absFileName));
     if (result.valid()) {
-        OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(effectMutex);
+        std::lock_guard<std::mutex> lock(shard.mutex);
         pair<EffectMap::iterator, bool> irslt
-            = effectMap.insert(make_pair(name, result));
+            = shard.effects.insert(make_pair(name, result));
         if (!irslt.second) {
             // Another thread beat us to it!. Discard our newly
             // constructed Effect and use the one in the cache.
@@ -146,6 +166,28 @@ Effect* makeEffect(const string& name,
 }
 
 
+namespace
+{
+// Effect needs some generated properties, like tangent vectors
+void setGenerators(Effect* effect, const SGPropertyNode* prop)
+{
+    const SGPropertyNode *generateProp = prop->getChild("generate");
+    if(generateProp)
+    {
+        effect->generator.clear();
+
+        const SGPropertyNode *parameter = generateProp->getChild("normal");
+        if(parameter) effect->setGenerator(Effect::NORMAL, parameter->getIntValue());
+
+        parameter = generateProp->getChild("tangent");
+        if(parameter) effect->setGenerator(Effect::TANGENT, parameter->getIntValue());
+
+        parameter = generateProp->getChild("binormal");
+        if(parameter) effect->setGenerator(Effect::BINORMAL, parameter->getIntValue());
+    }
+}
+}
+
 Effect* makeEffect(SGPropertyNode* prop,
                    bool realizeTechniques,
                    const SGReaderWriterOptions* options,
@@ -189,26 +231,10 @@ Effect* makeEffect(SGPropertyNode* prop,
         //prop->removeChild("inherits-from");
         parent = makeEffect(inheritProp->getStringValue(), false, options, filePath);
         if (parent) {
-            Effect::Key key;
-            key.unmerged = prop;
-            if (options) {
-                key.paths = options->getDatabasePathList();
-            } else {
-                key.paths = osgDB::FilePathList();
-            }
-            Effect::Cache* cache = 0;
-            Effect::Cache::iterator itr;
-            {
-                OpenThreads::ScopedLock<OpenThreads::ReentrantMutex>
-                    lock(effectMutex);
-                cache = parent->getCache();
-                itr = cache->find(key);
-                if ((itr != cache->end())&&
-                    itr->second.lock(effect))
-                {
-                    effect->generator = parent->generator;  // Copy the generators
-                }
-            }
+            Effect::Key key(prop, options ? options->getDatabasePathList()
+                                          : osgDB::FilePathList());
+            Effect::Cache* cache = parent->getCache();
+            effect = cache->find(key);
             if (!effect.valid()) {
                 effect = new Effect;
                 effect->setName(nameProp->getStringValue());
@@ -216,18 +242,14 @@ Effect* makeEffect(SGPropertyNode* prop,
                 effect->root = new SGPropertyNode;
                 mergePropertyTrees(effect->root, prop, parent->root);
                 effect->parametersProp = effect->root->getChild("parameters");
-                OpenThreads::ScopedLock<OpenThreads::ReentrantMutex>
-                    lock(effectMutex);
-                pair<Effect::Cache::iterator, bool> irslt
-                    = cache->insert(make_pair(key, effect));
-                if (!irslt.second) {
-                    ref_ptr<Effect> old;
-                    if (irslt.first->second.lock(old))
-                        effect = old; // Another thread beat us in creating it! Discard our own...
-                    else
-                        irslt.first->second = effect; // update existing, but empty observer
-                }
-                effect->generator = parent->generator;  // Copy the generators
+                // The generators are complete before the effect is shared:
+                // other threads may use a cached effect, it is not written
+                // again.
+                effect->generator = parent->generator;
+                setGenerators(effect.get(), prop);
+                // Another thread may have beaten us in creating it, then
+                // ours is discarded
+                effect = cache->insert(key, effect.get());
             }
         } else {
             simgear::reportFailure(simgear::LoadFailure::NotFound, simgear::ErrorCode::LoadEffectsShaders,
@@ -240,21 +262,7 @@ Effect* makeEffect(SGPropertyNode* prop,
         effect->setName(nameProp->getStringValue());
         effect->root = prop;
         effect->parametersProp = effect->root->getChild("parameters");
-    }
-    const SGPropertyNode *generateProp = prop->getChild("generate");
-    if(generateProp)
-    {
-        effect->generator.clear();
-
-        // Effect needs some generated properties, like tangent vectors
-        const SGPropertyNode *parameter = generateProp->getChild("normal");
-        if(parameter) effect->setGenerator(Effect::NORMAL, parameter->getIntValue());
-
-        parameter = generateProp->getChild("tangent");
-        if(parameter) effect->setGenerator(Effect::TANGENT, parameter->getIntValue());
-
-        parameter = generateProp->getChild("binormal");
-        if(parameter) effect->setGenerator(Effect::BINORMAL, parameter->getIntValue());
+        setGenerators(effect.get(), prop);
     }
     if (realizeTechniques) {
         try {
@@ -274,9 +282,29 @@ Effect* makeEffect(SGPropertyNode* prop,
 void clearEffectCache()
 {
     SG_LOG(SG_INPUT, SG_DEBUG, "clearEffectCache called");
-    OpenThreads::ScopedLock<OpenThreads::ReentrantMutex> lock(effectMutex);
-    effectMap.clear();
+    for (auto& shard : effectMapShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.effects.clear();
+    }
     UniformFactory::instance()->reset();
 }
 
+int preloadEffects(const vector<string>& names, const SGReaderWriterOptions* options)
+{
+    SGTimeStamp st;
+    st.stamp();
+    int count = 0;
+    for (const auto& name : names) {
+        // makeEffect keeps it in the cache by name
+        ref_ptr<Effect> effect = makeEffect(name, true, options);
+        if (effect.valid())
+            ++count;
+        else
+            SG_LOG(SG_INPUT, SG_WARN, "preloadEffects: couldn't build " << name);
+    }
+    SG_LOG(SG_INPUT, SG_INFO, "preloaded " << count << " effects in "
+           << st.elapsedMSec() << " ms");
+    return count;
+}
+
 }
@@ -0,0 +1,125 @@
+#include <simgear_config.h>
+#include <simgear/compiler.h>
+#include <simgear/misc/test_macros.hxx>
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <osg/ref_ptr>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/props/props_io.hxx>
+
+#include "Effect.hxx"
+
+using namespace simgear;
+
+namespace {
+
+const char* baseEffect = R"(<?xml version="1.0"?>
+<PropertyList>
+  <name>test-base</name>
+  <parameters><shininess>1</shininess></parameters>
+  <generate><tangent>6</tangent></generate>
+</PropertyList>
+)";
+
+// inherits the generators of the base
+const char* derivedEffect = R"(<?xml version="1.0"?>
+<PropertyList>
+  <name>test-derived</name>
+  <inherits-from>test-base</inherits-from>
+  <parameters><shininess>2</shininess></parameters>
+</PropertyList>
+)";
+
+// replaces them
+const char* generatingEffect = R"(<?xml version="1.0"?>
+<PropertyList>
+  <name>test-generating</name>
+  <inherits-from>test-base</inherits-from>
+  <parameters><shininess>3</shininess></parameters>
+  <generate><binormal>7</binormal></generate>
+</PropertyList>
+)";
+
+SGPropertyNode_ptr parse(const char* xml)
+{
+    SGPropertyNode_ptr props = new SGPropertyNode;
+    readProperties(xml, strlen(xml), props.ptr());
+    return props;
+}
+
+void checkGenerators(Effect* derived, Effect* generating)
+{
+    SG_VERIFY(derived);
+    SG_CHECK_EQUAL(derived->getGenerator(Effect::TANGENT), 6);
+    SG_CHECK_EQUAL(derived->getGenerator(Effect::BINORMAL), -1);
+
+    SG_VERIFY(generating);
+    SG_CHECK_EQUAL(generating->getGenerator(Effect::TANGENT), -1);
+    SG_CHECK_EQUAL(generating->getGenerator(Effect::BINORMAL), 7);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    simgear::Dir dir = simgear::Dir::tempDir("makeEffect_test");
+    dir.setRemoveOnDestroy();
+    {
+        sg_ofstream f(dir.file("test-base.eff"));
+        f << baseEffect;
+    }
+    // effects are found next to the model
+    const SGPath modelPath = dir.file("model.ac");
+
+    const SGPropertyNode_ptr derivedProps = parse(derivedEffect);
+    const SGPropertyNode_ptr generatingProps = parse(generatingEffect);
+
+    // makeEffect() adds to the properties, each caller has its own copy
+    auto make = [&modelPath](const SGPropertyNode* props) {
+        SGPropertyNode_ptr copy = new SGPropertyNode;
+        copyProperties(props, copy);
+        return osg::ref_ptr<Effect>(makeEffect(copy, false, nullptr, modelPath));
+    };
+
+    const osg::ref_ptr<Effect> derived = make(derivedProps);
+    const osg::ref_ptr<Effect> generating = make(generatingProps);
+    checkGenerators(derived.get(), generating.get());
+    SG_VERIFY(derived != generating);
+
+    // cache hits from several threads at once, like the pager threads
+    // loading tiles: same effects, generators left alone
+    const int threads = 8;
+    const int lookups = 2000;
+    std::vector<int> failures(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < lookups; ++i) {
+                const osg::ref_ptr<Effect> d = make(derivedProps);
+                const osg::ref_ptr<Effect> g = make(generatingProps);
+                if ((d != derived) || (g != generating) ||
+                    (d->generator != derived->generator) ||
+                    (g->generator != generating->generator)) {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    for (int t = 0; t < threads; ++t) {
+        SG_CHECK_EQUAL(failures[t], 0);
+    }
+    checkGenerators(derived.get(), generating.get());
+
+    return EXIT_SUCCESS;
+}
@@ -60,8 +60,90 @@ class SGMaterialLib::MatLibPrivate
 {
 public:
     std::mutex mutex;
+
+    // A material of a name, and the region block it came from
+    struct Candidate
+    {
+        SGSharedPtr<SGMaterial> material;
+        size_t region;
+    };
+
+    // One material of each region block: they all share the areas and
+    // condition of the block
+    std::vector<SGMaterial*> regions;
+    std::map<const SGMaterial*, size_t> regionOf;
+
+    // The candidates by material number, in the order internalFind()
+    // tries them
+    std::vector<std::vector<Candidate> > candidates;
+    std::shared_ptr<SGMaterialCache::Index> index;
+
+    // Lookup tables built so far, by which regions are valid
+    std::map<std::vector<bool>, std::shared_ptr<const SGMaterialCache::Lookup> > lookups;
+
+    void buildIndex(const material_map& matlib, const landclass_map& landclasslib);
+    std::shared_ptr<const SGMaterialCache::Lookup> lookupFor(SGVec2f center);
 };
 
+void SGMaterialLib::MatLibPrivate::buildIndex(const material_map& matlib,
+                                              const landclass_map& landclasslib)
+{
+    index = std::make_shared<SGMaterialCache::Index>();
+    candidates.clear();
+    lookups.clear();
+
+    for (const auto& entry : matlib) {
+        index->names[entry.first] = candidates.size();
+        std::vector<Candidate> c;
+        // the most specific regions come last in materials.xml
+        for (auto it = entry.second.rbegin(); it != entry.second.rend(); ++it) {
+            c.push_back({*it, regionOf[it->ptr()]});
+        }
+        candidates.push_back(std::move(c));
+    }
+
+    for (const auto& entry : landclasslib) {
+        auto it = index->names.find(entry.second._mat);
+        if (it != index->names.end()) {
+            index->landclasses[entry.first] = it->second;
+        }
+    }
+}
+
+std::shared_ptr<const SGMaterialCache::Lookup>
+SGMaterialLib::MatLibPrivate::lookupFor(SGVec2f center)
+{
+    std::vector<bool> valid(regions.size());
+    for (size_t i = 0; i < regions.size(); ++i) {
+        valid[i] = regions[i]->valid(center);
+    }
+
+    auto it = lookups.find(valid);
+    if (it != lookups.end()) {
+        return it->second;
+    }
+
+    auto lookup = std::make_shared<SGMaterialCache::Lookup>();
+    lookup->index = index;
+    lookup->materials.resize(candidates.size());
+    for (size_t m = 0; m < candidates.size(); ++m) {
+        for (const auto& c : candidates[m]) {
+            if (valid[c.region]) {
+                lookup->materials[m] = c.material;
+                break;
+            }
+        }
+    }
+
+    // conditions on changing properties such as the season could
+    // make many combinations over a long session
+    if (lookups.size() > 256) {
+        lookups.clear();
+    }
+    lookups.emplace(std::move(valid), lookup);
+    return lookup;
+}
+
 // Constructor
 SGMaterialLib::SGMaterialLib ( void ) :
     d(new MatLibPrivate)
@@ -136,10 +218,15 @@ bool SGMaterialLib::load( const SGPath &fg_root, const SGPath& mpath,
         const std::string region = node->getStringValue("name");
 		const simgear::PropertyList materials = node->getChildren("material");
 		simgear::PropertyList::const_iterator materials_iter = materials.begin();
+		const size_t regionIndex = d->regions.size();
 		for (; materials_iter != materials.end(); materials_iter++) {
 			const SGPropertyNode *node = materials_iter->get();
 			SGSharedPtr<SGMaterial> m =
 					new SGMaterial(options.get(), node, prop_root, arealist, condition, region);
+			if (d->regions.size() == regionIndex) {
+				d->regions.push_back(m.ptr());
+			}
+			d->regionOf[m.ptr()] = regionIndex;
 
 			std::vector<SGPropertyNode_ptr>names = node->getChildren("name");
 			for ( unsigned int j = 0; j < names.size(); j++ ) {
@@ -173,6 +260,7 @@ bool SGMaterialLib::load( const SGPath &fg_root, const SGPath& mpath,
         }
     }
 
+    d->buildIndex(matlib, landclasslib);
     return true;
 }
 
@@ -248,22 +336,17 @@ SGMaterial *SGMaterialLib::find( int lc, const SGGeod& center ) const
 SGMaterialCache *SGMaterialLib::generateMatCache(SGVec2f center, const simgear::SGReaderWriterOptions* options, bool generateAtlas)
 {
 
-    SGMaterialCache* newCache = new SGMaterialCache();
-    if (generateAtlas) newCache->setAtlas(SGMaterialLib::getOrCreateAtlas(landclasslib, center, options));
-    std::lock_guard<std::mutex> g(d->mutex);
-    material_map::const_reverse_iterator it = matlib.rbegin();
-    for (; it != matlib.rend(); ++it) {
-        newCache->insert(it->first, internalFind(it->first, center));
-    }
+    osg::ref_ptr<Atlas> atlas;
+    if (generateAtlas) atlas = SGMaterialLib::getOrCreateAtlas(landclasslib, center, options);
 
-    // Collapse down the mapping from landclasses to materials.
-    const_landclass_map_iterator lc_iter = landclasslib.begin();
-    for (; lc_iter != landclasslib.end(); ++lc_iter) {
-        SGMaterial* mat = internalFind(lc_iter->second._mat, center);
-        newCache->insert(lc_iter->first, mat);
-        SG_LOG(SG_TERRAIN, SG_DEBUG, "MatCache Landclass mapping: " << lc_iter->first << " : " << mat->get_names()[0]);
+    std::shared_ptr<const SGMaterialCache::Lookup> lookup;
+    {
+        std::lock_guard<std::mutex> g(d->mutex);
+        lookup = d->lookupFor(center);
     }
 
+    SGMaterialCache* newCache = new SGMaterialCache(lookup);
+    if (generateAtlas) newCache->setAtlas(atlas);
     return newCache;
 }
 
@@ -302,6 +385,11 @@ SGMaterialCache::SGMaterialCache ()
 {
 }
 
+SGMaterialCache::SGMaterialCache(std::shared_ptr<const Lookup> lookup) :
+    _lookup(std::move(lookup))
+{
+}
+
 // Insertion into the material cache
 void SGMaterialCache::insert(const std::string& name, SGSharedPtr<SGMaterial> material) {
 	cache[name] = material;    
@@ -316,15 +404,27 @@ void SGMaterialCache::insert(int lc, SGSharedPtr<SGMaterial> material) {
 SGMaterial *SGMaterialCache::find(const string& material) const
 {
     SGMaterialCache::material_cache::const_iterator it = cache.find(material);
-    if (it == cache.end())
-        return NULL;
+    if (it != cache.end())
+        return it->second;
 
-    return it->second;
+    if (_lookup) {
+        auto i = _lookup->index->names.find(material);
+        if (i != _lookup->index->names.end())
+            return _lookup->materials[i->second];
+    }
+
+    return NULL;
 }
 
 // Search of the material cache for a material code as an integer (e.g. from a VPB landclass texture).
 SGMaterial *SGMaterialCache::find(int lc) const
 {
+    if (_lookup) {
+        auto i = _lookup->index->landclasses.find(lc);
+        if (i != _lookup->index->landclasses.end())
+            return _lookup->materials[i->second];
+    }
+
     return find(getNameFromLandclass(lc));
 }
 
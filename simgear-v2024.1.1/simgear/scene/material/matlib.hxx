@@ -37,6 +37,7 @@
 #include <memory>
 #include <string>		// Standard C++ string library
 #include <map>			// STL associative "array"
+#include <unordered_map>
 #include <vector>		// STL "array"
 
 class SGMaterial;
@@ -58,8 +59,24 @@ public:
     //   represent the textures referenced by the texture-set in the material
     // - the texture indexes index into the Atlas itself.
  
+    // Material and landclass numbers, by name and by landclass
+    struct Index
+    {
+        std::unordered_map<std::string, size_t> names;
+        std::unordered_map<int, size_t> landclasses;
+    };
+
+    // The material valid for each material number at some location.
+    // Locations in the same regions share one.
+    struct Lookup
+    {
+        std::shared_ptr<const Index> index;
+        std::vector<SGSharedPtr<SGMaterial> > materials;
+    };
+
     // Constructor
     SGMaterialCache();
+    SGMaterialCache(std::shared_ptr<const Lookup> lookup);
 
     // Insertion
     void insert( const std::string& name, SGSharedPtr<SGMaterial> material );
@@ -78,6 +95,7 @@ public:
 private:
     typedef std::map < std::string, SGSharedPtr<SGMaterial> > material_cache;
     material_cache cache;
+    std::shared_ptr<const Lookup> _lookup;
     osg::ref_ptr<simgear::Atlas> _atlas;
 
     const std::string getNameFromLandclass(int lc) const {
@@ -149,6 +167,10 @@ public:
      * To fix this, and also avoid repeated re-evaluation of the material
      * conditions, we provide factory method to generate a material library
      * cache of the valid materials based on the current state and a given position.
+     *
+     * The cache only evaluates the areas and condition of each region
+     * once, and shares its table with the caches of all positions where
+     * the same regions are valid.
      */
 
     SGMaterialCache *generateMatCache( SGVec2f center, const simgear::SGReaderWriterOptions* options, bool generatAtlas = false);
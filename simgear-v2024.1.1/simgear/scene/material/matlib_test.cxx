@@ -0,0 +1,134 @@
+#include <simgear_config.h>
+#include <simgear/compiler.h>
+#include <simgear/misc/test_macros.hxx>
+
+#include <cstdlib>
+
+#include <osg/ref_ptr>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_dir.hxx>
+#include <simgear/props/props.hxx>
+
+#include "mat.hxx"
+#include "matlib.hxx"
+
+namespace {
+
+// Overlapping regions, one of them with two areas, and conditions on
+// the season, like the regions of the FGData materials.xml.
+const char* materialsXml = R"(<?xml version="1.0"?>
+<PropertyList>
+  <region>
+    <name>World</name>
+    <material><name>Grass</name><name>Landmass</name></material>
+    <material><name>Water</name></material>
+    <material><name>Town</name></material>
+  </region>
+  <region>
+    <name>Winter</name>
+    <condition><property>/sim/startup/winter</property></condition>
+    <material><name>Grass</name></material>
+  </region>
+  <region>
+    <name>Europe</name>
+    <area><lon1>-10</lon1><lon2>40</lon2><lat1>35</lat1><lat2>70</lat2></area>
+    <material><name>Grass</name><name>Town</name></material>
+  </region>
+  <region>
+    <name>Mountains</name>
+    <area><lon1>5</lon1><lon2>15</lon2><lat1>44</lat1><lat2>48</lat2></area>
+    <area><lon1>-125</lon1><lon2>-105</lon2><lat1>35</lat1><lat2>55</lat2></area>
+    <material><name>Grass</name></material>
+  </region>
+  <region>
+    <name>Tropics</name>
+    <area><lon1>180</lon1><lon2>-180</lon2><lat1>23</lat1><lat2>-23</lat2></area>
+    <condition><not><property>/sim/startup/winter</property></not></condition>
+    <material><name>Water</name></material>
+  </region>
+  <landclass-mapping>
+    <map><landclass>1</landclass><material-name>Grass</material-name></map>
+    <map><landclass>2</landclass><material-name>Town</material-name></map>
+    <map><landclass>3</landclass><material-name>Water</material-name></map>
+    <map><landclass>4</landclass><material-name>Nothing</material-name></map>
+  </landclass-mapping>
+</PropertyList>
+)";
+
+std::string regionName(const SGMaterial* m)
+{
+    return m ? m->get_region_name() : std::string("none");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    simgear::Dir dir = simgear::Dir::tempDir("matlib_test");
+    dir.setRemoveOnDestroy();
+    const SGPath mpath = dir.file("materials.xml");
+    {
+        sg_ofstream f(mpath);
+        f << materialsXml;
+    }
+
+    SGPropertyNode_ptr props = new SGPropertyNode;
+    SGPropertyNode* winter = props->getNode("sim/startup/winter", true);
+    winter->setBoolValue(false);
+
+    SGMaterialLibPtr matlib = new SGMaterialLib;
+    SG_VERIFY(matlib->load(dir.path(), mpath, props));
+
+    const char* names[] = {"Grass", "Landmass", "Water", "Town", "Nothing"};
+    int checked = 0;
+
+    // the cached lookup gives the same materials as searching the library
+    for (bool isWinter : {false, true}) {
+        winter->setBoolValue(isWinter);
+        for (float lat = -89.5f; lat < 90.0f; lat += 7.0f) {
+            for (float lon = -179.5f; lon < 180.0f; lon += 7.0f) {
+                const SGVec2f center(lon, lat);
+                osg::ref_ptr<SGMaterialCache> cache = matlib->generateMatCache(center, nullptr);
+                for (auto name : names) {
+                    SG_CHECK_EQUAL(regionName(cache->find(name)),
+                                   regionName(matlib->find(name, center)));
+                    SG_CHECK_EQUAL(cache->find(name), matlib->find(name, center));
+                    ++checked;
+                }
+                for (int lc = 0; lc <= 5; ++lc) {
+                    SG_CHECK_EQUAL(cache->find(lc), matlib->find(lc, center));
+                    ++checked;
+                }
+            }
+        }
+    }
+    SG_VERIFY(checked > 1000);
+
+    // spot checks, including both areas of one region
+    winter->setBoolValue(false);
+    osg::ref_ptr<SGMaterialCache> alps = matlib->generateMatCache(SGVec2f(10.0f, 46.0f), nullptr);
+    SG_CHECK_EQUAL(regionName(alps->find("Grass")), "Mountains");
+    SG_CHECK_EQUAL(regionName(alps->find("Town")), "Europe");
+    SG_CHECK_EQUAL(regionName(alps->find("Landmass")), "World");
+    SG_CHECK_EQUAL(alps->find(1), alps->find("Grass"));
+    SG_CHECK_EQUAL(alps->find(4), static_cast<SGMaterial*>(nullptr));
+
+    osg::ref_ptr<SGMaterialCache> rockies = matlib->generateMatCache(SGVec2f(-110.0f, 40.0f), nullptr);
+    SG_CHECK_EQUAL(regionName(rockies->find("Grass")), "Mountains");
+    SG_CHECK_EQUAL(regionName(rockies->find("Town")), "World");
+
+    osg::ref_ptr<SGMaterialCache> pacific = matlib->generateMatCache(SGVec2f(-150.0f, 0.0f), nullptr);
+    SG_CHECK_EQUAL(regionName(pacific->find("Water")), "Tropics");
+    SG_CHECK_EQUAL(regionName(pacific->find(1)), "World");
+
+    // conditions are evaluated for each cache, not when loading
+    winter->setBoolValue(true);
+    pacific = matlib->generateMatCache(SGVec2f(-150.0f, 0.0f), nullptr);
+    SG_CHECK_EQUAL(regionName(pacific->find("Water")), "World");
+    SG_CHECK_EQUAL(regionName(pacific->find(1)), "Winter");
+    alps = matlib->generateMatCache(SGVec2f(10.0f, 46.0f), nullptr);
+    SG_CHECK_EQUAL(regionName(alps->find("Grass")), "Mountains");
+
+    return EXIT_SUCCESS;
+}
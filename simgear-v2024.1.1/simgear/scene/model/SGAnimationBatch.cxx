@@ -0,0 +1,252 @@
+// SGAnimationBatch.cxx - evaluate the simple animations of a model in one pass
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Library General Public
+// License as published by the Free Software Foundation; either
+// version 2 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Library General Public License for more details.
+//
+// You should have received a copy of the GNU Library General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301, USA
+
+#include <simgear_config.h>
+
+#include "SGAnimationBatch.hxx"
+
+#include <limits>
+
+#include <simgear/math/SGLimits.hxx>
+
+#include "SGScaleTransform.hxx"
+#include "SGTranslateTransform.hxx"
+#include "animation.hxx"
+
+SGAnimationBatch::SGAnimationBatch() :
+  _hasAlwaysDirty(false),
+  _initialized(false),
+  _skippedUpdates(0)
+{
+  setName("SGAnimationBatch");
+}
+
+SGAnimationBatch::~SGAnimationBatch()
+{
+}
+
+SGAnimationBatch::Entry&
+SGAnimationBatch::addEntry(Kind kind, osg::Node* node,
+                           const SGCondition* condition)
+{
+  _entries.push_back(Entry());
+  Entry& entry = _entries.back();
+  entry.kind = kind;
+  entry.alwaysDirty = false;
+  entry.node = node;
+  entry.condition = condition;
+  entry.staticValue[0] = 0;
+  entry.staticValue[1] = 0;
+  entry.lastValue = std::numeric_limits<double>::quiet_NaN();
+  // force a full evaluation with the new entry on the next update
+  _initialized = false;
+  return entry;
+}
+
+void
+SGAnimationBatch::addTranslate(SGTranslateTransform* transform,
+                               const SGCondition* condition,
+                               const SGExpressiond* value)
+{
+  Entry& entry = addEntry(TRANSLATE, transform, condition);
+  entry.value[0] = value;
+  collectInputs(entry);
+}
+
+void
+SGAnimationBatch::addScale(SGScaleTransform* transform,
+                           const SGCondition* condition,
+                           const SGSharedPtr<const SGExpressiond> value[3])
+{
+  Entry& entry = addEntry(SCALE, transform, condition);
+  for (unsigned i = 0; i < 3; ++i)
+    entry.value[i] = value[i];
+  collectInputs(entry);
+}
+
+void
+SGAnimationBatch::addRange(osg::LOD* lod,
+                           const SGCondition* condition,
+                           const SGExpressiond* minValue,
+                           const SGExpressiond* maxValue,
+                           double minStaticValue, double maxStaticValue)
+{
+  Entry& entry = addEntry(RANGE, lod, condition);
+  entry.value[0] = minValue;
+  entry.value[1] = maxValue;
+  entry.staticValue[0] = minStaticValue;
+  entry.staticValue[1] = maxStaticValue;
+  collectInputs(entry);
+}
+
+void
+SGAnimationBatch::addBlend(osg::Node* node, const SGExpressiond* value)
+{
+  Entry& entry = addEntry(BLEND, node, 0);
+  entry.value[0] = value;
+  collectInputs(entry);
+}
+
+void
+SGAnimationBatch::collectInputs(Entry& entry)
+{
+  // Each condition and non constant expression must report at least one
+  // input property. One that does not hides what it depends on, even if
+  // the others report theirs, so there is no way around evaluating the
+  // entry every frame.
+  std::set<const SGPropertyNode*> props;
+  if (entry.condition && !collectInputs(entry.condition.get(), props))
+    entry.alwaysDirty = true;
+  for (unsigned i = 0; i < 3; ++i) {
+    if (!entry.value[i] || entry.value[i]->isConst())
+      continue;
+    if (!collectInputs(entry.value[i].get(), props))
+      entry.alwaysDirty = true;
+  }
+
+  if (entry.alwaysDirty) {
+    _hasAlwaysDirty = true;
+    return;
+  }
+
+  std::set<const SGPropertyNode*>::const_iterator i;
+  for (i = props.begin(); i != props.end(); ++i) {
+    if (!_inputSet.insert(*i).second)
+      continue;
+    _inputs.push_back(*i);
+    _inputValues.push_back(std::numeric_limits<double>::quiet_NaN());
+  }
+}
+
+template<typename T>
+bool
+SGAnimationBatch::collectInputs(const T* input,
+                                std::set<const SGPropertyNode*>& props)
+{
+  std::set<const SGPropertyNode*> inputProps;
+  input->collectDependentProperties(inputProps);
+  props.insert(inputProps.begin(), inputProps.end());
+  return !inputProps.empty();
+}
+
+bool
+SGAnimationBatch::inputsChanged()
+{
+  bool changed = false;
+  for (unsigned i = 0; i < _inputs.size(); ++i) {
+    const SGPropertyNode* input = _inputs[i];
+    switch (input->getType()) {
+    case simgear::props::STRING:
+    case simgear::props::UNSPECIFIED:
+      // comparing strings would cost as much as evaluating
+      changed = true;
+      break;
+    default: {
+      double value = input->getDoubleValue();
+      if (value != _inputValues[i]) {
+        _inputValues[i] = value;
+        changed = true;
+      }
+      break;
+    }
+    }
+  }
+  return changed;
+}
+
+void
+SGAnimationBatch::evaluate(Entry& entry, bool all)
+{
+  if (!all && !entry.alwaysDirty)
+    return;
+
+  bool enabled = !entry.condition || entry.condition->test();
+  switch (entry.kind) {
+  case TRANSLATE:
+    if (enabled) {
+      double value = entry.value[0]->getValue();
+      if (value != entry.lastValue) {
+        entry.lastValue = value;
+        static_cast<SGTranslateTransform*>(entry.node)->setValue(value);
+      }
+    }
+    break;
+  case SCALE:
+    if (enabled) {
+      SGScaleTransform* transform;
+      transform = static_cast<SGScaleTransform*>(entry.node);
+      SGVec3d scale(entry.value[0]->getValue(),
+                    entry.value[1]->getValue(),
+                    entry.value[2]->getValue());
+      if (scale != transform->getScaleFactor())
+        transform->setScaleFactor(scale);
+    }
+    break;
+  case RANGE: {
+    osg::LOD* lod = static_cast<osg::LOD*>(entry.node);
+    float minRange = 0;
+    float maxRange = SGLimitsf::max();
+    if (enabled) {
+      if (entry.value[0])
+        minRange = entry.value[0]->getValue();
+      else
+        minRange = entry.staticValue[0];
+      if (entry.value[1])
+        maxRange = entry.value[1]->getValue();
+      else
+        maxRange = entry.staticValue[1];
+    }
+    if (minRange != lod->getMinRange(0) || maxRange != lod->getMaxRange(0))
+      lod->setRange(0, minRange, maxRange);
+    break;
+  }
+  case BLEND: {
+    double blend = entry.value[0]->getValue();
+    if (blend != entry.lastValue) {
+      entry.lastValue = blend;
+      SGBlendAnimation::setBlend(*entry.node, 1 - blend);
+    }
+    break;
+  }
+  }
+}
+
+bool
+SGAnimationBatch::update()
+{
+  bool all = !_initialized || inputsChanged();
+  if (!_initialized) {
+    // prime the cached input values
+    inputsChanged();
+    _initialized = true;
+  }
+
+  if (!all && !_hasAlwaysDirty) {
+    ++_skippedUpdates;
+    return false;
+  }
+
+  for (unsigned i = 0; i < _entries.size(); ++i)
+    evaluate(_entries[i], all);
+  return true;
+}
+
+void
+SGAnimationBatch::operator()(osg::Node* node, osg::NodeVisitor* nv)
+{
+  update();
+  traverse(node, nv);
+}
@@ -0,0 +1,124 @@
+// SGAnimationBatch.hxx - evaluate the simple animations of a model in one pass
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Library General Public
+// License as published by the Free Software Foundation; either
+// version 2 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Library General Public License for more details.
+//
+// You should have received a copy of the GNU Library General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301, USA
+
+#ifndef SG_ANIMATION_BATCH_HXX
+#define SG_ANIMATION_BATCH_HXX
+
+#include <set>
+#include <vector>
+
+#include <osg/LOD>
+#include <osg/NodeCallback>
+#include <osg/ref_ptr>
+
+#include <simgear/props/condition.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/structure/SGExpression.hxx>
+#include <simgear/structure/SGSharedPtr.hxx>
+
+class SGScaleTransform;
+class SGTranslateTransform;
+
+/**
+ * Update callback collecting the translate, scale, range and blend
+ * animations of one loaded model.
+ *
+ * Instead of installing one osg::NodeCallback per animated node, the
+ * animation installers register their transform with the batch of the
+ * model being loaded. The batch is installed as a single update callback
+ * on the model root; every frame it first compares the properties the
+ * animations depend on with the values seen in the previous frame and
+ * only if one of them changed evaluates all conditions and expressions
+ * in one loop and writes the results to the transforms.
+ *
+ * The batch must only be installed on the model root it was filled for.
+ * Animations with an expression or condition that does not report its
+ * input properties through collectDependentProperties() are evaluated on
+ * every frame.
+ */
+class SGAnimationBatch : public osg::NodeCallback {
+public:
+  SGAnimationBatch();
+
+  void addTranslate(SGTranslateTransform* transform,
+                    const SGCondition* condition,
+                    const SGExpressiond* value);
+  void addScale(SGScaleTransform* transform,
+                const SGCondition* condition,
+                const SGSharedPtr<const SGExpressiond> value[3]);
+  void addRange(osg::LOD* lod,
+                const SGCondition* condition,
+                const SGExpressiond* minValue,
+                const SGExpressiond* maxValue,
+                double minStaticValue, double maxStaticValue);
+  void addBlend(osg::Node* node, const SGExpressiond* value);
+
+  bool empty() const
+  { return _entries.empty(); }
+  unsigned getNumAnimations() const
+  { return _entries.size(); }
+
+  /// Number of update traversals where the evaluation was skipped since
+  /// no input property changed.
+  unsigned getNumSkippedUpdates() const
+  { return _skippedUpdates; }
+
+  /// Evaluate the animations, returns false if nothing had to be done.
+  bool update();
+
+  virtual void operator()(osg::Node* node, osg::NodeVisitor* nv);
+
+protected:
+  virtual ~SGAnimationBatch();
+
+private:
+  enum Kind {
+    TRANSLATE,
+    SCALE,
+    RANGE,
+    BLEND
+  };
+
+  struct Entry {
+    Kind kind;
+    bool alwaysDirty;
+    // Not referenced: the animated nodes live below (or are) the node
+    // the batch is installed on, referencing them would create a cycle.
+    osg::Node* node;
+    SGSharedPtr<const SGCondition> condition;
+    SGSharedPtr<const SGExpressiond> value[3];
+    double staticValue[2];
+    double lastValue;
+  };
+
+  Entry& addEntry(Kind kind, osg::Node* node, const SGCondition* condition);
+  void collectInputs(Entry& entry);
+  template<typename T>
+  static bool collectInputs(const T* input,
+                            std::set<const SGPropertyNode*>& props);
+  bool inputsChanged();
+  void evaluate(Entry& entry, bool all);
+
+  std::vector<Entry> _entries;
+  std::vector<SGConstPropertyNode_ptr> _inputs;
+  std::vector<double> _inputValues;
+  std::set<const SGPropertyNode*> _inputSet;
+  bool _hasAlwaysDirty;
+  bool _initialized;
+  unsigned _skippedUpdates;
+};
+
+#endif
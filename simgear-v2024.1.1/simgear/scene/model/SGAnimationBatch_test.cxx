@@ -0,0 +1,61 @@
+// Unit tests for SGAnimationBatch
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <simgear_config.h>
+
+#include <cstdlib>
+
+#include <osg/ref_ptr>
+
+#include <simgear/misc/test_macros.hxx>
+#include <simgear/props/props.hxx>
+#include <simgear/structure/SGExpression.hxx>
+
+#include "SGAnimationBatch.hxx"
+#include "SGTranslateTransform.hxx"
+
+using namespace simgear;
+
+namespace {
+
+void testNestedInput()
+{
+    SGPropertyNode_ptr root = new SGPropertyNode;
+    SGPropertyNode* offset = root->getNode("offset", true);
+    SGPropertyNode* steps = root->getNode("steps", true);
+    offset->setDoubleValue(1);
+    steps->setIntValue(2);
+
+    // offset + convert(steps), the second input is below a conversion
+    SGSharedPtr<SGExpressiond> value = new SGSumExpression<double>(
+        new SGPropertyExpression<double>(offset),
+        new ConvertExpression<double, int>(new SGPropertyExpression<int>(steps)));
+
+    osg::ref_ptr<SGTranslateTransform> transform = new SGTranslateTransform;
+    osg::ref_ptr<SGAnimationBatch> batch = new SGAnimationBatch;
+    batch->addTranslate(transform.get(), nullptr, value);
+
+    SG_VERIFY(batch->update());
+    SG_CHECK_EQUAL(transform->getValue(), 3);
+
+    // nothing changed
+    SG_VERIFY(!batch->update());
+    SG_CHECK_EQUAL(batch->getNumSkippedUpdates(), 1u);
+
+    steps->setIntValue(5);
+    SG_VERIFY(batch->update());
+    SG_CHECK_EQUAL(transform->getValue(), 6);
+
+    offset->setDoubleValue(2);
+    SG_VERIFY(batch->update());
+    SG_CHECK_EQUAL(transform->getValue(), 7);
+    SG_CHECK_EQUAL(batch->getNumSkippedUpdates(), 1u);
+}
+
+} // of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    testNestedInput();
+    return EXIT_SUCCESS;
+}
@@ -47,6 +47,7 @@
 #include "SGReaderWriterXML.hxx"
 
 #include "animation.hxx"
+#include "SGAnimationBatch.hxx"
 #include "particles.hxx"
 #include "model.hxx"
 #include "SGLight.hxx"
@@ -860,6 +861,8 @@ sgLoad3DModel_internal(const SGPath& path,
     }
 
     simgear::SGTransientModelData modelData(group.get(), prop_root, options.get(), path.utf8Str());
+    ref_ptr<SGAnimationBatch> animationBatch = new SGAnimationBatch;
+    modelData.setAnimationBatch(animationBatch.get());
 
     for (unsigned i = 0; i < animation_nodes.size(); ++i) {
         if (previewMode && animation_nodes[i]->hasChild("nopreview")) {
@@ -903,10 +906,14 @@ sgLoad3DModel_internal(const SGPath& path,
     if (!needTransform && group->getNumChildren() < 2) {
         model = group->getChild(0);
         group->removeChild(model.get());
+        if (!animationBatch->empty())
+            model->addUpdateCallback(animationBatch.get());
         if (data.valid())
             data->modelLoaded(modelpath.utf8Str(), props, model.get());
         return std::make_tuple(animationcount, model.release());
     }
+    if (!animationBatch->empty())
+        group->addUpdateCallback(animationBatch.get());
     if (data.valid())
         data->modelLoaded(modelpath.utf8Str(), props, group.get());
     if (props->hasChild("debug-outfile")) {
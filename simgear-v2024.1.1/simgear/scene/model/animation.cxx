@@ -60,6 +60,7 @@
 #include "animation.hxx"
 #include "model.hxx"
 
+#include "SGAnimationBatch.hxx"
 #include "SGTranslateTransform.hxx"
 #include "SGMaterialAnimation.hxx"
 #include "SGPBRAnimation.hxx"
@@ -1064,8 +1065,12 @@ SGTranslateAnimation::createAnimationGroup(osg::Group& parent)
   SGTranslateTransform* transform = new SGTranslateTransform;
   transform->setName("translate animation");
   if (_animationValue && !_animationValue->isConst()) {
-    UpdateCallback* uc = new UpdateCallback(_condition, _animationValue);
-    transform->setUpdateCallback(uc);
+    if (SGAnimationBatch* batch = _modelData.getAnimationBatch()) {
+      batch->addTranslate(transform, _condition, _animationValue);
+    } else {
+      UpdateCallback* uc = new UpdateCallback(_condition, _animationValue);
+      transform->setUpdateCallback(uc);
+    }
     transform->_animationValue = _animationValue;
   }
   transform->setAxis(_axis);
@@ -1437,8 +1442,12 @@ SGScaleAnimation::createAnimationGroup(osg::Group& parent)
   transform->setName("scale animation");
   transform->setCenter(_center);
   transform->setScaleFactor(_initialValue);
-  UpdateCallback* uc = new UpdateCallback(_condition, _animationValue);
-  transform->setUpdateCallback(uc);
+  if (SGAnimationBatch* batch = _modelData.getAnimationBatch()) {
+    batch->addScale(transform, _condition, _animationValue);
+  } else {
+    UpdateCallback* uc = new UpdateCallback(_condition, _animationValue);
+    transform->setUpdateCallback(uc);
+  }
   parent.addChild(transform);
   return transform;
 }
@@ -1924,10 +1933,15 @@ SGRangeAnimation::createAnimationGroup(osg::Group& parent)
   lod->setCenterMode(osg::LOD::USE_BOUNDING_SPHERE_CENTER);
   lod->setRangeMode(osg::LOD::DISTANCE_FROM_EYE_POINT);
   if (_minAnimationValue || _maxAnimationValue || _condition) {
-    UpdateCallback* uc;
-    uc = new UpdateCallback(_condition, _minAnimationValue, _maxAnimationValue,
-                            _initialValue[0], _initialValue[1]);
-    lod->setUpdateCallback(uc);
+    if (SGAnimationBatch* batch = _modelData.getAnimationBatch()) {
+      batch->addRange(lod, _condition, _minAnimationValue, _maxAnimationValue,
+                      _initialValue[0], _initialValue[1]);
+    } else {
+      UpdateCallback* uc;
+      uc = new UpdateCallback(_condition, _minAnimationValue, _maxAnimationValue,
+                              _initialValue[0], _initialValue[1]);
+      lod->setUpdateCallback(uc);
+    }
   }
   return group;
 }
@@ -2107,8 +2121,7 @@ public:
     double blend = _animationValue->getValue();
     if (blend != _prev_value) {
       _prev_value = blend;
-      BlendVisitor visitor(1-blend);
-      node->accept(visitor);
+      setBlend(*node, 1-blend);
     }
     traverse(node, nv);
   }
@@ -2134,11 +2147,21 @@ SGBlendAnimation::createAnimationGroup(osg::Group& parent)
 
   osg::Group* group = new osg::Switch;
   group->setName("blend animation node");
-  group->setUpdateCallback(new UpdateCallback(getConfig(), _animationValue));
+  if (SGAnimationBatch* batch = _modelData.getAnimationBatch())
+    batch->addBlend(group, _animationValue);
+  else
+    group->setUpdateCallback(new UpdateCallback(getConfig(), _animationValue));
   parent.addChild(group);
   return group;
 }
 
+void
+SGBlendAnimation::setBlend(osg::Node& node, double blend)
+{
+  BlendVisitor visitor(blend);
+  node.accept(visitor);
+}
+
 void
 SGBlendAnimation::install(osg::Node& node)
 {
@@ -282,6 +282,11 @@ public:
   SGBlendAnimation(simgear::SGTransientModelData &modelData);
   virtual osg::Group* createAnimationGroup(osg::Group& parent);
   virtual void install(osg::Node& node);
+
+  /**
+   * Set the alpha of all materials and vertex colors below @a node.
+   */
+  static void setBlend(osg::Node& node, double blend);
 private:
   class BlendVisitor;
   class UpdateCallback;
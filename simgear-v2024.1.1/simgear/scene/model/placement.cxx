@@ -9,11 +9,43 @@
 
 #include "placement.hxx"
 
+#include <osg/NodeCallback>
+
 #include <simgear/compiler.h>
 #include <simgear/scene/util/OsgMath.hxx>
 #include <simgear/scene/util/SGSceneUserData.hxx>
 
 
+////////////////////////////////////////////////////////////////////////
+// Update throttling.
+////////////////////////////////////////////////////////////////////////
+
+class SGModelPlacement::UpdateThrottleCallback : public osg::NodeCallback {
+public:
+  UpdateThrottleCallback() :
+    _interval(1),
+    _skipped(0)
+  {
+    // spread the models over the frames instead of updating all of
+    // them in the same frame
+    static unsigned phase = 0;
+    _counter = phase++;
+    setName("SGModelPlacement::UpdateThrottleCallback");
+  }
+  virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+  {
+    if (_interval > 1 && (++_counter % _interval) != 0) {
+      ++_skipped;
+      return;
+    }
+    traverse(node, nv);
+  }
+
+  unsigned _interval;
+  unsigned _counter;
+  unsigned _skipped;
+};
+
 ////////////////////////////////////////////////////////////////////////
 // Implementation of SGModelPlacement.
 ////////////////////////////////////////////////////////////////////////
@@ -54,6 +86,7 @@ SGModelPlacement::add( osg::Node* model )
 
 void SGModelPlacement::clear()
 {
+    _updateThrottle = NULL;
     _selector = NULL;
     _transform = NULL;
 }
@@ -154,4 +187,30 @@ SGModelPlacement::setBodyAngularVelocity(const SGVec3d& angular)
   vel->angular = SGVec3d(-angular[0], angular[1], -angular[2]);
 }
 
+void
+SGModelPlacement::setUpdateInterval(unsigned frames)
+{
+  if (frames < 1)
+    frames = 1;
+  if (!_updateThrottle) {
+    if (frames == 1 || !_transform)
+      return;
+    _updateThrottle = new UpdateThrottleCallback;
+    _transform->addUpdateCallback(_updateThrottle.get());
+  }
+  _updateThrottle->_interval = frames;
+}
+
+unsigned
+SGModelPlacement::getUpdateInterval() const
+{
+  return _updateThrottle ? _updateThrottle->_interval : 1;
+}
+
+unsigned
+SGModelPlacement::getSkippedUpdates() const
+{
+  return _updateThrottle ? _updateThrottle->_skipped : 0;
+}
+
 // end of model.cxx
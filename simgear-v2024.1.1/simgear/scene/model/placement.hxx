@@ -69,8 +69,24 @@ public:
   void setReferenceTime(const double& referenceTime);
   void setBodyLinearVelocity(const SGVec3d& velocity);
   void setBodyAngularVelocity(const SGVec3d& velocity);
-  
+
+  /**
+   * Only run the update traversal (animations, ...) of the model every
+   * @a frames frames. 1, the default, updates the model on every frame.
+   * Used to throttle the animations of distant models.
+   */
+  void setUpdateInterval(unsigned frames);
+  unsigned getUpdateInterval() const;
+
+  /**
+   * Number of update traversals of the model skipped because of the
+   * update interval.
+   */
+  unsigned getSkippedUpdates() const;
+
 private:
+  class UpdateThrottleCallback;
+
                                 // Geodetic position
   SGGeod _position;
 
@@ -81,6 +97,7 @@ private:
 
   osg::ref_ptr<osg::Switch> _selector;
   osg::ref_ptr<osg::PositionAttitudeTransform> _transform;
+  osg::ref_ptr<UpdateThrottleCallback> _updateThrottle;
 };
 
 #endif // _SG_PLACEMENT_HXX
@@ -0,0 +1,134 @@
+// Unit tests for the SGModelPlacement update throttle
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <simgear_config.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include <osg/FrameStamp>
+#include <osg/Group>
+#include <osg/NodeCallback>
+#include <osg/ref_ptr>
+#include <osgUtil/UpdateVisitor>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "placement.hxx"
+
+namespace {
+
+const double FRAME_DT = 0.1;
+
+/// Records the frames in which the model below the placement is updated
+class RecordingCallback : public osg::NodeCallback
+{
+public:
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override
+    {
+        frames.push_back(nv->getFrameStamp()->getFrameNumber());
+        times.push_back(nv->getFrameStamp()->getSimulationTime());
+        traverse(node, nv);
+    }
+
+    std::vector<unsigned> frames;
+    std::vector<double> times;
+};
+
+struct Model {
+    Model()
+    {
+        osg::ref_ptr<osg::Group> node = new osg::Group;
+        recorder = new RecordingCallback;
+        node->setUpdateCallback(recorder.get());
+        placement.init(node.get());
+    }
+
+    SGModelPlacement placement;
+    osg::ref_ptr<RecordingCallback> recorder;
+};
+
+/// Runs the update traversal over the models for frames [first, last)
+void runFrames(std::vector<Model*> models, unsigned first, unsigned last)
+{
+    osg::ref_ptr<osg::Group> root = new osg::Group;
+    for (auto m : models) {
+        root->addChild(m->placement.getSceneGraph());
+    }
+
+    osg::ref_ptr<osgUtil::UpdateVisitor> visitor = new osgUtil::UpdateVisitor;
+    for (unsigned frame = first; frame < last; ++frame) {
+        osg::ref_ptr<osg::FrameStamp> stamp = new osg::FrameStamp;
+        stamp->setFrameNumber(frame);
+        stamp->setSimulationTime(frame * FRAME_DT);
+        visitor->setFrameStamp(stamp.get());
+        visitor->setTraversalNumber(frame);
+        root->accept(*visitor);
+    }
+}
+
+void testUnthrottled()
+{
+    Model model;
+    model.placement.setUpdateInterval(1);
+    runFrames({&model}, 0, 10);
+
+    SG_CHECK_EQUAL(model.placement.getUpdateInterval(), 1);
+    SG_CHECK_EQUAL(model.placement.getSkippedUpdates(), 0);
+    SG_CHECK_EQUAL(model.recorder->frames.size(), 10);
+}
+
+void testSkip()
+{
+    Model a, b;
+    a.placement.setUpdateInterval(4);
+    b.placement.setUpdateInterval(4);
+    SG_CHECK_EQUAL(a.placement.getUpdateInterval(), 4);
+    runFrames({&a, &b}, 0, 40);
+
+    // every fourth frame, the others are counted as skipped
+    for (auto m : {&a, &b}) {
+        SG_CHECK_EQUAL(m->recorder->frames.size(), 10);
+        SG_CHECK_EQUAL(m->placement.getSkippedUpdates(), 30);
+        for (size_t i = 1; i < m->recorder->frames.size(); ++i) {
+            SG_CHECK_EQUAL(m->recorder->frames[i] - m->recorder->frames[i - 1], 4);
+        }
+    }
+
+    // staggered, not both in the same frame
+    SG_VERIFY((a.recorder->frames.front() % 4) != (b.recorder->frames.front() % 4));
+}
+
+void testCatchUp()
+{
+    Model model;
+    model.placement.setUpdateInterval(5);
+    runFrames({&model}, 0, 20);
+
+    // the skipped frames are not replayed: each update sees the time of
+    // its own frame, so animations jump to the current state
+    const auto& rec = *model.recorder;
+    SG_CHECK_EQUAL(rec.frames.size(), 4);
+    for (size_t i = 0; i < rec.frames.size(); ++i) {
+        SG_CHECK_EQUAL_EP(rec.times[i], rec.frames[i] * FRAME_DT);
+    }
+
+    // back to full rate, updated on every frame again
+    model.placement.setUpdateInterval(1);
+    runFrames({&model}, 20, 30);
+    SG_CHECK_EQUAL(rec.frames.size(), 14);
+    for (unsigned frame = 20; frame < 30; ++frame) {
+        SG_CHECK_EQUAL(rec.frames[frame - 16], frame);
+    }
+    SG_CHECK_EQUAL(model.placement.getSkippedUpdates(), 16);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    testUnthrottled();
+    testSkip();
+    testCatchUp();
+    return EXIT_SUCCESS;
+}
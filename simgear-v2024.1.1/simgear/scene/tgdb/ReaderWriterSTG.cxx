@@ -62,6 +62,7 @@
 #include <simgear/scene/util/SGReaderWriterOptions.hxx>
 
 #include <simgear/scene/util/SGSceneFeatures.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 
 #include "SGOceanTile.hxx"
 
@@ -988,6 +989,7 @@ const char* ReaderWriterSTG::className() const
 osgDB::ReaderWriter::ReadResult
 ReaderWriterSTG::readNode(const std::string& fileName, const osgDB::Options* options) const
 {
+    simgear::TraceScope trace("tile", fileName);
     _ModelBin modelBin;
     SGBucket bucket(bucketIndexFromFileName(fileName));
     simgear::ErrorReportContext ec("terrain-bucket", bucket.gen_index_str());
@@ -105,14 +105,14 @@ SGLoadBTG(const std::string& path, const simgear::SGReaderWriterOptions* options
 
       nodes[i] = hlOr.transform(nodes[i]);
     }
-    tile.set_wgs84_nodes(nodes);
-    tile.set_overlaycoords(satellite_overlay_coords);
+    tile.set_wgs84_nodes(std::move(nodes));
+    tile.set_overlaycoords(std::move(satellite_overlay_coords));
 
     SGQuatf hlOrf(hlOr[0], hlOr[1], hlOr[2], hlOr[3]);
     std::vector<SGVec3f> normals = tile.get_normals();
     for (unsigned i = 0; i < normals.size(); ++i)
       normals[i] = hlOrf.transform(normals[i]);
-    tile.set_normals(normals);
+    tile.set_normals(std::move(normals));
 
     // tile surface    
     osg::ref_ptr<SGTileGeometryBin> tileGeometryBin = new SGTileGeometryBin();
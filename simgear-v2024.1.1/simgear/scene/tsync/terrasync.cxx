@@ -240,7 +240,8 @@ struct TerrasyncThreadState
                              _transfer_rate(0),
                              _total_kb_downloaded(0),
                              _totalKbPending(0),
-                             _extractTotalKbPending(0)
+                             _extractTotalKbPending(0),
+                             _verify_failed_files(0)
     {}
 
     bool _busy;
@@ -256,6 +257,7 @@ struct TerrasyncThreadState
     int _total_kb_downloaded;
     unsigned int _totalKbPending;
     unsigned int _extractTotalKbPending;
+    int _verify_failed_files;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -348,6 +350,9 @@ public:
 
     void setInstalledDir(const SGPath& p)  { _installRoot = p; }
 
+    /// check the requested directories on disk instead of syncing them
+    void setVerifyOnly(bool verifyOnly)    { _verifyOnly = verifyOnly; }
+
    void   setCacheHits(unsigned int hits)
     {
         std::lock_guard<std::mutex> g(_stateLock);
@@ -386,6 +391,7 @@ public:
     bool beginSyncAirports(SyncSlot& slot);
     bool beginSyncTile(SyncSlot& slot);
     bool beginNormalSync(SyncSlot& slot);
+    void verifySyncSlot(SyncSlot& slot);
 
     void drainWaitingTiles();
 
@@ -416,6 +422,7 @@ public:
     string _osmCityService = "o2c";
 
     bool _isAutomaticServer;
+    bool _verifyOnly = false;
     SGPath _installRoot;
     string _sceneryVersion;
     string _protocol;
@@ -697,6 +704,13 @@ void SGTerraSync::WorkerThread::updateSyncSlot(SyncSlot &slot)
             return;
         }
 
+        if (_verifyOnly) {
+            verifySyncSlot(slot);
+            slot.repository.reset();
+            slot.currentItem = {};
+            return;
+        }
+
         try {
             slot.repository->update();
         } catch (sg_exception& e) {
@@ -764,7 +778,7 @@ bool SGTerraSync::WorkerThread::beginSyncTile(SyncSlot& slot)
     slot.repository.reset(new HTTPRepository(path, &_http));
 
     if (slot.currentItem._type == SyncItem::OSMTile) {
-        if (_osmCityServer.empty()) {
+        if (_osmCityServer.empty() && !_verifyOnly) {
             SG_LOG(SG_TERRASYNC, SG_WARN, "No OSM2City server defined for:" << slot.currentItem._dir);
             return false;
         }
@@ -824,10 +838,53 @@ bool SGTerraSync::WorkerThread::beginNormalSync(SyncSlot& slot)
     return true;
 }
 
+/**
+ * Check the local copy of the slot's directory against its indices on disk,
+ * without any network access, and report the damaged and missing files.
+ * The tile caches are left alone, so a later sync still updates it.
+ */
+void SGTerraSync::WorkerThread::verifySyncSlot(SyncSlot& slot)
+{
+    SyncItem item = slot.currentItem;
+    HTTPRepository::ResultCode res = HTTPRepository::REPO_ERROR_NOT_FOUND;
+    int failedFiles = 1;
+
+    if (slot.isNewDirectory) {
+        SG_LOG(SG_TERRASYNC, SG_WARN, "Verify: '" << item._dir << "' is missing");
+    } else {
+        slot.stamp.stamp();
+        res = slot.repository->verifyLocalCopy();
+        const auto failures = slot.repository->failures();
+        for (const auto& f : failures) {
+            SG_LOG(SG_TERRASYNC, SG_WARN, "Verify: " << f.path << ": "
+                   << HTTPRepository::resultCodeAsString(f.error));
+        }
+        failedFiles = static_cast<int>(failures.size());
+        SG_LOG(SG_TERRASYNC, SG_INFO, "Verify of '" << item._dir << "' finished ("
+               << slot.stamp.elapsedMSec() << " msec): "
+               << HTTPRepository::resultCodeAsString(res));
+    }
+
+    std::lock_guard<std::mutex> g(_stateLock);
+    if (res == HTTPRepository::REPO_NO_ERROR) {
+        _state._success_count++;
+        item._status = SyncItem::Updated;
+    } else {
+        _state._fail_count++;
+        _state._verify_failed_files += failedFiles;
+        item._status = SyncItem::Failed;
+    }
+    _freshTiles.push_back(item);
+}
+
 void SGTerraSync::WorkerThread::runInternal()
 {
     while (!_stop) {
-        // try to find a terrasync server
+        // try to find a terrasync server, verifying needs none
+        if (_verifyOnly && !hasServer()) {
+            hasServer(true);
+        }
+
         if( !hasServer() ) {
             const auto haveServer = findServer();
             if (haveServer) {
@@ -982,7 +1039,8 @@ void SGTerraSync::WorkerThread::drainWaitingTiles()
     // drain the waiting tiles queue into the sync slot queues.
     while (!waitingTiles.empty()) {
         SyncItem next = waitingTiles.pop_front();
-        SyncItem::Status cacheStatus = isPathCached(next);
+        // verify everything requested, even when recently synced
+        SyncItem::Status cacheStatus = _verifyOnly ? SyncItem::Invalid : isPathCached(next);
         SG_LOG(SG_TERRASYNC, SG_INFO, "next._type=" << next._type
                 << " next._dir=" << next._dir
                 << " cacheStatus=" << cacheStatus
@@ -1209,6 +1267,14 @@ void SGTerraSync::reinit()
 
         _workerThread->setCacheHits(_terraRoot->getIntValue("cache-hit", 0));
 
+        const bool verifyOnly = _terraRoot->getBoolValue("verify-only", false);
+        if (verifyOnly) {
+            SG_LOG(SG_TERRASYNC, SG_MANDATORY_INFO,
+                   "TerraSync verify-only: checking the files in '" << sceneryRoot
+                   << "' without downloading");
+        }
+        _workerThread->setVerifyOnly(verifyOnly);
+
         if (_workerThread->start())
         {
             syncAirportsModels();
@@ -1251,6 +1317,7 @@ void SGTerraSync::bind()
     _enabledNode = _terraRoot->getNode("enabled", true);
     _availableNode = _terraRoot->getNode("available", true);
     _maxErrorsNode = _terraRoot->getNode("max-errors", true);
+    _verifyFailedFilesNode = _terraRoot->getNode("verify-failed-files", true);
 }
 
 void SGTerraSync::unbind()
@@ -1276,6 +1343,7 @@ void SGTerraSync::unbind()
     _enabledNode.clear();
     _availableNode.clear();
     _maxErrorsNode.clear();
+    _verifyFailedFilesNode.clear();
 }
 
 void SGTerraSync::update(double)
@@ -1310,6 +1378,7 @@ void SGTerraSync::update(double)
     _pendingKbytesNode->setIntValue(copiedState._totalKbPending);
     _downloadedKBtesNode->setIntValue(copiedState._total_kb_downloaded);
     _extractPendingKbytesNode->setIntValue(copiedState._extractTotalKbPending);
+    _verifyFailedFilesNode->setIntValue(copiedState._verify_failed_files);
 
     _stalledNode->setBoolValue(_workerThread->isStalled());
     _activeNode->setBoolValue(worker_running);
@@ -115,6 +115,7 @@ private:
     SGPropertyNode_ptr _downloadedKBtesNode;
     SGPropertyNode_ptr _extractPendingKbytesNode;
     SGPropertyNode_ptr _maxErrorsNode;
+    SGPropertyNode_ptr _verifyFailedFilesNode;
 
     string_list _sceneryPathSuffixes;
 
@@ -19,6 +19,8 @@
 #define SGTRANSIENTMODELDATA_HXX 1
 #include <simgear/math/SGGeometry.hxx>
 
+class SGAnimationBatch;
+
 namespace simgear
 {
     typedef std::map<std::string, SGLineSegment<double>> SGAxisDefinitionMap;
@@ -62,6 +64,13 @@ namespace simgear
         const std::string &getPath() { return path; }
         int getIndex() { return index; }
 
+        /*
+         * The batch collecting the update callbacks of the simple animations of this model.
+         * May be null, in which case every animation installs its own update callback.
+         */
+        SGAnimationBatch* getAnimationBatch() { return animationBatch; }
+        void setAnimationBatch(SGAnimationBatch* batch) { animationBatch = batch; }
+
         /*
          * Find an already located axis definition object line segment. Returns null if nothing found.
          */
@@ -91,6 +100,7 @@ namespace simgear
         const osgDB::Options* options = nullptr;
         const std::string path;
         int index = 0;
+        SGAnimationBatch* animationBatch = nullptr;
         SGAxisDefinitionMap axisDefinitions;
 
     };
@@ -1143,6 +1143,12 @@ namespace simgear
       return SGExpression<T>::simplify();
     }
 
+    virtual void collectDependentProperties(std::set<const SGPropertyNode*>& props) const
+    {
+      for (size_t i = 0; i < _expressions.size(); ++i)
+        _expressions[i]->collectDependentProperties(props);
+    }
+
     simgear::expression::Type getOperandType() const
     {
       return simgear::expression::TypeTraits<OpType>::typeTag;
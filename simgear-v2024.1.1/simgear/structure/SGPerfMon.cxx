@@ -25,6 +25,7 @@
 
 #include "SGPerfMon.hxx"
 #include <simgear/structure/SGSmplstat.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 
 #include <stdio.h>
 #include <string.h>
@@ -55,6 +56,7 @@ SGPerformanceMonitor::bind(void)
     _timingDetailsFlag->setBoolValue(false);
     _statisticsInterval  = _root->getChild("interval-s",    0, true);
     _maxTimePerFrame_ms = _root->getChild("max-time-per-frame-ms", 0, true);
+    _traceFlag          = _root->getChild("trace",         0, true);
 }
 
 void
@@ -64,6 +66,7 @@ SGPerformanceMonitor::unbind(void)
     _statisticsFlag = 0;
     _statisticsInterval = 0;
     _maxTimePerFrame_ms = 0;
+    _traceFlag = 0;
 }
 
 void
@@ -87,6 +90,9 @@ SGPerformanceMonitor::update(double dt)
         else
             _subSysMgr->setReportTimingCb(this,0);
     }
+    if (_traceFlag->getBoolValue() != simgear::TraceRecorder::isEnabled()) {
+        simgear::TraceRecorder::setEnabled(_traceFlag->getBoolValue());
+    }
     if (_timingDetailsFlag->getBoolValue()) {
         _subSysMgr->setReportTimingStats(true);
         _timingDetailsFlag->setBoolValue(false);
@@ -59,6 +59,7 @@ private:
     SGPropertyNode_ptr _statisticsFlag;
     SGPropertyNode_ptr _statisticsInterval;
     SGPropertyNode_ptr _maxTimePerFrame_ms;
+    SGPropertyNode_ptr _traceFlag;
 
     bool _isEnabled;
     int _count;
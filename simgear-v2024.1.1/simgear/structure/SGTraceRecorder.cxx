@@ -0,0 +1,250 @@
+// SPDX-FileName: SGTraceRecorder.cxx
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// SPDX-FileComment: Timeline of scoped spans on all threads, in Chrome trace format
+
+#include <simgear_config.h>
+
+#include "SGTraceRecorder.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_set>
+#include <vector>
+
+#include <simgear/io/iostreams/sgstream.hxx>
+#include <simgear/misc/sg_path.hxx>
+
+namespace simgear
+{
+
+namespace {
+
+/**
+ * A slot of a ring buffer. The owning thread writes it while the dump
+ * may read it: seq is odd while the slot is being written, and tells
+ * which span it holds, so the reader can detect a slot overwritten
+ * while it was copied.
+ */
+struct Span {
+    std::atomic<uint64_t> seq{0};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+};
+
+struct ThreadBuffer {
+    ThreadBuffer(int aId, size_t size) : id(aId), mask(size - 1), spans(new Span[size]) {}
+
+    const int id;
+    const uint64_t mask;
+    std::unique_ptr<Span[]> spans;
+    std::atomic<uint64_t> head{0};  ///< number of spans ever recorded
+
+    std::string name; ///< guarded by the registry mutex
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    size_t spansPerThread = 1 << 16;
+    std::unordered_set<std::string> names;
+};
+
+// never destroyed, threads may record during static destruction
+Registry& registry()
+{
+    static Registry* r = new Registry;
+    return *r;
+}
+
+std::atomic<uint64_t> clearedAt{0};
+
+// buffers are owned by the registry, so spans outlive their thread
+thread_local ThreadBuffer* threadBuffer = nullptr;
+
+ThreadBuffer& getThreadBuffer()
+{
+    if (!threadBuffer) {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        auto buffer = std::make_shared<ThreadBuffer>(static_cast<int>(r.buffers.size()) + 1, r.spansPerThread);
+        r.buffers.push_back(buffer);
+        threadBuffer = buffer.get();
+    }
+    return *threadBuffer;
+}
+
+void writeJSONString(std::ostream& os, const char* s)
+{
+    os << '"';
+    for (; s && *s; ++s) {
+        if ((*s == '"') || (*s == '\\')) {
+            os << '\\' << *s;
+        } else if (static_cast<unsigned char>(*s) < 0x20) {
+            os << ' ';
+        } else {
+            os << *s;
+        }
+    }
+    os << '"';
+}
+
+} // of anonymous namespace
+
+std::atomic<bool> TraceRecorder::s_enabled{false};
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+void TraceRecorder::setSpansPerThread(size_t spans)
+{
+    size_t size = 1;
+    while (size < spans) {
+        size <<= 1;
+    }
+
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.spansPerThread = size;
+}
+
+void TraceRecorder::setThreadName(const std::string& name)
+{
+    auto& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer.name = name;
+}
+
+const char* TraceRecorder::intern(const std::string& name)
+{
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.names.insert(name).first->c_str();
+}
+
+uint64_t TraceRecorder::now()
+{
+    // never 0, which TraceScope uses for not recording
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() | 1;
+}
+
+void TraceRecorder::addSpan(const char* category, const char* name, uint64_t startNSec, uint64_t endNSec)
+{
+    auto& buffer = getThreadBuffer();
+    const uint64_t i = buffer.head.load(std::memory_order_relaxed);
+    Span& span = buffer.spans[i & buffer.mask];
+
+    span.seq.store(2 * i + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    span.category.store(category, std::memory_order_relaxed);
+    span.name.store(name, std::memory_order_relaxed);
+    span.start.store(startNSec, std::memory_order_relaxed);
+    span.end.store(endNSec, std::memory_order_relaxed);
+    span.seq.store(2 * i + 2, std::memory_order_release);
+
+    buffer.head.store(i + 1, std::memory_order_release);
+}
+
+void TraceRecorder::clear()
+{
+    clearedAt = now();
+}
+
+void TraceRecorder::writeChromeTrace(std::ostream& os)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::string> names;
+    {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffers = r.buffers;
+        for (const auto& b : buffers) {
+            names.push_back(b->name);
+        }
+    }
+
+    const uint64_t from = clearedAt.load();
+    uint64_t origin = UINT64_MAX;
+
+    struct Copy {
+        int thread;
+        const char* category;
+        const char* name;
+        uint64_t start, end;
+    };
+    std::vector<Copy> copies;
+
+    for (const auto& b : buffers) {
+        const uint64_t head = b->head.load(std::memory_order_acquire);
+        const uint64_t first = (head > b->mask + 1) ? head - (b->mask + 1) : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            const Span& span = b->spans[i & b->mask];
+            const uint64_t seq = span.seq.load(std::memory_order_acquire);
+            Copy c{b->id,
+                   span.category.load(std::memory_order_relaxed),
+                   span.name.load(std::memory_order_relaxed),
+                   span.start.load(std::memory_order_relaxed),
+                   span.end.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((seq != 2 * i + 2) || (span.seq.load(std::memory_order_relaxed) != seq)) {
+                continue; // overwritten by the thread meanwhile
+            }
+
+            if (c.start < from) {
+                continue;
+            }
+
+            origin = std::min(origin, c.start);
+            copies.push_back(c);
+        }
+    }
+
+    // complete ("X") events, times in microseconds
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        if (names[i].empty()) {
+            continue;
+        }
+        os << (first ? "\n" : ",\n")
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffers[i]->id
+           << ",\"args\":{\"name\":";
+        writeJSONString(os, names[i].c_str());
+        os << "}}";
+        first = false;
+    }
+
+    os << std::fixed << std::setprecision(3);
+    for (const auto& c : copies) {
+        os << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJSONString(os, c.name);
+        os << ",\"cat\":";
+        writeJSONString(os, c.category);
+        os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << c.thread
+           << ",\"ts\":" << (c.start - origin) / 1000.0
+           << ",\"dur\":" << (c.end - c.start) / 1000.0 << "}";
+        first = false;
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool TraceRecorder::writeChromeTrace(const SGPath& path)
+{
+    sg_ofstream os(path, std::ios::out | std::ios::trunc);
+    if (!os.is_open()) {
+        return false;
+    }
+    writeChromeTrace(os);
+    return os.good();
+}
+
+} // namespace simgear
@@ -0,0 +1,104 @@
+// SPDX-FileName: SGTraceRecorder.hxx
+// SPDX-License-Identifier: LGPL-2.1-or-later
+// SPDX-FileComment: Timeline of scoped spans on all threads, in Chrome trace format
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// forward decls
+class SGPath;
+
+namespace simgear
+{
+
+/**
+ * Records a timeline of named spans - a subsystem update, a timer, a
+ * tile load - on every thread, and writes it in the Chrome trace format
+ * for chrome://tracing or Perfetto, so stalls can be correlated across
+ * threads.
+ *
+ * Each thread records into its own ring buffer, keeping its most recent
+ * spans, without locking. While recording is disabled, a TraceScope
+ * costs an atomic load.
+ */
+class TraceRecorder
+{
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * Number of spans kept per thread, for the buffers of threads which
+     * didn't record yet. Rounded up to a power of two.
+     */
+    static void setSpansPerThread(size_t spans);
+
+    /// name the calling thread in the trace
+    static void setThreadName(const std::string& name);
+
+    /// a copy of name which lives as long as the program, for span names built at runtime
+    static const char* intern(const std::string& name);
+
+    /// the clock spans are recorded with, in nanoseconds
+    static uint64_t now();
+
+    /**
+     * Record a span on the calling thread. The strings are not copied:
+     * use literals or intern().
+     */
+    static void addSpan(const char* category, const char* name, uint64_t startNSec, uint64_t endNSec);
+
+    /// forget the spans recorded so far
+    static void clear();
+
+    static void writeChromeTrace(std::ostream& os);
+    static bool writeChromeTrace(const SGPath& path);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * Records the span of its lifetime, if the recorder was enabled when it
+ * was created.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char* category, const char* name)
+        : _category(category), _name(name),
+          _start(TraceRecorder::isEnabled() ? TraceRecorder::now() : 0)
+    {
+    }
+
+    /// the name is interned, only if recording
+    TraceScope(const char* category, const std::string& name)
+        : _category(category), _name(nullptr),
+          _start(TraceRecorder::isEnabled() ? TraceRecorder::now() : 0)
+    {
+        if (_start) {
+            _name = TraceRecorder::intern(name);
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (_start) {
+            TraceRecorder::addSpan(_category, _name, _start, TraceRecorder::now());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* _category;
+    const char* _name;
+    const uint64_t _start;
+};
+
+} // namespace simgear
@@ -5,22 +5,24 @@
 #include "event_mgr.hxx"
 
 #include <algorithm>
+#include <cmath>
 
 #include <simgear/debug/logstream.hxx>
+#include <simgear/structure/SGTraceRecorder.hxx>
 
 void SGTimer::run()
 {
     callback();
 }
 
-void SGEventMgr::add(const std::string& name, simgear::Callback cb,
-                     double interval, double delay,
-                     bool repeat, bool simtime)
+SGTimerHandle SGEventMgr::add(const std::string& name, simgear::Callback cb,
+                              double interval, double delay,
+                              bool repeat, bool simtime)
 {
     // Prevent Nasal from attempting to add timers after the subsystem has been
     // shut down.
     if (_shutdown)
-        return;
+        return {};
 
     // Clamp the delay value to 1 usec, so that user code can use
     // "zero" as a synonym for "next frame".
@@ -36,13 +38,17 @@ void SGEventMgr::add(const std::string& name, simgear::Callback cb,
     
     SGTimerQueue& q = simtime ? _simQueue : _rtQueue;
 
-    q.insert(std::move(t), delay);
+    SGTimerHandle handle = q.insert(std::move(t), delay);
+    handle._simtime = simtime;
+    return handle;
 }
 
 SGEventMgr::SGEventMgr() :
     _inited(false),
     _shutdown(false)
 {
+    _rtQueue.setStats(&_timerStatsTable);
+    _simQueue.setStats(&_timerStatsTable);
 }
 
 SGEventMgr::~SGEventMgr()
@@ -81,10 +87,28 @@ void SGEventMgr::shutdown()
 
 void SGEventMgr::update(double delta_time_sec)
 {
-    _simQueue.update(delta_time_sec, _timerStats);
+    _timerStatsTable.snapshot();
+
+    _simQueue.update(delta_time_sec);
 
     double rt = _rtProp ? _rtProp->getDoubleValue() : 0;
-    _rtQueue.update(rt, _timerStats);
+    _rtQueue.update(rt);
+}
+
+const SGSubsystem::TimerStats& SGEventMgr::getTimerStats()
+{
+    _timerStatsTable.exportTo(_timerStats, _lastTimerStats);
+    return _timerStats;
+}
+
+void SGEventMgr::reportTimingStats(TimerStats* _lastValues)
+{
+    // the per-timer statistics are only converted to a map when reported,
+    // and dropped again so the timing loop does not copy them every frame
+    _timerStatsTable.exportTo(_timerStats, _lastTimerStats);
+    SGSubsystem::reportTimingStats(_lastValues);
+    _timerStats.clear();
+    _lastTimerStats.clear();
 }
 
 void SGEventMgr::removeTask(const std::string& name)
@@ -110,6 +134,16 @@ void SGEventMgr::removeTask(const std::string& name)
     }
 }
 
+bool SGEventMgr::removeTask(const SGTimerHandle& handle)
+{
+    if (!_inited || !handle.isValid()) {
+        return false;
+    }
+
+    SGTimerQueue& q = handle._simtime ? _simQueue : _rtQueue;
+    return q.remove(handle);
+}
+
 void SGEventMgr::dump()
 {
     SG_LOG(SG_GENERAL, SG_INFO, "EventMgr: sim-time queue:");
@@ -123,79 +157,398 @@ SGSubsystemMgr::Registrant<SGEventMgr> registrantSGEventMgr(
     SGSubsystemMgr::DISPLAY);
 
 
+////////////////////////////////////////////////////////////////////////
+// SGTimerStats
+////////////////////////////////////////////////////////////////////////
+
+unsigned SGTimerStats::intern(const std::string& name)
+{
+    auto it = _indices.find(name);
+    if (it != _indices.end()) {
+        return it->second;
+    }
+
+    const unsigned index = _names.size();
+    _indices.emplace(name, index);
+    _names.push_back(name);
+    _seconds.push_back(0.0);
+    _lastSeconds.push_back(0.0);
+    return index;
+}
+
+void SGTimerStats::exportTo(std::map<std::string, double>& stats,
+                            std::map<std::string, double>& lastStats) const
+{
+    for (size_t i = 0; i < _names.size(); ++i) {
+        stats[_names[i]] = _seconds[i];
+        lastStats[_names[i]] = i < _lastSeconds.size() ? _lastSeconds[i] : 0.0;
+    }
+}
+
+void SGTimerStats::clear()
+{
+    // interned indices stay valid, queued timers keep referring to them
+    std::fill(_seconds.begin(), _seconds.end(), 0.0);
+    std::fill(_lastSeconds.begin(), _lastSeconds.end(), 0.0);
+}
+
 ////////////////////////////////////////////////////////////////////////
 // SGTimerQueue
 ////////////////////////////////////////////////////////////////////////
 
+// The wheel has LEVELS levels of LEVEL_SLOTS slots each. A timer due in
+// less than LEVEL_SLOTS ticks is kept in the level 0 slot of its tick, one
+// due later in the level covering the distance; whenever the tick counter
+// crosses a multiple of LEVEL_SLOTS^l the matching slot of level l is
+// cascaded down. Slots are intrusive doubly linked lists of _nodes indices,
+// and so are the chains of timers sharing a name, headed in _names.
+
 void SGTimerQueue::clear()
 {
-    _table.clear();
+    _nodes.clear();
+    _freeNodes.clear();
+    _expired.clear();
+    _names.clear();
+    std::fill(std::begin(_slots), std::end(_slots), NIL);
+    std::fill(std::begin(_levelCount), std::end(_levelCount), 0u);
+    _slotsInitialized = true;
+    _numQueued = 0;
+}
+
+void SGTimerQueue::update(double deltaSecs)
+{
+    doUpdate(deltaSecs, nullptr);
 }
 
 void SGTimerQueue::update(double deltaSecs, std::map<std::string, double> &timingStats)
+{
+    doUpdate(deltaSecs, &timingStats);
+}
+
+void SGTimerQueue::doUpdate(double deltaSecs, std::map<std::string, double>* timingStats)
 {
     _now += deltaSecs;
+    if (!_slotsInitialized) {
+        clear();
+    }
+
+    const double nowTicks = std::floor(_now / TICK_SECS);
+    const uint64_t target = nowTicks > _tick ? static_cast<uint64_t>(nowTicks) : _tick;
+
+    // all slots before the target tick expire completely
+    while (_tick < target) {
+        if (_numQueued == 0) {
+            _tick = target;
+            break;
+        }
+
+        if (_cascadedTick != _tick) {
+            cascade(_tick);
+        }
+
+        if (_levelCount[0] == 0) {
+            // nothing can expire before the next cascade
+            _tick = std::min((_tick | LEVEL_MASK) + 1, target);
+            continue;
+        }
+
+        expireSlot(_tick & LEVEL_MASK, false);
+        ++_tick;
+    }
+
+    // the current tick only up to now, the rest is checked again next time
+    if (_cascadedTick != _tick) {
+        cascade(_tick);
+    }
+    expireSlot(_tick & LEVEL_MASK, true);
+
+    if (_expired.empty()) {
+        return;
+    }
+
+    std::sort(_expired.begin(), _expired.end(), [this](uint32_t a, uint32_t b) {
+        const Node& na = _nodes[a];
+        const Node& nb = _nodes[b];
+        return na.due < nb.due || (na.due == nb.due && na.sequence < nb.sequence);
+    });
+
+    // _expired and _nodes may be modified by the callbacks, so only access
+    // them by index
+    for (size_t i = 0; i < _expired.size(); ++i) {
+        const uint32_t index = _expired[i];
+        if (_nodes[index].state != State::Expired) {
+            continue; // removed by an earlier callback
+        }
 
-    while (!_table.empty() && nextTime() <= _now) {
-        _current_timer = remove();
+        const uint32_t generation = _nodes[index].generation;
+        const unsigned statsIndex = _nodes[index].statsIndex;
+        _nodes[index].state = State::Running;
+        _current = index;
+        _current_timer = std::move(_nodes[index].timer);
 
         // warning: this is not thread safe
         // but the entire timer queue isn't either
         SGTimeStamp timeStamp;
         timeStamp.stamp();
         _current_timer->running = true;
-        _current_timer->run();
+        {
+            simgear::TraceScope trace("timer", _current_timer->name);
+            _current_timer->run();
+        }
         _current_timer->running = false;
-        timingStats[_current_timer->name] += timeStamp.elapsedMSec() / 1000.0;
+        const double elapsed = timeStamp.elapsedMSec() / 1000.0;
+        if (_stats) {
+            _stats->add(statsIndex, elapsed);
+        }
+        if (timingStats) {
+            (*timingStats)[_current_timer->name] += elapsed;
+        }
 
-        // insert() after run() because the timer can remove itself with removeByName()
-        if(_current_timer->repeat) {
-            double interval = _current_timer->interval;
-            insert(std::move(_current_timer), interval);
+        // reschedule after run() because the timer can remove itself, and
+        // the whole queue might have been cleared meanwhile
+        if ((index < _nodes.size()) && (_nodes[index].generation == generation) &&
+            (_nodes[index].state == State::Running)) {
+            if (_current_timer->repeat) {
+                const double interval = _current_timer->interval;
+                _nodes[index].timer = std::move(_current_timer);
+                schedule(index, interval);
+            } else {
+                release(index);
+            }
         }
 
         _current_timer = nullptr;
+        _current = NIL;
+    }
+
+    _expired.clear();
+}
+
+SGTimerHandle SGTimerQueue::insert(std::unique_ptr<SGTimer> timer, double time)
+{
+    if (!_slotsInitialized) {
+        clear();
+    }
+
+    uint32_t index;
+    if (_freeNodes.empty()) {
+        index = _nodes.size();
+        _nodes.emplace_back();
+    } else {
+        index = _freeNodes.back();
+        _freeNodes.pop_back();
+    }
+
+    // generations are unique per queue, never per node, so a handle can't
+    // match a node which was reused, even after clear()
+    if (++_generation == 0) {
+        ++_generation;
+    }
+
+    Node& node = _nodes[index];
+    node.generation = _generation;
+    node.statsIndex = _stats ? _stats->intern(timer->name) : 0;
+    node.timer = std::move(timer);
+    linkName(index);
+    return schedule(index, time);
+}
+
+SGTimerHandle SGTimerQueue::schedule(uint32_t index, double time)
+{
+    Node& node = _nodes[index];
+    node.due = _now + time;
+    node.sequence = _sequence++;
+    link(index);
+    return SGTimerHandle(index, node.generation);
+}
+
+void SGTimerQueue::link(uint32_t index)
+{
+    Node& node = _nodes[index];
+
+    const uint64_t span = uint64_t(1) << (LEVEL_BITS * LEVELS);
+    const double dueTicks = std::floor(node.due / TICK_SECS);
+    uint64_t delta = 0;
+    if (dueTicks > _tick) {
+        // timers beyond the wheel are parked in the last slot and
+        // re-linked when it expires
+        delta = (dueTicks - _tick >= span) ? span - 1
+                                            : static_cast<uint64_t>(dueTicks) - _tick;
+    }
+    const uint64_t tick = _tick + delta;
+
+    unsigned level = 0;
+    while ((level < LEVELS - 1) && (delta >= (uint64_t(1) << (LEVEL_BITS * (level + 1))))) {
+        ++level;
+    }
+
+    const unsigned slot = level * LEVEL_SLOTS + ((tick >> (LEVEL_BITS * level)) & LEVEL_MASK);
+    node.slot = slot;
+    node.state = State::Queued;
+    node.prev = NIL;
+    node.next = _slots[slot];
+    if (node.next != NIL) {
+        _nodes[node.next].prev = index;
+    }
+    _slots[slot] = index;
+    ++_levelCount[level];
+    ++_numQueued;
+}
+
+void SGTimerQueue::unlink(uint32_t index)
+{
+    Node& node = _nodes[index];
+    if (node.prev != NIL) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _slots[node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+        _nodes[node.next].prev = node.prev;
+    }
+    node.prev = node.next = NIL;
+    --_levelCount[node.slot / LEVEL_SLOTS];
+    --_numQueued;
+}
 
+void SGTimerQueue::linkName(uint32_t index)
+{
+    Node& node = _nodes[index];
+    auto it = _names.try_emplace(node.timer->name, NIL).first;
+    // element pointers stay valid across rehashing
+    node.nameEntry = &*it;
+    node.namePrev = NIL;
+    node.nameNext = it->second;
+    if (node.nameNext != NIL) {
+        _nodes[node.nameNext].namePrev = index;
     }
+    it->second = index;
+}
+
+void SGTimerQueue::unlinkName(uint32_t index)
+{
+    Node& node = _nodes[index];
+    if (node.namePrev != NIL) {
+        _nodes[node.namePrev].nameNext = node.nameNext;
+    } else if (node.nameNext != NIL) {
+        node.nameEntry->second = node.nameNext;
+    } else {
+        _names.erase(_names.find(node.nameEntry->first));
+    }
+    if (node.nameNext != NIL) {
+        _nodes[node.nameNext].namePrev = node.namePrev;
+    }
+    node.namePrev = node.nameNext = NIL;
+    node.nameEntry = nullptr;
+}
+
+void SGTimerQueue::release(uint32_t index)
+{
+    Node& node = _nodes[index];
+    unlinkName(index);
+    node.timer.reset();
+    node.state = State::Free;
+    _freeNodes.push_back(index);
 }
 
-std::unique_ptr<SGTimer> SGTimerQueue::remove()
+void SGTimerQueue::cascade(uint64_t tick)
 {
-    if(_table.empty()) {
-        return nullptr;
+    _cascadedTick = tick;
+    for (unsigned level = 1; level < LEVELS; ++level) {
+        const unsigned shift = LEVEL_BITS * level;
+        if (tick & ((uint64_t(1) << shift) - 1)) {
+            break; // not on a boundary of this level
+        }
+
+        const unsigned slot = level * LEVEL_SLOTS + ((tick >> shift) & LEVEL_MASK);
+        uint32_t index = _slots[slot];
+        while (index != NIL) {
+            const uint32_t next = _nodes[index].next;
+            unlink(index);
+            link(index);
+            index = next;
+        }
     }
+}
 
-    std::pop_heap(_table.begin(), _table.end(), std::greater<>());
-    auto ptr = std::move(_table[_table.size()-1].timer);
-    _table.pop_back();
-    return ptr;
+void SGTimerQueue::expireSlot(unsigned slot, bool partial)
+{
+    uint32_t index = _slots[slot];
+    while (index != NIL) {
+        const uint32_t next = _nodes[index].next;
+        if (_nodes[index].due <= _now) {
+            unlink(index);
+            _nodes[index].state = State::Expired;
+            _expired.push_back(index);
+        } else if (!partial) {
+            // parked beyond the range of the wheel
+            unlink(index);
+            link(index);
+        }
+        index = next;
+    }
 }
 
+bool SGTimerQueue::cancel(uint32_t index)
+{
+    switch (_nodes[index].state) {
+    case State::Queued:
+        unlink(index);
+        release(index);
+        return true;
+    case State::Expired:
+        // skipped by the running update()
+        release(index);
+        return true;
+    case State::Running:
+        if (_current_timer) {
+            _current_timer->repeat = false;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
 
-void SGTimerQueue::insert(std::unique_ptr<SGTimer> timer, double time)
+bool SGTimerQueue::remove(const SGTimerHandle& handle)
 {
-    _table.push_back({_now + time, std::move(timer)});
-    std::push_heap(_table.begin(), _table.end(), std::greater<>());
+    if ((handle._index >= _nodes.size()) ||
+        (_nodes[handle._index].generation != handle._generation)) {
+        return false;
+    }
+
+    return cancel(handle._index);
 }
 
 void SGTimerQueue::dump()
 {
-    for (const Entry &entry : _table) {
-        const auto &t = entry.timer;
+    for (const Node &node : _nodes) {
+        if (node.state != State::Queued) {
+            continue;
+        }
+        const auto &t = node.timer;
         SG_LOG(SG_GENERAL, SG_INFO, "\ttimer:" << t->name << ", interval=" << t->interval);
     }
 }
 
 bool SGTimerQueue::removeByName(const std::string& name)
 {
-    for (size_t i=0; i < _table.size(); ++i) {
-        if (_table[i].timer->name == name) {
-            std::pop_heap(_table.begin()+i, _table.end(), std::greater<>());
-            _table.pop_back();
-            if(i != 0) {
-              std::make_heap(_table.begin(), _table.end(), std::greater<>());
+    // the chain is in insertion order, remove the timer due first
+    auto it = _names.find(name);
+    if (it != _names.end()) {
+        uint32_t first = NIL;
+        for (uint32_t index = it->second; index != NIL; index = _nodes[index].nameNext) {
+            const Node& node = _nodes[index];
+            if ((node.state != State::Queued) && (node.state != State::Expired)) {
+                continue;
+            }
+            if ((first == NIL) || (node.due < _nodes[first].due) ||
+                ((node.due == _nodes[first].due) && (node.sequence < _nodes[first].sequence))) {
+                first = index;
             }
-            return true;
+        }
+        if (first != NIL) {
+            return cancel(first);
         }
     }
 
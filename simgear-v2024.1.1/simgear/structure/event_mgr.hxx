@@ -4,11 +4,14 @@
 #include <simgear/props/props.hxx>
 #include <simgear/structure/subsystem_mgr.hxx>
 
+#include <cstdint>
+#include <unordered_map>
 #include <utility>
 
 #include "callback.hxx"
 
 class SGEventMgr;
+class SGTimerQueue;
 
 class SGTimer
 {
@@ -30,7 +33,65 @@ public:
     SGTimer(SGTimer &&other) = default;
 };
 
-/*! Queue to execute SGTimers after given delays */
+/*! Identifies a timer inserted into a SGTimerQueue, for removal in O(1).
+ *  A handle stays valid while the timer is queued or running, afterwards
+ *  it simply does not match anything anymore. */
+class SGTimerHandle
+{
+public:
+    SGTimerHandle() = default;
+
+    bool isValid() const { return _generation != 0; }
+    void clear() { *this = SGTimerHandle(); }
+
+    bool operator==(const SGTimerHandle& other) const
+    {
+        return _index == other._index && _generation == other._generation &&
+               _simtime == other._simtime;
+    }
+
+private:
+    friend class SGTimerQueue;
+    friend class SGEventMgr;
+
+    SGTimerHandle(uint32_t index, uint32_t generation) :
+        _index(index), _generation(generation) {}
+
+    uint32_t _index = 0;
+    uint32_t _generation = 0;
+    bool _simtime = false;
+};
+
+/*! Accumulated run time per timer name. Names are interned once when a
+ *  timer is inserted, running a timer only adds to a table slot. */
+class SGTimerStats final
+{
+public:
+    unsigned intern(const std::string& name);
+
+    void add(unsigned index, double secs) { _seconds[index] += secs; }
+
+    /// remember the current values, the base of the next report's deltas
+    void snapshot() { _lastSeconds = _seconds; }
+
+    void exportTo(std::map<std::string, double>& stats,
+                  std::map<std::string, double>& lastStats) const;
+
+    void clear();
+
+private:
+    std::unordered_map<std::string, unsigned> _indices;
+    std::vector<std::string> _names;
+    std::vector<double> _seconds;
+    std::vector<double> _lastSeconds;
+};
+
+/*! Queue to execute SGTimers after given delays.
+ *
+ *  Implemented as a hierarchical timing wheel with a resolution of one
+ *  millisecond, so inserting and removing (by handle) a timer is O(1).
+ *  Timers still fire in the order of their exact expiry time. Timers are
+ *  also chained by name, so removing by name doesn't scan the queue. */
 class SGTimerQueue final
 {
 public:
@@ -38,26 +99,83 @@ public:
     ~SGTimerQueue() = default;      // non-virtual intentional
 
     void clear();
+
+    /// advance the queue and run all expired timers, accumulating their
+    /// run time into the statistics table set with setStats()
+    void update(double deltaSecs);
+    /// as above, but additionally accumulate the run times by name
     void update(double deltaSecs, std::map<std::string, double> &timingStats);
-    void insert(std::unique_ptr<SGTimer> timer, double time);
+
+    SGTimerHandle insert(std::unique_ptr<SGTimer> timer, double time);
+    bool remove(const SGTimerHandle& handle);
     bool removeByName(const std::string& name);
 
+    void setStats(SGTimerStats* stats) { _stats = stats; }
+    size_t size() const { return _numQueued; }
+
     void dump();
 
 private:
-    std::unique_ptr<SGTimer> remove();
-    double nextTime() const { return _table[0].pri; }
+    static constexpr double TICK_SECS = 0.001;
+    static constexpr unsigned LEVEL_BITS = 8;
+    static constexpr unsigned LEVEL_SLOTS = 1u << LEVEL_BITS;
+    static constexpr unsigned LEVEL_MASK = LEVEL_SLOTS - 1;
+    static constexpr unsigned LEVELS = 4;
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    enum class State : uint8_t {
+        Free,
+        Queued,     ///< in a wheel slot
+        Expired,    ///< waiting to be run in this update
+        Running,
+    };
 
-    struct Entry {
-        double pri;
+    struct Node {
         std::unique_ptr<SGTimer> timer;
-
-        bool operator>(const Entry& other) const { return pri > other.pri; }
+        double due = 0.0;
+        uint64_t sequence = 0;
+        uint32_t generation = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t namePrev = NIL;    ///< timers with the same name
+        uint32_t nameNext = NIL;
+        std::pair<const std::string, uint32_t>* nameEntry = nullptr;
+        uint16_t slot = 0;          ///< level * LEVEL_SLOTS + slot index
+        State state = State::Free;
+        unsigned statsIndex = 0;
     };
 
+    void doUpdate(double deltaSecs, std::map<std::string, double>* timingStats);
+    SGTimerHandle schedule(uint32_t index, double time);
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void linkName(uint32_t index);
+    void unlinkName(uint32_t index);
+    void release(uint32_t index);
+    void cascade(uint64_t tick);
+    void expireSlot(unsigned slot, bool partial);
+    bool cancel(uint32_t index);
+
+    std::vector<Node> _nodes;
+    std::vector<uint32_t> _freeNodes;
+    std::vector<uint32_t> _expired;
+    uint32_t _slots[LEVELS * LEVEL_SLOTS];
+    /// first node of the chain of timers with a name, from insert()
+    /// until release(), including while running
+    std::unordered_map<std::string, uint32_t> _names;
+    unsigned _levelCount[LEVELS] = {};
+    bool _slotsInitialized = false;
+
+    uint64_t _tick = 0;                 ///< next tick to be processed
+    uint64_t _cascadedTick = UINT64_MAX;
+    uint64_t _sequence = 0;
+    uint32_t _generation = 0;
+    size_t _numQueued = 0;
+
     std::unique_ptr<SGTimer> _current_timer;
+    uint32_t _current = NIL;
     double _now = 0.0;
-    std::vector<Entry> _table;
+    SGTimerStats* _stats = nullptr;
 };
 
 class SGEventMgr : public SGSubsystem
@@ -75,37 +193,47 @@ public:
     // Subsystem identification.
     static const char* staticSubsystemClassId() { return "events"; }
 
+    const TimerStats& getTimerStats() override;
+    void reportTimingStats(TimerStats* _lastValues) override;
+
     void setRealtimeProperty(SGPropertyNode* node) { _rtProp = node; }
 
     /**
      * Add a callback as a one-shot event.
      */
-    inline void addEvent(const std::string& name, simgear::Callback cb,
-                         double delay, bool sim=false)
-    { add(name, std::move(cb), 0, delay, false, sim); }
+    inline SGTimerHandle addEvent(const std::string& name, simgear::Callback cb,
+                                  double delay, bool sim=false)
+    { return add(name, std::move(cb), 0, delay, false, sim); }
 
     /**
      * Add a callback as a repeating task.
      */
-    inline void addTask(const std::string& name,
-                        simgear::Callback cb,
-                        double interval, double delay=0, bool sim=false)
-    { add(name, std::move(cb), interval, delay, true, sim); }
+    inline SGTimerHandle addTask(const std::string& name,
+                                 simgear::Callback cb,
+                                 double interval, double delay=0, bool sim=false)
+    { return add(name, std::move(cb), interval, delay, true, sim); }
 
 
     void removeTask(const std::string& name);
 
+    /**
+     * Remove a task or event by the handle returned when adding it. Unlike
+     * removal by name this does not need to search the queues.
+     */
+    bool removeTask(const SGTimerHandle& handle);
+
     void dump();
 
 private:
     friend class SGTimer;
 
-    void add(const std::string& name, simgear::Callback cb,
-             double interval, double delay,
-             bool repeat, bool simtime);
+    SGTimerHandle add(const std::string& name, simgear::Callback cb,
+                      double interval, double delay,
+                      bool repeat, bool simtime);
 
     SGPropertyNode_ptr _freezeProp;
     SGPropertyNode_ptr _rtProp;
+    SGTimerStats _timerStatsTable;
     SGTimerQueue _rtQueue;
     SGTimerQueue _simQueue;
     bool _inited, _shutdown;
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: LGPL-2.0-or-later
 
 #include <cstdlib>
+#include <vector>
 
 #include <simgear/misc/test_macros.hxx>
 
@@ -86,6 +87,93 @@ void testSGTimerQueueRemoveByName() {
     SG_CHECK_EQUAL(call_counter, 2);
 }
 
+void testSGTimerQueueRemoveByNameShared() {
+    SGTimerQueue queue;
+    std::vector<int> calls(4, 0);
+
+    // three repeating timers share a name, the last has its own
+    for (int i = 0; i < 4; ++i) {
+        auto timer = std::make_unique<SGTimer>();
+        timer->callback = [&calls, i]() { ++calls[i]; };
+        timer->name = (i < 3) ? "Shared" : "Other";
+        timer->repeat = true;
+        timer->interval = 1;
+        queue.insert(std::move(timer), 1);
+    }
+    queue.update(1.0);
+    SG_CHECK_EQUAL(queue.size(), 4);
+
+    // each call removes one of them
+    SG_CHECK_EQUAL(queue.removeByName("Shared"), true);
+    SG_CHECK_EQUAL(queue.size(), 3);
+    SG_CHECK_EQUAL(queue.removeByName("Shared"), true);
+    SG_CHECK_EQUAL(queue.removeByName("Shared"), true);
+    SG_CHECK_EQUAL(queue.removeByName("Shared"), false);
+    SG_CHECK_EQUAL(queue.size(), 1);
+
+    queue.update(1.0);
+    SG_CHECK_EQUAL(calls[0] + calls[1] + calls[2], 3);
+    SG_CHECK_EQUAL(calls[3], 2);
+
+    // a name can be used again after its timers are gone
+    auto timer = std::make_unique<SGTimer>();
+    timer->callback = [&calls]() { ++calls[0]; };
+    timer->name = "Shared";
+    queue.insert(std::move(timer), 1);
+    SG_CHECK_EQUAL(queue.removeByName("Shared"), true);
+    queue.update(1.0);
+    SG_CHECK_EQUAL(calls[0] + calls[1] + calls[2], 3);
+
+    // and a timer can remove itself by name while it runs
+    timer = std::make_unique<SGTimer>();
+    timer->callback = [&]() {
+        ++calls[0];
+        SG_CHECK_EQUAL(queue.removeByName("Self"), true);
+    };
+    timer->name = "Self";
+    timer->repeat = true;
+    timer->interval = 1;
+    queue.insert(std::move(timer), 1);
+    queue.update(1.0);
+    queue.update(1.0);
+    SG_CHECK_EQUAL(calls[0] + calls[1] + calls[2], 4);
+    SG_CHECK_EQUAL(queue.removeByName("Self"), false);
+    SG_CHECK_EQUAL(queue.removeByName("Other"), true);
+    SG_CHECK_EQUAL(queue.size(), 0);
+}
+
+void testSGTimerQueueRemoveByNameEarliest() {
+    // two timers of the same name, inserted in both orders: removeByName()
+    // takes the one due first
+    for (const bool earlyFirst : {true, false}) {
+        SGTimerQueue queue;
+        int early_calls = 0, late_calls = 0;
+
+        auto early = std::make_unique<SGTimer>();
+        early->callback = [&early_calls]() { ++early_calls; };
+        early->name = "Twice";
+        auto late = std::make_unique<SGTimer>();
+        late->callback = [&late_calls]() { ++late_calls; };
+        late->name = "Twice";
+
+        if (earlyFirst) {
+            queue.insert(std::move(early), 1);
+            queue.insert(std::move(late), 3);
+        } else {
+            queue.insert(std::move(late), 3);
+            queue.insert(std::move(early), 1);
+        }
+
+        SG_CHECK_EQUAL(queue.removeByName("Twice"), true);
+        SG_CHECK_EQUAL(queue.size(), 1);
+        queue.update(2.0);
+        SG_CHECK_EQUAL(early_calls, 0);
+        queue.update(2.0);
+        SG_CHECK_EQUAL(late_calls, 1);
+        SG_CHECK_EQUAL(queue.size(), 0);
+    }
+}
+
 void testSGTimerQueueOneShot() {
     SGTimerQueue queue;
     int call_counter = 0;
@@ -108,11 +196,148 @@ void testSGTimerQueueOneShot() {
     SG_CHECK_EQUAL(call_counter, 1);
 }
 
+void testSGTimerQueueRemoveByHandle() {
+    SGTimerQueue queue;
+    int call_counter = 0;
+
+    auto timer = std::make_unique<SGTimer>();
+    timer->callback = [&call_counter]() { ++call_counter; };
+    timer->name = "TestTimer1";
+    timer->repeat = true;
+    timer->interval = 1;
+    SGTimerHandle handle = queue.insert(std::move(timer), 1);
+    SG_VERIFY(handle.isValid());
+    SG_CHECK_EQUAL(queue.size(), 1);
+
+    queue.update(1.0);
+    SG_CHECK_EQUAL(call_counter, 1);
+    SG_CHECK_EQUAL(queue.remove(handle), true);
+    SG_CHECK_EQUAL(queue.size(), 0);
+    queue.update(1.0);
+    SG_CHECK_EQUAL(call_counter, 1);
+
+    // the handle is stale, even once its node is reused
+    SG_CHECK_EQUAL(queue.remove(handle), false);
+    auto other = std::make_unique<SGTimer>();
+    other->callback = [&call_counter]() { ++call_counter; };
+    other->name = "TestTimer2";
+    queue.insert(std::move(other), 1);
+    SG_CHECK_EQUAL(queue.remove(handle), false);
+    queue.update(1.0);
+    SG_CHECK_EQUAL(call_counter, 2);
+    SG_CHECK_EQUAL(queue.remove(SGTimerHandle()), false);
+}
+
+void testSGTimerQueueOrder() {
+    SGTimerQueue queue;
+    std::vector<int> order;
+
+    // spread over all levels of the wheel, inserted in reverse order
+    const double delays[] = {5000.0, 300.0, 70.0, 2.5, 0.3, 0.0105, 0.01};
+    for (int i = 0; i < 7; ++i) {
+        auto timer = std::make_unique<SGTimer>();
+        timer->callback = [&order, i]() { order.push_back(i); };
+        timer->name = "TestTimer";
+        queue.insert(std::move(timer), delays[i]);
+    }
+
+    // same expiry: first in, first out
+    for (int i = 7; i < 9; ++i) {
+        auto timer = std::make_unique<SGTimer>();
+        timer->callback = [&order, i]() { order.push_back(i); };
+        timer->name = "TestTimer";
+        queue.insert(std::move(timer), 2.5);
+    }
+
+    queue.update(0.005);
+    SG_CHECK_EQUAL(order.size(), 0);
+    queue.update(0.0052);
+    SG_CHECK_EQUAL(order.size(), 1);
+    SG_CHECK_EQUAL(order[0], 6);
+
+    // one large step fires everything else in expiry order
+    queue.update(10000.0);
+    const int expected[] = {6, 5, 4, 3, 7, 8, 2, 1, 0};
+    SG_CHECK_EQUAL(order.size(), 9);
+    for (int i = 0; i < 9; ++i) {
+        SG_CHECK_EQUAL(order[i], expected[i]);
+    }
+    SG_CHECK_EQUAL(queue.size(), 0);
+}
+
+void testSGTimerQueueSmallSteps() {
+    SGTimerQueue queue;
+    int call_counter = 0;
+
+    auto timer = std::make_unique<SGTimer>();
+    timer->callback = [&call_counter]() { ++call_counter; };
+    timer->name = "TestTimer1";
+    timer->repeat = true;
+    timer->interval = 0.5;
+    queue.insert(std::move(timer), 0.5);
+
+    // 100 s in frames of 1/64 s: 200 runs
+    for (int i = 0; i < 6400; ++i) {
+        queue.update(1.0 / 64.0);
+    }
+    SG_CHECK_EQUAL(call_counter, 200);
+}
+
+void testSGTimerQueueRemoveSelf() {
+    SGTimerQueue queue;
+    int call_counter = 0;
+    SGTimerHandle handle;
+
+    auto timer = std::make_unique<SGTimer>();
+    timer->callback = [&]() {
+        ++call_counter;
+        SG_CHECK_EQUAL(queue.remove(handle), true);
+    };
+    timer->name = "TestTimer1";
+    timer->repeat = true;
+    timer->interval = 1;
+    handle = queue.insert(std::move(timer), 1);
+
+    queue.update(1.0);
+    SG_CHECK_EQUAL(call_counter, 1);
+    queue.update(1.0);
+    SG_CHECK_EQUAL(call_counter, 1);
+    SG_CHECK_EQUAL(queue.size(), 0);
+}
+
+void testSGTimerStats() {
+    SGTimerStats table;
+    SGTimerQueue queue;
+    queue.setStats(&table);
+
+    for (int i = 0; i < 2; ++i) {
+        auto timer = std::make_unique<SGTimer>();
+        timer->callback = []() {};
+        timer->name = "TestTimer";
+        queue.insert(std::move(timer), 1);
+    }
+    queue.update(1.0);
+
+    std::map<std::string, double> stats, lastStats;
+    table.exportTo(stats, lastStats);
+    SG_CHECK_EQUAL(stats.size(), 1);
+    SG_CHECK_EQUAL(lastStats.size(), 1);
+    SG_VERIFY(stats["TestTimer"] >= 0.0);
+    SG_CHECK_EQUAL(lastStats["TestTimer"], 0.0);
+}
+
 int main(int argc, char *argv[]) {
     testSGTimer();
     testSGTimerQueueClear();
     testSGTimerQueueRemoveByName();
+    testSGTimerQueueRemoveByNameShared();
+    testSGTimerQueueRemoveByNameEarliest();
     testSGTimerQueueOneShot();
+    testSGTimerQueueRemoveByHandle();
+    testSGTimerQueueOrder();
+    testSGTimerQueueSmallSteps();
+    testSGTimerQueueRemoveSelf();
+    testSGTimerStats();
 
     return EXIT_SUCCESS;
 }
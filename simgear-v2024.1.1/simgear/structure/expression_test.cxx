@@ -98,12 +98,43 @@ void testParse()
     SG_VERIFY(deps.find(propertyTree->getNode("group-b/thing-1")) != deps.end());
 }
 
+void testNestedDependencies()
+{
+    initPropTree();
+    SGPropertyNode* barProp = propertyTree->getNode("group-a/bar");
+    SGPropertyNode* zotProp = propertyTree->getNode("group-a/zot");
+    SGPropertyNode* thingProp = propertyTree->getNode("group-b/thing-1");
+
+    // sum(bar, convert(zot)): the property below the conversion counts too
+    SGSharedPtr<SGExpressiond> sum = new SGSumExpression<double>(
+        new SGPropertyExpression<double>(barProp),
+        new ConvertExpression<double, int>(new SGPropertyExpression<int>(zotProp)));
+
+    std::set<const SGPropertyNode*> deps;
+    sum->collectDependentProperties(deps);
+    SG_CHECK_EQUAL(deps.size(), 2);
+    SG_VERIFY(deps.find(barProp) != deps.end());
+    SG_VERIFY(deps.find(zotProp) != deps.end());
+
+    // predicates report all of their operands
+    SGSharedPtr<SGExpression<bool> > equal = new EqualToExpression<double>(
+        new SGPropertyExpression<double>(barProp),
+        new ConvertExpression<double, bool>(new SGPropertyExpression<bool>(thingProp)));
+
+    deps.clear();
+    equal->collectDependentProperties(deps);
+    SG_CHECK_EQUAL(deps.size(), 2);
+    SG_VERIFY(deps.find(barProp) != deps.end());
+    SG_VERIFY(deps.find(thingProp) != deps.end());
+}
+
 int main(int argc, char* argv[])
 {
     sglog().setLogLevels( SG_ALL, SG_INFO );
   
     testBasic();
     testParse();
+    testNestedDependencies();
     
     cout << __FILE__ << ": All tests passed" << endl;
     return EXIT_SUCCESS;
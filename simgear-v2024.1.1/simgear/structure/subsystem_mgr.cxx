@@ -21,13 +21,19 @@
 #include <simgear_config.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <future>
+#include <iomanip>
+#include <ostream>
+#include <set>
 
 #include <simgear/debug/logstream.hxx>
 #include <simgear/timing/timestamp.hxx>
 
 #include "exception.hxx"
 #include "subsystem_mgr.hxx"
+#include "SGTraceRecorder.hxx"
 #include "commands.hxx"
 
 #include "SGSmplstat.hxx"
@@ -42,6 +48,13 @@ const char SUBSYSTEM_NAME_SEPARATOR = '.';
 using std::string;
 using State = SGSubsystem::State;
 
+namespace {
+    const SGSubsystemMgr::DependencyVec* findDependencies(const std::string& name);
+
+    // worker threads of parallel init are numbered for the timeline
+    std::atomic<int> nextInitThread{1};
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Implementation of SGSubsystem
 ////////////////////////////////////////////////////////////////////////
@@ -241,6 +254,18 @@ public:
     int exceptionCount;
     int initTime;
 
+    // init timeline, see SGSubsystemMgr::initTimeline()
+    bool initStarted = false;
+    SGTimeStamp initStart, initEnd;
+    int initThread = 0;
+    std::string initAfter;
+
+    /// pending init on a worker thread, see isInitThreadSafe()
+    std::future<void> asyncInit;
+
+    /// interned name for the trace recorder
+    const char* traceName = nullptr;
+
     void mergeTimerStats(SGSubsystem::TimerStats &stats);
 };
 
@@ -284,25 +309,45 @@ SGSubsystemGroup::incrementalInit()
         return INIT_DONE;
     }
 
+    if (_initPosition < 0) {
+        // first call
+        assert(_state == State::BIND);
+        _initPosition = 0;
+        _lastMainInit.clear();
+        for (auto m : _members) {
+            m->initStarted = false;
+        }
+    }
+
+    const bool allJoined = joinMemberInits(false);
+
     // termination test
     if (_initPosition >= static_cast<int>(_members.size())) {
+        if (!allJoined) {
+            return INIT_CONTINUE;
+        }
         _state = State::INIT;
         return INIT_DONE;
     }
 
-    if (_initPosition < 0) {
-        // first call
-        assert(_state == State::BIND);
-        _initPosition = 0;
-        notifyWillChange(_members.front()->subsystem, State::INIT);
+    const auto m = _members[_initPosition];
+    if (!m->initStarted && !startMemberInit(m)) {
+        // a dependency is still being inited on a worker thread
+        return INIT_CONTINUE;
+    }
+
+    if (m->asyncInit.valid()) {
+        // carry on with the next member meanwhile
+        ++_initPosition;
+        return INIT_CONTINUE;
     }
 
-    const auto m = _members[_initPosition];
     SGTimeStamp st;
     st.stamp();
     InitStatus memberStatus;
 
     try {
+        simgear::TraceScope trace("init", m->name);
         memberStatus = m->subsystem->incrementalInit();
     } catch (std::exception& e) {
         simgear::reportError("Caught exception init-ing subsystem " + m->subsystem->subsystemId() + "\n\t" + e.what());
@@ -313,16 +358,117 @@ SGSubsystemGroup::incrementalInit()
 
     if (memberStatus == INIT_DONE) {
         // complete init of this one
+        m->initEnd.stamp();
+        _lastMainInit = m->name;
         notifyDidChange(m->subsystem, State::INIT);
         ++_initPosition;
+    }
 
-        if (_initPosition < static_cast<int>(_members.size())) {
-            // start init of the next one
-            notifyWillChange( _members[_initPosition]->subsystem, State::INIT);
+  return INIT_CONTINUE;
+}
+
+bool SGSubsystemGroup::startMemberInit(Member* m)
+{
+    // the init to wait for is the previous one on the main thread, or the
+    // last finished of the dependencies
+    std::string after = _lastMainInit;
+    SGTimeStamp afterEnd;
+    const auto last = after.empty() ? nullptr : get_member(after);
+    if (last) {
+        afterEnd = last->initEnd;
+    }
+
+    const auto deps = findDependencies(m->subsystem->subsystemClassId());
+    if (deps) {
+        for (const auto& dep : *deps) {
+            if ((dep.type != SGSubsystemMgr::Dependency::HARD) &&
+                (dep.type != SGSubsystemMgr::Dependency::SOFT) &&
+                (dep.type != SGSubsystemMgr::Dependency::SEQUENCE)) {
+                continue;
+            }
+
+            // only earlier members can still be running
+            for (int i = 0; i < _initPosition; ++i) {
+                const auto d = _members[i];
+                if ((d->name != dep.name) && (d->subsystem->subsystemClassId() != dep.name)) {
+                    continue;
+                }
+
+                if (d->asyncInit.valid()) {
+                    return false;
+                }
+
+                if (d->initEnd > afterEnd) {
+                    after = d->name;
+                    afterEnd = d->initEnd;
+                }
+            }
         }
     }
 
-  return INIT_CONTINUE;
+    m->initStarted = true;
+    m->initAfter = after;
+    notifyWillChange(m->subsystem, State::INIT);
+    m->initStart.stamp();
+
+    if (m->subsystem->isInitThreadSafe()) {
+        m->initThread = nextInitThread++;
+        m->asyncInit = std::async(std::launch::async, [m]() {
+            simgear::TraceScope trace("init", m->name);
+            while (m->subsystem->incrementalInit() == INIT_CONTINUE) {
+            }
+            m->initEnd.stamp();
+        });
+    } else {
+        m->initThread = 0;
+    }
+
+    return true;
+}
+
+bool SGSubsystemGroup::joinMemberInits(bool wait)
+{
+    bool allJoined = true;
+    for (auto m : _members) {
+        if (!m->asyncInit.valid()) {
+            continue;
+        }
+
+        if (!wait && (m->asyncInit.wait_for(std::chrono::seconds(0)) != std::future_status::ready)) {
+            allJoined = false;
+            continue;
+        }
+
+        try {
+            m->asyncInit.get();
+        } catch (std::exception& e) {
+            simgear::reportError("Caught exception init-ing subsystem " + m->subsystem->subsystemId() + "\n\t" + e.what());
+            throw;
+        }
+
+        m->initTime += (m->initEnd - m->initStart).toMSecs();
+        notifyDidChange(m->subsystem, State::INIT);
+    }
+
+    return allJoined;
+}
+
+void SGSubsystemGroup::collectInitTimeline(std::vector<SGSubsystemInitSpan>& spans) const
+{
+    for (auto m : _members) {
+        if (!m->initStarted) {
+            continue;
+        }
+
+        // absolute times, made relative by the manager
+        spans.push_back({m->name, m->initStart.toMSecs(),
+                         (m->initEnd - m->initStart).toMSecs(),
+                         m->initThread, m->initAfter});
+
+        if (m->subsystem->is_group()) {
+            static_cast<SGSubsystemGroup*>(m->subsystem.ptr())->collectInitTimeline(spans);
+        }
+    }
 }
 
 void SGSubsystemGroup::forEach(std::function<void(SGSubsystem*)> f)
@@ -366,6 +512,8 @@ SGSubsystemGroup::shutdown ()
 {
     if (_state < State::INIT) {
         SG_LOG(SG_EVENT, SG_ALERT, "Shutdown of non-init-ed group:" << _name);
+        // don't leave inits running on worker threads
+        joinMemberInits(true);
         return;
     }
 
@@ -879,6 +1027,11 @@ SGSubsystemGroup::Member::update (double delta_time_sec)
     simgear::ReportBadAllocGuard bg;
     SGTimeStamp oTimer;
     try {
+        if (!traceName && simgear::TraceRecorder::isEnabled()) {
+            traceName = simgear::TraceRecorder::intern(name);
+        }
+        simgear::TraceScope trace("subsystem", traceName);
+
         oTimer.stamp();
         subsystem->update(elapsed_sec);
         subsystem->_lastExecutionTime = subsystem->_executionTime;
@@ -982,12 +1135,117 @@ SGSubsystemMgr::incrementalInit()
     return INIT_DONE;
 
   InitStatus memberStatus = _groups[_initPosition]->incrementalInit();
-  if (memberStatus == INIT_DONE)
+  if (memberStatus == INIT_DONE) {
     ++_initPosition;
 
+    if (_initPosition == MAX_GROUPS) {
+      for (const auto& span : initCriticalPath()) {
+        SG_LOG(SG_GENERAL, SG_INFO, "Init critical path: " << span.subsystem << " at "
+               << span.startMSec << "ms took " << span.durationMSec << "ms"
+               << (span.thread ? " (worker thread)" : ""));
+      }
+    }
+  }
+
   return INIT_CONTINUE;
 }
 
+std::vector<SGSubsystemInitSpan>
+SGSubsystemMgr::initTimeline() const
+{
+    std::vector<SGSubsystemInitSpan> spans;
+    for (const auto& group : _groups) {
+        group->collectInitTimeline(spans);
+    }
+
+    std::sort(spans.begin(), spans.end(), [](const SGSubsystemInitSpan& a, const SGSubsystemInitSpan& b) {
+        return a.startMSec < b.startMSec;
+    });
+
+    if (!spans.empty()) {
+        const double origin = spans.front().startMSec;
+        for (auto& span : spans) {
+            span.startMSec -= origin;
+        }
+    }
+    return spans;
+}
+
+std::vector<SGSubsystemInitSpan>
+SGSubsystemMgr::initCriticalPath() const
+{
+    const auto spans = initTimeline();
+    if (spans.empty()) {
+        return {};
+    }
+
+    std::map<std::string, const SGSubsystemInitSpan*> byName;
+    const SGSubsystemInitSpan* last = &spans.front();
+    for (const auto& span : spans) {
+        byName[span.subsystem] = &span;
+        if (span.startMSec + span.durationMSec > last->startMSec + last->durationMSec) {
+            last = &span;
+        }
+    }
+
+    // walk back through the inits each one waited for
+    std::vector<SGSubsystemInitSpan> path;
+    std::set<std::string> seen;
+    for (auto span = last; span && seen.insert(span->subsystem).second;) {
+        path.push_back(*span);
+        auto it = byName.find(span->after);
+        span = (it == byName.end()) ? nullptr : it->second;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+namespace {
+    void writeJSONString(std::ostream& os, const std::string& s)
+    {
+        os << '"';
+        for (const char c : s) {
+            if ((c == '"') || (c == '\\')) {
+                os << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                os << ' ';
+            } else {
+                os << c;
+            }
+        }
+        os << '"';
+    }
+}
+
+void
+SGSubsystemMgr::writeInitTrace(std::ostream& os) const
+{
+    const auto spans = initTimeline();
+    const auto critical = initCriticalPath();
+    std::set<std::string> onCriticalPath;
+    for (const auto& span : critical) {
+        onCriticalPath.insert(span.subsystem);
+    }
+
+    // complete ("X") events, times in microseconds
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& span : spans) {
+        os << (first ? "\n" : ",\n") << "{\"name\":";
+        writeJSONString(os, span.subsystem);
+        os << ",\"cat\":\"init\",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.thread
+           << std::fixed << std::setprecision(0)
+           << ",\"ts\":" << span.startMSec * 1000.0
+           << ",\"dur\":" << span.durationMSec * 1000.0
+           << std::defaultfloat << ",\"args\":{\"after\":";
+        writeJSONString(os, span.after);
+        os << ",\"critical\":" << (onCriticalPath.count(span.subsystem) ? "true" : "false") << "}}";
+        first = false;
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
 void
 SGSubsystemMgr::postinit ()
 {
@@ -1247,6 +1505,15 @@ namespace  {
                                { return name == d.name; });
         return it;
     }
+
+    const SGSubsystemMgr::DependencyVec* findDependencies(const std::string& name)
+    {
+        auto it = findRegistration(name);
+        if (it == getGlobalRegistrations().end()) {
+            return nullptr;
+        }
+        return &it->depends;
+    }
 } // of anonymous namespace
 
 void SGSubsystemMgr::registerSubsystem(const std::string& name,
@@ -29,6 +29,7 @@
 #include <map>
 #include <vector>
 #include <functional>
+#include <iosfwd>
 
 #include <simgear/timing/timestamp.hxx>
 #include <simgear/structure/SGSharedPtr.hxx>
@@ -49,6 +50,19 @@ public:
     const SGTimeStamp& getTime() const { return time; }
 };
 
+/**
+ * The init of one subsystem in the startup timeline, see
+ * SGSubsystemMgr::initTimeline().
+ */
+struct SGSubsystemInitSpan
+{
+    std::string subsystem;
+    double startMSec;     ///< since the first init started
+    double durationMSec;  ///< including frames in between incremental steps
+    int thread;           ///< 0 for the main thread
+    std::string after;    ///< the init it had to wait for, empty if none
+};
+
 // forward decls
 class SampleStatistic;
 class SGSubsystemGroup;
@@ -162,6 +176,18 @@ public:
 
   virtual InitStatus incrementalInit ();
 
+  /**
+   * Whether incrementalInit() may run on a worker thread.
+   *
+   * <p>During SGSubsystemGroup::incrementalInit(), the init of such a
+   * subsystem runs concurrently with the init of the following members
+   * of its group. Those which rely on it being initialised must declare
+   * it as a dependency (HARD, SOFT or SEQUENCE) in their registration;
+   * they wait for it. The group is only done once all inits finished,
+   * and the delegates are notified on the main thread.</p>
+   */
+  virtual bool isInitThreadSafe () const { return false; }
+
   /**
    * Initialize parts that depend on other subsystems having been initialized.
    *
@@ -453,6 +479,11 @@ public:
 
 private:
     void forEach(std::function<void(SGSubsystem*)> f);
+
+    class Member;
+    bool startMemberInit(Member* m);
+    bool joinMemberInits(bool wait);
+    void collectInitTimeline(std::vector<SGSubsystemInitSpan>& spans) const;
     void reverseForEach(std::function<void(SGSubsystem*)> f);
 
     void notifyWillChange(SGSubsystem* sub, SGSubsystem::State s);
@@ -465,7 +496,6 @@ private:
 
     void set_manager(SGSubsystemMgr* manager);
     
-    class Member;
     Member* get_member (const std::string &name, bool create = false);
     
     using MemberVec = std::vector<Member*>;
@@ -479,6 +509,9 @@ private:
 
   /// index of the member we are currently init-ing
     int _initPosition;
+
+    /// last member inited on the main thread, for the init timeline
+    std::string _lastMainInit;
     
     /// back-pointer to the manager, for the root groups. (sub-groups
     /// will have this as null, and chain via their parent)
@@ -585,6 +618,24 @@ public:
     SGSubsystem* get_subsystem(const std::string &name, const std::string& subsystemInstanceId) const;
 
     void reportTiming();
+
+    /**
+     * @brief the inits of the last incrementalInit(), in the order they started
+     */
+    std::vector<SGSubsystemInitSpan> initTimeline() const;
+
+    /**
+     * @brief the chain of inits, each waiting for the previous one, which
+     * finished last: the part of the startup which parallel init can't shorten
+     */
+    std::vector<SGSubsystemInitSpan> initCriticalPath() const;
+
+    /**
+     * @brief write the init timeline as a Chrome trace (JSON) which can be
+     * loaded in chrome://tracing or Perfetto
+     */
+    void writeInitTrace(std::ostream& os) const;
+
     void setReportTimingCb(void* userData, SGSubsystemTimingCb cb) { reportTimingCb = cb; reportTimingUserData = userData; }
     void setReportTimingStats(bool v) { reportTimingStatsRequest = v; }
 
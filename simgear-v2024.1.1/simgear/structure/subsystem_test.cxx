@@ -2,6 +2,10 @@
 
 #include <cstdio>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
 
 #include <simgear/compiler.h>
 #include <simgear/constants.h>
@@ -111,6 +115,46 @@ public:
     double lastUpdateTime = 0.0;
 };
 
+class SlowLoaderSub : public SGSubsystem
+{
+public:
+    static const char* staticSubsystemClassId() { return "slow-loader"; }
+
+    bool isInitThreadSafe() const override { return true; }
+
+    void init() override
+    {
+        initThread = std::this_thread::get_id();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        wasInited = true;
+    }
+
+    void update(double dt) override
+    {
+    }
+
+    std::thread::id initThread;
+    std::atomic<bool> wasInited{false};
+};
+
+class LoaderUserSub : public SGSubsystem
+{
+public:
+    static const char* staticSubsystemClassId() { return "loader-user"; }
+
+    void init() override
+    {
+        auto loader = get_manager()->get_subsystem<SlowLoaderSub>();
+        loaderWasInited = loader->wasInited;
+    }
+
+    void update(double dt) override
+    {
+    }
+
+    bool loaderWasInited = false;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // sample delegate
 
@@ -162,6 +206,10 @@ SGSubsystemMgr::Registrant<InstrumentGroup> registrant4(SGSubsystemMgr::FDM);
 
 SGSubsystemMgr::InstancedRegistrant<FakeRadioSub> registrant3(SGSubsystemMgr::POST_FDM);
 
+SGSubsystemMgr::Registrant<SlowLoaderSub> registrant5(SGSubsystemMgr::GENERAL);
+SGSubsystemMgr::Registrant<LoaderUserSub> registrant6(SGSubsystemMgr::GENERAL,
+    {{"slow-loader", SGSubsystemMgr::Dependency::SEQUENCE}});
+
 void testRegistrationAndCreation()
 {
     SGSharedPtr<SGSubsystemMgr> manager = new SGSubsystemMgr();
@@ -341,6 +389,58 @@ void testIncrementalInit()
     SG_VERIFY(d->hasEvent("fake-radio.nav2-did-init"));
 }
 
+void testParallelInit()
+{
+    SGSharedPtr<SGSubsystemMgr> manager = new SGSubsystemMgr();
+    auto d = new RecorderDelegate;
+    manager->addDelegate(d);
+
+    auto loader = manager->add<SlowLoaderSub>();
+    auto mySub = manager->add<MySub1>();
+    auto user = manager->add<LoaderUserSub>();
+
+    manager->bind();
+    for ( ; ; ) {
+        auto status = manager->incrementalInit();
+        if (status == SGSubsystemMgr::INIT_DONE)
+            break;
+    }
+
+    SG_VERIFY(loader->wasInited);
+    SG_VERIFY(loader->initThread != std::this_thread::get_id());
+    SG_VERIFY(mySub->wasInited);
+    // waited for its dependency
+    SG_VERIFY(user->loaderWasInited);
+
+    SG_VERIFY(d->hasEvent("slow-loader-will-init"));
+    SG_VERIFY(d->hasEvent("slow-loader-did-init"));
+    SG_VERIFY(d->findEvent("slow-loader-did-init") < d->findEvent("loader-user-will-init"));
+
+    // the main thread carried on while the loader was busy
+    SG_VERIFY(d->findEvent("mysub-did-init") < d->findEvent("slow-loader-did-init"));
+
+    const auto timeline = manager->initTimeline();
+    SG_CHECK_EQUAL(timeline.size(), 3);
+    SG_CHECK_EQUAL(timeline.front().subsystem, "slow-loader");
+    SG_VERIFY(timeline.front().thread != 0);
+    SG_VERIFY(timeline.front().durationMSec >= 50.0);
+
+    const auto critical = manager->initCriticalPath();
+    SG_CHECK_EQUAL(critical.size(), 2);
+    SG_CHECK_EQUAL(critical.front().subsystem, "slow-loader");
+    SG_CHECK_EQUAL(critical.back().subsystem, "loader-user");
+    SG_CHECK_EQUAL(critical.back().after, "slow-loader");
+
+    std::ostringstream trace;
+    manager->writeInitTrace(trace);
+    SG_VERIFY(trace.str().find("\"traceEvents\"") != std::string::npos);
+    SG_VERIFY(trace.str().find("\"name\":\"loader-user\"") != std::string::npos);
+
+    manager->postinit();
+    manager->shutdown();
+    manager->unbind();
+}
+
 void testEmptyGroup()
 {
     // testing the assert described here:
@@ -547,6 +647,7 @@ int main(int argc, char* argv[])
     testPropertyRoot();
     testAddRemoveAfterInit();
     testEmptyGroup();
+    testParallelInit();
     
     cout << __FILE__ << ": All tests passed" << endl;
     return EXIT_SUCCESS;
@@ -0,0 +1,102 @@
+// Unit tests for TraceRecorder
+// SPDX-License-Identifier: LGPL-2.1-or-later
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <simgear/misc/test_macros.hxx>
+
+#include "SGTraceRecorder.hxx"
+
+using simgear::TraceRecorder;
+using simgear::TraceScope;
+
+namespace {
+
+size_t countOf(const std::string& haystack, const std::string& needle)
+{
+    size_t count = 0;
+    for (auto pos = haystack.find(needle); pos != std::string::npos;
+         pos = haystack.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+std::string trace()
+{
+    std::ostringstream os;
+    TraceRecorder::writeChromeTrace(os);
+    return os.str();
+}
+
+} // namespace
+
+void testDisabled()
+{
+    TraceRecorder::setEnabled(false);
+    {
+        TraceScope scope("test", "disabled-span");
+    }
+    SG_CHECK_EQUAL(countOf(trace(), "disabled-span"), 0);
+}
+
+void testThreads()
+{
+    TraceRecorder::setEnabled(true);
+    TraceRecorder::setThreadName("main");
+    {
+        TraceScope scope("test", "main-span");
+    }
+
+    std::thread worker([]() {
+        TraceRecorder::setThreadName("worker");
+        for (int i = 0; i < 3; ++i) {
+            TraceScope scope("test", std::string("worker-span"));
+        }
+    });
+    worker.join();
+
+    const std::string json = trace();
+    SG_CHECK_EQUAL(countOf(json, "\"main-span\""), 1);
+    SG_CHECK_EQUAL(countOf(json, "\"worker-span\""), 3);
+    SG_CHECK_EQUAL(countOf(json, "\"thread_name\""), 2);
+    SG_VERIFY(json.find("\"worker\"") != std::string::npos);
+    SG_VERIFY(json.front() == '{' || json.front() == '[');
+
+    TraceRecorder::clear();
+    SG_CHECK_EQUAL(countOf(trace(), "-span\""), 0);
+    TraceRecorder::setEnabled(false);
+}
+
+void testRingBuffer()
+{
+    TraceRecorder::setEnabled(true);
+    TraceRecorder::setSpansPerThread(4);
+
+    // a new thread gets a buffer of the new size, keeping the latest spans
+    std::thread worker([]() {
+        const char* names[] = {"ring-0", "ring-1", "ring-2", "ring-3", "ring-4", "ring-5"};
+        for (auto name : names) {
+            TraceScope scope("test", name);
+        }
+    });
+    worker.join();
+
+    const std::string json = trace();
+    SG_CHECK_EQUAL(countOf(json, "\"ring-0\""), 0);
+    SG_CHECK_EQUAL(countOf(json, "\"ring-1\""), 0);
+    SG_CHECK_EQUAL(countOf(json, "\"ring-2\""), 1);
+    SG_CHECK_EQUAL(countOf(json, "\"ring-5\""), 1);
+    TraceRecorder::setEnabled(false);
+}
+
+int main(int argc, char* argv[])
+{
+    testDisabled();
+    testThreads();
+    testRingBuffer();
+    return EXIT_SUCCESS;
+}
@@ -444,6 +444,13 @@ public:
    * @param _parser the XML parser
    */
   void setParser(XML_Parser _parser) { parser = _parser; }
+
+  /** Set the position in the parsed file.
+   * For visitors which are fed events from another source than the XML
+   * parser, such as a recording of an earlier parse.
+   * @see #savePosition
+   */
+  void setPosition(int _line, int _column) { line = _line; column = _column; }
 private:
   XML_Parser parser;
   std::string path;